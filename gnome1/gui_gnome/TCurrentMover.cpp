@@ -28,9 +28,6 @@ TCurrentMover::TCurrentMover (TMap *owner, char *name) : TMover(owner, name)
 	fRightCurUncertainty = .1;  // 10%
 	fLeftCurUncertainty= -.1; 
 
-	fLESetSizesH = 0;
-	fUncertaintyListH = 0;
-
 	bIAmPartOfACompoundMover = false;
 	bIAmA3DMover = false;
 }
@@ -21,9 +21,6 @@ TWindMover::TWindMover(TMap *owner,char* name) : TMover(owner, name)
 	fUncertainStartTime = 0;
 	fDuration = 3*3600; // 3 hours
 	
-	fWindUncertaintyList = 0;
-	fLESetSizes = 0;
-	
 	fSpeedScale = 2;
 	fAngleScale = .4;
 	fMaxSpeed = 30; //mps
@@ -108,7 +108,7 @@ OSErr ADCPMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *patVe
 	//err = this -> UpdateUncertainty();
 	//if(err) return err;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 	
 	
 	if(useEddyUncertainty)
@@ -130,9 +130,9 @@ OSErr ADCPMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *patVe
 	}
 	
 	
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(patVelocity->u*patVelocity->u + patVelocity->v * patVelocity->v);
 		
 		
@@ -164,7 +164,7 @@ OSErr ADCPMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *patVe
 	}
 	else 
 	{
-		TechError("ADCPMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("ADCPMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		patVelocity->u=patVelocity->v=0;
 	}
 	return err;
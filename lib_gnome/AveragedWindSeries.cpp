@@ -0,0 +1,159 @@
+/*
+ *  AveragedWindSeries.cpp
+ *  gnome
+ *
+ */
+
+#include <math.h>
+
+#include "AveragedWindSeries.h"
+
+static const long kMaxAveragedWindSamples = 1L << 20;	// past this the grid starts again at the window
+
+static Seconds GreatestCommonDivisor(Seconds a, Seconds b)
+{
+	while (b != 0) {
+		Seconds r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+AveragedWindSeries::AveragedWindSeries()
+{
+	fTimeFile = 0;
+	fTheta = 0;
+	fTimeStep = 0;
+	fSpacing = 3600;
+	fStride = 1;
+	fFirstTime = 0;
+}
+
+void AveragedWindSeries::Reset(TimeValue_c *timeFile, double theta, Seconds timeStep)
+{
+	fTimeFile = timeFile;
+	fTheta = theta;
+	fTimeStep = timeStep;
+	fSpacing = timeStep > 0 ? GreatestCommonDivisor(3600, timeStep) : 3600;
+	fStride = 3600 / fSpacing;
+	fFirstTime = 0;
+	fSums.clear();
+}
+
+Boolean AveragedWindSeries::IsSetFor(TimeValue_c *timeFile, double theta, Seconds timeStep)
+{
+	return fTimeFile == timeFile && fTheta == theta && fTimeStep == timeStep;
+}
+
+// the grid gets fStride samples for each hour the model steps through, a window
+// summed from scratch numHours for each step
+Boolean AveragedWindSeries::UsesGrid(long numHours)
+{
+	return fTimeStep <= 0 || (double)fStride * fTimeStep <= (double)numHours * 3600;
+}
+
+OSErr AveragedWindSeries::GetMeanComponent(Seconds startTime, long numHours, double *mean)
+{
+	OSErr err = 0;
+	long firstSample, lastSample;
+	double sum;
+
+	*mean = 0;
+	if (!fTimeFile || numHours < 1)
+		return -1;
+
+	if (!UsesGrid(numHours))
+	{
+		fSums.clear();
+		if ((err = SumHours(startTime, numHours, &sum)) != 0)
+			return err;
+		*mean = sum / numHours;
+		return 0;
+	}
+
+	// a window off the grid, or before it, means the model did not just step forward
+	if (fSums.empty() || startTime < fFirstTime || (startTime - fFirstTime) % fSpacing != 0
+		|| (startTime - fFirstTime) / fSpacing + (numHours - 1) * fStride >= kMaxAveragedWindSamples)
+	{
+		fSums.clear();
+		fFirstTime = startTime;
+	}
+
+	firstSample = (startTime - fFirstTime) / fSpacing;
+	lastSample = firstSample + (numHours - 1) * fStride;
+	if ((err = ExtendTo(lastSample)) != 0)
+		return err;
+
+	sum = fSums[lastSample];
+	if (firstSample >= fStride)
+		sum -= fSums[firstSample - fStride];
+
+	*mean = sum / numHours;
+	return 0;
+}
+
+OSErr AveragedWindSeries::SumHours(Seconds startTime, long numHours, double *sum)
+{
+	OSErr err = 0;
+	double cosTheta = cos(fTheta), sinTheta = sin(fTheta);
+	std::vector<Seconds> times;
+	std::vector<VelocityRec> winds;
+
+	*sum = 0;
+	try
+	{
+		times.resize(numHours);
+		winds.resize(numHours);
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	for (long j = 0; j < numHours; j++)
+		times[j] = startTime + j * 3600;
+	if ((err = fTimeFile->GetTimeValues(&times[0], numHours, &winds[0])) != 0)
+		return err;
+
+	for (long j = 0; j < numHours; j++)
+		*sum += winds[j].u * cosTheta + winds[j].v * sinTheta;
+	return 0;
+}
+
+OSErr AveragedWindSeries::ExtendTo(long lastSample)
+{
+	OSErr err = 0;
+	long k, firstNew = fSums.size(), numNew = lastSample + 1 - firstNew;
+	double cosTheta = cos(fTheta), sinTheta = sin(fTheta);
+	std::vector<Seconds> times;
+	std::vector<VelocityRec> winds;
+
+	if (numNew <= 0)
+		return 0;
+
+	try
+	{
+		times.resize(numNew);
+		winds.resize(numNew);
+		fSums.reserve(lastSample + 1);
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	for (k = 0; k < numNew; k++)
+		times[k] = fFirstTime + (firstNew + k) * fSpacing;
+	if ((err = fTimeFile->GetTimeValues(&times[0], numNew, &winds[0])) != 0)
+		return err;
+
+	for (k = 0; k < numNew; k++)
+	{
+		long sample = firstNew + k;
+		double component = winds[k].u * cosTheta + winds[k].v * sinTheta;
+
+		fSums.push_back(sample >= fStride ? fSums[sample - fStride] + component : component);
+	}
+	return 0;
+}
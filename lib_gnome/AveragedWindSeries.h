@@ -0,0 +1,54 @@
+/*
+ *  AveragedWindSeries.h
+ *  gnome
+ *
+ *  Running sums of a wind time file's component along one direction,
+ *  sampled on a regular grid of times. Averaging the wind over the hours
+ *  before a model step is then two lookups, whatever the length of the
+ *  averaging window. The grid only grows to cover new times as the model
+ *  steps forward.
+ *
+ *  The grid takes more samples to the hour the less the time step has in
+ *  common with the hour, 3600 when they have only the second. When it would
+ *  sample more often than summing the hours of each window from scratch,
+ *  the windows are summed from scratch instead.
+ *
+ */
+
+#ifndef __AveragedWindSeries__
+#define __AveragedWindSeries__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "TimeValue_c.h"
+#include "ExportSymbols.h"
+
+class DLL_API AveragedWindSeries {
+
+public:
+	AveragedWindSeries();
+
+	// the samples are spaced by the largest interval dividing both the hour and the model time step
+	void		Reset(TimeValue_c *timeFile, double theta, Seconds timeStep);
+	Boolean		IsSetFor(TimeValue_c *timeFile, double theta, Seconds timeStep);
+
+	// mean of u cos(theta) + v sin(theta) over the hourly times startTime, startTime + 3600, ...
+	OSErr		GetMeanComponent(Seconds startTime, long numHours, double *mean);
+
+private:
+	TimeValue_c	*fTimeFile;
+	double		fTheta;
+	Seconds		fTimeStep;
+	Seconds		fSpacing;		// between samples
+	long		fStride;		// samples to the hour
+	Seconds		fFirstTime;		// of sample 0
+	std::vector<double>	fSums;	// sample k plus sample k - fStride plus ... back to the first hour
+
+	Boolean		UsesGrid(long numHours);
+	OSErr		ExtendTo(long lastSample);
+	OSErr		SumHours(Seconds startTime, long numHours, double *sum);
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ *  BlendedVelocityField.cpp
+ *  gnome
+ *
+ */
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+#include "BlendedVelocityField.h"
+#include "MemUtils.h"
+
+static const long kTileShift = 8;	// 256 values to a tile
+static const long kTileSize = 1L << kTileShift;
+
+struct BlendedVelocityField::Tiles {
+	std::vector<VelocityRec>	values;
+	std::atomic<char>			*blended;	// one flag per tile, set once its values are filled
+	std::mutex					fillMutex;
+
+	Tiles() : blended(0) {}
+	~Tiles() {delete [] blended;}
+};
+
+BlendedVelocityField::BlendedVelocityField()
+{
+	fIsValid = false;
+	fModelTime = 0;
+	fStartH = fEndH = 0;
+	fTimeAlpha = 1.;
+	fNumValues = fNumTiles = 0;
+	fTiles = new Tiles();
+}
+
+BlendedVelocityField::~BlendedVelocityField()
+{
+	delete fTiles;
+}
+
+void BlendedVelocityField::Prepare(const Seconds& model_time, VelocityFH startH, VelocityFH endH, double timeAlpha, Boolean blendAll)
+{
+	long numValues = 0, numTiles;
+
+	fIsValid = false;
+	if (!startH || !endH)
+		return;
+
+	numValues = _GetHandleSize((Handle)startH) / sizeof(**startH);
+	if (_GetHandleSize((Handle)endH) / (long)sizeof(**endH) < numValues)
+		numValues = _GetHandleSize((Handle)endH) / sizeof(**endH);
+	numTiles = (numValues + kTileSize - 1) >> kTileShift;
+
+	if (numTiles != fNumTiles)
+	{
+		delete [] fTiles->blended;
+		fTiles->blended = numTiles > 0 ? new std::atomic<char>[numTiles] : 0;
+	}
+	fTiles->values.resize(numValues);
+	for (long tile = 0; tile < numTiles; tile++)
+		fTiles->blended[tile].store(0, std::memory_order_relaxed);
+
+	fModelTime = model_time;
+	fStartH = startH;
+	fEndH = endH;
+	fTimeAlpha = timeAlpha;
+	fNumValues = numValues;
+	fNumTiles = numTiles;
+	fIsValid = true;
+
+	if (blendAll)
+	{
+		for (long tile = 0; tile < numTiles; tile++)
+			BlendTile(tile);
+	}
+}
+
+void BlendedVelocityField::Invalidate()
+{
+	if (!fIsValid && !fStartH && !fEndH)
+		return;	// nothing to do, and nothing written for threads reading the field
+	fIsValid = false;
+	fStartH = fEndH = 0;
+}
+
+const VelocityRec &BlendedVelocityField::GetVelocity(long index)
+{
+	long tile = index >> kTileShift;
+
+	if (!fTiles->blended[tile].load(std::memory_order_acquire))
+		BlendTile(tile);
+	return fTiles->values[index];
+}
+
+// same arithmetic as TimeGridVelRect_c::InterpolateVelocity, so the blended values match it exactly
+void BlendedVelocityField::BlendTile(long tile)
+{
+	std::lock_guard<std::mutex> lock(fTiles->fillMutex);
+
+	if (fTiles->blended[tile].load(std::memory_order_relaxed))
+		return;	// another thread got here first
+
+	long first = tile << kTileShift;
+	long last = _min(first + kTileSize, fNumValues);
+	VelocityFP start = *fStartH, end = *fEndH;
+
+	for (long i = first; i < last; i++)
+	{
+		fTiles->values[i].u = fTimeAlpha*start[i].u + (1-fTimeAlpha)*end[i].u;
+		fTiles->values[i].v = fTimeAlpha*start[i].v + (1-fTimeAlpha)*end[i].v;
+	}
+	fTiles->blended[tile].store(1, std::memory_order_release);
+}
+
+long BlendedVelocityField::GetNumTilesBlended()
+{
+	long numBlended = 0;
+
+	if (!fIsValid)
+		return 0;
+	for (long tile = 0; tile < fNumTiles; tile++)
+	{
+		if (fTiles->blended[tile].load(std::memory_order_relaxed))
+			numBlended++;
+	}
+	return numBlended;
+}
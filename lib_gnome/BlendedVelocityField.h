@@ -0,0 +1,49 @@
+/*
+ *  BlendedVelocityField.h
+ *  gnome
+ *
+ *  The start and end time slices of a time grid blended in time for one
+ *  model time, so that looking up an LE's velocity is a read instead of a
+ *  blend. Values are blended in tiles of neighbouring grid values, either
+ *  the first time a lookup lands in a tile or all at once when prepared.
+ *
+ */
+
+#ifndef __BlendedVelocityField__
+#define __BlendedVelocityField__
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class DLL_API BlendedVelocityField {
+
+public:
+	BlendedVelocityField();
+	~BlendedVelocityField();
+
+	// the slices must stay loaded until Invalidate, blendAll fills every tile now
+	void		Prepare(const Seconds& model_time, VelocityFH startH, VelocityFH endH, double timeAlpha, Boolean blendAll);
+	void		Invalidate();
+	Boolean		IsPreparedFor(const Seconds& model_time) {return fIsValid && fModelTime == model_time;}
+
+	// timeAlpha * start + (1 - timeAlpha) * end at a slice index, safe to call from several threads
+	const VelocityRec	&GetVelocity(long index);
+
+	long		GetNumTiles() {return fNumTiles;}
+	long		GetNumTilesBlended();
+
+private:
+	struct Tiles;
+
+	Boolean		fIsValid;
+	Seconds		fModelTime;
+	VelocityFH	fStartH, fEndH;
+	double		fTimeAlpha;
+	long		fNumValues, fNumTiles;
+	Tiles		*fTiles;
+
+	void		BlendTile(long tile);
+};
+
+#endif
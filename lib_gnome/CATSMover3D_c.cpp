@@ -111,7 +111,7 @@
  err = this -> UpdateUncertainty();
  if(err) return err;
  
- if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+ if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
  
  
  if(useEddyUncertainty)
@@ -133,9 +133,9 @@
  }
  
  
- if(fUncertaintyListH && fLESetSizesH)
+ if(fUncertainty.IsAllocated())
  {
- unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+ unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
  lengthS = sqrt(patVelocity->u*patVelocity->u + patVelocity->v * patVelocity->v);
  
  
@@ -167,7 +167,7 @@
  }
  else 
  {
- TechError("TCATSMover3D::AddUncertainty()", "fUncertaintyListH==nil", 0);
+ TechError("TCATSMover3D::AddUncertainty()", "fUncertainty not allocated", 0);
  patVelocity->u=patVelocity->v=0;
  }
  return err;
@@ -12,6 +12,7 @@
 #include "CompFunctions.h"
 #include "MemUtils.h"
 #include "DagTreeIO.h"
+#include "TriGridVel_c.h"
 #include "StringFunctions.h"
 //#include "OUTILS.H"
 
@@ -32,8 +33,6 @@ CATSMover_c::CATSMover_c () : CurrentMover_c() {
 	
 	fDuration = 48 * 3600; //48 hrs as seconds
 	fTimeUncertaintyWasSet = 0;
-	fLESetSizesH = 0;
-	fUncertaintyListH = 0;
 	fGrid = 0;
 	SetTimeDep(0);
 	bTimeFileActive = false;
@@ -41,6 +40,8 @@ CATSMover_c::CATSMover_c () : CurrentMover_c() {
 	fEddyV0 = 0.1; // JLM 5/20/99
 
 	bApplyLogProfile = false;
+	bUseLastTriangle = true;
+	fStepLastTris = 0;
 
 	memset(&fOptimize, 0, sizeof(fOptimize));
 }
@@ -59,6 +60,8 @@ CATSMover_c::CATSMover_c(TMap *owner, char *name) : CurrentMover_c(owner, name)
 	fEddyV0 = 0.1; // JLM 5/20/99
 
 	bApplyLogProfile = false;
+	bUseLastTriangle = true;
+	fStepLastTris = 0;
 
 	memset(&fOptimize, 0, sizeof(fOptimize));
 
@@ -207,7 +210,7 @@ OSErr CATSMover_c::AddUncertainty(long setIndex, long leIndex,
 	double u, v, lengthS, alpha, beta, v0, gammaScale;
 	LEUncertainRec unrec;
 
-	if (!fUncertaintyListH || !fLESetSizesH)
+	if (!fUncertainty.IsAllocated())
 		return 0; // this is our clue to not add uncertainty
 
 	if (useEddyUncertainty) {
@@ -225,8 +228,8 @@ OSErr CATSMover_c::AddUncertainty(long setIndex, long leIndex,
 		rand2 = 0;
 	}
 
-	if (fUncertaintyListH && fLESetSizesH) {
-		unrec = (*fUncertaintyListH)[(*fLESetSizesH)[setIndex] + leIndex];
+	if (fUncertainty.IsAllocated()) {
+		unrec = fUncertainty.GetCurrentRec(setIndex, leIndex);
 		lengthS = sqrt((patVelocity->u * patVelocity->u) +
 					   (patVelocity->v * patVelocity->v));
 
@@ -262,7 +265,7 @@ OSErr CATSMover_c::AddUncertainty(long setIndex, long leIndex,
 		}
 	}
 	else {
-		TechError("TCATSMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("TCATSMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		patVelocity->u = patVelocity->v = 0;
 	}
 
@@ -273,6 +276,7 @@ OSErr CATSMover_c::AddUncertainty(long setIndex, long leIndex,
 OSErr CATSMover_c::PrepareForModelRun()
 {
 	this->fOptimize.isFirstStep = true;
+	fLastTriangles.Clear();
 	return CurrentMover_c::PrepareForModelRun();
 }
 
@@ -324,31 +328,44 @@ OSErr CATSMover_c::get_move(int n, Seconds model_time, Seconds step_len,
 		return 2;
 	}
 
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr CATSMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
 
 	WorldPoint3D zero_delta = { {0, 0}, 0.};
 
+	// the reference scale is set for the step and the eddy uncertainty draws random numbers in LE order
+	Boolean inParallel = fNumThreads > 1 && fOptimize.isOptimizedForStep && spillType == FORECAST_LE;
+
+	if (inParallel && timeDep && bTimeFileActive) {
+		// make sure the time file has its values for this time before the threads read them
+		VelocityRec timeValue;
+		timeDep->GetTimeValue(model_time, &timeValue);
+	}
+
+	// each LE only reads and writes its own entry, so the threads can share the array
+	fStepLastTris = bUseLastTriangle ? fLastTriangles.GetLastTris(spill_ID, spillType == UNCERTAINTY_LE, les.GetNumSpillLEs()) : 0;
+
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
-		if ( LE_status[i] != OILSTAT_INWATER) {
+		LERec rec;
+		if ( !les.IsInWater(i)) {
 			delta[i] = zero_delta;
 			continue;
 		}
+		les.GetLE(i, &rec);
 
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1e6;
-		rec.p.pLong *= 1e6;
-
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 
 		delta[i].p.pLat /= 1e6;
 		delta[i].p.pLong /= 1e6;
 	}
 
+	fStepLastTris = 0;
 	return noErr;
 }
 
@@ -366,7 +383,7 @@ WorldPoint3D CATSMover_c::GetMove(const Seconds &model_time, Seconds timeStep,
 	refPoint3D.p = (*theLE).p;
 	refPoint3D.z = (*theLE).z;
 
-	scaledPatVelocity = this->GetScaledPatValue(model_time, refPoint3D, &useEddyUncertainty);
+	scaledPatVelocity = this->GetScaledPatValue(model_time, refPoint3D, &useEddyUncertainty, fStepLastTris ? &fStepLastTris[leIndex] : 0);
 
 	if (leType == UNCERTAINTY_LE) {
 		AddUncertainty(setIndex, leIndex, &scaledPatVelocity, timeStep, useEddyUncertainty);
@@ -385,7 +402,7 @@ WorldPoint3D CATSMover_c::GetMove(const Seconds &model_time, Seconds timeStep,
 /// 5/12/99 JLM, we only add the eddy uncertainty when the vectors are big enough when the timeValue is 1
 // This is in response to the Prince William sound problem where 5 patterns are being added together
 VelocityRec CATSMover_c::GetScaledPatValue(const Seconds &model_time,
-										   WorldPoint3D p, Boolean *useEddyUncertainty)
+										   WorldPoint3D p, Boolean *useEddyUncertainty, long *lastTri)
 {
 	VelocityRec	patVelocity, timeValue = {1, 1};
 	float lengthSquaredBeforeTimeFactor;
@@ -407,7 +424,7 @@ VelocityRec CATSMover_c::GetScaledPatValue(const Seconds &model_time,
 			timeValue = errVelocity;
 	}
 
-	patVelocity = GetPatValue(p);
+	patVelocity = GetPatValue(p, lastTri);
 	patVelocity.u *= refScale; 
 	patVelocity.v *= refScale; 
 
@@ -427,8 +444,11 @@ VelocityRec CATSMover_c::GetScaledPatValue(const Seconds &model_time,
 }
 
 
-VelocityRec CATSMover_c::GetPatValue(WorldPoint3D p)
+// lastTri, if given, is where a triangle grid starts its search and is updated to the LE's triangle
+VelocityRec CATSMover_c::GetPatValue(WorldPoint3D p, long *lastTri)
 {
+	TriGridVel_c *triGrid = lastTri ? dynamic_cast<TriGridVel_c*>(fGrid) : 0;
+
 	double depthAtPoint = 0., scaleFactor = 1.;
 	VelocityRec patVal = {0., 0.};
 
@@ -452,7 +472,10 @@ VelocityRec CATSMover_c::GetPatValue(WorldPoint3D p)
 			scaleFactor = 1. - log(p.z) / log(depthAtPoint);
 	}
 
-	patVal = fGrid->GetPatValue(p.p);
+	if (triGrid && triGrid->GetDagTree())
+		patVal = triGrid->GetPatValueFromLastTri(p.p, lastTri);
+	else
+		patVal = fGrid->GetPatValue(p.p);
 	patVal.u *= scaleFactor;
 	patVal.v *= scaleFactor;
 
@@ -13,6 +13,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "CurrentMover_c.h"
+#include "DagTree.h"
 #include "ExportSymbols.h"
 
 #ifndef pyGNOME
@@ -52,6 +53,9 @@ public:
 	double			fEddyDiffusion;			// cm**2/s minimum eddy velocity for uncertainty
 	double			fEddyV0;			//  in m/s, used for cutoff of minimum eddy for uncertainty
 	TCM_OPTIMZE fOptimize; // this does not need to be saved to the save file	
+	Boolean			bUseLastTriangle;		// triangle grid lookups start from the triangle each LE was in last step
+	LastTriangleCache	fLastTriangles;
+	long			*fStepLastTris;			// set by get_move for the spill it is moving
 	
 #ifndef pyGNOME
 						CATSMover_c (TMap *owner, char *name);
@@ -66,8 +70,8 @@ public:
 	void				SetTimeDep (TOSSMTimeValue *newTimeDep);
 	TOSSMTimeValue		*GetTimeDep () { return (timeDep); }
 	void				DeleteTimeDep ();
-	VelocityRec			GetPatValue (WorldPoint3D p);
-	VelocityRec 		GetScaledPatValue(const Seconds& model_time, WorldPoint3D p,Boolean * useEddyUncertainty);//JLM 5/12/99
+	VelocityRec			GetPatValue (WorldPoint3D p, long *lastTri = 0);
+	VelocityRec 		GetScaledPatValue(const Seconds& model_time, WorldPoint3D p,Boolean * useEddyUncertainty, long *lastTri = 0);//JLM 5/12/99
 	VelocityRec			GetSmoothVelocity (WorldPoint p);
 	virtual OSErr       ComputeVelocityScale(const Seconds& model_time);
 	virtual WorldPoint3D       GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *theLE,LETYPE leType);
@@ -80,6 +84,7 @@ public:
 	virtual	OSErr TextRead(char* path);
 
 	OSErr get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 
 };
 
@@ -144,6 +144,10 @@ void ComponentMover_c::ModelStepIsDone()
 OSErr ComponentMover_c::PrepareForModelRun()
 {
 	this -> fOptimize.isFirstStep = true;
+#ifdef pyGNOME
+	// the wind or the averaging settings may have changed since the last run
+	fAveragedWinds.Reset(timeFile, PI * -(0.5 + (pat1Angle / 180.0)), 0);
+#endif
 	return CurrentMover_c::PrepareForModelRun();
 }
 
@@ -189,33 +193,21 @@ done:
 	return err;
 }
 #ifdef pyGNOME
-OSErr ComponentMover_c::CalculateAveragedWindsVelocity(const Seconds& model_time, char *errmsg)
+OSErr ComponentMover_c::CalculateAveragedWindsVelocity(const Seconds& model_time, const Seconds& time_step, char *errmsg)
 {
 	OSErr err = 0;
-	long j;
-	VelocityRec avValue;
-	VelocityRec wVel = {0.,0.};
 	double pat1Theta = PI * -(0.5 + (pat1Angle / 180.0));
-	double pat2Theta = PI * -(0.5 + (pat2Angle / 180.0));
-	WorldPoint3D refPoint3D = {0,0,0.};
-	VelocityRec pat1ValRef;
-	double pat1ValRefLength;
 	
-	refPoint3D.p = refP;
-	pat1ValRef = pattern1 -> GetPatValue (refPoint3D);
-	pat1ValRefLength = sqrt (pat1ValRef.u * pat1ValRef.u + pat1ValRef.v * pat1ValRef.v);
-
 	strcpy(errmsg,"");
+	fAveragedWindVelocity.u = fAveragedWindVelocity.v = 0;
 	
 	long averageTimeSteps;
-	double averageSpeed=0.,averageDir = 0;
+	double averageSpeed=0.;
 	Seconds timeToGetAverageFor = model_time;
 	Seconds startPastTime  = timeToGetAverageFor - fPastHoursToAverage * 3600;
-	//INDEXH(fAveragedWindsHdl, i).time = model -> GetStartTime () + i * model -> GetTimeStep();
-	//averageTimeSteps = fPastHoursToAverage+1; // for now, will change to match model time steps...
 	averageTimeSteps = fPastHoursToAverage; // for now, will change to match model time steps...
 	// code goes here, may want to change to GetStartTime, GetEndTime, then check out of range
-	if (timeFile) timeFile->CheckStartTime(startPastTime);
+	if (timeFile) err = timeFile->CheckStartTime(startPastTime);
 	else {err = -1; strcpy(errmsg,"There is no wind data to average"); return err;}
 	if (err==-1) 
 	{
@@ -225,59 +217,31 @@ OSErr ComponentMover_c::CalculateAveragedWindsVelocity(const Seconds& model_time
 		}
 		else
 		{strcpy(errmsg,"There is not enough data in your wind file for the averaging"); return err;}
-		//printError("There is not enough data in your wind file for the averaging"); goto done;
 	}
 	if (err==-2) 
 	{
-		//strcpy(errmsg,"No point in averaging for constant wind."); goto done;
-		//fPastHoursToAverage=0; err=0;	// allow constant wind, only need one value though 
-		//printError("No point in averaging for constant wind."); goto done;
 		averageTimeSteps = 1; 
 		startPastTime = timeToGetAverageFor;	// this doesn't really matter with constant wind
 		err = 0;
 	}
-	//if (forTime > INDEXH(timeValues, n - 1).time) 
 	if (fPastHoursToAverage==0) averageTimeSteps = 1;	// just use the straight wind
-	for (j=0;j<averageTimeSteps;j++)
-	{
-		Seconds timeToAddToAverage = startPastTime + j*3600; // eventually this will be time step...
-		double		windSpeedToScale, windDir,theta;
-		// get the time file / wind mover value for this time
-		// get the mover first then repeat using it for the times..., but make sure get time value gets a value...
-		// check first value - 24, last value else will just use first/last value 
-		// also check if it's not a time file...
-		// check here that time is in the handle...
-		timeFile-> GetTimeValue (timeToAddToAverage, &wVel);	
-		
-		//windSpeedToScale = sqrt(wVel.u*wVel.u + wVel.v*wVel.v);
-		// code goes here, take the component first, then average ?
-		windSpeedToScale = wVel.u * cos (pat1Theta) + wVel.v * sin (pat1Theta);
-		//averageSpeed += (windSpeedToScale) * fScaleFactorAveragedWinds / pat1ValRefLength; //windSpeedToScale; //?? need the dot product too
-		//averageSpeed += (windSpeedToScale); //windSpeedToScale; //?? need the dot product too - seems this was done twice?
-		//windDir = fmod(atan2(wVel.u,wVel.v)*180/PI+360,360); // floating point remainder
-		windDir = atan2(wVel.u,wVel.v); // 
-		//windDir = fmod(-180,360); // not sure what above does...
-		//theta = fmod(theta+180,360); // rotate the vector cause wind is FROM this direction
-		//r=sqrt(u*u+v*v);
-		//	windDir = 0;
-		averageSpeed = averageSpeed + windSpeedToScale; // need to divide by averageTimeSteps
-		averageDir = averageDir + windDir;
-		//averageDir = averageDir + windSpeedToScale; // need to divide by averageTimeSteps
-		// if add up wind dir make sure it's -180 to 180 - not necessary
-	}
-	averageSpeed = averageSpeed / averageTimeSteps;
+	
+	// the component of the wind along pattern 1, averaged over the hourly values
+	// from startPastTime on (the direction of the wind isn't used)
+	if (!fAveragedWinds.IsSetFor(timeFile, pat1Theta, time_step))
+		fAveragedWinds.Reset(timeFile, pat1Theta, time_step);
+	err = fAveragedWinds.GetMeanComponent(startPastTime, averageTimeSteps, &averageSpeed);
+	if (err) {strcpy(errmsg,"Could not average the winds in your wind file"); return err;}
+	
 	// apply power and scale - is this the right order?
 	if (averageSpeed<0) averageSpeed = -1. * pow(fabs(averageSpeed),fPowerFactorAveragedWinds);
 	else
 	/*if (fPowerFactorAveragedWinds!=1.)*/  averageSpeed = pow(averageSpeed,fPowerFactorAveragedWinds); 
 	//for now apply the scale factor in SetOptimizeVariables()
-	//averageSpeed = averageSpeed*fScaleFactorAveragedWinds; 
 	// code goes here bUseMainDialogScaleFactor = true do this way leave out fSFAW, = false just use fSFAW
-	averageDir = averageDir / averageTimeSteps;
-	//avValue.u = averageSpeed*sin(averageDir/*+PI*/);	// not sure about the pi
-	//avValue.v = averageSpeed*cos(averageDir/*+PI*/);
-	avValue.u = averageSpeed;	// not sure about the pi
-	avValue.v = 0;	// not sure about the pi
+	fAveragedWindVelocity.u = averageSpeed;
+	fAveragedWindVelocity.v = 0;
+	return err;
 }
 #else
 OSErr ComponentMover_c::CalculateAveragedWindsHdl(char *errmsg)
@@ -618,8 +582,9 @@ OSErr ComponentMover_c::SetOptimizeVariables (char *errmsg, const Seconds& model
 		{
 			if (bUseAveragedWinds)
 			{
-				err = CalculateAveragedWindsVelocity(model_time,errmsg);
-				wVel = fAveragedWindVelocity;	// don't need to store?
+				err = CalculateAveragedWindsVelocity(model_time,time_step,errmsg);
+				if (err) return err;
+				wVel = fAveragedWindVelocity;
 			}
 			else
 				timeFile->GetTimeValue(model_time, &wVel);	// this needs to be defined
@@ -704,27 +669,30 @@ OSErr ComponentMover_c::get_move(int n, Seconds model_time, Seconds step_len,
 	{
 		return 2;
 	}
-	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
-	
+
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr ComponentMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
 	WorldPoint3D zero_delta = { {0, 0}, 0.};
 	
+	// the component velocities are set up once per step, after that the moves are independent
+	Boolean inParallel = fNumThreads > 1 && fOptimize.isOptimizedForStep;
+	
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
-		if ( LE_status[i] != OILSTAT_INWATER) {
+		LERec rec;
+		if ( !les.IsInWater(i)) {
 			delta[i] = zero_delta;
 			continue;
 		}
+		les.GetLE(i, &rec);
 		
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1e6;
-		rec.p.pLong *= 1e6;
-		
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1e6;
 		delta[i].p.pLong /= 1e6;
@@ -821,12 +789,12 @@ OSErr ComponentMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *
 	//err = this -> UpdateUncertainty();
 	//if(err) return err;
 
-	if(!fUncertaintyListH || !fLESetSizesH) 
+	if(!fUncertainty.IsAllocated()) 
 		return 0; // this is our clue to not add uncertainty
 	
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(patVelocity->u*patVelocity->u + patVelocity->v * patVelocity->v);
 		
 		u = patVelocity->u;
@@ -844,7 +812,7 @@ OSErr ComponentMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *
 	}
 	else 
 	{
-		TechError("TComponentMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("TComponentMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		patVelocity->u=patVelocity->v=0;
 	}
 	return err;
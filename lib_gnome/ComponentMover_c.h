@@ -13,6 +13,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "CurrentMover_c.h"
+#include "AveragedWindSeries.h"
 
 #ifdef pyGNOME
 #define TCATSMover CATSMover_c
@@ -62,6 +63,7 @@ public:
 	TimeValuePairH	fAveragedWindsHdl;
 #else
 	VelocityRec		fAveragedWindVelocity;
+	AveragedWindSeries	fAveragedWinds;	// set up again each run
 #endif
 	
 	//							optimize fields don't need to be saved
@@ -84,7 +86,7 @@ public:
 	OSErr				CalculateAveragedWindsHdl(char *errmsg);
 	OSErr				GetAveragedWindValue(Seconds time, const Seconds& time_step, VelocityRec *avValue);
 #else
-	OSErr 				CalculateAveragedWindsVelocity(const Seconds& model_time, char *errmsg);
+	OSErr 				CalculateAveragedWindsVelocity(const Seconds& model_time, const Seconds& time_step, char *errmsg);
 #endif
 	virtual OSErr		AddUncertainty(long setIndex, long leIndex,VelocityRec *patVelocity,double timeStep);
 
@@ -102,6 +104,7 @@ public:
 	virtual	OSErr TextRead(char* catsPath1, char* catsPath2);
 #endif
 	OSErr get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 };
 
 #undef TCATSMover
@@ -57,12 +57,12 @@ OSErr CompoundMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *p
 	//if(err) return err;
 	
 	
-	if(!fUncertaintyListH || !fLESetSizesH) 
+	if(!fUncertainty.IsAllocated()) 
 		return 0; // this is our clue to not add uncertainty
 	
-	/*if(fUncertaintyListH && fLESetSizesH)
+	/*if(fUncertainty.IsAllocated())
 	 {
-	 unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+	 unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 	 lengthS = sqrt(patVelocity->u*patVelocity->u + patVelocity->v * patVelocity->v);
 	 
 	 u = patVelocity->u;
@@ -80,7 +80,7 @@ OSErr CompoundMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *p
 	 }
 	 else 
 	 {
-	 TechError("TCompoundMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+	 TechError("TCompoundMover::AddUncertainty()", "fUncertainty not allocated", 0);
 	 patVelocity->u=patVelocity->v=0;
 	 }*/
 	return err;
@@ -0,0 +1,100 @@
+/*
+ *  CounterRandom.cpp
+ *  gnome
+ *
+ */
+
+#include "CounterRandom.h"
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+// maps a word to (0,1), never exactly 0 so it is safe to take the log
+#define WORD_TO_UNIT(w) (((double)(w) + 0.5) * (1.0 / 4294967296.0))
+
+void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+{
+	uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+	uint32_t k0 = key[0], k1 = key[1];
+
+	for (int i = 0; i < PHILOX_ROUNDS; i++)
+	{
+		uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+		uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+
+		c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+		c1 = (uint32_t)p1;
+		c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+		c3 = (uint32_t)p0;
+
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+
+	result[0] = c0;
+	result[1] = c1;
+	result[2] = c2;
+	result[3] = c3;
+}
+
+CounterRandom::CounterRandom(unsigned long seed, unsigned long moverStream, long spillID, long leIndex,
+							 unsigned long step, long stream)
+{
+	fKey[0] = (uint32_t)seed;
+	fKey[1] = (uint32_t)moverStream;
+	fCounter[0] = (uint32_t)leIndex;
+	fCounter[1] = (uint32_t)step;
+	fCounter[2] = 0;	// block number within this LE's step
+	fCounter[3] = ((uint32_t)spillID << 8) | ((uint32_t)stream & 0xFF);
+	fNumUsed = 4;
+	bHaveNormal = false;
+	fNormal = 0.;
+}
+
+void CounterRandom::NextBlock(void)
+{
+	Philox4x32(fCounter, fKey, fBlock);
+	fCounter[2]++;
+	fNumUsed = 0;
+}
+
+uint32_t CounterRandom::NextWord(void)
+{
+	if (fNumUsed >= 4)
+		NextBlock();
+	return fBlock[fNumUsed++];
+}
+
+double CounterRandom::Uniform(double low, double high)
+{
+	return low + (high - low) * WORD_TO_UNIT(NextWord());
+}
+
+double CounterRandom::Normal(void)
+{
+	// Box-Muller gives two at a time, keep the second for the next call
+	if (bHaveNormal)
+	{
+		bHaveNormal = false;
+		return fNormal;
+	}
+
+	double r = sqrt(-2. * log(WORD_TO_UNIT(NextWord())));
+	double theta = 2. * PI * WORD_TO_UNIT(NextWord());
+
+	fNormal = r * sin(theta);
+	bHaveNormal = true;
+	return r * cos(theta);
+}
+
+void CounterRandom::VectorInUnitCircle(float *u, float *v)
+{
+	do
+	{
+		*u = (float)Uniform(-1.0, 1.0);
+		*v = (float)Uniform(-1.0, 1.0);
+	} while ( (*u)*(*u) + (*v)*(*v) > 1.0);
+}
@@ -0,0 +1,53 @@
+/*
+ *  CounterRandom.h
+ *  gnome
+ *
+ *  Counter based random numbers (Philox4x32-10, Salmon et al. 2011).
+ *  Every draw is a pure function of (seed, mover stream, spill, LE, step,
+ *  draw number)
+ *  so the same LE gets the same numbers whatever order or thread the LEs
+ *  are moved in.
+ *
+ */
+
+#ifndef __CounterRandom__
+#define __CounterRandom__
+
+#include <stdint.h>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+// what a mover's draws are for, so that one mover drawing for two things
+// doesn't draw the same numbers for both
+enum { kRandomMoverDraws = 1, kRandomVerticalDraws, kCurrentUncertaintyDraws, kWindUncertaintyDraws };
+
+// one Philox4x32-10 block: four 32 bit words from a 128 bit counter and 64 bit key
+void DLL_API Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+class DLL_API CounterRandom {
+
+public:
+	// the draws for one LE in one step of a mover's stream (Mover_c::GetRandomStream),
+	// stream separates e.g. forecast and uncertainty LEs
+	CounterRandom(unsigned long seed, unsigned long moverStream, long spillID, long leIndex,
+				  unsigned long step, long stream = 0);
+
+	double		Uniform(double low, double high);	// uniform in (low, high)
+	double		Normal(void);						// standard normal
+	void		VectorInUnitCircle(float *u, float *v);
+
+private:
+	uint32_t	fKey[2];
+	uint32_t	fCounter[4];
+	uint32_t	fBlock[4];
+	short		fNumUsed;
+	Boolean		bHaveNormal;
+	double		fNormal;
+
+	void		NextBlock(void);
+	uint32_t	NextWord(void);
+};
+
+#endif
@@ -174,31 +174,39 @@ OSErr CurrentCycleMover_c::get_move(int n, Seconds model_time, Seconds step_len,
 		// cout << "Invalid spillType.\n";
 		return 2;
 	}
+
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr CurrentCycleMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
+	WorldPoint3D zero_delta ={0,0,0.};
 	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
+	// once the interval is set for the step the grid is only read
+	Boolean inParallel = fNumThreads > 1 && fIsOptimizedForStep;
 	
-	WorldPoint3D zero_delta ={0,0,0.};
+	if (inParallel && timeDep && bTimeFileActive) {
+		// make sure the time file has its values for this time before the threads read them
+		VelocityRec timeValue;
+		timeDep->GetTimeValue(model_time, &timeValue);
+	}
 	
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 		
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		
-	//sprintf(errmsg,"rec.p.pLat = %lf, rec.p.pLong = %lf\n",rec.p.pLat, rec.p.pLong);
-	//printNote(errmsg);
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	
-		rec.p.pLong*= 1000000;
+		les.GetLE(i, &rec);
 		
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
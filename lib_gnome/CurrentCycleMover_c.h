@@ -85,6 +85,7 @@ public:
 	virtual void 		ModelStepIsDone();
 			OSErr 		TextRead(char *path, char *topFilePath); 
 			OSErr		get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 	//OSErr 				ReorderPoints(TMap **newMap, short *bndry_indices, short *bndry_nums, short *bndry_type, long numBoundaryPts); 
 	//virtual Boolean 	CheckInterval(long &timeDataInterval, const Seconds& model_time);	// AH 07/17/2012
 	//virtual OSErr	 	SetInterval(char *errmsg, const Seconds& model_time); // AH 07/17/2012
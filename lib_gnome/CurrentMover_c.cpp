@@ -10,6 +10,7 @@
 #include "CurrentMover_c.h"
 #include "CompFunctions.h"
 #include "MemUtils.h"
+#include "CounterRandom.h"
 
 #ifdef pyGNOME
 #include "Replacements.h"
@@ -30,9 +31,6 @@ CurrentMover_c::CurrentMover_c (TMap *owner, char *name) : Mover_c(owner, name)
 	fRightCurUncertainty = .1;  // 10%
 	fLeftCurUncertainty= -.1; 
 	
-	fLESetSizesH = 0;
-	fUncertaintyListH = 0;
-	
 	bIAmPartOfACompoundMover = false;
 	bIAmA3DMover = false;
 	
@@ -52,9 +50,6 @@ CurrentMover_c::CurrentMover_c () : Mover_c()
 	fRightCurUncertainty = .1;  // 10%
 	fLeftCurUncertainty= -.1; 
 	
-	fLESetSizesH = 0;
-	fUncertaintyListH = 0;
-	
 	bIAmPartOfACompoundMover = false;
 	bIAmA3DMover = false;
 	
@@ -71,113 +66,62 @@ void CurrentMover_c::Dispose ()
 	Mover_c::Dispose ();
 }
 
+void CurrentMover_c::FillUncertaintyValues(Seconds elapsedTime, long first, long last)
+{
+	float downLow = _min(fDownCurUncertainty,fUpCurUncertainty), downHigh = _max(fDownCurUncertainty,fUpCurUncertainty);
+	float crossLow = _min(fLeftCurUncertainty,fRightCurUncertainty), crossHigh = _max(fLeftCurUncertainty,fRightCurUncertainty);
+	
+	fUncertainty.FillTerms(first, last, [&](long setIndex, long leIndex, float *downStream, float *crossStream) {
+		// each uncertainty record draws from its own stream for this time
+		CounterRandom rng(fRandomSeed,GetRandomStream(kCurrentUncertaintyDraws),setIndex,leIndex,elapsedTime);
+		*downStream = rng.Uniform(downLow,downHigh);
+		*crossStream = rng.Uniform(crossLow,crossHigh);
+	});
+}
+
 void CurrentMover_c::UpdateUncertaintyValues(Seconds elapsedTime)
 {
-	long i,n;
-	
 	fTimeUncertaintyWasSet = elapsedTime;
 	
-	if(!fUncertaintyListH) return;
-	
-	n = _GetHandleSize((Handle)fUncertaintyListH)/sizeof(**fUncertaintyListH);
+	if(!fUncertainty.IsAllocated()) return;
 	
-	
-	for(i=0;i<n;i++)
-	{
-		LEUncertainRec localCopy;
-		memset(&localCopy,0,sizeof(LEUncertainRec));
-		
-		if(fDownCurUncertainty<fUpCurUncertainty)
-		{
-			localCopy.downStream = 
-			GetRandomFloat(fDownCurUncertainty,fUpCurUncertainty);
-		}
-		else
-		{
-			localCopy.downStream = 
-			GetRandomFloat(fUpCurUncertainty,fDownCurUncertainty);
-		}
-		if(fLeftCurUncertainty<fRightCurUncertainty)
-		{
-			localCopy.crossStream = 
-			GetRandomFloat(fLeftCurUncertainty,fRightCurUncertainty);
-		}
-		else
-		{
-			localCopy.crossStream = 
-			GetRandomFloat(fRightCurUncertainty,fLeftCurUncertainty);
-		}
-		INDEXH(fUncertaintyListH,i) = localCopy;
-		
-	}	
+	this->FillUncertaintyValues(elapsedTime, 0, fUncertainty.GetNumLEs());
 }
 
 OSErr CurrentMover_c::ReallocateUncertainty(int numLEs, short* statusCodes)	// remove off map LEs
 {
-	long i,numrec=0,uncertListSize,numLESetsStored;
 	OSErr err=0;
 	
 	if (numLEs == 0 || ! statusCodes) return -1;	// shouldn't happen
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0;	// assume uncertainty is not on
+	if(!fUncertainty.IsAllocated()) return 0;	// assume uncertainty is not on
 
-	// check that (*fLESetSizesH)[0]==numLEs and size of fLESetSizesH == 1
-	uncertListSize = _GetHandleSize((Handle)fUncertaintyListH)/sizeof(LEUncertainRec);
-	numLESetsStored = _GetHandleSize((Handle)fLESetSizesH)/sizeof(long);
-	
-	if (uncertListSize != numLEs) return -1;
-	if (numLESetsStored != 1) return -1;
+	if (fUncertainty.GetNumLEs() != numLEs) return -1;
+	if (fUncertainty.GetNumLESets() != 1) return -1;
 	
-	for (i = 0; i < numLEs ; i++) {
-		if( statusCodes[i] == OILSTAT_TO_BE_REMOVED)	// for OFF_MAPS, EVAPORATED, etc
-		{
-			continue;
-		}
-		else {
-			(*fUncertaintyListH)[numrec] = (*fUncertaintyListH)[i];
-			numrec++;
-		}
-	}
+	err = fUncertainty.RemoveLEs(numLEs, statusCodes);	// for OFF_MAPS, EVAPORATED, etc
+	if (err) return err;
 	
-	if (numrec == 0)
-	{	
+	if (fUncertainty.GetNumLEs() == 0)
 		this->DisposeUncertainty();
-		return noErr;
-	}
-	
-	if (numrec < uncertListSize)
-	{
-		//(*fLESetSizesH)[0] = numrec;
-		//(*fLESetSizesH)[0] = 0;	// index into array, should never change
-		_SetHandleSize((Handle)fUncertaintyListH,numrec*sizeof(LEUncertainRec)); 
-	}
 	
 	return noErr;
 }
 
 OSErr CurrentMover_c::AllocateUncertainty(int numLESets, int* LESetsSizesList)	// only passing in uncertainty list information
 {
-	long i,j,numrec=0;
 	OSErr err=0;
 	
 	this->DisposeUncertainty(); // get rid of any old values
 	
 	if (numLESets == 0) return -1;	// shouldn't happen - if we get here there should be an uncertainty set
 	
-	if(!(fLESetSizesH = (LONGH)_NewHandle(sizeof(long)*numLESets)))goto errHandler;
-	
-	for (i = 0,numrec=0; i < numLESets ; i++) {
-		(*fLESetSizesH)[i]=numrec;
-		numrec += LESetsSizesList[i];
+	if ((err = fUncertainty.Allocate(numLESets, LESetsSizesList)) != noErr)
+	{
+		this->DisposeUncertainty(); // get rid of any values allocated
+		TechError("TCurrentMover::AllocateUncertainty()", "Allocate()", 0);
 	}
-	if(!(fUncertaintyListH = 
-		 (LEUncertainRecH)_NewHandle(sizeof(LEUncertainRec)*numrec)))goto errHandler;
-	
-	return noErr;
-errHandler:
-	this->DisposeUncertainty(); // get rid of any values allocated
-	TechError("TCurrentMover::AllocateUncertainty()", "_NewHandle()", 0);
-	return memFullErr;
+	return err;
 }
 
 OSErr CurrentMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESets, int* LESetsSizesList)
@@ -192,12 +136,12 @@ OSErr CurrentMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESet
 	
 	if(!bAddUncertainty)
 	{	// we will not be adding uncertainty
-		// make sure fWindUncertaintyList  && fLESetSizesH are unallocated
-		if(fUncertaintyListH) this->DisposeUncertainty();
+		// make sure fUncertainty is unallocated
+		if(fUncertainty.IsAllocated()) this->DisposeUncertainty();
 		return 0;
 	}
 	
-	if(!fUncertaintyListH || !fLESetSizesH)
+	if(!fUncertainty.IsAllocated())
 		needToReInit = true;
 	
 	if(elapsedTime < fTimeUncertaintyWasSet) 
@@ -205,23 +149,22 @@ OSErr CurrentMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESet
 		needToReInit = true;
 	}
 	
-	if(fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{	// check the LE sets are still the same, JLM 9/18/98
-		//TLEList *list;
-		long numrec, uncertListSize = 0, numLESetsStored;;
-		numLESetsStored = _GetHandleSize((Handle)fLESetSizesH)/sizeof(long);
+		long numrec, uncertListSize = 0, numLESetsStored;
+		numLESetsStored = fUncertainty.GetNumLESets();
 		if(numLESets != numLESetsStored) needToReInit = true;
 		else
 		{
 			for (i = 0,numrec=0; i < numLESets ; i++) {
-				if(numrec != (*fLESetSizesH)[i])
+				if(numrec != fUncertainty.GetSetStart(i))
 				{
 					needToReInit = true;
 					break;
 				}
 				numrec += LESetsSizesList[i];
 			}
-			uncertListSize = _GetHandleSize((Handle)fUncertaintyListH)/sizeof(LEUncertainRec); 
+			uncertListSize = fUncertainty.GetNumLEs(); 
 			if (numrec != uncertListSize)// this should not happen for gui gnome
 			{
 #ifdef pyGNOME
@@ -232,48 +175,20 @@ OSErr CurrentMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESet
 #else
 				needToReInit = true;
 #endif
-				//break;
 			}// need to check
 		}
 		
 		if (needToReAllocate)
-		{	// move to separate function, and probably should combine with 
-			//char errmsg[256] = "";
-			_SetHandleSize((Handle)fUncertaintyListH, numrec*sizeof(LEUncertainRec));
-			//sprintf(errmsg,"Num LEs to Allocate = %ld, previous Size = %ld\n",numrec,uncertListSize);
-			//printNote(errmsg);
-			//for pyGNOME there should only be one uncertainty spill so fLESetSizes has only 1 value which is zero and doesn't need to be updated.
+		{	// the LEs released since are added on the end, the others keep their values
+			//for pyGNOME there should only be one uncertainty spill so there is only 1 set, which starts at zero and doesn't need to be updated.
 			if (numLESets != 1 || numLESetsStored != 1) {printError("num uncertainty spills not equal 1\n"); return -1;}
 			if (needToReInit) printNote("Uncertainty arrays are being reset\n");	// this shouldn't happen
-			//if(elapsedTime >= fTimeUncertaintyWasSet + fDuration) // we exceeded the persistance, time to update - either update whole list or just add on
-			for(i=uncertListSize;i<numrec;i++)
+			if ((err = fUncertainty.Grow(numrec)) != noErr)
 			{
-				LEUncertainRec localCopy;
-				memset(&localCopy,0,sizeof(LEUncertainRec));
-				
-				if(fDownCurUncertainty<fUpCurUncertainty)
-				{
-					localCopy.downStream = 
-					GetRandomFloat(fDownCurUncertainty,fUpCurUncertainty);
-				}
-				else
-				{
-					localCopy.downStream = 
-					GetRandomFloat(fUpCurUncertainty,fDownCurUncertainty);
-				}
-				if(fLeftCurUncertainty<fRightCurUncertainty)
-				{
-					localCopy.crossStream = 
-					GetRandomFloat(fLeftCurUncertainty,fRightCurUncertainty);
-				}
-				else
-				{
-					localCopy.crossStream = 
-					GetRandomFloat(fRightCurUncertainty,fLeftCurUncertainty);
-				}
-				INDEXH(fUncertaintyListH,i) = localCopy;
-				
-			}	
+				TechError("TCurrentMover::UpdateUncertainty()", "Grow()", 0);
+				return err;
+			}
+			this->FillUncertaintyValues(elapsedTime, uncertListSize, numrec);
 		}
 	}
 	
@@ -317,15 +232,5 @@ void CurrentMover_c::DisposeUncertainty()
 {
 	fTimeUncertaintyWasSet = 0;
 	
-	if (fUncertaintyListH)
-	{
-		DisposeHandle ((Handle) fUncertaintyListH);
-		fUncertaintyListH = nil;
-	}
-	
-	if (fLESetSizesH)
-	{
-		DisposeHandle ((Handle) fLESetSizesH);
-		fLESetSizesH = 0;
-	}
+	fUncertainty.Dispose();
 }
\ No newline at end of file
@@ -14,13 +14,13 @@
 #include "TypeDefs.h"
 #include "Mover_c.h"
 #include "GEOMETRY.H"
+#include "UncertaintyArrays.h"
 #include "ExportSymbols.h"
 
 class DLL_API CurrentMover_c : virtual public Mover_c {
 	
 public:
-	LONGH			fLESetSizesH;			// cumulative total num le's in each set
-	LEUncertainRecH	fUncertaintyListH;		// list of uncertain factors list elements of type LEUncertainRec
+	UncertaintyArrays	fUncertainty;		// downStream and crossStream factors of each LE, by LE set
 	Boolean bIsFirstStep;
 	Seconds fModelStartTime;
 	
@@ -40,10 +40,12 @@ public:
 	virtual			   ~CurrentMover_c () { Dispose (); }
 	virtual void		Dispose ();
 	virtual void 		UpdateUncertaintyValues(Seconds elapsedTime);
+	void				FillUncertaintyValues(Seconds elapsedTime, long first, long last);
 	virtual OSErr		UpdateUncertainty(const Seconds& elapsedTime, int numLESets, int* LESetsSizesList);
 	virtual OSErr		AllocateUncertainty (int numLESets, int* LESetsSizesList);
 	virtual OSErr		ReallocateUncertainty(int numLEs, short* statusCodes);	
 	virtual void		DisposeUncertainty ();
+	virtual const UncertaintyArrays *GetUncertainty() const { return fUncertainty.IsAllocated() ? &fUncertainty : 0; }
 	
 	virtual OSErr 		PrepareForModelRun(); 
 	virtual OSErr 		PrepareForModelStep(const Seconds&, const Seconds&, bool, int numLESets, int* LESetsSizesList); 
@@ -2,6 +2,7 @@
 #include "DagTreeIO.h"
 #include "DagTree.h"
 #include "MemUtils.h"
+#include "TriPointIndex.h"
 
 using namespace std;
 
@@ -41,12 +42,30 @@ TDagTree::TDagTree(LongPoint **ptsHdl, Topology **topHdl, DAG** tree,VelocityFH
 	fTreeH = tree; 
 
 	fVelH = velocityH;
+	fPointIndex = 0;
 
 	fNumBranches = nBranches;
 }
 
+// build the index before the grid is used from more than one thread
+void TDagTree::SetUsePointIndex(Boolean usePointIndex)
+{
+	if (usePointIndex && !fPointIndex)
+		fPointIndex = new TriPointIndex(fPtsH, fTopH);
+	else if (!usePointIndex && fPointIndex)
+	{
+		delete fPointIndex;
+		fPointIndex = 0;
+	}
+}
+
 void TDagTree::Dispose ()
 {
+	if (fPointIndex)
+	{
+		delete fPointIndex;
+		fPointIndex = 0;
+	}
 	if (fPtsH)
 	{
 		DisposeHandle((Handle)fPtsH);
@@ -71,6 +90,17 @@ void TDagTree::Dispose ()
 
 /////////////////////////////////////////////////////////////////
 
+long* LastTriangleCache::GetLastTris(long spillID, Boolean uncertain, long numLEs)
+{
+	std::vector<long> &lastTris = fLastTris[2 * spillID + (uncertain ? 1 : 0)];
+
+	// released LEs are added at the end, a stale entry only costs a full search
+	if ((long)lastTris.size() != numLEs)
+		lastTris.resize(numLEs, -1);
+
+	return numLEs > 0 ? &lastTris[0] : 0;
+}
+
 //////////////////////////////////////////////////////////////////////
 
 // Find the third point of the triangle to the right of the segment
@@ -92,6 +122,55 @@ long TDagTree::FindThirdPoint(long p1, long p2, long index)
 // RETURNS a negative number if there is an error
 //////////////////////////////////////////////////////////////////////
 long TDagTree::WhatTriAmIIn(LongPoint pt)
+{
+	if (fPointIndex)
+		return fPointIndex->WhatTriAmIIn(pt);
+	return WhatTriIsPtIn(fTreeH,fTopH,fPtsH,pt);
+}
+
+// LEs move a short way each step, so the triangle they were last in or one
+// of its neighbors almost always has them. Walk across the edges the point is
+// to the right of, and fall back to the full search if the walk leaves the grid.
+long TDagTree::WhatTriAmIIn(LongPoint pt, long *lastTri)
+{
+	long triNum = -1;
+
+	if (lastTri && *lastTri >= 0)
+		triNum = WalkToTri(pt, *lastTri);
+
+	if (triNum < 0)
+		triNum = WhatTriAmIIn(pt);
+
+	if (lastTri && triNum >= 0)
+		*lastTri = triNum;
+
+	return triNum;
+}
+
+long TDagTree::WalkToTri(LongPoint pt, long startTri)
+{
+	const long kMaxSteps = 16;
+	long numTri = _GetHandleSize((Handle)fTopH)/sizeof(**fTopH);
+	long triNum = startTri;
+	TopologyPtr tri;
+
+	for (long step = 0; step < kMaxSteps && triNum >= 0 && triNum < numTri; step++)
+	{
+		tri = &(*fTopH)[triNum];
+		// adjTriN is across the edge opposite vertexN
+		if (Right_or_Left_Point(tri->vertex2, tri->vertex3, pt) > 0)
+			triNum = tri->adjTri1;
+		else if (Right_or_Left_Point(tri->vertex3, tri->vertex1, pt) > 0)
+			triNum = tri->adjTri2;
+		else if (Right_or_Left_Point(tri->vertex1, tri->vertex2, pt) > 0)
+			triNum = tri->adjTri3;
+		else
+			return triNum;
+	}
+	return -1;
+}
+
+long TDagTree::WhatTriAmIInDag(LongPoint pt)
 {
 	return WhatTriIsPtIn(fTreeH,fTopH,fPtsH,pt);
 }
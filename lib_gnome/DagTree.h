@@ -2,10 +2,14 @@
 #ifndef __DAGTREE__
 #define __DAGTREE__
 
+#include <map>
+#include <vector>
+
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "RectUtils.h"
 #include "GEOMETRY.H"
+#include "ExportSymbols.h"
 
 typedef struct	Topology
 {
@@ -32,7 +36,13 @@ typedef struct DAGTreeStruct
 //	Side_List ** sideHdl;				// handle to the sidelist
 } DAGTreeStruct;
 
-DAGTreeStruct  MakeDagTree(TopologyHdl topoHdl, LongPoint **pointList, char *errStr);
+// bumped whenever MakeDagTree builds a different tree from the same triangles,
+// so trees cached by an earlier build aren't used
+#define kDagTreeBuilderVersion 2
+
+DLL_API DAGTreeStruct  MakeDagTree(TopologyHdl topoHdl, LongPoint **pointList, char *errStr);
+
+class TriPointIndex;
 
 class TDagTree
 {
@@ -42,10 +52,12 @@ class TDagTree
 		LongPointHdl 		fPtsH;
 		TopologyHdl			fTopH;
 		VelocityFH			fVelH;
+		TriPointIndex		*fPointIndex;	// bucket grid used in place of the DAG walk when set
 		//long**				longH;
 
 		int Right_or_Left_Point(long ref_p1, long ref_p2, LongPoint test_p1);
 		long FindThirdPoint(long p1, long p2, long index);
+		long WalkToTri(LongPoint pt, long startTri);
 
 	public:
 						TDagTree(LongPointHdl points, TopologyHdl topo,DAG **tree, VelocityFH velocityH,long numbranches);
@@ -53,6 +65,10 @@ class TDagTree
 		virtual void 	Dispose();
 
 		long			WhatTriAmIIn(LongPoint pt);
+		long			WhatTriAmIIn(LongPoint pt, long *lastTri);	// walks from *lastTri and updates it
+		long			WhatTriAmIInDag(LongPoint pt);
+		void			SetUsePointIndex(Boolean usePointIndex);
+		Boolean			GetUsePointIndex(){return fPointIndex != 0;};
 		LongPointHdl	GetPointsHdl(){return fPtsH;};
 		TopologyHdl		GetTopologyHdl(){return fTopH;};
 		VelocityFH		GetVelocityHdl(){return fVelH;};
@@ -61,4 +77,15 @@ class TDagTree
 		void			GetVelocity(LongPoint lp,VelocityRec *r);
 };
 
+// the last triangle each LE was found in, one array per spill, for TDagTree::WhatTriAmIIn(pt, lastTri)
+class LastTriangleCache
+{
+	public:
+		long*			GetLastTris(long spillID, Boolean uncertain, long numLEs);	// LEs not seen before start at -1
+		void			Clear(){fLastTris.clear();};
+
+	private:
+		std::map<long, std::vector<long> > fLastTris;
+};
+
 #endif 
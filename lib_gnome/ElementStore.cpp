@@ -0,0 +1,494 @@
+/*
+ *  ElementStore.cpp
+ *  gnome
+ *
+ */
+
+#include <string.h>
+
+#include "ElementStore.h"
+
+using namespace std;
+
+static const long long kBlockAlignment = 4096;	// a page, what a mapping's offset must be a multiple of
+static const long long kArrayAlignment = 64;
+
+// the header: the magic, the format's version, and the offset and size of the
+// last step's record, 0 before there is one. The numbers are all 8 bytes, in
+// the byte order of the machine that wrote them.
+static const char kStoreMagic[8] = {'G', 'N', 'O', 'M', 'E', 'E', 'L', 'S'};
+static const long long kStoreVersion = 2;
+static const long long kHeaderBytes = sizeof(kStoreMagic) + 3 * 8;
+
+static int SeekTo(FILE *file, long long offset)
+{
+#ifdef _WIN32
+	return _fseeki64(file, offset, SEEK_SET);
+#else
+	return fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+}
+
+static void PutNumber(string &buffer, long long value)
+{
+	buffer.append((const char *)&value, sizeof(value));
+}
+
+static void PutDouble(string &buffer, double value)
+{
+	buffer.append((const char *)&value, sizeof(value));
+}
+
+static void PutString(string &buffer, const string &value)
+{
+	PutNumber(buffer, value.size());
+	buffer.append(value);
+}
+
+// reads back what PutNumber and PutString wrote, false past the end
+class IndexReader {
+public:
+	IndexReader(const string &buffer) : fBuffer(buffer), fPos(0) {}
+
+	bool GetNumber(long long *value)
+	{
+		if (fBuffer.size() - fPos < sizeof(*value))
+			return false;
+		memcpy(value, fBuffer.data() + fPos, sizeof(*value));
+		fPos += sizeof(*value);
+		return true;
+	}
+
+	bool GetDouble(double *value)
+	{
+		if (fBuffer.size() - fPos < sizeof(*value))
+			return false;
+		memcpy(value, fBuffer.data() + fPos, sizeof(*value));
+		fPos += sizeof(*value);
+		return true;
+	}
+
+	bool GetString(string *value)
+	{
+		long long size;
+
+		if (!GetNumber(&size) || size < 0 || (long long)(fBuffer.size() - fPos) < size)
+			return false;
+		value->assign(fBuffer, fPos, size);
+		fPos += size;
+		return true;
+	}
+
+	bool AtEnd() const {return fPos == fBuffer.size();}
+
+private:
+	const string	&fBuffer;
+	size_t			fPos;
+};
+
+ElementStore::ElementStore()
+{
+	fFile = 0;
+	fReadOnly = false;
+	fFileSize = 0;
+	fLastRecordOffset = fLastRecordBytes = 0;
+	fInStep = false;
+	fStepNum = -1;
+	fStepUncertain = false;
+}
+
+OSErr ElementStore::Create(const char *path)
+{
+	Close();
+
+	fFile = fopen(path, "wb+");
+	if (!fFile)
+		return -1;
+
+	fReadOnly = false;
+	fFileSize = kHeaderBytes;
+	fLastRecordOffset = fLastRecordBytes = 0;
+	if (WriteHeader() != noErr)
+	{
+		Close();
+		return -1;
+	}
+
+	fPath = path;
+	return noErr;
+}
+
+OSErr ElementStore::Open(const char *path, Boolean readOnly)
+{
+	OSErr err = noErr;
+
+	Close();
+
+	fFile = fopen(path, readOnly ? "rb" : "rb+");
+	if (!fFile)
+		return -1;
+
+	fReadOnly = readOnly;
+	if ((err = ReadIndex()) != noErr)
+	{
+		Close();
+		return err;
+	}
+
+	fPath = path;
+	return noErr;
+}
+
+void ElementStore::Close()
+{
+	if (fFile)
+	{
+		fclose(fFile);
+		fFile = 0;
+	}
+	fPath.clear();
+	fReadOnly = false;
+	fFileSize = 0;
+	fLastRecordOffset = fLastRecordBytes = 0;
+	fSteps[0].clear();
+	fSteps[1].clear();
+	fInStep = false;
+	fStep.arrays.clear();
+}
+
+// the file's size is no longer known, so nothing more can be appended
+OSErr ElementStore::WriteFailed()
+{
+	fclose(fFile);
+	fFile = 0;
+	fInStep = false;
+	fStep.arrays.clear();
+	return -1;
+}
+
+OSErr ElementStore::Pad(long long alignment)
+{
+	static const char zeros[kBlockAlignment] = {0};
+	long long numBytes = (alignment - fFileSize % alignment) % alignment;
+
+	if (numBytes > 0 && fwrite(zeros, 1, numBytes, fFile) != (size_t)numBytes)
+		return WriteFailed();
+
+	fFileSize += numBytes;
+	return noErr;
+}
+
+OSErr ElementStore::BeginStep(long stepNum, Boolean uncertain, Boolean hasTimeStamp, double timeStamp)
+{
+	OSErr err = noErr;
+
+	if (!fFile || fReadOnly || fInStep || stepNum < 0)
+		return -1;
+
+	// the block goes after the last step's record, over anything a failed step left
+	if (SeekTo(fFile, fFileSize) != 0)
+		return WriteFailed();
+
+	if ((err = Pad(kBlockAlignment)) != noErr)
+		return err;
+
+	fInStep = true;
+	fStepNum = stepNum;
+	fStepUncertain = uncertain;
+
+	fStep.stored = true;
+	fStep.hasTimeStamp = hasTimeStamp;
+	fStep.timeStamp = timeStamp;
+	fStep.offset = fFileSize;
+	fStep.numBytes = 0;
+	fStep.arrays.clear();
+	return noErr;
+}
+
+OSErr ElementStore::AddArray(const char *name, const char *typeCode, long numDims, const long *shape,
+							 const char *data, long long numBytes)
+{
+	StoredArray array;
+	OSErr err = noErr;
+
+	if (!fInStep || numBytes < 0 || (numBytes > 0 && !data))
+		return -1;
+
+	if ((err = Pad(kArrayAlignment)) != noErr)
+		return err;
+
+	if (numBytes > 0 && fwrite(data, 1, numBytes, fFile) != (size_t)numBytes)
+		return WriteFailed();
+
+	try
+	{
+		array.name = name;
+		array.typeCode = typeCode;
+		array.shape.assign(shape, shape + numDims);
+		array.offset = fFileSize;
+		array.numBytes = numBytes;
+		fStep.arrays.push_back(array);
+	}
+	catch (...)
+	{
+		fInStep = false;	// the step is dropped, its block is left unindexed
+		fFileSize += numBytes;
+		return memFullErr;
+	}
+
+	fFileSize += numBytes;
+	return noErr;
+}
+
+OSErr ElementStore::EndStep()
+{
+	vector<StoredStep> &steps = fSteps[fStepUncertain ? 1 : 0];
+	long long recordOffset, recordBytes;
+	OSErr err = noErr;
+
+	if (!fInStep)
+		return -1;
+
+	fInStep = false;
+	fStep.numBytes = fFileSize - fStep.offset;
+
+	try
+	{
+		if ((long)steps.size() <= fStepNum)
+		{
+			StoredStep notStored;
+			notStored.stored = false;
+			steps.resize(fStepNum + 1, notStored);
+		}
+		steps[fStepNum] = fStep;
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	recordOffset = fFileSize;
+	if ((err = WriteStepRecord(fStepNum, fStepUncertain, fStep, &recordBytes)) != noErr)
+		return err;
+
+	fStep.arrays.clear();
+	fLastRecordOffset = recordOffset;
+	fLastRecordBytes = recordBytes;
+	return WriteHeader();
+}
+
+// the step's record goes right after its block, with where the record before
+// it is, so the records chain back from the last one to the first
+OSErr ElementStore::WriteStepRecord(long stepNum, Boolean uncertain, const StoredStep &step, long long *recordBytes)
+{
+	string record;
+
+	try
+	{
+		PutNumber(record, fLastRecordOffset);
+		PutNumber(record, fLastRecordBytes);
+		PutNumber(record, uncertain ? 1 : 0);
+		PutNumber(record, stepNum);
+		PutNumber(record, step.hasTimeStamp ? 1 : 0);
+		PutDouble(record, step.timeStamp);
+		PutNumber(record, step.offset);
+		PutNumber(record, step.numBytes);
+		PutNumber(record, step.arrays.size());
+
+		for (vector<StoredArray>::const_iterator array = step.arrays.begin(); array != step.arrays.end(); array++)
+		{
+			PutString(record, array->name);
+			PutString(record, array->typeCode);
+			PutNumber(record, array->shape.size());
+			for (size_t d = 0; d < array->shape.size(); d++)
+				PutNumber(record, array->shape[d]);
+			PutNumber(record, array->offset);
+			PutNumber(record, array->numBytes);
+		}
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	// the header only points at the record once the block and the record are in the file
+	if (fwrite(record.data(), 1, record.size(), fFile) != record.size() || fflush(fFile) != 0)
+		return WriteFailed();
+
+	fFileSize += record.size();
+	*recordBytes = record.size();
+	return noErr;
+}
+
+OSErr ElementStore::WriteHeader()
+{
+	string header;
+
+	try
+	{
+		header.append(kStoreMagic, sizeof(kStoreMagic));
+		PutNumber(header, kStoreVersion);
+		PutNumber(header, fLastRecordOffset);
+		PutNumber(header, fLastRecordBytes);
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	if (SeekTo(fFile, 0) != 0 ||
+		fwrite(header.data(), 1, header.size(), fFile) != header.size() ||
+		fflush(fFile) != 0)
+		return WriteFailed();
+
+	return noErr;
+}
+
+// follows the records back from the one the header points at, a step written
+// again keeps the last record of it
+OSErr ElementStore::ReadIndex()
+{
+	string header, record;
+	long long version, recordOffset, recordBytes;
+
+	try
+	{
+		header.resize(kHeaderBytes);
+		if (SeekTo(fFile, 0) != 0 || fread(&header[0], 1, kHeaderBytes, fFile) != (size_t)kHeaderBytes)
+			return -1;
+
+		if (memcmp(header.data(), kStoreMagic, sizeof(kStoreMagic)) != 0)
+			return -1;
+
+		header.erase(0, sizeof(kStoreMagic));
+		IndexReader headerReader(header);
+		if (!headerReader.GetNumber(&version) || version != kStoreVersion ||
+			!headerReader.GetNumber(&recordOffset) || !headerReader.GetNumber(&recordBytes) ||
+			recordBytes < 0 || (recordBytes > 0 && recordOffset < kHeaderBytes))
+			return -1;
+
+		fLastRecordOffset = recordOffset;
+		fLastRecordBytes = recordBytes;
+		fFileSize = recordBytes > 0 ? recordOffset + recordBytes : kHeaderBytes;
+
+		while (recordBytes > 0)
+		{
+			long long prevOffset, prevBytes, uncertain, stepNum, hasTimeStamp, numArrays, numDims, dim;
+			StoredStep step;
+
+			record.resize(recordBytes);
+			if (SeekTo(fFile, recordOffset) != 0 || fread(&record[0], 1, recordBytes, fFile) != (size_t)recordBytes)
+				return -1;
+
+			IndexReader reader(record);
+			if (!reader.GetNumber(&prevOffset) || !reader.GetNumber(&prevBytes) ||
+				prevBytes < 0 || (prevBytes > 0 && (prevOffset < kHeaderBytes || prevOffset + prevBytes > recordOffset)) ||
+				!reader.GetNumber(&uncertain) || uncertain < 0 || uncertain > 1 ||
+				!reader.GetNumber(&stepNum) || stepNum < 0 ||
+				!reader.GetNumber(&hasTimeStamp) || !reader.GetDouble(&step.timeStamp) ||
+				!reader.GetNumber(&step.offset) || !reader.GetNumber(&step.numBytes) ||
+				!reader.GetNumber(&numArrays) || numArrays < 0 ||
+				step.offset < kHeaderBytes || step.numBytes < 0 || step.offset + step.numBytes > recordOffset)
+				return -1;
+
+			step.stored = true;
+			step.hasTimeStamp = hasTimeStamp != 0;
+
+			for (long long i = 0; i < numArrays; i++)
+			{
+				StoredArray array;
+
+				if (!reader.GetString(&array.name) || !reader.GetString(&array.typeCode) ||
+					!reader.GetNumber(&numDims) || numDims < 0)
+					return -1;
+				for (long long d = 0; d < numDims; d++)
+				{
+					if (!reader.GetNumber(&dim))
+						return -1;
+					array.shape.push_back(dim);
+				}
+				if (!reader.GetNumber(&array.offset) || !reader.GetNumber(&array.numBytes) ||
+					array.offset < step.offset || array.numBytes < 0 ||
+					array.offset + array.numBytes > step.offset + step.numBytes)
+					return -1;
+				step.arrays.push_back(array);
+			}
+			if (!reader.AtEnd())
+				return -1;
+
+			vector<StoredStep> &steps = fSteps[uncertain];
+			if ((long long)steps.size() <= stepNum)
+			{
+				StoredStep notStored;
+				notStored.stored = false;
+				steps.resize(stepNum + 1, notStored);
+			}
+			if (!steps[stepNum].stored)
+				steps[stepNum] = step;
+
+			recordOffset = prevOffset;
+			recordBytes = prevBytes;
+		}
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	return noErr;
+}
+
+const ElementStore::StoredStep *ElementStore::FindStep(long stepNum, Boolean uncertain) const
+{
+	const vector<StoredStep> &steps = fSteps[uncertain ? 1 : 0];
+
+	if (stepNum < 0 || stepNum >= (long)steps.size() || !steps[stepNum].stored)
+		return 0;
+
+	return &steps[stepNum];
+}
+
+Boolean ElementStore::HasStep(long stepNum, Boolean uncertain) const
+{
+	return FindStep(stepNum, uncertain) != 0;
+}
+
+OSErr ElementStore::GetStepBlock(long stepNum, Boolean uncertain, long long *offset, long long *numBytes) const
+{
+	const StoredStep *step = FindStep(stepNum, uncertain);
+
+	if (!step)
+		return -1;
+
+	*offset = step->offset;
+	*numBytes = step->numBytes;
+	return noErr;
+}
+
+Boolean ElementStore::GetTimeStamp(long stepNum, Boolean uncertain, double *timeStamp) const
+{
+	const StoredStep *step = FindStep(stepNum, uncertain);
+
+	if (!step || !step->hasTimeStamp)
+		return false;
+
+	*timeStamp = step->timeStamp;
+	return true;
+}
+
+long ElementStore::GetNumArrays(long stepNum, Boolean uncertain) const
+{
+	const StoredStep *step = FindStep(stepNum, uncertain);
+
+	return step ? step->arrays.size() : 0;
+}
+
+const StoredArray *ElementStore::GetArray(long stepNum, Boolean uncertain, long index) const
+{
+	const StoredStep *step = FindStep(stepNum, uncertain);
+
+	if (!step || index < 0 || index >= (long)step->arrays.size())
+		return 0;
+
+	return &step->arrays[index];
+}
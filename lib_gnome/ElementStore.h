@@ -0,0 +1,110 @@
+/*
+ *  ElementStore.h
+ *  gnome
+ *
+ *  Keeps a run's element data arrays, step after step, in one file that is
+ *  only ever appended to. Each step's arrays are written one after another
+ *  in a block of their own, and the store keeps an index of the blocks by
+ *  step number, so a step is found without reading any other. The blocks
+ *  start on a page boundary and the arrays within them on a 64 byte one,
+ *  so a reader can map a step's block and use the arrays where they are.
+ *
+ *  A step is written between BeginStep and EndStep, and is only in the
+ *  index, and flushed to the file, once EndStep returns. Writing a step
+ *  again replaces it in the index, the earlier block stays in the file.
+ *
+ *  EndStep also appends the step's record to the index: what the step's
+ *  arrays are and where, and where the record before it is. The header at
+ *  the start of the file says which version of the format the file has and
+ *  where the last record is, so Open can take the store up again, in this
+ *  process or another, by following the records back. The header is only
+ *  changed once a record is in the file, so a step that was cut off leaves
+ *  the steps before it readable.
+ *
+ *  The arrays are described by the caller's type code and shape, which the
+ *  store keeps without looking at.
+ *
+ */
+
+#ifndef __ElementStore__
+#define __ElementStore__
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+struct StoredArray {
+	std::string			name;
+	std::string			typeCode;
+	std::vector<long>	shape;
+	long long			offset;		// from the start of the file
+	long long			numBytes;
+};
+
+class DLL_API ElementStore {
+
+public:
+	ElementStore();
+	~ElementStore() {Close();}
+
+	// truncates a file already at path
+	OSErr		Create(const char *path);
+	// a store made by Create, read only or to add more steps to
+	OSErr		Open(const char *path, Boolean readOnly);
+	// clears the index along with closing the file; a failed write only
+	// closes the file, and the steps already written can still be read
+	void		Close();
+	Boolean		IsOpen() const {return fFile != 0;}
+	const char	*GetPath() const {return fPath.c_str();}
+
+	OSErr		BeginStep(long stepNum, Boolean uncertain, Boolean hasTimeStamp, double timeStamp);
+	OSErr		AddArray(const char *name, const char *typeCode, long numDims, const long *shape,
+						 const char *data, long long numBytes);
+	OSErr		EndStep();
+
+	Boolean		HasStep(long stepNum, Boolean uncertain) const;
+	// the step's block, for mapping it whole
+	OSErr		GetStepBlock(long stepNum, Boolean uncertain, long long *offset, long long *numBytes) const;
+	// false if the step was saved without one
+	Boolean		GetTimeStamp(long stepNum, Boolean uncertain, double *timeStamp) const;
+	long		GetNumArrays(long stepNum, Boolean uncertain) const;
+	const StoredArray *GetArray(long stepNum, Boolean uncertain, long index) const;
+
+	long long	GetFileSize() const {return fFileSize;}
+
+private:
+	struct StoredStep {
+		Boolean						stored;
+		Boolean						hasTimeStamp;
+		double						timeStamp;
+		long long					offset, numBytes;
+		std::vector<StoredArray>	arrays;
+	};
+
+	std::string					fPath;
+	FILE						*fFile;
+	Boolean						fReadOnly;
+	long long					fFileSize;	// the end of the last step's record, where the next block goes
+	long long					fLastRecordOffset, fLastRecordBytes;
+	std::vector<StoredStep>		fSteps[2];	// by step number, forecast then uncertain
+
+	// the step being written
+	Boolean						fInStep;
+	long						fStepNum;
+	Boolean						fStepUncertain;
+	StoredStep					fStep;
+
+	OSErr		Pad(long long alignment);
+	OSErr		WriteFailed();
+	OSErr		WriteStepRecord(long stepNum, Boolean uncertain, const StoredStep &step, long long *recordBytes);
+	OSErr		WriteHeader();
+	OSErr		ReadIndex();
+	const StoredStep *FindStep(long stepNum, Boolean uncertain) const;
+};
+
+#endif
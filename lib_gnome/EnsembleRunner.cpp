@@ -0,0 +1,163 @@
+/*
+ *  EnsembleRunner.cpp
+ *  gnome
+ *
+ */
+
+#include "EnsembleRunner.h"
+#include "CounterRandom.h"
+#include "ForEachLE.h"
+
+LEBlock EnsembleRunner::Member::GetLEs() const
+{
+	LEBlock les(numLEs, ref, status);
+
+	if (windages) les.SetWindages(windages);
+	if (riseVelocities) les.SetRiseVelocities(riseVelocities);
+	return les;
+}
+
+void EnsembleRunner::Dispose()
+{
+	for (size_t m = 0; m < fMembers.size(); m++)
+	{
+		for (size_t i = 0; i < fMembers[m]->movers.size(); i++)
+			delete fMembers[m]->movers[i];
+		delete fMembers[m];
+	}
+	fMembers.clear();
+}
+
+// one Philox block keyed on the member's seed hashes the mover index, so
+// the seeds of a member's movers look unrelated to each other and to the
+// seeds of the other members
+unsigned long EnsembleRunner::GetMoverSeed(unsigned long randomSeed, long moverIndex)
+{
+	uint32_t counter[4] = {(uint32_t)moverIndex, 0, 0, 0};
+	uint32_t key[2] = {(uint32_t)randomSeed, 0x454E534D};	// "ENSM"
+	uint32_t result[4];
+
+	Philox4x32(counter, key, result);
+	return result[0];
+}
+
+long EnsembleRunner::AddMember(unsigned long randomSeed)
+{
+	Member *member = 0;
+
+	try
+	{
+		member = new Member();
+		fMembers.push_back(member);
+	}
+	catch (...)
+	{
+		delete member;
+		return -1;
+	}
+	member->numLEs = 0;
+	member->ref = member->nextPositions = 0;
+	member->status = 0;
+	member->windages = member->riseVelocities = 0;
+	// the members are what run in parallel
+	member->chain.SetBlocksInParallel(false);
+
+	for (size_t i = 0; i < fMovers.size(); i++)
+	{
+		Mover_c *mover = fMovers[i]->NewEnsembleMember(GetMoverSeed(randomSeed, i));
+		if (!mover)
+		{
+			for (size_t j = 0; j < member->movers.size(); j++)
+				delete member->movers[j];
+			delete member;
+			fMembers.pop_back();
+			return -1;
+		}
+		mover->SetNumThreads(1);
+		member->movers.push_back(mover);
+		member->chain.AddMover(mover);
+	}
+	return fMembers.size() - 1;
+}
+
+OSErr EnsembleRunner::SetMemberLEs(long member, long numLEs, WorldPoint3D *ref, WorldPoint3D *nextPositions,
+								   short *LE_status, double *windages, double *riseVelocities)
+{
+	if (member < 0 || member >= (long)fMembers.size())
+		return -1;
+	if (numLEs > 0 && (!ref || !nextPositions || !LE_status))
+		return 1;
+
+	Member *m = fMembers[member];
+	m->numLEs = numLEs;
+	m->ref = ref;
+	m->nextPositions = nextPositions;
+	m->status = LE_status;
+	m->windages = windages;
+	m->riseVelocities = riseVelocities;
+	return noErr;
+}
+
+OSErr EnsembleRunner::PrepareForModelRun()
+{
+	OSErr err = noErr;
+
+	for (size_t m = 0; m < fMembers.size(); m++)
+		for (size_t i = 0; i < fMembers[m]->movers.size() && !err; i++)
+			err = fMembers[m]->movers[i]->PrepareForModelRun();
+
+	return err;
+}
+
+OSErr EnsembleRunner::Step(Seconds model_time, Seconds step_len, LEType spillType)
+{
+	long numMembers = fMembers.size(), m, largest = -1;
+	bool uncertain = spillType == UNCERTAINTY_LE;
+	std::vector<OSErr> errs(numMembers, noErr);
+	OSErr err = noErr;
+
+	if (spillType < FORECAST_LE || spillType > UNCERTAINTY_LE)
+		return 2;
+
+	// one member at a time, as the first one through loads the interval
+	for (m = 0; m < numMembers && !err; m++)
+	{
+		int numLEs = fMembers[m]->numLEs;
+		err = fMembers[m]->chain.PrepareForModelStep(model_time, step_len, uncertain, 1, &numLEs);
+	}
+
+	// the member with the most LEs moves one of them on its own first, so
+	// anything the shared grids set up on the first move of a step is there,
+	// sized for the most LEs, before the members read them at once; the LE's
+	// move doesn't depend on it being moved twice
+	for (m = 0; m < numMembers; m++)
+	{
+		if (fMembers[m]->numLEs > 0 && (largest < 0 || fMembers[m]->numLEs > fMembers[largest]->numLEs))
+			largest = m;
+	}
+	if (!err && largest >= 0)
+	{
+		Member *member = fMembers[largest];
+		WorldPoint3D nextPosition = member->nextPositions[0];
+		err = member->chain.GetMoves(member->GetLEs().GetSubBlock(0, 1), model_time, step_len, &nextPosition, spillType, 0);
+	}
+
+	if (!err)
+	{
+		ForEachLE(numMembers, [&](long first, long last) {
+			for (long i = first; i < last; i++)
+			{
+				Member *member = fMembers[i];
+				errs[i] = member->chain.GetMoves(member->GetLEs(), model_time, step_len, member->nextPositions, spillType, 0);
+			}
+		}, 1);
+	}
+
+	for (m = 0; m < numMembers; m++)
+	{
+		for (size_t i = 0; i < fMembers[m]->movers.size(); i++)
+			fMembers[m]->movers[i]->ModelStepIsDone();
+		if (!err) err = errs[m];
+	}
+	return err;
+}
@@ -0,0 +1,84 @@
+/*
+ *  EnsembleRunner.h
+ *  gnome
+ *
+ *  Moves the LEs of many members of an ensemble a step at a time. Each
+ *  member gets its own copy of the runner's movers, from
+ *  Mover_c::NewEnsembleMember, with its own random draws and uncertainty:
+ *  each of a member's movers is seeded from the member's seed and the
+ *  mover's place in the runner, rather than all of them getting the
+ *  member's seed.
+ *  The copies share the read only data of the mover they came from: the
+ *  gridded movers' grids, triangle trees and loaded time slices are held
+ *  once, however many members there are. The movers that can't share
+ *  (for now the CATS and component movers, which own their grids and tide
+ *  series) return no member, and AddMember fails with them.
+ *
+ *  The members are prepared for a step one after another, so the first
+ *  loads the shared grids' interval and the rest find it loaded. The
+ *  member with the most LEs then moves one of them on its own, which sets
+ *  up anything else the grids keep for the step (the blended velocities)
+ *  for that many LEs; the members with fewer use it as it is. The members
+ *  are then moved on several threads, a member to a thread.
+ *
+ *  The LE arrays are the caller's, as with MoverChain::get_move, and the
+ *  moves are added to each member's next positions. Beaching is left to
+ *  the caller too.
+ *
+ */
+
+#ifndef __EnsembleRunner__
+#define __EnsembleRunner__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "Mover_c.h"
+#include "MoverChain.h"
+#include "ExportSymbols.h"
+
+class DLL_API EnsembleRunner {
+
+public:
+	EnsembleRunner() {}
+	~EnsembleRunner() {Dispose();}
+	void		Dispose();
+
+	// the movers the members are copied from, which the runner doesn't own;
+	// they are all added before the first member
+	void		AddMover(Mover_c *mover) {fMovers.push_back(mover);}
+	long		GetNumMovers() const {return fMovers.size();}
+
+	// the index of the new member, -1 if one of the movers can't be shared
+	long		AddMember(unsigned long randomSeed);
+	// the seed of the member's copy of mover moverIndex
+	static unsigned long	GetMoverSeed(unsigned long randomSeed, long moverIndex);
+	long		GetNumMembers() const {return fMembers.size();}
+
+	// the arrays must stay put until the step is done; windages and riseVelocities
+	// may be 0 when none of the movers use them
+	OSErr		SetMemberLEs(long member, long numLEs, WorldPoint3D *ref, WorldPoint3D *nextPositions,
+							 short *LE_status, double *windages, double *riseVelocities);
+
+	OSErr		PrepareForModelRun();
+	// adds every member's moves to its next positions
+	OSErr		Step(Seconds model_time, Seconds step_len, LEType spillType);
+
+private:
+	struct Member {
+		std::vector<Mover_c*>	movers;
+		MoverChain				chain;
+		long					numLEs;
+		WorldPoint3D			*ref, *nextPositions;
+		short					*status;
+		double					*windages, *riseVelocities;
+
+		LEBlock					GetLEs() const;
+	};
+
+	std::vector<Mover_c*>	fMovers;
+	std::vector<Member*>	fMembers;
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ *  ForEachLE.h
+ *  gnome
+ *
+ *  Splits a loop over LEs among threads, for work where each LE is
+ *  independent of the others. Other loops of independent items can use
+ *  it too, with a minimum to a thread that suits the cost of an item.
+ *
+ */
+
+#ifndef __ForEachLE__
+#define __ForEachLE__
+
+#include <thread>
+#include <vector>
+
+const long kMinLEsPerThread = 16384;
+
+// runs body(first, last) over the LEs, on several threads when there are enough of them
+template <class Body> void ForEachLE(long numLEs, const Body &body, long minPerThread = kMinLEsPerThread)
+{
+	long numThreads = std::thread::hardware_concurrency();
+	std::vector<std::thread> threads;
+
+	if (numThreads > numLEs / minPerThread) numThreads = numLEs / minPerThread;
+	if (numThreads <= 1)
+	{
+		body(0, numLEs);
+		return;
+	}
+
+	try
+	{
+		for (long i = 1; i < numThreads; i++)
+			threads.push_back(std::thread(body, numLEs * i / numThreads, numLEs * (i + 1) / numThreads));
+	}
+	catch (...)
+	{
+		// no more threads to be had, this one does the chunks left over
+	}
+	body(0, numLEs / numThreads);
+	if ((long)threads.size() + 1 < numThreads)
+		body(numLEs * ((long)threads.size() + 1) / numThreads, numLEs);
+	for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+}
+
+#endif
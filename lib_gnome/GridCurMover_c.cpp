@@ -20,12 +20,12 @@ OSErr GridCurMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *ve
 	//err = this -> UpdateUncertainty();
 	//if(err) return err;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 	
 	
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(velocity->u*velocity->u + velocity->v * velocity->v);
 		
 		
@@ -50,7 +50,7 @@ OSErr GridCurMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *ve
 	}
 	else 
 	{
-		TechError("GridCurMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("GridCurMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		err = -1;
 		velocity->u=velocity->v=0;
 	}
@@ -58,6 +58,8 @@ GridCurrentMover_c::GridCurrentMover_c (TMap *owner, char *name) : CurrentMover_
 	//
 	
 	fIsOptimizedForStep = false;
+	bUseBatchedGetMove = true;
+	bUseLastTriangle = true;
 		
 	SetClassName (name); // short file name
 	
@@ -101,6 +103,8 @@ GridCurrentMover_c::GridCurrentMover_c () : CurrentMover_c()
 	//
 	
 	fIsOptimizedForStep = false;
+	bUseBatchedGetMove = true;
+	bUseLastTriangle = true;
 	
 	//SetClassName (name); // short file name
 	
@@ -113,8 +117,11 @@ void GridCurrentMover_c::Dispose ()
 {
 	if (timeGrid)
 	{
-		timeGrid -> Dispose();
-		delete timeGrid;	// this causes a crash...
+		if (timeGrid->RemoveOwner())
+		{
+			timeGrid -> Dispose();
+			delete timeGrid;	// this causes a crash...
+		}
 		timeGrid = nil;
 	}
 	
@@ -127,11 +134,11 @@ OSErr GridCurrentMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec
 	double u,v,lengthS,alpha,beta,v0;
 	OSErr err = 0;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 		
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(velocity->u*velocity->u + velocity->v * velocity->v);
 		
 		
@@ -155,7 +162,7 @@ OSErr GridCurrentMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec
 	}
 	else 
 	{
-		TechError("GridCurrentMover_c::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("GridCurrentMover_c::AddUncertainty()", "fUncertainty not allocated", 0);
 		err = -1;
 		velocity->u=velocity->v=0;
 	}
@@ -165,6 +172,7 @@ OSErr GridCurrentMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec
 
 OSErr GridCurrentMover_c::PrepareForModelRun()
 {
+	fLastTriangles.Clear();
 	return CurrentMover_c::PrepareForModelRun();
 }
 
@@ -215,6 +223,33 @@ void GridCurrentMover_c::ModelStepIsDone()
 	bIsFirstStep = false;
 }
 
+// the member starts as a copy of this mover and shares its time grid, 
+// the loaded slices and the triangle tree with it from then on
+Mover_c *GridCurrentMover_c::NewEnsembleMember(unsigned long randomSeed)
+{
+	GridCurrentMover_c *member = 0;
+	
+	if (!timeGrid) return 0;
+	
+	try
+	{
+		member = new GridCurrentMover_c(*this);
+	}
+	catch (...)
+	{
+		return 0;
+	}
+	timeGrid->AddOwner();
+	
+	member->DisposeUncertainty();
+	member->fLastTriangles.Clear();
+	member->fRandomSeed = randomSeed;
+	member->bIsFirstStep = true;
+	member->fIsOptimizedForStep = false;
+	
+	return member;
+}
+
 
 OSErr GridCurrentMover_c::get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID) {
 
@@ -231,28 +266,39 @@ OSErr GridCurrentMover_c::get_move(int n, Seconds model_time, Seconds step_len,
 		return 2;
 	}
 	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr GridCurrentMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+	
+	// blend the interval PrepareForModelStep set, now that the number of LEs is known
+	if (fIsOptimizedForStep)
+		timeGrid->PrepareBlendedVelocities(model_time, les.GetNumSpillLEs());
+	
+	if (bUseBatchedGetMove)
+		return GetBatchedMoves(les, model_time, step_len, delta, spillType, spill_ID);
 	
 	WorldPoint3D zero_delta ={0,0,0.};
 	
+	// once the interval is set for the step the grid is only read
+	Boolean inParallel = fNumThreads > 1 && CanMoveLEsInParallel(spillType);
+	
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 		
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
+		les.GetLE(i, &rec);
 		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	
-		rec.p.pLong*= 1000000;
-		
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
@@ -261,6 +307,77 @@ OSErr GridCurrentMover_c::get_move(int n, Seconds model_time, Seconds step_len,
 	return noErr;
 }
 
+// same result as calling GetMove for each LE, but the time grid does the cell lookups
+// and time interpolation for the whole array in one call
+OSErr GridCurrentMover_c::GetBatchedMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+	OSErr err = 0;
+	char errmsg[256];
+	WorldPoint3D zero_delta ={0,0,0.};
+	
+	if (n <= 0)
+		return noErr;
+	
+	if(!fIsOptimizedForStep) 
+		err = timeGrid->SetInterval(errmsg, model_time); 
+	
+	if (err)
+	{
+		for (int i = 0; i < n; i++)
+			delta[i] = zero_delta;
+		return noErr;
+	}
+	
+	vector<VelocityRec> scaledPatVelocity(n);
+	long *lastTris = bUseLastTriangle ? fLastTriangles.GetLastTris(spill_ID, spillType == UNCERTAINTY_LE, les.GetNumSpillLEs()) : 0;
+	
+	// the interval is set, so the grid is only read from here on and each
+	// thread can look up its own block of LEs
+	int numThreads = fNumThreads > 1 ? fNumThreads : 1;
+	int blockSize = (n + numThreads - 1) / numThreads;
+	#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+	for (int block = 0; block < numThreads; block++) {
+		int first = block * blockSize;
+		int count = _min(blockSize, n - first);
+		if (count > 0)
+			timeGrid->GetScaledPatValues(model_time, les.GetSubBlock(first, count), &scaledPatVelocity[first], lastTris ? lastTris + les.GetSpillIndex(first) : 0);
+	}
+	
+	#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+	for (int i = 0; i < n; i++) {
+		double dLong, dLat, refLat;
+		
+		if( !les.IsInWater(i))
+		{
+			delta[i] = zero_delta;
+			continue;
+		}
+		
+		VelocityRec &velocity = scaledPatVelocity[i];
+		velocity.u *= fCurScale;
+		velocity.v *= fCurScale;
+		
+		if(spillType == UNCERTAINTY_LE)
+		{
+			AddUncertainty(spill_ID, les.GetSpillIndex(i), &velocity, step_len, false);
+		}
+		
+		refLat = les.GetScaledPosition(i).p.pLat;
+		dLong = ((velocity.u / METERSPERDEGREELAT) * step_len) / LongToLatRatio3 (refLat);
+		dLat  =  (velocity.v / METERSPERDEGREELAT) * step_len;
+		
+		// keep the same scaling steps as GetMove so the results are identical
+		delta[i].p.pLong = dLong * 1000000;
+		delta[i].p.pLat  = dLat  * 1000000;
+		delta[i].p.pLong /= 1000000;
+		delta[i].p.pLat /= 1000000;
+		delta[i].z = 0.;
+	}
+	
+	return noErr;
+}
+
 WorldPoint3D GridCurrentMover_c::GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *theLE,LETYPE leType)
 {
 	WorldPoint3D	deltaPoint = {{0,0},0.};
@@ -13,6 +13,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "CurrentMover_c.h"
+#include "DagTree.h"
 #include "ExportSymbols.h"
 
 #ifndef pyGNOME
@@ -31,6 +32,9 @@ public:
 	char fPathName[kMaxNameLen];
 	char fUserName[kPtCurUserNameLen];
 	Boolean fIsOptimizedForStep;
+	Boolean bUseBatchedGetMove;	// get_move does the velocity lookups for the whole array instead of per LE
+	Boolean bUseLastTriangle;	// triangle grid lookups start from the triangle each LE was in last step
+	LastTriangleCache fLastTriangles;
 	TimeGridVel *timeGrid;
 	
 	Boolean fAllowVerticalExtrapolationOfCurrents;
@@ -65,11 +69,16 @@ public:
 	virtual WorldPoint3D       GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *thisLE,LETYPE leType);
 	virtual OSErr 		PrepareForModelStep(const Seconds&, const Seconds&, bool, int numLESets, int* LESetsSizesList); 
 	virtual void 		ModelStepIsDone();
+	virtual Mover_c		*NewEnsembleMember(unsigned long randomSeed);
 	
 			OSErr		TextRead(char *path,char *topFilePath);
 			OSErr 		ExportTopology(char* path){return timeGrid->ExportTopology(path);}
 
 			OSErr		get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	// the step's first call blends the interval and sizes the last triangles
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return fIsOptimizedForStep; }
+			OSErr		GetBatchedMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 
 };
 
@@ -15,6 +15,7 @@
 #include "StringFunctions.h"
 #include "CompFunctions.h"
 #include "DagTreeIO.h"
+#include "TimeSlicePrefetcher.h"
 #include "netcdf.h"
 
 #ifndef pyGNOME
@@ -222,8 +223,14 @@ OSErr GridMap_c::InitMap()
 
 /////////////////////////////////////////////////
 
-OSErr GridMap_c::SetUpCurvilinearGrid(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg)
+OSErr GridMap_c::SetUpCurvilinearGrid(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg, const char *gridPath)
 {
+	TopologyCache topologyCache(gridPath, landMaskH, numRows, numCols, vertexPtsH);
+	CurvilinearTopology cachedTopology;
+	
+	if (topologyCache.Read(true, &cachedTopology) == noErr)
+		return SetUpCachedCurvilinearGrid(&cachedTopology, numRows, numCols, depthPtsH, errmsg);
+	
 	long i, j, n, ntri, numVerdatPts=0; 
 	long numRows_ext = numRows+1, numCols_ext = numCols+1;
 	long nv = numRows * numCols, nv_ext = numRows_ext*numCols_ext;
@@ -695,6 +702,12 @@ setFields:
 	//triGrid -> SetDepths(totalDepthH);	// used by PtCurMap to check vertical movement
 	triGrid -> SetDepths(depths);	// used by PtCurMap to check vertical movement
 	
+	if (waterBoundaryPtsH)
+	{	// if it can't be written the grid is just built again next time
+		CurvilinearTopology topology = {pts, topo, tree.treeHdl, tree.numBranches, verdatPtsH, boundaryEndPtsH, waterBoundaryPtsH, boundaryPtsH};
+		topologyCache.Write(topology);
+	}
+	
 	pts = 0;	// because fGrid is now responsible for it
 	topo = 0; // because fGrid is now responsible for it
 	velH = 0; // because fGrid is now responsible for it
@@ -757,6 +770,83 @@ done:
 	return err;
 }
 
+// the grid SetUpCurvilinearGrid would build, from what it saved in the topology cache
+OSErr GridMap_c::SetUpCachedCurvilinearGrid(CurvilinearTopology *topology, long numRows, long numCols, FLOATH depthPtsH, char* errmsg)
+{
+	long i, n, iIndex, jIndex, numCols_ext = numCols+1;
+	long numPts = _GetHandleSize((Handle)topology->pts)/sizeof(**topology->pts);
+	WorldRect triBounds = voidWorldRect;
+	FLOATH depths = 0;
+	TTriGridVel *triGrid = nil;
+	TDagTree *dagTree = 0;
+	OSErr err = 0;
+	
+	depths = (FLOATH)_NewHandle(sizeof(float)*numPts);
+	if (!depths) {err = memFullErr; goto done;}
+	for (i=0;i<numPts;i++)
+	{
+		// points on the extra row and column take the depth of their neighbor in the file
+		n = INDEXH(topology->verdatToNetCDF,i);
+		iIndex = n/numCols_ext;
+		jIndex = n%numCols_ext;
+		INDEXH(depths,i) = INDEXH(depthPtsH,(iIndex>0 ? iIndex-1 : 0)*numCols + (jIndex<numCols ? jIndex : numCols-1));
+		AddWPointToWRect(INDEXH(topology->pts,i).v, INDEXH(topology->pts,i).h, &triBounds);
+	}
+	
+	triGrid = new TTriGridVel;
+	if (!triGrid)
+	{		
+		err = true;
+		TechError("Error in GridMap::SetUpCachedCurvilinearGrid()","new TTriGridVel",err);
+		goto done;
+	}
+	
+	fGrid = (TTriGridVel*)triGrid;
+	
+	triGrid -> SetBounds(triBounds); 
+	dagTree = new TDagTree(topology->pts,topology->topo,topology->tree,0,topology->numBranches); 
+	if(!dagTree)
+	{
+		err = -1;
+		printError("Unable to create dag tree.");
+		goto done;
+	}
+	
+	triGrid -> SetDagTree(dagTree);
+	triGrid -> SetDepths(depths);	// used by PtCurMap to check vertical movement
+	
+	depths = 0;
+	topology->pts = 0;	// because fGrid is now responsible for them
+	topology->topo = 0;
+	topology->tree = 0;
+	
+	this->SetBoundarySegs(topology->boundarySegs);	
+	this->SetWaterBoundaries(topology->boundaryTypes);
+	this->SetBoundaryPoints(topology->boundaryPts);
+	this->SetMapBounds(triBounds);		
+	topology->boundarySegs = 0;
+	topology->boundaryTypes = 0;
+	topology->boundaryPts = 0;
+	
+done:
+	if (depths) {DisposeHandle((Handle)depths); depths = 0;}
+	TopologyCache::DisposeTopology(topology);	// the verdat points, and everything else on an error
+	
+	if(err)
+	{
+		if(!errmsg[0])
+			strcpy(errmsg,"An error occurred in GridMap_c::SetUpCachedCurvilinearGrid");
+		printError(errmsg); 
+		if(fGrid)
+		{
+			fGrid ->Dispose();
+			delete fGrid;
+			fGrid = 0;
+		}
+	}
+	return err;
+}
+
 OSErr GridMap_c::SetUpCurvilinearGrid2(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg)
 {	// this is for the points on nodes case (old coops_mask)
 	OSErr err = 0;
@@ -1859,6 +1949,7 @@ done:
 
 OSErr GridMap_c::GetPointsAndMask(char *path,DOUBLEH *maskH,WORLDPOINTFH *vertexPointsH, FLOATH *depthPointsH, long *numRows, long *numCols)	
 {
+	NetCDFLock lock;	// the writer thread may be in the library
 	// this code is for curvilinear grids
 	OSErr err = 0;
 	long i,j,k, indexOfStart = 0;
@@ -2101,6 +2192,7 @@ OSErr GridMap_c::GetPointsAndBoundary(char *path,
 									  LONGPTR *boundary_indices, LONGPTR *boundary_nums, LONGPTR *boundary_type, long *numBoundaryPts,
 									  LONGPTR *triangle_verts, LONGPTR *triangle_neighbors, long *ntri)
 {
+	NetCDFLock lock;
 	OSErr err = 0;
 	char errmsg[256] = "";
 
@@ -2988,6 +3080,7 @@ done:
 
 OSErr GridMap_c::SaveAsNetCDF(char *path)
 {	
+	NetCDFLock lock;
 	OSErr err = 0;	
 	int status, ncid, ver_dim, top_dim, dag_dim, edge_dim, top_dimid[2], landwater_dimid[1], edge_dimid[2], boundary_count_dimid[1], dag_dimid[2], lat_dimid[1], lon_dimid[1], depth_dimid[1];
 	int mesh2_node_x_id, mesh2_node_y_id, mesh2_depth_id, mesh2_face_links_id, mesh2_face_nodes_id, mesh2_dagtree_id, mesh2_landwater_id, mesh2_edge_id, mesh2_boundary_count_id;
@@ -3586,7 +3679,7 @@ OSErr GridMap_c::TextRead(char *path)
 
 				err = this->GetPointsAndMask(path, &maskH, &vertexPtsH, &depthPtsH, &numRows, &numCols);	//Text read
 				if (!err)
-					err = this->SetUpCurvilinearGrid(maskH, numRows, numCols, vertexPtsH, depthPtsH, errmsg);	//Reorder points
+					err = this->SetUpCurvilinearGrid(maskH, numRows, numCols, vertexPtsH, depthPtsH, errmsg, path);	//Reorder points
 
 				if (maskH) {
 					DisposeHandle((Handle)maskH);
@@ -22,6 +22,7 @@ using namespace std;
 #include "ClassID_c.h"
 #include "my_build_list.h"
 #include "GridMapUtils.h"
+#include "TopologyCache.h"
 
 
 #ifdef pyGNOME
@@ -77,7 +78,8 @@ public:
 	virtual  long 	GetNumPointsInBoundarySeg(long segno);
 	virtual	long 	GetNumBoundaryPts(void);
 	
-	OSErr			SetUpCurvilinearGrid(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg);	
+	OSErr			SetUpCurvilinearGrid(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg, const char *gridPath = 0);	
+	OSErr			SetUpCachedCurvilinearGrid(CurvilinearTopology *topology, long numRows, long numCols, FLOATH depthPtsH, char* errmsg);
 	OSErr			SetUpCurvilinearGrid2(DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, char* errmsg);	
 	OSErr			SetUpTriangleGrid2(long numNodes, long numTri, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, long *bndry_indices, long *bndry_nums, long *bndry_type, long numBoundaryPts, long *tri_verts, long *tri_neighbors);
 	OSErr			SetUpTriangleGrid(long numNodes, long numTri, WORLDPOINTFH vertexPtsH, FLOATH depthPtsH, long *bndry_indices, long *bndry_nums, long *bndry_type, long numBoundaryPts);
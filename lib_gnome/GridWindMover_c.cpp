@@ -58,8 +58,11 @@ void GridWindMover_c::Dispose()
 {
 	if (timeGrid)
 	{
-		timeGrid -> Dispose();
-		delete timeGrid; // this causes a crash...
+		if (timeGrid->RemoveOwner())
+		{
+			timeGrid -> Dispose();
+			delete timeGrid; // this causes a crash...
+		}
 		timeGrid = nil;
 	}
 	
@@ -112,6 +115,32 @@ void GridWindMover_c::ModelStepIsDone()
 	fIsOptimizedForStep = false;
 }
 
+// as GridCurrentMover_c::NewEnsembleMember, the member shares the wind grid
+Mover_c *GridWindMover_c::NewEnsembleMember(unsigned long randomSeed)
+{
+	GridWindMover_c *member = 0;
+	
+	if (!timeGrid) return 0;
+	
+	try
+	{
+		member = new GridWindMover_c(*this);
+	}
+	catch (...)
+	{
+		return 0;
+	}
+	timeGrid->AddOwner();
+	
+	member->timeDep = nil;	// gridded winds don't use it, and it isn't the member's to dispose of
+	member->DisposeUncertainty();
+	member->fRandomSeed = randomSeed;
+	member->bIsFirstStep = true;
+	member->fIsOptimizedForStep = false;
+	
+	return member;
+}
+
 
 OSErr GridWindMover_c::get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, double* windages, short* LE_status, LEType spillType, long spill_ID) {
 
@@ -126,30 +155,34 @@ OSErr GridWindMover_c::get_move(int n, Seconds model_time, Seconds step_len, Wor
 		// cout << "Invalid spillType.\n";
 		return 2;
 	}
-	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
-	
+
+	LEBlock les(n, ref, LE_status);
+	les.SetWindages(windages);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr GridWindMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
 	WorldPoint3D zero_delta ={0,0,0.};
 	
+	// once the interval is set for the step the grid is only read; the uncertainty draws random numbers in LE order
+	Boolean inParallel = fNumThreads > 1 && fIsOptimizedForStep && spillType == FORECAST_LE;
+	
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 		
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		rec.windage = windages[i];	// define the windage for the current LE
-		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	
-		rec.p.pLong*= 1000000;
+		les.GetLE(i, &rec);
 		
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
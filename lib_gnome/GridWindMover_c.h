@@ -65,12 +65,14 @@ public:
 	virtual OSErr 		PrepareForModelRun(); 
 	virtual OSErr 		PrepareForModelStep(const Seconds&, const Seconds&, bool, int numLESets, int* LESetsSizesList); 
 	virtual void 		ModelStepIsDone();
+	virtual Mover_c		*NewEnsembleMember(unsigned long randomSeed);
 	virtual WorldPoint3D       GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *theLE,LETYPE leType);
 	
 	OSErr			TextRead(char *path,char *topFilePath);
 	OSErr 			ExportTopology(char* path){return timeGrid->ExportTopology(path);}
 
 	OSErr 			get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, double* windages, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 };
 
 #endif
@@ -0,0 +1,88 @@
+/*
+ *  LEBlock.cpp
+ *  gnome
+ *
+ */
+
+#include "LEBlock.h"
+
+LEBlock::LEBlock(long numLEs, WorldPoint3D *positions, short *status)
+{
+	fNumLEs = numLEs;
+	fFirstLE = 0;
+	fNumSpillLEs = numLEs;
+	fUnitsPerDegree = 1.;
+	SetField(&fLongs, &positions[0].p.pLong, sizeof(WorldPoint3D));
+	SetField(&fLats, &positions[0].p.pLat, sizeof(WorldPoint3D));
+	SetField(&fDepths, &positions[0].z, sizeof(WorldPoint3D));
+	SetField(&fStatus, status, sizeof(short));
+	SetField(&fWindages, 0, 0);
+	SetField(&fRiseVelocities, 0, 0);
+}
+
+LEBlock::LEBlock(long numLEs, WorldCoord *longs, WorldCoord *lats, double *depths, short *status)
+{
+	fNumLEs = numLEs;
+	fFirstLE = 0;
+	fNumSpillLEs = numLEs;
+	fUnitsPerDegree = 1.;
+	SetField(&fLongs, longs, sizeof(WorldCoord));
+	SetField(&fLats, lats, sizeof(WorldCoord));
+	SetField(&fDepths, depths, sizeof(double));
+	SetField(&fStatus, status, sizeof(short));
+	SetField(&fWindages, 0, 0);
+	SetField(&fRiseVelocities, 0, 0);
+}
+
+LEBlock::LEBlock(long numLEs, LERec *les)
+{
+	fNumLEs = numLEs;
+	fFirstLE = 0;
+	fNumSpillLEs = numLEs;
+	fUnitsPerDegree = 1000000.;
+	SetField(&fLongs, &les[0].p.pLong, sizeof(LERec));
+	SetField(&fLats, &les[0].p.pLat, sizeof(LERec));
+	SetField(&fDepths, &les[0].z, sizeof(LERec));
+	SetField(&fStatus, &les[0].statusCode, sizeof(LERec));
+	SetField(&fWindages, &les[0].windage, sizeof(LERec));
+	SetField(&fRiseVelocities, &les[0].riseVelocity, sizeof(LERec));
+}
+
+LEBlock LEBlock::GetSubBlock(long first, long count) const
+{
+	LEBlock sub = *this;
+	Field *fields[] = {&sub.fLongs, &sub.fLats, &sub.fDepths, &sub.fStatus, &sub.fWindages, &sub.fRiseVelocities};
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (fields[i]->base)
+			fields[i]->base += first * fields[i]->stride;
+	}
+	sub.fNumLEs = count;
+	sub.fFirstLE = fFirstLE + first;
+	return sub;
+}
+
+// scaled straight from the stored units so a position in degrees comes out
+// exactly as get_move used to compute it
+WorldPoint3D LEBlock::GetScaledPosition(long i) const
+{
+	WorldPoint3D p;
+	double scale = 1000000. / fUnitsPerDegree;
+
+	p.p.pLong = Get<WorldCoord>(fLongs, i) * scale;
+	p.p.pLat = Get<WorldCoord>(fLats, i) * scale;
+	p.z = GetZ(i);
+	return p;
+}
+
+void LEBlock::GetLE(long i, LERec *theLE) const
+{
+	WorldPoint3D p = GetScaledPosition(i);
+
+	theLE->p = p.p;
+	theLE->z = p.z;
+	theLE->windage = GetWindage(i);
+	theLE->riseVelocity = GetRiseVelocity(i);
+	theLE->statusCode = GetStatus(i);
+}
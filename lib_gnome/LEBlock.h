@@ -0,0 +1,78 @@
+/*
+ *  LEBlock.h
+ *  gnome
+ *
+ *  The LEs a mover works on, seen as separate arrays of longitude, latitude,
+ *  depth, status and so on, the way the Python spill container keeps them.
+ *  A block only points at arrays its caller owns. Each field has its own
+ *  stride, so the same block can look at plain arrays, at the (long, lat, z)
+ *  positions get_move is passed, or at the records in an LE list handle.
+ *
+ *  A sub-block still knows where its LEs are in the whole spill, so a mover
+ *  can key its per-LE state (uncertainty, last triangles, random streams)
+ *  the same way whether it is given the spill or a piece of it.
+ *
+ */
+
+#ifndef __LEBlock__
+#define __LEBlock__
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class DLL_API LEBlock {
+
+public:
+#ifdef pyGNOME
+	typedef double WorldCoord;	// the type of a WorldPoint's pLong and pLat
+#else
+	typedef long WorldCoord;
+#endif
+
+	LEBlock(long numLEs, WorldPoint3D *positions, short *status);	// positions in degrees, as get_move is passed them
+	LEBlock(long numLEs, WorldCoord *longs, WorldCoord *lats, double *depths, short *status);
+	LEBlock(long numLEs, LERec *les);	// positions scaled by 1e6, as in an LE list
+
+	void		SetWindages(double *windages) {SetField(&fWindages, windages, sizeof(double));}
+	void		SetRiseVelocities(double *riseVelocities) {SetField(&fRiseVelocities, riseVelocities, sizeof(double));}
+
+	long		GetNumLEs() const {return fNumLEs;}
+	LEBlock		GetSubBlock(long first, long count) const;	// the LEs first up to first + count, sharing the arrays
+
+	long		GetSpillIndex(long i) const {return fFirstLE + i;}	// where LE i is in the whole spill
+	long		GetNumSpillLEs() const {return fNumSpillLEs;}
+
+	// positions in degrees
+	double		GetLong(long i) const {return Get<WorldCoord>(fLongs, i) / fUnitsPerDegree;}
+	double		GetLat(long i) const {return Get<WorldCoord>(fLats, i) / fUnitsPerDegree;}
+	double		GetZ(long i) const {return Get<double>(fDepths, i);}
+	WorldPoint3D	GetScaledPosition(long i) const;	// times 1e6, what GetMove expects
+
+	OilStatus	GetStatus(long i) const {return Get<OilStatus>(fStatus, i);}
+	void		SetStatus(long i, OilStatus status) {Get<OilStatus>(fStatus, i) = status;}
+	Boolean		IsInWater(long i) const {return GetStatus(i) == OILSTAT_INWATER;}
+
+	// zero if the caller has not given the array
+	double		GetWindage(long i) const {return fWindages.base ? Get<double>(fWindages, i) : 0.;}
+	double		GetRiseVelocity(long i) const {return fRiseVelocities.base ? Get<double>(fRiseVelocities, i) : 0.;}
+
+	// fills only the fields the movers read, p (scaled), z, windage, riseVelocity and statusCode
+	void		GetLE(long i, LERec *theLE) const;
+
+private:
+	typedef struct {
+		char	*base;
+		long	stride;		// bytes from one LE to the next
+	} Field;
+
+	long		fNumLEs;
+	long		fFirstLE, fNumSpillLEs;
+	double		fUnitsPerDegree;
+	Field		fLongs, fLats, fDepths, fStatus, fWindages, fRiseVelocities;
+
+	static void	SetField(Field *field, void *base, long stride) {field->base = (char*)base; field->stride = stride;}
+	template <class T> T &Get(const Field &field, long i) const {return *(T*)(field.base + i * field.stride);}
+};
+
+#endif
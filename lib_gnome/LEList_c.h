@@ -14,6 +14,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "ClassID_c.h"
+#include "LEBlock.h"
 
 class LEList_c : virtual public ClassID_c {
 
@@ -33,6 +34,7 @@ public:
 	void			ReFloatLE (long leNum);
 	void			GetLE (long leNum, LERecP theLE);
 	void			SetLE (long leNum, LERecP theLE);
+	LEBlock			GetLEBlock () { return LEBlock(numOfLEs, *LEHandle); }	// only valid until the handle is resized
 	WorldPoint		GetLEPosition (long leNum);
 	void			SetLEPosition (long leNum, WorldPoint p);
 	Seconds			GetLEReleaseTime (long leNum);
@@ -1,10 +1,13 @@
 // this file could be included in GNOME to deal with DagTree if not included in Ptcur files
 // just uncomment out the makeDagTree call in TextRead
+#include <algorithm>
+#include <utility>
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "MemUtils.h"
 #include "DagTreeIO.h"
 #include "my_build_list.h"
+#include "ForEachLE.h"
 
 #ifndef pyGNOME
 #include "CROSS.H"
@@ -12,15 +15,11 @@
 #include "Replacements.h"
 #endif
 
-DAGTreeStruct gDagTree;	
-WORLDPOINTDH gCoord;
-Side_List **gSidesList;
-long gAllocatedDagLength = 0;
-char gErrStr[256];
-#define NUMTOALLOCATE  500
 #define NUMTESTS	300
 #define SEED	5
 
+const long kMinTestWorkPerThread = 1L << 17;	// sides compared, for a node's tests to be split among threads
+
 ///////////////////////////////////////////////////////////////////////////////////
 //																				 //
 //	Given a triangle number and two vertices, return the point number of the 	 //
@@ -169,27 +168,33 @@ Side_List**  BuildSideList(TopologyHdl topoHdl, char *errStr)
 	return(sideListHdl);
 }
 
-OSErr LatLongTransform(LongPointHdl vertices)// may need to read in the doubles then convert later
+// the points scaled to about a unit square, in which the sides are compared
+static OSErr LatLongTransform(LongPointHdl vertices, std::vector<WorldPointD> &coord)
 {
 	long i,npoints = _GetHandleSize((Handle)vertices)/sizeof(LongPoint);	
 	double deg2rad = 3.14159/180.;
 	double R = 8000,dLat,dLong,Height,Width,scalefactor,tx,ty;
 	double xmin=1e6,xmax=-1e6,ymin=1e6,ymax=-1e6;
-	WORLDPOINTDH coord=0;
 	
-	if(!(coord = (WORLDPOINTDH) _NewHandleClear(sizeof(WorldPointD) * npoints)))return -1;
+	try
+	{
+		coord.resize(npoints);
+	}
+	catch (...)
+	{
+		return -1;
+	}
 	for(i=0;i<npoints;i++)
 	{
-		(*coord)[i].pLat = (*vertices)[i].v / 1000000.;
-		(*coord)[i].pLong = (*vertices)[i].h / 1000000.;
+		coord[i].pLat = (*vertices)[i].v / 1000000.;
+		coord[i].pLong = (*vertices)[i].h / 1000000.;
 	}
-	//GetVertexRange(vertices, &xmin,&xmax,&ymin,&ymax);	// defined in Iocats.c
 	for(i=0;i<npoints;i++)
 	{
-		if((*coord)[i].pLat < ymin) ymin = (*coord)[i].pLat;
-		if((*coord)[i].pLat > ymax) ymax = (*coord)[i].pLat;
-		if((*coord)[i].pLong < xmin) xmin = (*coord)[i].pLong;
-		if((*coord)[i].pLong > xmax) xmax = (*coord)[i].pLong;
+		if(coord[i].pLat < ymin) ymin = coord[i].pLat;
+		if(coord[i].pLat > ymax) ymax = coord[i].pLat;
+		if(coord[i].pLong < xmin) xmin = coord[i].pLong;
+		if(coord[i].pLong > xmax) xmax = coord[i].pLong;
 	}
 	dLat = ymax - ymin;
 	dLong = xmax - xmin;
@@ -201,444 +206,316 @@ OSErr LatLongTransform(LongPointHdl vertices)// may need to read in the doubles
 	
 	for(i= 0; i < npoints ; i++)
 	{
-		(*coord)[i].pLong = tx * ((*coord)[i].pLong - xmin);
-		 (*coord)[i].pLat = ty * ((*coord)[i].pLat - ymin);
+		coord[i].pLong = tx * (coord[i].pLong - xmin);
+		coord[i].pLat = ty * (coord[i].pLat - ymin);
 	}
-	gCoord = coord;
 	return 0;
 }
 
-void ConvertSegNoToTopIndex(Side_List **sl, DAGTreeStruct dagTree)
+DagTreeRandom::DagTreeRandom(unsigned int seed)
 {
-	long nnodes = dagTree.numBranches,i;
-	DAG** dagHdl;	
-	
-	dagHdl = dagTree.treeHdl;
+	long i;
 	
-	for(i=0;i<nnodes;i++)
+	// as glibc's srandom_r: a Park-Miller sequence, then 310 values thrown away
+	fState[0] = seed;
+	for (i=1;i<31;i++)
 	{
-		(*dagHdl)[i].topoIndex = (*sl)[(*dagHdl)[i].topoIndex].topoIndex;
+		fState[i] = (int32_t)((16807LL * fState[i-1]) % 2147483647);
+		if (fState[i] < 0) fState[i] += 2147483647;
 	}
+	for (i=31;i<34;i++)
+		fState[i] = fState[i-31];
+	fIndex = 34;
+	for (i=34;i<344;i++)
+		Next();
 }
 
-DAGTreeStruct  MakeDagTree(TopologyHdl topoHdl, LongPoint **pointList, char *errStr)
+long DagTreeRandom::Next()
 {
-	Side_List **sidesList = 0;
-	DAGTreeStruct  dagTree;
-	long numSidesInList;		
-	long nodeNum;					// The index in the current side list for the node (segment)
-									//			to split across.
-	strcpy(errStr,"");
-	dagTree.treeHdl = 0;
-	dagTree.numBranches = 0;
-	sidesList=BuildSideList(topoHdl, errStr);
-
-	//input checking
-	if(sidesList == nil) 
-	{ 
-		strcpy(errStr,"sideList is nil in MakeDagTree");
-		goto done;
-	}
+	// r[i] = r[i-31] + r[i-3], in the last 34 values
+	uint32_t r = (uint32_t)fState[(fIndex+3)%34] + (uint32_t)fState[(fIndex+31)%34];
 	
-	LatLongTransform(pointList);
-	gSidesList = sidesList;
-
-	numSidesInList = (_GetHandleSize((Handle)sidesList))/(sizeof(Side_List));
-	if (numSidesInList < 3)
-	{
-		sprintf(errStr,"Triangles have 3 sides; the data has only %ld sides.", numSidesInList);
-		goto done;
-	}
-
-	// make a better guess of size here
-	gErrStr[0] = 0;	
-	gAllocatedDagLength = 2*numSidesInList;
-
-	gDagTree.numBranches=0;	
-	gDagTree.treeHdl = (DAG**)_NewHandleClear(gAllocatedDagLength*sizeof(DAG));
-	if(!gDagTree.treeHdl)  
-	{ 
-		strcpy(errStr,"Out of memory in MakeDagTree");
-		goto done;
-	}
-	
-	srand(SEED);
-	//srand(SEED+1);
-	
-	nodeNum = newNodexx(sidesList);
-	split(sidesList, nodeNum);
-	//	Nothing should come back until DAG is completed.
-
-	//gDagTree.numBranches--;  	// Had one too many increments in the split recursion.
-	
-	if(gErrStr[0])
-	{
-		strcpy(errStr,gErrStr);
-		gErrStr[0] = 0;
-		if(gDagTree.treeHdl) DisposeHandle((Handle) gDagTree.treeHdl);
-		gDagTree.treeHdl = nil;
-		gDagTree.numBranches = 0;
-		goto done;
-	}
-	
-	ConvertSegNoToTopIndex(sidesList,gDagTree);
-
-	dagTree = gDagTree;
-	gDagTree.treeHdl = nil;// the handle is now their responsibility
-	gDagTree.numBranches = 0;
-	
-done:
-	if(sidesList)
-	{
-		{DisposeHandle((Handle)sidesList);sidesList=0;}
-	}
-	return dagTree;
+	fState[fIndex%34] = (int32_t)r;
+	fIndex = fIndex%34 + 1;
+	return r >> 1;
 }
 
-//////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////
-//																		//
-//  Use this function to compare the nodes in the list of possible		//
-//		nodes.  We are looking for a minimum of the function in 		//
-//		NewNodexx														//
-//																		//
-//////////////////////////////////////////////////////////////////////////
-
-int NodeTestCompare(void const *x1, void const *x2)
+DagTreeBuilder::DagTreeBuilder(Side_List **sidesList, LongPointHdl pointList) : fRandom(SEED)
 {
-	Test *p1,*p2;	
-	p1 = (Test*)x1;
-	p2 = (Test*)x2;
-	
-	if (p1->countTotal < p2->countTotal) 
-		return -1;  // first less than second
-	else if (p1->countTotal > p2->countTotal)
-		return 1;
-	else return 0;// same,equivalent
-	
+	fSidesList = sidesList;
+	fPointList = pointList;
+	fNumSides = _GetHandleSize((Handle)sidesList)/sizeof(Side_List);
 }
 
-//////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////
-//																		//
-//  Increment the DagTree length in memory as we write dag				//
-//																		//
-//////////////////////////////////////////////////////////////////////////
-void IncrementGDagTree(void)
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// 																								//
+// RightOrLeft decides if a segment is to the right or left										//
+//		of a reference segment, or is neither.													//
+//																								//
+//	Return:																						//
+//				+1 = Right means the entire segment is to the right of the reference			//
+//				0  = Neither.  The segment is either along a line created by extending			//
+//							the reference segment infinitely OR the segment intersects a 		//
+//							line created by extending the reference segment infinitely			//
+//				-1 = Left means the entire segment is to the left of the reference				//
+//			NOTE: A Segment that has only one point on the line created by extending			//
+//							the reference segment infinitely will be determined as right		//
+//							or left, not both													//
+// 																								//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+static int RightOrLeft(const DagTreeSide &ref, const DagTreeSide &test)
 {
-	// increment the counter and allocate more memory if needed
-	OSErr err = noErr;
-	gDagTree.numBranches ++;
-	if(gDagTree.numBranches  >= gAllocatedDagLength)
-	{									// then allocate more memory
-		long newNumber = gAllocatedDagLength + NUMTOALLOCATE;
-		_SetHandleSize((Handle)gDagTree.treeHdl,newNumber* sizeof(DAG));
+	double ref_h = ref.x2 - ref.x1, ref_v = ref.y2 - ref.y1;
+	double test1_h = test.x1 - ref.x1, test1_v = test.y1 - ref.y1;
+	double test2_h = test.x2 - ref.x1, test2_v = test.y2 - ref.y1;
+	double cp_1 = test1_h* ref_v - test1_v * ref_h;
+	double cp_2 = test2_h* ref_v - test2_v * ref_h;
+	
+	//Test for segments that share one point
+	if (ref.p1 == test.p1)
+		cp_1 = 0.;
+	else if (ref.p1 == test.p2)
+		cp_2 = 0.;
 		
-		err = _MemError();	
-		if (err)
-		{
-			strcpy(gErrStr,"Not enough memory to expand the DAG tree structure");
-		}
-		else
-		{
-			gAllocatedDagLength = newNumber;
-		}
-	}
+	if (ref.p2 == test.p1)
+		cp_1 = 0.;
+	else if (ref.p2 == test.p2)
+		cp_2 = 0.;
+
+	// decide right, left or neither
+	if (cp_1 > 0.)
+		return cp_2 >= 0. ? 1 : 0;
+	else if (cp_1 == 0.)
+		return cp_2 > 0. ? 1 : (cp_2 < 0. ? -1 : 0);	// both on the line could mean that the segments are the same.....
+	else if (cp_1 < 0.)
+		return cp_2 > 0. ? 0 : -1;
+	return 0;
 }
-//////////////////////////////////////////////////////////////////////////
+
 //////////////////////////////////////////////////////////////////////////
 // 																		//
 // Here we pick a node to split another branch of the DAG tree			//
-//		Select the new node randomly among the list of sides.			//
+//		The best of NUMTESTS sides picked at random, the one that		//
+//		divides the others most evenly.  Boundary sides are only		//
+//		picked when there is nothing else.								//
 //																		//
 //////////////////////////////////////////////////////////////////////////
-
-long newNodexx(Side_List **sides_node)
-// The side to serve as a new node for the DAG tree.
+long DagTreeBuilder::PickNode(const std::vector<DagTreeSide> &sides)
 {
-	//long new_node;					// The new branch point chosen randomly
-	long numSides_node = (_GetHandleSize((Handle)sides_node))/(sizeof(Side_List));
-	long numBoundSides_node = 0;
+	long numSides = sides.size(), numBoundSides = 0, numTests = NUMTESTS, numPicked, i, best = 0;
 	Test tN[NUMTESTS];
-	long numTests = NUMTESTS;
-	long location;					// result of right or left routine
-	long testNodeP1, testNodeP2;	// points in test node segment
-	long i,j;						// Counters
-	//char str[512];
-	//long	start, end;		
+	long picked[NUMTESTS], totals[NUMTESTS];
 	
-	for (i=0; i<numSides_node; i++)
+	for (i=0; i<numSides; i++)
 	{
-		if ((*sides_node)[i].triRight == -1) numBoundSides_node++;
+		if ((*fSidesList)[sides[i].sideNum].triRight == -1) numBoundSides++;
 	}
+	if (numSides < numTests) numTests = numSides;	// Don't do more tests than the total number of sides to test.
 	
-	// Old Way
-	//if (numSides_node == numBoundSides_node){
-	//	new_node = (rand() % numSides_node)+1;
-	//	return (new_node);
-	//	}
-	//new_node = (rand() % (numSides_node - numBoundSides_node)+1);
-	//	return (numBoundSides_node+new_node);
-
-	//start = TickCount();
+	// the random picks are all made first, in the order they always have been
+	for (i=0;i<numTests;i++)
+	{
+		if (numSides == numBoundSides)
+			tN[i].nodes = fRandom.Next() % numSides;
+		else
+			tN[i].nodes = numBoundSides + fRandom.Next() % (numSides - numBoundSides);	// boundary sides sort first
+	}
 	
-	if (numSides_node < numTests) numTests = numSides_node;  // Don't do more tests than the total
-															// number of sides to test.
+	// so the tests themselves can run side by side, each side picked more than once only tested once
 	for (i=0;i<numTests;i++)
+		picked[i] = tN[i].nodes;
+	std::sort(picked, picked + numTests);
+	numPicked = std::unique(picked, picked + numTests) - picked;
+	ForEachLE(numPicked, [&](long first, long last)
 	{
-		if (numSides_node == numBoundSides_node){
-			tN[i].nodes = (rand() % numSides_node);
-		}												//Want to use boundary sides last...
-		else (tN[i].nodes = numBoundSides_node + (rand() % (numSides_node - numBoundSides_node)));
-		testNodeP1 = (*sides_node)[tN[i].nodes].p1;
-		testNodeP2 = (*sides_node)[tN[i].nodes].p2;
-		tN[i].countBoth = tN[i].countRight = tN[i].countLeft = 0;
-		for	(j=0;j<numSides_node;j++)				//Test the remaining sides against the
-		{										//  current node to see how it divides the domain
-			if (tN[i].nodes == j) continue;
-			location = Right_or_Left(testNodeP1,testNodeP2,(*sides_node)[j].p1,(*sides_node)[j].p2);
-			switch(location)
+		for (long k = first; k < last; k++)
+		{
+			const DagTreeSide &testNode = sides[picked[k]];
+			long countLeft = 0, countRight = 0, countBoth = 0;
+			
+			for (long j=0;j<numSides;j++)
 			{
-				case -1:// left
-					tN[i].countLeft++;
-					break;
-				case 1: // right
-					tN[i].countRight++;
-					break;
-				case 0: // both
-					tN[i].countBoth++;
-					break;
+				if (picked[k] == j) continue;
+				switch(RightOrLeft(testNode, sides[j]))
+				{
+					case -1: countLeft++; break;
+					case 1: countRight++; break;
+					case 0: countBoth++; break;
+				}
 			}
-
+			totals[k] = labs(countLeft-countRight)+2*countBoth;	// minimize this
 		}
-		tN[i].countTotal = abs(tN[i].countLeft-tN[i].countRight)+2*(tN[i].countBoth); //Selection
-	}										// algorithm for best node - minimize this function
-	qsort(tN,numTests,sizeof(Test),NodeTestCompare);
-	//end = TickCount();
-	//sprintf(str,"%f seconds for %f tries to optimize node selection", (end-start)/60.0, (float)numTests);
-	//MESSAGE(str);
-	return(tN[0].nodes);
-}
-//////////////////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////////////////
-// 																		//
-// Here we find the original node number from the side list				//
-// 																		//
-//////////////////////////////////////////////////////////////////////////
-long oldNodeNum(long pt1, long pt2)
-{
-	long segNum = -999;	// The number that we are looking for
-	long j=0; 			// An index
+	}, kMinTestWorkPerThread / numSides + 1);
+	for (i=0;i<numTests;i++)
+		tN[i].countTotal = totals[std::lower_bound(picked, picked + numPicked, tN[i].nodes) - picked];
 	
-	while (segNum == -999)
+	// the first of the best, as the stable sort of the tests always gave
+	for (i=1;i<numTests;i++)
 	{
-		if ((*gSidesList)[j].p1 == pt1 && (*gSidesList)[j].p2 == pt2) segNum = j;
-		else j++;
+		if (tN[i].countTotal < tN[best].countTotal) best = i;
 	}
-	return (segNum);
+	return tN[best].nodes;
 }
+
 //////////////////////////////////////////////////////////////////////////
 // 																		//
 // Here we split the segments into the DAG tree							//
+//		The branches are numbered in the order they are built, each		//
+//		node followed by all of its left branch, then its right.		//
 // 																		//
 //////////////////////////////////////////////////////////////////////////
-
-void split(Side_List **sideListH, long nodeNum)
+OSErr DagTreeBuilder::Build(DAGTreeStruct *dagTree, char *errStr)
 {
-	// **sideListH;				 Listing of the sides in the domain for splitting DAG tree
-	// nodeNum;						 The index for the segment from sideList to use for pivot/split in DAG tree
-	long numSidesL =0;							// the number of sides that are split off to the left
-	long numSidesR =0;							// the number of sides that are split off to the right
-	Side_List **sidesLeftH = nil;				// pointer to area of heap where sides are left
-	Side_List **sidesRightH = nil;				// pointer to area of hear where sides are left
-	long numSideInList = _GetHandleSize((Handle)sideListH)/(sizeof(Side_List));	// The number of sides for splitting
-	long location,i;
-	long nodeP1,nodeP2;
-	Side_List sideListForNode;
-	long bCounterL =0, bCounterR =0;					// counting the number of boundary seg in a side list
-	long branchNum;
-	static long nsx = 0;
-
-	nsx++;
-	if(nsx == 964)
+	typedef struct {
+		std::vector<DagTreeSide>	sides;
+		long	parent;		// the node this branches from, -1 for the first
+		Boolean	isLeft;
+	} Branch;
+	
+	std::vector<WorldPointD> coord;
+	std::vector<long> firstSide(fNumSides);
+	std::vector<Branch> pending(1);
+	std::vector<DAG> nodes;
+	long i;
+	
+	dagTree->treeHdl = 0;
+	dagTree->numBranches = 0;
+	
+	if (LatLongTransform(fPointList, coord)) {strcpy(errStr,"Out of memory in MakeDagTree"); return memFullErr;}
+	
+	// a node is stored as the first side with its end points
 	{
-		nsx = 0;
+		std::vector<std::pair<std::pair<long,long>,long> > byPoints(fNumSides);
+		for (i=0;i<fNumSides;i++)
+			byPoints[i] = std::make_pair(std::make_pair((*fSidesList)[i].p1, (*fSidesList)[i].p2), i);
+		std::sort(byPoints.begin(), byPoints.end());
+		for (i=0;i<fNumSides;i++)
+			firstSide[byPoints[i].second] = (i > 0 && byPoints[i].first == byPoints[i-1].first) ? firstSide[byPoints[i-1].second] : byPoints[i].second;
 	}
-
-	if(gErrStr[0] ) goto done;
-	if(sideListH == nil) 
+	
+	pending[0].parent = -1;
+	pending[0].isLeft = false;
+	pending[0].sides.resize(fNumSides);
+	for (i=0;i<fNumSides;i++)
 	{
-		strcpy(gErrStr,"Nil handle passed to split");
-		goto done;
+		DagTreeSide &s = pending[0].sides[i];
+		s.p1 = (*fSidesList)[i].p1;
+		s.p2 = (*fSidesList)[i].p2;
+		s.x1 = coord[s.p1].pLong; s.y1 = coord[s.p1].pLat;
+		s.x2 = coord[s.p2].pLong; s.y2 = coord[s.p2].pLat;
+		s.sideNum = i;
 	}
-
-	branchNum = gDagTree.numBranches;
-	IncrementGDagTree();
-				
-	(*gDagTree.treeHdl)[branchNum].topoIndex = oldNodeNum(((*sideListH)[nodeNum]).p1,((*sideListH)[nodeNum]).p2);
-
-	sidesLeftH = (Side_List **)_NewHandleClear((numSideInList)*sizeof(Side_List));
-	if(!sidesLeftH){strcpy(gErrStr,"Out of memory in split");goto done;}
-
-	sidesRightH = (Side_List **)_NewHandleClear((numSideInList)*sizeof(Side_List));
-	if(!sidesRightH) {strcpy(gErrStr,"Out of memory in split");goto done;}
-
-	// find the node's points for determining relative right and left
-	nodeP1 = (*sideListH)[nodeNum].p1;
-	nodeP2 = (*sideListH)[nodeNum].p2;
-
-	// Do the actual splitting
-	for (i=0;i<numSideInList; i++) {
-		if(i == nodeNum) continue; // skip the case that nodeNum = i
+	nodes.reserve(2*fNumSides);	// usually enough
+	
+	while (!pending.empty())
+	{
+		Branch branch, left, right;
+		long branchNum = nodes.size(), nodeNum, numSides;
+		DAG node;
 		
-		// find the points associated with the test side
-		location = Right_or_Left(nodeP1,nodeP2,(*sideListH)[i].p1,(*sideListH)[i].p2);
-
-		// Distribute the sides to the two R/L areas of the heap
-		switch(location)
+		std::swap(branch.sides, pending.back().sides);
+		branch.parent = pending.back().parent;
+		branch.isLeft = pending.back().isLeft;
+		pending.pop_back();
+		numSides = branch.sides.size();
+		
+		nodeNum = PickNode(branch.sides);
+		const DagTreeSide &nodeSide = branch.sides[nodeNum];
+		
+		if (branch.parent >= 0)
 		{
-			case -1:// left
-				(*sidesLeftH)[numSidesL++] = (*sideListH)[i];// copy the structure
-				break;
-			case 1: // right
-				(*sidesRightH)[numSidesR++] = (*sideListH)[i];// copy the structure
-				break;
-			case 0: // both
-				(*sidesLeftH)[numSidesL++] = (*sideListH)[i];// copy the structure
-				(*sidesRightH)[numSidesR++] = (*sideListH)[i];// copy the structure
-				break;
+			if (branch.isLeft) nodes[branch.parent].branchLeft = branchNum;
+			else nodes[branch.parent].branchRight = branchNum;
 		}
+		node.topoIndex = (*fSidesList)[firstSide[nodeSide.sideNum]].topoIndex;
+		node.branchLeft = node.branchRight = -8;	// place holder for steps in dag to all tri
+		nodes.push_back(node);
+		
+		// Distribute the sides to the two R/L areas
+		for (i=0;i<numSides;i++)
+		{
+			if (i == nodeNum) continue;
+			switch(RightOrLeft(nodeSide, branch.sides[i]))
+			{
+				case -1: left.sides.push_back(branch.sides[i]); break;
+				case 1: right.sides.push_back(branch.sides[i]); break;
+				case 0: left.sides.push_back(branch.sides[i]); right.sides.push_back(branch.sides[i]); break;
+			}
+		}
+		
+		if (left.sides.empty() && (*fSidesList)[nodeSide.sideNum].triLeft == -1)
+		{
+			strcpy(errStr,"Boundary not set up correctly - outside is on LHS");
+			return -1;
+		}
+		
+		// the left branch is built first, so it goes on top
+		if (!right.sides.empty())
+		{
+			pending.push_back(Branch());
+			std::swap(pending.back().sides, right.sides);
+			pending.back().parent = branchNum;
+			pending.back().isLeft = false;
+		}
+		if (!left.sides.empty())
+		{
+			pending.push_back(Branch());
+			std::swap(pending.back().sides, left.sides);
+			pending.back().parent = branchNum;
+			pending.back().isLeft = true;
+		}
+		MySpinCursor(); // JLM 8/4/99
 	}
 	
+	dagTree->treeHdl = (DAG**)_NewHandle(nodes.size()*sizeof(DAG));
+	if (!dagTree->treeHdl) {strcpy(errStr,"Out of memory in MakeDagTree"); return memFullErr;}
+	memcpy(*dagTree->treeHdl, &nodes[0], nodes.size()*sizeof(DAG));
+	dagTree->numBranches = nodes.size();
+	return noErr;
+}
+
+DAGTreeStruct  MakeDagTree(TopologyHdl topoHdl, LongPoint **pointList, char *errStr)
+{
+	Side_List **sidesList = 0;
+	DAGTreeStruct  dagTree;
+	long numSidesInList;		
 	
-// trim sidesL and sidesR to numSidesL and numSidesR, respectively
-	_SetHandleSize((Handle)sidesLeftH,(numSidesL)*sizeof(Side_List));
-	_SetHandleSize((Handle)sidesRightH,(numSidesR)*sizeof(Side_List));
-	
-	sideListForNode = (*sideListH)[nodeNum];
-	
-	// Left Hand Side
-	if (numSidesL ==0) {
-		(*gDagTree.treeHdl)[branchNum].branchLeft = -8;
-		// Fake a split
-		if (sideListForNode.triLeft == -1) 
-		{
-			strcpy(gErrStr,"Boundary not set up correctly - outside is on LHS");
-			goto done;
-		}
+	strcpy(errStr,"");
+	dagTree.treeHdl = 0;
+	dagTree.numBranches = 0;
+	sidesList=BuildSideList(topoHdl, errStr);
 
+	//input checking
+	if(sidesList == nil) 
+	{ 
+		strcpy(errStr,"sideList is nil in MakeDagTree");
+		goto done;
 	}
-	else {
-	// fTreeH in GNOME (a DAGHdl), member of fDagTree (part of GridVel, owned by the mover)
-		(*gDagTree.treeHdl)[branchNum].branchLeft = gDagTree.numBranches;
-		if(gErrStr[0]) goto done;
-		// set call for correct area for sides
-		nodeNum = newNodexx(sidesLeftH);
-		MySpinCursor(); // JLM 8/4/99
-		split(sidesLeftH,nodeNum); 			// recursively for LHS
-		//sidesLeftH = nil; // split disposed of this hdl
+	
+	numSidesInList = (_GetHandleSize((Handle)sidesList))/(sizeof(Side_List));
+	if (numSidesInList < 3)
+	{
+		sprintf(errStr,"Triangles have 3 sides; the data has only %ld sides.", numSidesInList);
+		goto done;
 	}
 
-
-	// Right Hand Side
-	if (numSidesR == 0) 
+	try
 	{
-		// Fake a split
-		(*gDagTree.treeHdl)[branchNum].branchRight = -8;  // place holder for steps in dag to all tri
+		DagTreeBuilder builder(sidesList, pointList);
+		builder.Build(&dagTree, errStr);
 	}
-	else 
+	catch (...)
 	{
-		(*gDagTree.treeHdl)[branchNum].branchRight = gDagTree.numBranches;
-		if(gErrStr[0]) goto done;
-		// set call for correct area for sides
-		nodeNum = newNodexx(sidesRightH);
-		split(sidesRightH,nodeNum); 			// recursively for RHS
-		//sidesRightH = nil; // split disposed of this hdl
+		if(dagTree.treeHdl) DisposeHandle((Handle) dagTree.treeHdl);
+		dagTree.treeHdl = nil;
+		dagTree.numBranches = 0;
+		strcpy(errStr,"Out of memory in MakeDagTree");
 	}
 	
 done:
-
-	if(sidesRightH) DisposeHandle((Handle) sidesRightH);
-	sidesRightH = nil;
-	if(sidesLeftH) DisposeHandle((Handle) sidesLeftH);
-	sidesLeftH = nil;
-	
-	return;
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////////////
-// 																								//
-// Right_or_Left decides if a segment is to the right or left									//
-//		of a reference segment, or is neither.													//
-//																								//
-//	Given: ref_seg_pt1, ref_seg_pt2, test_seg_pt1, test_seg_pt2									//
-//	Return:																						//
-//			location																			//
-//				+1 = Right means the entire segment is to the right of the reference			//
-//				0  = Neither.  The segment is either along a line created by extending			//
-//							the reference segment infinitely OR the segment intersects a 		//
-//							line created by extending the reference segment infinitely			//
-//				-1 = Left means the entire segment is to the left of the reference				//
-//			NOTE: A Segment that has only one point on the line created by extending			//
-//							the reference segment infinitely will be determined as right		//
-//							or left, not both													//
-// 																								//
-//////////////////////////////////////////////////////////////////////////////////////////////////
-int	Right_or_Left(long ref_p1,long ref_p2, long test_seg_p1, long test_seg_p2)
-{
-	//long ref_p1_h, ref_p1_v, ref_p2_h, ref_p2_v;	
-	//long test_p1_h, test_p1_v, test_p2_h, test_p2_v;	
-													
-	double ref_h, ref_v;								
-	double test1_h, test1_v;							
-	double test2_h, test2_v;							
-	
-	double cp_1;						
-	double cp_2;						
-	int location;
-
-
-	ref_h = ((*gCoord)[ref_p2].pLong - (*gCoord)[ref_p1].pLong);	
-	ref_v = ((*gCoord)[ref_p2].pLat - (*gCoord)[ref_p1].pLat);
-	test1_h = ((*gCoord)[test_seg_p1].pLong - (*gCoord)[ref_p1].pLong);
-	test1_v = ((*gCoord)[test_seg_p1].pLat - (*gCoord)[ref_p1].pLat);
-	test2_h = ((*gCoord)[test_seg_p2].pLong - (*gCoord)[ref_p1].pLong);
-	test2_v = ((*gCoord)[test_seg_p2].pLat - (*gCoord)[ref_p1].pLat);
-	
-	cp_1 = test1_h* ref_v - test1_v * ref_h;
-	cp_2 = test2_h* ref_v - test2_v * ref_h;
-	
-	//Test for segments that share one point
-	if (ref_p1 == test_seg_p1)
-		cp_1 = 0.;
-	else if (ref_p1 == test_seg_p2)
-		cp_2 = 0.;
-		
-	if (ref_p2 == test_seg_p1)
-		cp_1 = 0.;
-	else if (ref_p2 == test_seg_p2)
-		cp_2 = 0.;
-
-	// decide right, left or neither
-	if (cp_1 > 0.)
-		{
-		if (cp_2 >= 0.) location=1;
-		else if (cp_2 < 0.) location=0;
-		}
-	else if (cp_1 == 0.)
-		{
-		if (cp_2 > 0.) location=1;
-		else if (cp_2 == 0.)  location = 0.;
-		// This could mean that the segments are the same.....
-		else if (cp_2 < 0.) location=-1;
-		}	
-	else if (cp_1 < 0.)
-		{
-		if (cp_2 > 0.) location = 0;
-		else if (cp_2 <= 0.) location=-1;
-		}
-
-	return (location);
+	if(sidesList)
+	{
+		{DisposeHandle((Handle)sidesList);sidesList=0;}
+	}
+	return dagTree;
 }
-////////////////////////////////////////////////////////////////////////
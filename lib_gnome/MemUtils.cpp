@@ -10,6 +10,9 @@
 #include "TypeDefs.h"
 #include "MemUtils.h"
 
+#include <mutex>
+#include <vector>
+
 
 #ifndef hubris
 
@@ -37,6 +40,9 @@ static OSErr memoryError = 0;
 static Ptr *masterPointers = 0;
 static Handle freeMasterPointers[10];
 
+// handles can be made and disposed of from the time slice prefetch thread
+static std::mutex masterPointersMutex;
+
 
 
 void _MyHLock(Handle h)
@@ -76,28 +82,224 @@ void _DeleteAllHandles()
 	_DisposePtr((Ptr)masterPointers);
 }
 
-Ptr _NewPtr(long size)
+///// POOLED BLOCKS /////////////////////////
+
+// Pointer and handle data comes in size classes, powers of two from 32 bytes
+// to 1 MB. A freed block goes on the free list of its class and is handed
+// out again, and the small classes are carved out of 64 KB chunks. A block
+// can grow in place while it still fits its class, so resizing a handle in
+// the step loop is usually free. Bigger blocks come straight from the heap.
+//
+// The header puts the size last, just before the data, where _GetPtrSize
+// has always found it.
+
+typedef struct {
+	int		sizeClass;		// -1 if the block came straight from the heap
+	int		chunkIndex;		// -1 if the block is not in a chunk
+	long	size;
+} BlockHeader;
+
+typedef struct {
+	char	*memory;		// 0 once the chunk has been freed
+	long	used;			// bytes carved off so far
+	long	numLive;		// blocks handed out and not freed
+} PoolChunk;
+
+static const int kNumSizeClasses = 16;
+static const long kSmallestBlock = 32;
+static const long kChunkSize = 64 * 1024;
+static const long kLargestChunkedBlock = 4096;
+
+static std::mutex poolMutex;
+static Boolean poolEnabled = true;
+static std::vector<Ptr> freeBlocks[kNumSizeClasses];
+static std::vector<PoolChunk> chunks;
+static long carvingChunk[kNumSizeClasses];	// chunk index + 1, 0 for none
+static HandlePoolStats poolStats;
+
+static BlockHeader *GetBlockHeader(Ptr p)
 {
-	memoryError = 0;
+	return (BlockHeader *)(p - sizeof(BlockHeader));
+}
+
+static long GetBlockCapacity(BlockHeader *header)
+{
+	return header->sizeClass < 0 ? header->size : kSmallestBlock << header->sizeClass;
+}
+
+static int GetSizeClass(long size)
+{
+	int sizeClass = 0;
+
+	if (!poolEnabled || size > kSmallestBlock << (kNumSizeClasses - 1))
+		return -1;
+
+	while ((kSmallestBlock << sizeClass) < size)
+		sizeClass++;
+
+	return sizeClass;
+}
+
+// caller holds poolMutex, throws if the heap is out of memory
+static Ptr AllocateBlock(long size)
+{
+	int sizeClass = GetSizeClass(size);
+	long capacity = sizeClass < 0 ? size : kSmallestBlock << sizeClass;
+	long blockSize = capacity + sizeof(BlockHeader);
+	int chunkIndex = -1;
+	char *block;
 	Ptr p;
 
-	try {
-		p = new char[size + sizeof(long)]();
-	}
-	catch(...) {
-		memoryError = -1; 
-		return 0; 
+	if (sizeClass >= 0 && !freeBlocks[sizeClass].empty()) {
+		p = freeBlocks[sizeClass].back();
+		freeBlocks[sizeClass].pop_back();
+		chunkIndex = GetBlockHeader(p)->chunkIndex;
+		if (chunkIndex >= 0)
+			chunks[chunkIndex].numLive++;
+		poolStats.numReused++;
+		block = p - sizeof(BlockHeader);
 	}
+	else if (sizeClass >= 0 && blockSize <= kLargestChunkedBlock) {
+		chunkIndex = carvingChunk[sizeClass] - 1;
+		if (chunkIndex < 0 || chunks[chunkIndex].used + blockSize > kChunkSize) {
+			PoolChunk chunk = {new char[kChunkSize], 0, 0};
+
+			for (chunkIndex = 0; chunkIndex < (long)chunks.size(); chunkIndex++)
+				if (!chunks[chunkIndex].memory)
+					break;
+			if (chunkIndex == (long)chunks.size())
+				chunks.push_back(chunk);
+			else
+				chunks[chunkIndex] = chunk;
 
-	((long *)p)[0] = size;
+			carvingChunk[sizeClass] = chunkIndex + 1;
+			poolStats.numSystemAllocations++;
+			poolStats.bytesReserved += kChunkSize;
+		}
+		block = chunks[chunkIndex].memory + chunks[chunkIndex].used;
+		chunks[chunkIndex].used += blockSize;
+		chunks[chunkIndex].numLive++;
+	}
+	else {
+		block = new char[blockSize];
+		poolStats.numSystemAllocations++;
+		poolStats.bytesReserved += blockSize;
+	}
 
-	p += sizeof(long);
+	BlockHeader *header = (BlockHeader *)block;
+	header->sizeClass = sizeClass;
+	header->chunkIndex = chunkIndex;
+	header->size = size;
 
+	p = block + sizeof(BlockHeader);
 	memset(p, 0, size);
 
+	poolStats.numAllocations++;
+	poolStats.bytesInUse += size;
 	_handleCount++;
-	
-	return(p);
+
+	return p;
+}
+
+// caller holds poolMutex
+static void FreeBlock(Ptr p)
+{
+	BlockHeader *header = GetBlockHeader(p);
+
+	poolStats.numFrees++;
+	poolStats.bytesInUse -= header->size;
+	_handleCount--;
+
+	if (header->sizeClass < 0) {
+		poolStats.bytesReserved -= header->size + sizeof(BlockHeader);
+		delete[] (char *)header;
+		return;
+	}
+
+	if (header->chunkIndex >= 0)
+		chunks[header->chunkIndex].numLive--;
+	freeBlocks[header->sizeClass].push_back(p);
+}
+
+void _SetHandlePoolEnabled(Boolean enabled)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	poolEnabled = enabled;
+}
+
+Boolean _GetHandlePoolEnabled()
+{
+	return poolEnabled;
+}
+
+void _TrimHandlePool()
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	for (int sizeClass = 0; sizeClass < kNumSizeClasses; sizeClass++) {
+		std::vector<Ptr> keep;
+
+		for (size_t i = 0; i < freeBlocks[sizeClass].size(); i++) {
+			Ptr p = freeBlocks[sizeClass][i];
+			BlockHeader *header = GetBlockHeader(p);
+
+			if (header->chunkIndex >= 0) {
+				// the block goes with its chunk if that is freed below
+				if (chunks[header->chunkIndex].numLive > 0)
+					keep.push_back(p);
+			}
+			else {
+				poolStats.bytesReserved -= GetBlockCapacity(header) + sizeof(BlockHeader);
+				delete[] (char *)header;
+			}
+		}
+		freeBlocks[sizeClass].swap(keep);
+	}
+
+	for (size_t i = 0; i < chunks.size(); i++) {
+		if (chunks[i].memory && chunks[i].numLive == 0) {
+			delete[] chunks[i].memory;
+			chunks[i].memory = 0;
+			chunks[i].used = 0;
+			poolStats.bytesReserved -= kChunkSize;
+		}
+	}
+
+	for (int sizeClass = 0; sizeClass < kNumSizeClasses; sizeClass++)
+		if (carvingChunk[sizeClass] > 0 && !chunks[carvingChunk[sizeClass] - 1].memory)
+			carvingChunk[sizeClass] = 0;
+}
+
+void _GetHandlePoolStats(HandlePoolStats *stats)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	*stats = poolStats;
+}
+
+// the byte counts describe the pool as it is, so they are kept
+void _ResetHandlePoolStats()
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	poolStats.numAllocations = poolStats.numFrees = 0;
+	poolStats.numResizes = poolStats.numResizesInPlace = 0;
+	poolStats.numReused = poolStats.numSystemAllocations = 0;
+}
+
+Ptr _NewPtr(long size)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	memoryError = 0;
+
+	try {
+		return AllocateBlock(size);
+	}
+	catch(...) {
+		memoryError = -1; 
+		return 0; 
+	}
 }
 
 
@@ -111,62 +313,56 @@ long _GetPtrSize(Ptr p)
 	return ((long *)(p - sizeof(long)))[0];
 }
 
-// ok this is a bit tricky
-// these memory pointers are managed as
-// a (sort of)struct of the type
-//    struct Data {
-//	    long size;
-//	    char data[];
-//    };
-// and this function manages the resizing of
-// the data *and* the value which reports the
-// size.
-//
-// Basically any pointer p passed in is assumed to
-// be immediately preceded in memory by a long
-// value representing the size of allocated memory.
+// Resizes the data *and* the size stored just before it. A block that
+// still fits its size class keeps its place, the bytes it gains are
+// cleared as a new pointer's would be. Otherwise the data moves to a new
+// block and the old one is freed.
 Ptr _SetPtrSize(Ptr p, long newSize)
 {
-	Ptr p2 = 0;
+	std::lock_guard<std::mutex> lock(poolMutex);
 	memoryError = 0;
 
-	if (p > (Ptr)sizeof(long)) {
-		// we have a valid buffer coming in
-		try {
-			long *currentSize = (long *)(p - sizeof(long));
+	if (p <= (Ptr)sizeof(BlockHeader)) {
+		memoryError = -1;
+		return p;
+	}
 
-			p2 = new char[newSize + sizeof(long)]();
+	BlockHeader *header = GetBlockHeader(p);
+	long size = header->size;
 
-			((long *)p2)[0] = newSize;
+	poolStats.numResizes++;
 
-			if (newSize < currentSize[0])
-				memmove(p2 + sizeof(long), p, newSize);
-			else
-				memmove(p2 + sizeof(long), p, *currentSize);
+	if (header->sizeClass >= 0 && newSize <= GetBlockCapacity(header)) {
+		if (newSize > size)
+			memset(p + size, 0, newSize - size);
+		header->size = newSize;
+		poolStats.bytesInUse += newSize - size;
+		poolStats.numResizesInPlace++;
+		return p;
+	}
 
-			// this seems a bit brittle, but...ok.
-			p -= sizeof(long);
-			delete[] p;
-		}
-		catch(...) {
-			memoryError = -1;
-			return p;
-		}
+	try {
+		Ptr p2 = AllocateBlock(newSize);
+
+		memmove(p2, p, newSize < size ? newSize : size);
+		FreeBlock(p);
+
+		// a resize is not a new pointer
+		poolStats.numAllocations--;
+		poolStats.numFrees--;
+		return p2;
 	}
-	else {
+	catch(...) {
 		memoryError = -1;
 		return p;
 	}
-
-	return (p2 + sizeof(long));
 }
 
 void _DisposePtr(Ptr p)
 {
-	if ((size_t)p > sizeof(long)) {
-		p -= sizeof(long);
-		delete[] p;
-		_handleCount--;
+	if ((size_t)p > sizeof(BlockHeader)) {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		FreeBlock(p);
 	}
 	else {
 		printf("_DisposePtr(): Warning: trying to dispose an invalid pointer(%lX)", (size_t)p);
@@ -182,6 +378,7 @@ Handle _NewHandle(long size)
 {
 	Ptr p;
 	Handle h = 0;
+	std::lock_guard<std::mutex> lock(masterPointersMutex);
 	
 	// look for a free space
 	for (long i = 0; i < 10; i++)
@@ -260,6 +457,7 @@ Handle _TempNewHandle(long size, LONGPTR err)
 Handle _RecoverHandle(Ptr p)
 {
 	long i;
+	std::lock_guard<std::mutex> lock(masterPointersMutex);
 	
 	memoryError = 0;
 	
@@ -312,6 +510,7 @@ long _GetHandleSize(Handle h)
 void _DisposeHandleReally(Handle h)
 {
 	short i;
+	std::lock_guard<std::mutex> lock(masterPointersMutex);
 	
 	_DisposePtr(*h);
 	
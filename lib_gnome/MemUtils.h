@@ -92,6 +92,26 @@ void _DisposeHandleReally(Handle p);
 #define _ZeroHandleError ZeroHandleError
 #endif
 
+// Counters for the pooled memory behind _NewPtr and _NewHandle.
+typedef struct {
+	long	numAllocations;			// pointers and handles made
+	long	numFrees;
+	long	numResizes;
+	long	numResizesInPlace;		// resizes that still fit the block they had
+	long	numReused;				// allocations served from a free list
+	long	numSystemAllocations;	// chunks and blocks taken from the heap
+	double	bytesInUse;				// as asked for by the callers
+	double	bytesReserved;			// held by the pool, in use or free
+} HandlePoolStats;
+
+#ifndef hubris
+DLL_API void _SetHandlePoolEnabled(Boolean enabled);	// off, new blocks come straight from the heap
+DLL_API Boolean _GetHandlePoolEnabled();
+DLL_API void _TrimHandlePool();		// frees the free blocks and every chunk with nothing left in use
+DLL_API void _GetHandlePoolStats(HandlePoolStats *stats);
+DLL_API void _ResetHandlePoolStats();
+#endif
+
 long GetNumDoubleHdlItems(DOUBLEH h);
 long GetNumHandleItems(Handle h, long itemSize);
 
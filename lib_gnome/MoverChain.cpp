@@ -0,0 +1,121 @@
+/*
+ *  MoverChain.cpp
+ *  gnome
+ *
+ */
+
+#include <mutex>
+
+#include "MoverChain.h"
+#include "ForEachLE.h"
+
+using std::lock_guard;
+using std::mutex;
+
+OSErr MoverChain::PrepareForModelStep(const Seconds &model_time, const Seconds &step_len, bool uncertain, int numLESets, int *LESetsSizesList)
+{
+	OSErr err = noErr;
+
+	for (size_t m = 0; m < fMovers.size() && !err; m++)
+		err = fMovers[m]->PrepareForModelStep(model_time, step_len, uncertain, numLESets, LESetsSizesList);
+
+	return err;
+}
+
+Boolean MoverChain::CanMoveBlocksInParallel(LEType spillType) const
+{
+	if (!fBlocksInParallel)
+		return false;
+
+	for (size_t m = 0; m < fMovers.size(); m++)
+	{
+		if (!fMovers[m]->CanMoveLEsInParallel(spillType) || fMovers[m]->GetNumThreads() > 1)
+			return false;
+	}
+	return true;
+}
+
+// moves blocks firstBlock up to lastBlock, each by every mover in turn
+OSErr MoverChain::MoveBlocks(const LEBlock &les, long firstBlock, long lastBlock, Seconds model_time, Seconds step_len,
+							 WorldPoint3D *nextPositions, LEType spillType, long spill_ID) const
+{
+	long n = les.GetNumLEs();
+	std::vector<WorldPoint3D> blockDelta;
+	OSErr err = noErr;
+
+	try
+	{
+		blockDelta.resize(kMoverChainBlockLEs);
+	}
+	catch (...)
+	{
+		return memFullErr;
+	}
+
+	for (long b = firstBlock; b < lastBlock; b++)
+	{
+		long first = b * kMoverChainBlockLEs;
+		long count = _min(kMoverChainBlockLEs, n - first);
+		LEBlock block = les.GetSubBlock(first, count);
+		WorldPoint3D *next = nextPositions + first;
+
+		for (size_t m = 0; m < fMovers.size(); m++)
+		{
+			err = fMovers[m]->GetMoves(block, model_time, step_len, &blockDelta[0], spillType, spill_ID);
+			if (err) return err;
+
+			for (long i = 0; i < count; i++)
+			{
+				next[i].p.pLong += blockDelta[i].p.pLong;
+				next[i].p.pLat += blockDelta[i].p.pLat;
+				next[i].z += blockDelta[i].z;
+			}
+		}
+	}
+	return noErr;
+}
+
+OSErr MoverChain::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *nextPositions, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs(), numBlocks;
+	OSErr err = noErr;
+	mutex errMutex;
+
+	if (n <= 0 || fMovers.empty())
+		return noErr;
+
+	numBlocks = (n + kMoverChainBlockLEs - 1) / kMoverChainBlockLEs;
+	err = MoveBlocks(les, 0, 1, model_time, step_len, nextPositions, spillType, spill_ID);
+	if (err || numBlocks == 1)
+		return err;
+
+	if (!CanMoveBlocksInParallel(spillType))
+		return MoveBlocks(les, 1, numBlocks, model_time, step_len, nextPositions, spillType, spill_ID);
+
+	ForEachLE(numBlocks - 1, [&](long first, long last)
+	{
+		OSErr blockErr = MoveBlocks(les, first + 1, last + 1, model_time, step_len, nextPositions, spillType, spill_ID);
+
+		if (blockErr)
+		{
+			lock_guard<mutex> lock(errMutex);
+			if (!err) err = blockErr;
+		}
+	}, kMinLEsPerThread / kMoverChainBlockLEs);
+	return err;
+}
+
+OSErr MoverChain::get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D *ref, WorldPoint3D *nextPositions,
+						   double *windages, double *riseVelocities, short *LE_status, LEType spillType, long spill_ID)
+{
+	if (!ref || !nextPositions || !LE_status)
+		return 1;
+
+	if (spillType < FORECAST_LE || spillType > UNCERTAINTY_LE)
+		return 2;
+
+	LEBlock les(n, ref, LE_status);
+	if (windages) les.SetWindages(windages);
+	if (riseVelocities) les.SetRiseVelocities(riseVelocities);
+	return GetMoves(les, model_time, step_len, nextPositions, spillType, spill_ID);
+}
@@ -0,0 +1,63 @@
+/*
+ *  MoverChain.h
+ *  gnome
+ *
+ *  The movers of a model run as one. Rather than each mover making a pass
+ *  over all the LEs and handing back its own array of deltas, the chain
+ *  goes through the LEs a block at a time, has every mover move the block
+ *  and adds the moves into the next positions while the block is still in
+ *  the cache. The moves are added in mover order, so the next positions
+ *  come out the same as adding each mover's deltas to them in turn.
+ *
+ *  Each block is moved by one thread, mover after mover. The first block
+ *  of a call is moved on its own, so the movers set up whatever they keep
+ *  for the step, then the other blocks are split across threads if all the
+ *  movers can move LEs in parallel and none has threads of its own to
+ *  split them across.
+ *
+ *  The chain doesn't own its movers.
+ *
+ */
+
+#ifndef __MoverChain__
+#define __MoverChain__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "Mover_c.h"
+#include "ExportSymbols.h"
+
+const long kMoverChainBlockLEs = 4096;
+
+class DLL_API MoverChain {
+
+public:
+	MoverChain() : fBlocksInParallel(true) {}
+
+	void		AddMover(Mover_c *mover) {fMovers.push_back(mover);}
+	void		ClearMovers() {fMovers.clear();}
+	long		GetNumMovers() const {return fMovers.size();}
+	// off when the caller already runs chains on several threads
+	void		SetBlocksInParallel(Boolean inParallel) {fBlocksInParallel = inParallel;}
+	Boolean		GetBlocksInParallel() const {return fBlocksInParallel;}
+
+	OSErr		PrepareForModelStep(const Seconds &model_time, const Seconds &step_len, bool uncertain, int numLESets, int *LESetsSizesList);
+
+	// adds every mover's move for the LEs to nextPositions, in degrees
+	OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *nextPositions, LEType spillType, long spill_ID);
+	// windages and riseVelocities may be 0 when none of the movers use them
+	OSErr		get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D *ref, WorldPoint3D *nextPositions,
+						 double *windages, double *riseVelocities, short *LE_status, LEType spillType, long spill_ID);
+
+private:
+	std::vector<Mover_c*>		fMovers;
+	Boolean						fBlocksInParallel;
+
+	Boolean		CanMoveBlocksInParallel(LEType spillType) const;
+	OSErr		MoveBlocks(const LEBlock &les, long firstBlock, long lastBlock, Seconds model_time, Seconds step_len,
+						   WorldPoint3D *nextPositions, LEType spillType, long spill_ID) const;
+};
+
+#endif
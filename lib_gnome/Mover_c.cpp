@@ -25,6 +25,9 @@ Mover_c::Mover_c(TMap *owner, char *name)
 	fUncertainStartTime = 0;
 	fDuration = 0; // JLM 9/18/98
 	fTimeUncertaintyWasSet = 0;// JLM 9/18/98
+	fNumThreads = 1;
+	fRandomSeed = 1;
+	fRandomStream = 0;
 	//fColor = colors[PURPLE];	// default to draw arrows in purple
 }
 #endif
@@ -36,6 +39,9 @@ Mover_c::Mover_c()
 	fUncertainStartTime = 0;
 	fDuration = 0; // JLM 9/18/98
 	fTimeUncertaintyWasSet = 0;// JLM 9/18/98
+	fNumThreads = 1;
+	fRandomSeed = 1;
+	fRandomStream = 0;
 }
 
 
@@ -60,4 +66,27 @@ WorldPoint3D Mover_c::GetMove (const Seconds& model_time, Seconds timeStep,long
 	return theLE3D;
 }
 
+// movers that can do better than one GetMove per LE override this
+OSErr Mover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	WorldPoint3D zero_delta = {{0,0},0.};
+	LERec rec;
+
+	for (long i = 0; i < les.GetNumLEs(); i++)
+	{
+		if (!les.IsInWater(i))
+		{
+			delta[i] = zero_delta;
+			continue;
+		}
+		les.GetLE(i, &rec);
+
+		delta[i] = this->GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
+
+		delta[i].p.pLat /= 1000000;
+		delta[i].p.pLong /= 1000000;
+	}
+	return noErr;
+}
+
 //#undef TMap
\ No newline at end of file
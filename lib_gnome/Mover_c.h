@@ -14,6 +14,7 @@
 #include "TypeDefs.h"
 #include "ClassID_c.h"
 #include "RectUtils.h"
+#include "LEBlock.h"
 //#include "Map_c.h"
 #include "ExportSymbols.h"
 
@@ -25,6 +26,8 @@
 class TMap;
 #endif
 
+class UncertaintyArrays;
+
 class DLL_API Mover_c : virtual public ClassID_c {
 
 public:
@@ -33,6 +36,9 @@ public:
 #endif
 	Seconds				fUncertainStartTime;
 	double				fDuration; 				// duration time for uncertainty;
+	long				fNumThreads;			// threads get_move may split the LEs across, 1 is serial
+	unsigned long		fRandomSeed;			// key for the CounterRandom draws of this mover
+	unsigned long		fRandomStream;			// set by the caller, so two movers of a type with one seed draw apart
 	//RGBColor			fColor;
 	
 protected:
@@ -46,8 +52,19 @@ public:
 	virtual				~Mover_c();
 	virtual void		Dispose () {}
 
+	// the CounterRandom stream of this mover's draws of one kind (kRandomMoverDraws etc.),
+	// movers of different types draw apart whatever their fRandomStream
+	unsigned long		GetRandomStream(long drawKind) const { return (fRandomStream << 4) | (drawKind & 0xF); }
+
 	virtual OSErr		AddUncertainty (long setIndex, long leIndex, VelocityRec *v) { return 0; }
+	// the per LE uncertainty factors, 0 for movers without them or before they are allocated
+	virtual const UncertaintyArrays *GetUncertainty() const { return 0; }
 	virtual WorldPoint3D       GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *theLE,LETYPE leType); 
+	// deltas in degrees for a block of LEs, LEs that are not in the water do not move
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	// true when, once a step's first GetMoves has returned, GetMoves may be called
+	// for different LEs of the spill at the same time
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return false; }
 	
 	virtual Boolean		VelocityStrAtPoint(WorldPoint3D wp, char *velStr) {return false;}
 	virtual float		GetArrowDepth(){return 0.;}
@@ -65,6 +82,11 @@ public:
 	virtual void 		ModelStepIsDone(){ return; }
 	virtual OSErr 		ReallocateUncertainty(int numLEs, short* LE_Status){ return 0; }
 	virtual Boolean		IAmA3DMover() {return false;}
+	// a new mover for another member of an ensemble, sharing this one's read only
+	// data, with its own uncertainty and random draws; 0 if the mover can't share
+	virtual Mover_c		*NewEnsembleMember(unsigned long randomSeed) { return 0; }
+	void				SetNumThreads(long numThreads) { fNumThreads = numThreads > 1 ? numThreads : 1; }
+	long				GetNumThreads() { return fNumThreads; }
 	//virtual ClassID 	GetClassID () { return TYPE_MOVER; }
 	//virtual Boolean		IAm(ClassID id) { if(id==TYPE_MOVER) return TRUE; return ClassID_c::IAm(id); }
 	
@@ -0,0 +1,273 @@
+/*
+ *  NetCDFFilePool.cpp
+ *  gnome
+ *
+ */
+
+#include <list>
+#include <map>
+#include <utility>
+
+#include "NetCDFFilePool.h"
+#include "netcdf.h"
+
+using namespace std;
+
+typedef pair<int, int> StatusAndId;		// a failed lookup is remembered as well, readers probe for optional names
+typedef pair<int, string> VarAndName;
+
+struct NetCDFFilePool::OpenFile {
+	string	path;
+	int		ncid;
+
+	StatusAndId							numDims;
+	map<string, StatusAndId>			dimIDs;
+	map<string, StatusAndId>			varIDs;
+	map<int, StatusAndId>				varNumDims;
+	map<VarAndName, pair<int, double> >	doubleAtts;
+	map<VarAndName, pair<int, float> >	floatAtts;
+	map<VarAndName, pair<int, string> >	textAtts;
+};
+
+// most recently used file at the front
+struct NetCDFFilePool::OpenFiles {
+	list<OpenFile>	files;
+};
+
+NetCDFFilePool::NetCDFFilePool(long maxOpenFiles)
+{
+	fMaxOpenFiles = maxOpenFiles < 1 ? 1 : maxOpenFiles;
+	fFiles = new OpenFiles;
+}
+
+NetCDFFilePool::~NetCDFFilePool()
+{
+	CloseAll();
+	delete fFiles;
+}
+
+void NetCDFFilePool::SetMaxOpenFiles(long maxOpenFiles)
+{
+	fMaxOpenFiles = maxOpenFiles < 1 ? 1 : maxOpenFiles;
+	CloseLeastRecent(fMaxOpenFiles);
+}
+
+void NetCDFFilePool::CloseLeastRecent(long numToKeep)
+{
+	while ((long)fFiles->files.size() > numToKeep)
+	{
+		nc_close(fFiles->files.back().ncid);
+		fFiles->files.pop_back();
+	}
+}
+
+long NetCDFFilePool::GetNumOpenFiles()
+{
+	return fFiles->files.size();
+}
+
+int NetCDFFilePool::Open(const char *path, int *ncid)
+{
+	int status;
+	list<OpenFile>::iterator it;
+
+	for (it = fFiles->files.begin(); it != fFiles->files.end(); it++)
+	{
+		if (it->path == path)
+		{
+			fFiles->files.splice(fFiles->files.begin(), fFiles->files, it);
+			*ncid = it->ncid;
+			return NC_NOERR;
+		}
+	}
+
+	status = nc_open(path, NC_NOWRITE, ncid);
+	if (status != NC_NOERR)
+		return status;
+
+	CloseLeastRecent(fMaxOpenFiles - 1);	// make room
+
+	fFiles->files.push_front(OpenFile());
+	fFiles->files.front().path = path;
+	fFiles->files.front().ncid = *ncid;
+	fFiles->files.front().numDims = StatusAndId(NC_EBADID, 0);
+	return NC_NOERR;
+}
+
+void NetCDFFilePool::Close(const char *path)
+{
+	list<OpenFile>::iterator it;
+
+	for (it = fFiles->files.begin(); it != fFiles->files.end(); it++)
+	{
+		if (it->path == path)
+		{
+			nc_close(it->ncid);
+			fFiles->files.erase(it);
+			return;
+		}
+	}
+}
+
+void NetCDFFilePool::CloseAll()
+{
+	CloseLeastRecent(0);
+}
+
+NetCDFFilePool::OpenFile *NetCDFFilePool::Find(int ncid)
+{
+	list<OpenFile>::iterator it;
+
+	for (it = fFiles->files.begin(); it != fFiles->files.end(); it++)
+	{
+		if (it->ncid == ncid)
+			return &*it;
+	}
+	return 0;
+}
+
+int NetCDFFilePool::InqNDims(int ncid, int *ndims)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_inq_ndims(ncid, ndims);
+
+	if (file->numDims.first != NC_NOERR)
+		file->numDims.first = nc_inq_ndims(ncid, &file->numDims.second);
+	*ndims = file->numDims.second;
+	return file->numDims.first;
+}
+
+int NetCDFFilePool::InqDimID(int ncid, const char *name, int *dimid)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_inq_dimid(ncid, name, dimid);
+
+	map<string, StatusAndId>::iterator found = file->dimIDs.find(name);
+	if (found == file->dimIDs.end())
+	{
+		StatusAndId result;
+		result.first = nc_inq_dimid(ncid, name, &result.second);
+		found = file->dimIDs.insert(make_pair(string(name), result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*dimid = found->second.second;
+	return found->second.first;
+}
+
+int NetCDFFilePool::InqVarID(int ncid, const char *name, int *varid)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_inq_varid(ncid, name, varid);
+
+	map<string, StatusAndId>::iterator found = file->varIDs.find(name);
+	if (found == file->varIDs.end())
+	{
+		StatusAndId result;
+		result.first = nc_inq_varid(ncid, name, &result.second);
+		found = file->varIDs.insert(make_pair(string(name), result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*varid = found->second.second;
+	return found->second.first;
+}
+
+int NetCDFFilePool::InqVarNDims(int ncid, int varid, int *ndims)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_inq_varndims(ncid, varid, ndims);
+
+	map<int, StatusAndId>::iterator found = file->varNumDims.find(varid);
+	if (found == file->varNumDims.end())
+	{
+		StatusAndId result;
+		result.first = nc_inq_varndims(ncid, varid, &result.second);
+		found = file->varNumDims.insert(make_pair(varid, result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*ndims = found->second.second;
+	return found->second.first;
+}
+
+int NetCDFFilePool::GetAttDouble(int ncid, int varid, const char *name, double *value)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_get_att_double(ncid, varid, name, value);
+
+	VarAndName key(varid, name);
+	map<VarAndName, pair<int, double> >::iterator found = file->doubleAtts.find(key);
+	if (found == file->doubleAtts.end())
+	{
+		pair<int, double> result(0, 0.);
+		result.first = nc_get_att_double(ncid, varid, name, &result.second);
+		found = file->doubleAtts.insert(make_pair(key, result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*value = found->second.second;
+	return found->second.first;
+}
+
+int NetCDFFilePool::GetAttFloat(int ncid, int varid, const char *name, float *value)
+{
+	OpenFile *file = Find(ncid);
+
+	if (!file)
+		return nc_get_att_float(ncid, varid, name, value);
+
+	VarAndName key(varid, name);
+	map<VarAndName, pair<int, float> >::iterator found = file->floatAtts.find(key);
+	if (found == file->floatAtts.end())
+	{
+		pair<int, float> result(0, 0.f);
+		result.first = nc_get_att_float(ncid, varid, name, &result.second);
+		found = file->floatAtts.insert(make_pair(key, result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*value = found->second.second;
+	return found->second.first;
+}
+
+int NetCDFFilePool::GetAttText(int ncid, int varid, const char *name, string *value)
+{
+	OpenFile *file = Find(ncid);
+	VarAndName key(varid, name);
+	map<VarAndName, pair<int, string> >::iterator found;
+
+	if (file)
+		found = file->textAtts.find(key);
+
+	if (!file || found == file->textAtts.end())
+	{
+		pair<int, string> result(0, string());
+		size_t len = 0;
+
+		result.first = nc_inq_attlen(ncid, varid, name, &len);
+		if (result.first == NC_NOERR)
+		{
+			char *text = new char[len + 1];
+			result.first = nc_get_att_text(ncid, varid, name, text);
+			text[len] = '\0';
+			result.second = text;
+			delete [] text;
+		}
+		if (!file)
+		{
+			if (result.first == NC_NOERR)
+				*value = result.second;
+			return result.first;
+		}
+		found = file->textAtts.insert(make_pair(key, result)).first;
+	}
+	if (found->second.first == NC_NOERR)
+		*value = found->second.second;
+	return found->second.first;
+}
@@ -0,0 +1,56 @@
+/*
+ *  NetCDFFilePool.h
+ *  gnome
+ *
+ *  Keeps the NetCDF files a grid reads its time slices from open between
+ *  reads, along with the variable ids, dimension ids and attributes looked
+ *  up in them. The calls mirror the nc_ functions they replace and return
+ *  the same status codes.
+ *
+ */
+
+#ifndef __NetCDFFilePool__
+#define __NetCDFFilePool__
+
+#include <string>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class DLL_API NetCDFFilePool {
+
+public:
+	NetCDFFilePool(long maxOpenFiles = 2);
+	~NetCDFFilePool();
+
+	// least recently used files are closed past this, 2 keeps both files open across a file series overlap
+	void	SetMaxOpenFiles(long maxOpenFiles);
+	long	GetMaxOpenFiles() {return fMaxOpenFiles;}
+	long	GetNumOpenFiles();
+
+	int		Open(const char *path, int *ncid);
+	void	Close(const char *path);
+	void	CloseAll();
+
+	int		InqNDims(int ncid, int *ndims);
+	int		InqDimID(int ncid, const char *name, int *dimid);
+	int		InqVarID(int ncid, const char *name, int *varid);
+	int		InqVarNDims(int ncid, int varid, int *ndims);
+
+	int		GetAttDouble(int ncid, int varid, const char *name, double *value);
+	int		GetAttFloat(int ncid, int varid, const char *name, float *value);
+	int		GetAttText(int ncid, int varid, const char *name, std::string *value);
+
+private:
+	struct OpenFile;
+	struct OpenFiles;
+
+	long		fMaxOpenFiles;
+	OpenFiles	*fFiles;
+
+	OpenFile	*Find(int ncid);
+	void		CloseLeastRecent(long numToKeep);
+};
+
+#endif
@@ -105,11 +105,11 @@ OSErr NetCDFMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *vel
 	double u,v,lengthS,alpha,beta,v0;
 	OSErr err = 0;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 		
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(velocity->u*velocity->u + velocity->v * velocity->v);
 		
 		
@@ -133,7 +133,7 @@ OSErr NetCDFMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *vel
 	}
 	else 
 	{
-		TechError("NetCDFMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("NetCDFMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		err = -1;
 		velocity->u=velocity->v=0;
 	}
@@ -991,6 +991,13 @@ OSErr NetCDFMover_c::get_move(int n, Seconds model_time, Seconds step_len, World
 		return 2;
 	}
 	
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr NetCDFMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
 	LERec* prec;
 	LERec rec;
 	prec = &rec;
@@ -1000,19 +1007,14 @@ OSErr NetCDFMover_c::get_move(int n, Seconds model_time, Seconds step_len, World
 	for (int i = 0; i < n; i++) {
 		
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	
-		rec.p.pLong*= 1000000;
+		les.GetLE(i, &rec);
 		
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), prec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
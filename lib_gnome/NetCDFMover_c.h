@@ -95,7 +95,7 @@ public:
 #ifndef pyGNOME
 	NetCDFMover_c (TMap *owner, char *name);
 #endif
-	NetCDFMover_c () {fTimeHdl = 0; fGrid = 0; fDepthLevelsHdl = 0; fDepthLevelsHdl2 = 0; fDepthsH = 0; fDepthDataInfo = 0; fInputFilesHdl = 0; fLESetSizesH = 0; fUncertaintyListH = 0;} // AH 07/17/2012
+	NetCDFMover_c () {fTimeHdl = 0; fGrid = 0; fDepthLevelsHdl = 0; fDepthLevelsHdl2 = 0; fDepthsH = 0; fDepthDataInfo = 0; fInputFilesHdl = 0;} // AH 07/17/2012
 	
 	//virtual ClassID 	GetClassID () { return TYPE_NETCDFMOVER; }
 	//virtual Boolean	IAm(ClassID id) { if(id==TYPE_NETCDFMOVER) return TRUE; return TCurrentMover::IAm(id); }
@@ -146,6 +146,7 @@ public:
 	
 
 			OSErr		get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
 
 };
 
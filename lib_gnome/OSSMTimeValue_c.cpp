@@ -36,6 +36,7 @@ OSSMTimeValue_c::OSSMTimeValue_c() : TimeValue_c()
 	bOSSMStyle = true;
 	fTransport = 0;
 	fVelAtRefPt = 0;
+	fTimeIndexCursor = 0;
 #ifdef pyGNOME
 	fInterpolationType = LINEAR;
 #else
@@ -58,6 +59,7 @@ OSSMTimeValue_c::OSSMTimeValue_c(TMover *theOwner) : TimeValue_c(theOwner)
 	bOSSMStyle = true;
 	fTransport = 0;
 	fVelAtRefPt = 0;
+	fTimeIndexCursor = 0;
 	fInterpolationType = HERMITE;	// pyGNOME doesn't use this constructor
 }
 #endif
@@ -112,13 +114,51 @@ OSErr OSSMTimeValue_c::GetTimeChange(long a, long b, Seconds *dt)
 }
 
 
+// the first value whose time is not before forTime, which must be within the table.
+// Callers step forward in time, so the value the last lookup found or the one after
+// it is usually the answer; only when neither is do we fall back to a binary search.
+long OSSMTimeValue_c::FindTimeIndex(Seconds forTime, long *cursor)
+{
+	long startIndex, midIndex, endIndex;
+	long i, n = GetNumValues();
+
+	for (i = *cursor; i <= *cursor + 1 && i < n; i++) {
+		if (i >= 0 && forTime <= INDEXH(timeValues, i).time
+			&& (i == 0 || INDEXH(timeValues, i - 1).time < forTime))
+			return (*cursor = i);
+	}
+
+	// use a binary method 
+	startIndex = 0;
+	endIndex = n - 1;
+	while(endIndex - startIndex > 3) {
+		midIndex = (startIndex + endIndex) / 2;
+		if (forTime <= INDEXH(timeValues, midIndex).time)
+			endIndex = midIndex;
+		else
+			startIndex = midIndex;
+	}
+
+	for (i = startIndex; i < n - 1; i++) {
+		if (forTime <= INDEXH(timeValues, i).time)
+			break;
+	}
+
+	return (*cursor = i);
+}
+
+
 OSErr OSSMTimeValue_c::GetInterpolatedComponent(Seconds forTime, double *value, short index)
 {
-	OSErr err = 0;
+	return GetInterpolatedComponent(forTime, value, index, &fTimeIndexCursor);
+}
 
-	long startIndex, midIndex, endIndex;
 
-	long a, b, n = GetNumValues();
+OSErr OSSMTimeValue_c::GetInterpolatedComponent(Seconds forTime, double *value, short index, long *cursor)
+{
+	OSErr err = 0;
+
+	long i, a, b, n = GetNumValues();
 	double dv, slope, slope1, slope2, intercept;
 	Seconds dt;
 
@@ -189,35 +229,18 @@ OSErr OSSMTimeValue_c::GetInterpolatedComponent(Seconds forTime, double *value,
 	
 	// find before and after elements
 	
-	/////////////////////////////////////////////////
-	// JLM 7/21/00, we need to speed this up for when we have a lot of values
-	// code goes here, (should we use a static to remember a guess of where to start) before we do the binary search ?
-	// use a binary method 
-	startIndex = 0;
-	endIndex = n - 1;
-	while(endIndex - startIndex > 3) {
-		midIndex = (startIndex + endIndex) / 2;
-		if (forTime <= INDEXH(timeValues, midIndex).time)
-			endIndex = midIndex;
-		else
-			startIndex = midIndex;
-	}
+	i = FindTimeIndex(forTime, cursor);
 
-	for (long i = startIndex; i < n; i++) {
-		if (forTime <= INDEXH(timeValues, i).time) {
-			dt = INDEXH(timeValues, i).time - forTime;
-			if (dt <= TIMEVALUE_TOLERANCE) {
-				// found match
-				(*value) = UorV(INDEXH(timeValues, i).value, index);
-				return 0;
-			}
-			
-			a = i - 1;
-			b = i;
-			break;
-		}
+	dt = INDEXH(timeValues, i).time - forTime;
+	if (dt <= TIMEVALUE_TOLERANCE) {
+		// found match
+		(*value) = UorV(INDEXH(timeValues, i).value, index);
+		return 0;
 	}
 
+	a = i - 1;
+	b = i;
+
 	dv = UorV(INDEXH(timeValues, b).value, index)
 	   - UorV(INDEXH(timeValues, a).value, index);
 
@@ -310,6 +333,7 @@ void OSSMTimeValue_c::SetTimeValueHandle(TimeValuePairH t)
 		DisposeHandle((Handle)timeValues);
 
 	timeValues = t;
+	fTimeIndexCursor = 0;
 }
 
 
@@ -371,6 +395,33 @@ OSErr OSSMTimeValue_c::GetTimeValue(const Seconds& forTime, VelocityRec *value)
 }
 
 
+// the times need not be in order, but when they are each lookup picks up where the last one stopped
+OSErr OSSMTimeValue_c::GetTimeValues(const Seconds *times, long numTimes, VelocityRec *values)
+{
+	OSErr err = 0;
+	long cursor = fTimeIndexCursor;
+
+	if (!timeValues || _GetHandleSize((Handle)timeValues) == 0) {
+		// no value to return
+		for (long i = 0; i < numTimes; i++) {
+			values[i].u = 0;
+			values[i].v = 0;
+		}
+		return -1; 
+	}
+
+	for (long i = 0; i < numTimes; i++) {
+		if ((err = GetInterpolatedComponent(times[i], &values[i].u, kUCode, &cursor)) != 0)
+			return err;
+
+		if ((err = GetInterpolatedComponent(times[i], &values[i].v, kVCode, &cursor)) != 0)
+			return err;
+	}
+
+	return 0;
+}
+
+
 void OSSMTimeValue_c::RescaleTimeValues (double oldScaleFactor, double newScaleFactor)
 {
 	long numValues = GetNumValues();
@@ -38,6 +38,7 @@ public:
 	double					fTransport;
 	double					fVelAtRefPt;
 	short					fInterpolationType;
+	long					fTimeIndexCursor;	// where the last lookup found forTime, the next one starts there
 	
 	virtual void 			GetTimeFileName (char *theName) { strcpy (theName, fileName); }
 	virtual short			GetFileType	() { if (fFileType == PROGRESSIVETIDEFILE) return SHIOHEIGHTSFILE; else return fFileType; }
@@ -55,6 +56,7 @@ public:
 	
 	virtual void			Dispose ();
 	virtual OSErr			GetTimeValue(const Seconds& current_time, VelocityRec *value);
+	virtual OSErr			GetTimeValues(const Seconds *times, long numTimes, VelocityRec *values);
 	virtual OSErr			CheckStartTime (Seconds time);
 	virtual void			RescaleTimeValues (double oldScaleFactor, double newScaleFactor);
 	virtual long			GetNumValues ();
@@ -80,6 +82,8 @@ public:
 	
 protected:
 	OSErr					GetInterpolatedComponent (Seconds forTime, double *value, short index);
+	OSErr					GetInterpolatedComponent (Seconds forTime, double *value, short index, long *cursor);
+	long					FindTimeIndex (Seconds forTime, long *cursor);
 	OSErr					GetTimeChange (long a, long b, Seconds *dt);
 
 	OSErr ConvertRowValuesToUV(string &value1, string &value2,
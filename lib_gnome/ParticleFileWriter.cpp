@@ -0,0 +1,452 @@
+/*
+ *  ParticleFileWriter.cpp
+ *  gnome
+ *
+ */
+
+#include <string.h>
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "ParticleFileWriter.h"
+#include "TimeSlicePrefetcher.h"
+#include "netcdf.h"
+
+using namespace std;
+
+// steps copied and waiting for the writer thread; AppendStep waits past this
+static const size_t kMaxQueuedSteps = 4;
+
+static const char *kComponentDimNames[5] = {0, "two", "three", "four", "five"};
+
+static long ValueSize(int ncType)
+{
+	switch (ncType)
+	{
+		case NC_BYTE: case NC_UBYTE: case NC_CHAR:
+			return 1;
+		case NC_SHORT: case NC_USHORT:
+			return 2;
+		case NC_INT: case NC_UINT: case NC_FLOAT:
+			return 4;
+		case NC_INT64: case NC_UINT64: case NC_DOUBLE:
+			return 8;
+	}
+	return 0;
+}
+
+struct QueuedStep {
+	long					timeIndex;
+	long					dataStart;
+	double					time;
+	long					numParticles;
+	vector< vector<char> >	columns;
+};
+
+struct ParticleFileWriter::Writer {
+	mutex					lock;
+	condition_variable		changed;
+	deque<QueuedStep*>		queue;		// the front step stays until it is written
+	bool					stopping;
+	int						status;
+	thread					writer;
+};
+
+ParticleFileWriter::ParticleFileWriter()
+{
+	fNcid = -1;
+	fTimeVarid = fCountVarid = -1;
+	fDataDimid = -1;
+	for (int i = 0; i < 5; i++) fComponentDimids[i] = -1;
+	fCompress = true;
+	fChunkSize = 1024;
+	fDefining = false;
+	fNumSteps = fNumParticles = 0;
+	fWriter = 0;
+}
+
+ParticleFileWriter::~ParticleFileWriter()
+{
+	Close();
+}
+
+const char *ParticleFileWriter::GetErrorMessage(int status)
+{
+	return nc_strerror(status);
+}
+
+int ParticleFileWriter::Create(const char *path, Boolean compress, long chunkSize)
+{
+	int status, timeDimid;
+
+	if (IsOpen())
+		return NC_EINVAL;
+
+	fCompress = compress;
+	fChunkSize = chunkSize > 0 ? chunkSize : 1;
+
+	{
+		NetCDFLock lock;
+
+		status = nc_create(path, NC_NETCDF4 | NC_NOCLOBBER, &fNcid);
+		if (status != NC_NOERR) {fNcid = -1; return status;}
+		fDefining = true;
+
+		status = nc_def_dim(fNcid, "time", NC_UNLIMITED, &timeDimid);
+		if (status == NC_NOERR)
+			status = nc_def_dim(fNcid, "data", NC_UNLIMITED, &fDataDimid);
+		for (int i = 1; i < 5 && status == NC_NOERR; i++)
+			status = nc_def_dim(fNcid, kComponentDimNames[i], i + 1, &fComponentDimids[i]);
+		if (status != NC_NOERR) goto done;
+
+		status = DefineStepVariable("time", NC_DOUBLE, 0, &fTimeVarid);
+		if (status == NC_NOERR)
+			status = DefineStepVariable("particle_count", NC_INT, 0, &fCountVarid);
+	}
+
+done:
+	if (status != NC_NOERR) Close();
+	return status;
+}
+
+// numComponents 0 for the time dimension's variables
+int ParticleFileWriter::DefineStepVariable(const char *name, int ncType, long numComponents, int *varid)
+{
+	int status, dimids[2], numDims = 1;
+	size_t chunks[2];
+
+	if (numComponents == 0)
+		status = nc_inq_dimid(fNcid, "time", &dimids[0]);
+	else
+	{
+		status = NC_NOERR;
+		dimids[0] = fDataDimid;
+		if (numComponents > 1)
+			dimids[numDims++] = fComponentDimids[numComponents - 1];
+	}
+	if (status != NC_NOERR) return status;
+
+	chunks[0] = fChunkSize;
+	chunks[1] = numComponents;
+
+	status = nc_def_var(fNcid, name, ncType, numDims, dimids, varid);
+	if (status == NC_NOERR)
+		status = nc_def_var_chunking(fNcid, *varid, NC_CHUNKED, chunks);
+	if (status == NC_NOERR && fCompress)
+		status = nc_def_var_deflate(fNcid, *varid, 1, 1, 4);	// what netCDF4-python's zlib=True does
+
+	return status;
+}
+
+long ParticleFileWriter::DefineVariable(const char *name, int ncType, long numComponents, int *status)
+{
+	Variable var;
+
+	if (!fDefining || numComponents < 1 || numComponents > 5 || ValueSize(ncType) == 0)
+	{
+		*status = fDefining ? NC_EINVAL : NC_ENOTINDEFINE;
+		return -1;
+	}
+
+	{
+		NetCDFLock lock;
+		*status = DefineStepVariable(name, ncType, numComponents, &var.varid);
+	}
+	if (*status != NC_NOERR)
+		return -1;
+
+	var.name = name;
+	var.numComponents = numComponents;
+	var.valueSize = ValueSize(ncType) * numComponents;
+	fVars.push_back(var);
+	return fVars.size() - 1;
+}
+
+int ParticleFileWriter::PutAttribute(const char *varName, const char *name, const char *value)
+{
+	int varid = NC_GLOBAL, status = NC_NOERR;
+
+	if (!IsOpen())
+		return NC_EBADID;
+	if (!fDefining)
+		return NC_ENOTINDEFINE;
+
+	NetCDFLock lock;
+
+	if (varName)
+		status = nc_inq_varid(fNcid, varName, &varid);
+	if (status == NC_NOERR)
+		status = nc_put_att_text(fNcid, varid, name, strlen(value), value);
+
+	return status;
+}
+
+int ParticleFileWriter::EndDefinitions()
+{
+	int status;
+
+	if (!IsOpen())
+		return NC_EBADID;
+	if (!fDefining)
+		return NC_ENOTINDEFINE;
+
+	{
+		NetCDFLock lock;
+		status = nc_enddef(fNcid);
+	}
+	if (status == NC_NOERR)
+		fDefining = false;
+	return status;
+}
+
+int ParticleFileWriter::OpenForAppend(const char *path)
+{
+	int status, timeDimid;
+	size_t numSteps = 0, numParticles = 0;
+
+	if (IsOpen())
+		return NC_EINVAL;
+
+	{
+		NetCDFLock lock;
+
+		status = nc_open(path, NC_WRITE, &fNcid);
+		if (status != NC_NOERR) {fNcid = -1; return status;}
+
+		status = nc_inq_dimid(fNcid, "time", &timeDimid);
+		if (status == NC_NOERR)
+			status = nc_inq_dimlen(fNcid, timeDimid, &numSteps);
+		if (status == NC_NOERR)
+			status = nc_inq_dimid(fNcid, "data", &fDataDimid);
+		if (status == NC_NOERR)
+			status = nc_inq_dimlen(fNcid, fDataDimid, &numParticles);
+		if (status == NC_NOERR)
+			status = nc_inq_varid(fNcid, "time", &fTimeVarid);
+		if (status == NC_NOERR)
+			status = nc_inq_varid(fNcid, "particle_count", &fCountVarid);
+	}
+
+	if (status != NC_NOERR)
+	{
+		Close();
+		return status;
+	}
+
+	fNumSteps = numSteps;
+	fNumParticles = numParticles;
+	return NC_NOERR;
+}
+
+long ParticleFileWriter::UseVariable(const char *name, int ncType, long numComponents, int *status)
+{
+	Variable var;
+	int fileType, numDims, dimids[NC_MAX_VAR_DIMS];
+	size_t fileComponents = 1;
+
+	if (!IsOpen() || fWriter)
+	{
+		*status = IsOpen() ? NC_EINVAL : NC_EBADID;
+		return -1;
+	}
+
+	{
+		NetCDFLock lock;
+
+		*status = nc_inq_varid(fNcid, name, &var.varid);
+		if (*status == NC_NOERR)
+			*status = nc_inq_var(fNcid, var.varid, 0, &fileType, &numDims, dimids, 0);
+		if (*status == NC_NOERR && (numDims < 1 || numDims > 2 || dimids[0] != fDataDimid))
+			*status = NC_EINVAL;
+		if (*status == NC_NOERR && numDims == 2)
+			*status = nc_inq_dimlen(fNcid, dimids[1], &fileComponents);
+	}
+	if (*status == NC_NOERR && (fileType != ncType || (long)fileComponents != numComponents))
+		*status = NC_EBADTYPE;
+	if (*status != NC_NOERR)
+		return -1;
+
+	var.name = name;
+	var.numComponents = numComponents;
+	var.valueSize = ValueSize(ncType) * numComponents;
+	fVars.push_back(var);
+	return fVars.size() - 1;
+}
+
+int ParticleFileWriter::StartWriter()
+{
+	try
+	{
+		fWriter = new Writer;
+	}
+	catch (...)
+	{
+		return NC_ENOMEM;
+	}
+	fWriter->stopping = false;
+	fWriter->status = NC_NOERR;
+
+	Writer *w = fWriter;
+	int ncid = fNcid, timeVarid = fTimeVarid, countVarid = fCountVarid;
+	const vector<Variable> &vars = fVars;	// not added to once the writer is started
+
+	fWriter->writer = thread([w, ncid, timeVarid, countVarid, &vars]() {
+		for (;;)
+		{
+			QueuedStep *step;
+			{
+				unique_lock<mutex> lk(w->lock);
+				w->changed.wait(lk, [w]() {return !w->queue.empty() || w->stopping;});
+				if (w->queue.empty())
+					return;
+				step = w->queue.front();
+			}
+
+			int status = NC_NOERR;
+			{
+				NetCDFLock lock;
+				size_t start[2] = {(size_t)step->timeIndex, 0}, count[2] = {1, 0};
+				int numParticles = step->numParticles;
+
+				status = nc_put_vara_double(ncid, timeVarid, start, count, &step->time);
+				if (status == NC_NOERR)
+					status = nc_put_vara_int(ncid, countVarid, start, count, &numParticles);
+
+				start[0] = step->dataStart;
+				count[0] = step->numParticles;
+				for (size_t i = 0; i < vars.size() && step->numParticles > 0 && status == NC_NOERR; i++)
+				{
+					count[1] = vars[i].numComponents;
+					status = nc_put_vara(ncid, vars[i].varid, start, count, &step->columns[i][0]);
+				}
+			}
+
+			{
+				lock_guard<mutex> lk(w->lock);
+				w->queue.pop_front();
+				if (w->status == NC_NOERR) w->status = status;
+			}
+			w->changed.notify_all();
+			delete step;
+		}
+	});
+
+	return NC_NOERR;
+}
+
+int ParticleFileWriter::AppendStep(double time, long numParticles, const char *const *columns, const long *strides)
+{
+	QueuedStep *step = 0;
+	int status;
+
+	if (!IsOpen())
+		return NC_EBADID;
+	if (fDefining)
+		return NC_EINDEFINE;
+	if (numParticles < 0)
+		return NC_EINVAL;
+
+	if (!fWriter && (status = StartWriter()) != NC_NOERR)
+		return status;
+
+	{
+		lock_guard<mutex> lk(fWriter->lock);
+		if (fWriter->status != NC_NOERR)
+			return fWriter->status;
+	}
+
+	// copied here so the caller's arrays are free to change once this returns
+	try
+	{
+		step = new QueuedStep;
+		step->columns.resize(fVars.size());
+		for (size_t i = 0; i < fVars.size(); i++)
+		{
+			long valueSize = fVars[i].valueSize;
+			vector<char> &column = step->columns[i];
+
+			column.resize(numParticles * valueSize);
+			if (numParticles == 0)
+				continue;
+			if (strides[i] == valueSize)
+				memcpy(&column[0], columns[i], numParticles * valueSize);
+			else
+				for (long j = 0; j < numParticles; j++)
+					memcpy(&column[j * valueSize], columns[i] + j * strides[i], valueSize);
+		}
+	}
+	catch (...)
+	{
+		delete step;
+		return NC_ENOMEM;
+	}
+	step->time = time;
+	step->numParticles = numParticles;
+	step->timeIndex = fNumSteps++;
+	step->dataStart = fNumParticles;
+	fNumParticles += numParticles;
+
+	{
+		unique_lock<mutex> lk(fWriter->lock);
+		fWriter->changed.wait(lk, [this]() {return fWriter->queue.size() < kMaxQueuedSteps;});
+		fWriter->queue.push_back(step);
+	}
+	fWriter->changed.notify_all();
+
+	return NC_NOERR;
+}
+
+int ParticleFileWriter::Flush()
+{
+	if (!fWriter)
+		return NC_NOERR;	// nothing queued
+
+	unique_lock<mutex> lk(fWriter->lock);
+	fWriter->changed.wait(lk, [this]() {return fWriter->queue.empty();});
+	return fWriter->status;
+}
+
+int ParticleFileWriter::StopWriter()
+{
+	int status;
+
+	if (!fWriter)
+		return NC_NOERR;
+
+	{
+		lock_guard<mutex> lk(fWriter->lock);
+		fWriter->stopping = true;
+	}
+	fWriter->changed.notify_all();
+	fWriter->writer.join();		// the queue is written out first
+
+	status = fWriter->status;
+	delete fWriter;
+	fWriter = 0;
+	return status;
+}
+
+int ParticleFileWriter::Close()
+{
+	int status = StopWriter(), closeStatus;
+
+	if (!IsOpen())
+		return status;
+
+	{
+		NetCDFLock lock;
+		closeStatus = nc_close(fNcid);	// ends define mode as well
+	}
+	if (status == NC_NOERR) status = closeStatus;
+
+	fNcid = -1;
+	fTimeVarid = fCountVarid = -1;
+	fDataDimid = -1;
+	for (int i = 0; i < 5; i++) fComponentDimids[i] = -1;
+	fDefining = false;
+	fNumSteps = fNumParticles = 0;
+	fVars.clear();
+	return status;
+}
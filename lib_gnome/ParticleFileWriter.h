@@ -0,0 +1,96 @@
+/*
+ *  ParticleFileWriter.h
+ *  gnome
+ *
+ *  Writes a run's particles to a NetCDF-4 file as a contiguous ragged
+ *  array: each step appends its time and particle count along the time
+ *  dimension, and all of its particles' values along the data dimension,
+ *  one variable at a time. The layout is the one NetCDFOutput has always
+ *  written, so read_data and other CF readers read the files as before.
+ *
+ *  AppendStep copies the step's columns and returns; the compression and
+ *  the writes are done on a thread of the writer's own, which holds the
+ *  NetCDFLock while it calls the library. A few steps may be queued, past
+ *  that AppendStep waits for the thread to catch up. An error the thread
+ *  runs into is returned by the next call.
+ *
+ *  netCDF calls made without the lock -- the grids' TextRead, or netCDF4
+ *  from python -- must wait for Flush while steps are queued.
+ *
+ *  The calls return the netCDF status codes, NC_NOERR on success.
+ *
+ */
+
+#ifndef __ParticleFileWriter__
+#define __ParticleFileWriter__
+
+#include <string>
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class DLL_API ParticleFileWriter {
+
+public:
+	ParticleFileWriter();
+	~ParticleFileWriter();
+
+	// a new file, left in define mode; the time and particle_count
+	// variables are defined along with the dimensions
+	int		Create(const char *path, Boolean compress, long chunkSize);
+	// a file an earlier writer left, appended to after its last step
+	int		OpenForAppend(const char *path);
+	int		Close();
+	Boolean	IsOpen() const {return fNcid >= 0;}
+
+	// varName 0 for a global attribute, only before EndDefinitions
+	int		PutAttribute(const char *varName, const char *name, const char *value);
+	// a variable of numComponents values per particle, 1 to 5; returns the
+	// index its column is passed at in AppendStep, or -1. The variables are
+	// all named before the first step is appended.
+	long	DefineVariable(const char *name, int ncType, long numComponents, int *status);
+	// a variable already in a file opened for append, -1 if it isn't there
+	// or doesn't have the type and components given
+	long	UseVariable(const char *name, int ncType, long numComponents, int *status);
+	int		EndDefinitions();
+	long	GetNumVariables() const {return fVars.size();}
+
+	// columns[i] is the first particle's values of variable i, the next
+	// particle's strides[i] bytes on; a particle's components are contiguous
+	int		AppendStep(double time, long numParticles, const char *const *columns, const long *strides);
+	// waits for the queued steps to be written
+	int		Flush();
+
+	// in the file once the queue is written, the steps from an earlier writer included
+	long	GetNumSteps() const {return fNumSteps;}
+	long	GetNumParticles() const {return fNumParticles;}
+
+	static const char *GetErrorMessage(int status);
+
+private:
+	struct Variable {
+		std::string	name;
+		int			varid;
+		long		numComponents;
+		long		valueSize;	// bytes per particle
+	};
+	struct Writer;
+
+	int						fNcid;
+	int						fTimeVarid, fCountVarid;
+	int						fDataDimid, fComponentDimids[5];
+	Boolean					fCompress;
+	long					fChunkSize;
+	Boolean					fDefining;
+	long					fNumSteps, fNumParticles;
+	std::vector<Variable>	fVars;
+	Writer					*fWriter;
+
+	int		DefineStepVariable(const char *name, int ncType, long numComponents, int *varid);
+	int		StartWriter();
+	int		StopWriter();
+};
+
+#endif
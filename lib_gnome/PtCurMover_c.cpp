@@ -70,12 +70,12 @@ OSErr PtCurMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *velo
 	//err = this -> UpdateUncertainty();
 	//if(err) return err;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 	
 	
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(velocity->u*velocity->u + velocity->v * velocity->v);
 		
 		
@@ -99,7 +99,7 @@ OSErr PtCurMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *velo
 	}
 	else 
 	{
-		TechError("PtCurMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("PtCurMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		err = -1;
 		velocity->u=velocity->v=0;
 	}
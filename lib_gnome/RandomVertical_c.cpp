@@ -9,6 +9,7 @@
 
 #include "RandomVertical_c.h"
 #include "CompFunctions.h"
+#include "CounterRandom.h"
 #include "GEOMETRY.H"
 #include "Units.h"
 
@@ -74,28 +75,32 @@ OSErr RandomVertical_c::get_move(int n, Seconds model_time, Seconds step_len, Wo
 		// cout << "Invalid spillType.\n";
 		return 2;
 	}
-	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
-	
+
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr RandomVertical_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
 	WorldPoint3D zero_delta ={0,0,0.};
 
+	// each LE has its own random stream so the LEs can be moved in any order
+	Boolean inParallel = fNumThreads > 1 && CanMoveLEsInParallel(spillType);
+
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	
-		rec.p.pLong*= 1000000;
+		les.GetLE(i, &rec);
 		
-		delta[i] = this->GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = this->GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
@@ -118,6 +123,7 @@ WorldPoint3D RandomVertical_c::GetMove (const Seconds& model_time, Seconds timeS
 	WorldPoint refPoint = (*theLE).p;	
 	float rand;
 	OSErr err = 0;
+	CounterRandom rng(fRandomSeed, GetRandomStream(kRandomVerticalDraws), setIndex, leIndex, model_time, leType);
 
 	//if ((*theLE).z==0)	return deltaPoint;
 	// will need a flag to check if LE is supposed to stay on the surface or can be diffused below	
@@ -139,7 +145,7 @@ WorldPoint3D RandomVertical_c::GetMove (const Seconds& model_time, Seconds timeS
 		{
 			if (fVerticalDiffusionCoefficient==0) return deltaPoint;	
 			verticalDiffusionCoefficient = sqrt(6.*(fVerticalDiffusionCoefficient/10000.)*timeStep);
-			rand = GetRandomFloat(-1.0, 1.0);
+			rand = (float)rng.Uniform(-1.0, 1.0);
 			deltaPoint.z = rand*verticalDiffusionCoefficient;
 			//z = deltaPoint.z;	// will add this on to the next move
 			
@@ -155,7 +161,7 @@ WorldPoint3D RandomVertical_c::GetMove (const Seconds& model_time, Seconds timeS
 			{
 				deltaPoint.z = mixedLayerDepth - (totalLEDepth - mixedLayerDepth) - (*theLE).z; // reflect about mixed layer depth
 				// check if went above surface and put randomly into mixed layer
-				if ((*theLE).z+deltaPoint.z <= 0) deltaPoint.z = GetRandomFloat(eps,mixedLayerDepth) - (*theLE).z;	
+				if ((*theLE).z+deltaPoint.z <= 0) deltaPoint.z = rng.Uniform(eps,mixedLayerDepth) - (*theLE).z;	
 					// or just let it go and deal with it later? then it will go into full water column...
 			}
 		}
@@ -164,7 +170,7 @@ WorldPoint3D RandomVertical_c::GetMove (const Seconds& model_time, Seconds timeS
 		// now apply below mixed layer depth diffusion to all particles above and below
 		if (fVerticalBottomDiffusionCoefficient==0/* && z==0*/) /*return deltaPoint*/goto dochecks;	// don't return until do checks
 		verticalDiffusionCoefficient = sqrt(6.*(fVerticalBottomDiffusionCoefficient/10000.)*timeStep);
-		rand = GetRandomFloat(-1.0, 1.0);
+		rand = (float)rng.Uniform(-1.0, 1.0);
 		deltaPoint.z = rand*verticalDiffusionCoefficient;
 		
 		z = z + deltaPoint.z;	// add move to previous move if any
@@ -181,7 +187,7 @@ dochecks:
 			deltaPoint.z = - totalLEDepth - (*theLE).z;	// reflect below surface
 			totalLEDepth = (*theLE).z + deltaPoint.z;
 			if (totalLEDepth > depthAtPoint) 
-				deltaPoint.z = GetRandomFloat(eps,depthAtPoint-eps) - (*theLE).z;
+				deltaPoint.z = rng.Uniform(eps,depthAtPoint-eps) - (*theLE).z;
 			return deltaPoint;
 		}
 		if (totalLEDepth==depthAtPoint) 
@@ -196,7 +202,7 @@ dochecks:
 			totalLEDepth = (*theLE).z + deltaPoint.z;
 			if (totalLEDepth <= 0) 
 				// put randomly into water column
-				deltaPoint.z = GetRandomFloat(eps,depthAtPoint-eps) - (*theLE).z;
+				deltaPoint.z = rng.Uniform(eps,depthAtPoint-eps) - (*theLE).z;
 			return deltaPoint;
 		}
 		else
@@ -36,6 +36,8 @@ public:
 	
 	
 	OSErr				get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return true; }
 
 protected:
 	void				Init();
@@ -9,6 +9,7 @@
 
 #include "Random_c.h"
 #include "CompFunctions.h"
+#include "CounterRandom.h"
 #include "GEOMETRY.H"
 #include "Units.h"
 
@@ -58,6 +59,24 @@ void Random_c::ModelStepIsDone()
 	memset(&fOptimize,0,sizeof(fOptimize));
 }
 
+// nothing to share, the member is a copy drawing its own random moves
+Mover_c *Random_c::NewEnsembleMember(unsigned long randomSeed)
+{
+	Random_c *member = 0;
+	
+	try
+	{
+		member = new Random_c(*this);
+	}
+	catch (...)
+	{
+		return 0;
+	}
+	member->fRandomSeed = randomSeed;
+	
+	return member;
+}
+
 
 OSErr Random_c::get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID) {
 	
@@ -73,28 +92,32 @@ OSErr Random_c::get_move(int n, Seconds model_time, Seconds step_len, WorldPoint
 		// cout << "Invalid spillType.\n";
 		return 2;
 	}
-	
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
-	
+
+	LEBlock les(n, ref, LE_status);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr Random_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
 	WorldPoint3D zero_delta ={0,0,0.};
 
+	// each LE has its own random stream, but the depth dependent option resets fOptimize for every LE
+	Boolean inParallel = fNumThreads > 1 && CanMoveLEsInParallel(spillType);
+
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
+		les.GetLE(i, &rec);
 		
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	// really only need this for the latitude
-		//rec.p.pLong*= 1000000;
-		
-		delta[i] = this->GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		delta[i] = this->GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
@@ -160,14 +183,16 @@ WorldPoint3D Random_c::GetMove (const Seconds& model_time, Seconds timeStep,long
 	else
 		diffusionCoefficient = this -> fOptimize.value;
 	
+	CounterRandom rng(fRandomSeed, GetRandomStream(kRandomMoverDraws), setIndex, leIndex, model_time, leType);
+	
 	if(this -> fOptimize.isFirstStep)
 	{
-		GetRandomVectorInUnitCircle(&rand1,&rand2);
+		rng.VectorInUnitCircle(&rand1,&rand2);
 	}
 	else
 	{
-		rand1 = GetRandomFloat(-1.0, 1.0);
-		rand2 = GetRandomFloat(-1.0, 1.0);
+		rand1 = (float)rng.Uniform(-1.0, 1.0);
+		rand2 = (float)rng.Uniform(-1.0, 1.0);
 	}
 	
 	dLong = (rand1 * diffusionCoefficient )/ LongToLatRatio3 (refPoint.pLat);
@@ -30,10 +30,13 @@ public:
 	virtual OSErr 		PrepareForModelRun(); 
 	virtual OSErr 		PrepareForModelStep(const Seconds&, const Seconds&, bool, int numLESets, int* LESetsSizesList); // AH 07/10/2012
 	virtual void 		ModelStepIsDone();
+	virtual Mover_c		*NewEnsembleMember(unsigned long randomSeed);
 	virtual WorldPoint3D       GetMove(const Seconds& model_time, Seconds timeStep,long setIndex,long leIndex,LERec *theLE,LETYPE leType);
 	
 	
 	OSErr				get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, short* LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return fOptimize.isOptimizedForStep && !bUseDepthDependent; }
 
 protected:
 	void				Init();
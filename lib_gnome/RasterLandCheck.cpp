@@ -0,0 +1,252 @@
+/*
+ *  RasterLandCheck.cpp
+ *  gnome
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "RasterLandCheck.h"
+#include "ForEachLE.h"
+
+static const long kMaxPixelCoord = 1L << 28;	// keeps the walk arithmetic well inside 64 bits
+
+static long ToPixel(double coord, double center, double scale, double offset)
+{
+	double pixel = floor((coord - center) * scale + offset);
+
+	if (pixel < -kMaxPixelCoord) return -kMaxPixelCoord;
+	if (pixel > kMaxPixelCoord) return kMaxPixelCoord;
+	return (long)pixel;
+}
+
+static double ToCoord(long pixel, double center, double scale, double offset)
+{
+	return ((pixel + 0.5) - offset) / scale + center;	// middle of the pixel
+}
+
+// the pixel after a number of steps of the walk, relative to its start
+static void WalkOffset(long long dx, long long dy, long long step, long long *nx, long long *ny)
+{
+	if (dx >= dy) {*nx = step; *ny = dx ? (2 * dy * step + dx - 1) / (2 * dx) : 0;}
+	else {*ny = step; *nx = (2 * dx * step + dy - 1) / (2 * dy);}
+}
+
+// the first step in [low, high) for which isPast is true, high if none
+template <class Pred> static long long FirstStep(long long low, long long high, const Pred &isPast)
+{
+	while (low < high)
+	{
+		long long mid = low + (high - low) / 2;
+		if (isPast(mid)) high = mid;
+		else low = mid + 1;
+	}
+	return low;
+}
+
+RasterLandCheck::RasterLandCheck(const unsigned char *raster, long numCols, long numRows)
+{
+	fRaster = raster;
+	fNumCols = numCols;
+	fNumRows = numRows;
+}
+
+void RasterLandCheck::BuildLevels()
+{
+	long x, y, cols = fNumCols, rows = fNumRows;
+
+	fLevels.clear();
+	fLevelRows.clear();
+
+	// level 1 from the raster, land grown by a pixel to cover the diagonal check
+	while (cols > 1 || rows > 1)
+	{
+		long prevRows = rows;
+
+		cols = (cols + 1) / 2;
+		rows = (rows + 1) / 2;
+		fLevels.push_back(std::vector<unsigned char>(cols * rows, 0));
+		fLevelRows.push_back(rows);
+
+		std::vector<unsigned char> &level = fLevels.back();
+		if (fLevels.size() == 1)
+		{
+			for (x = 0; x < fNumCols; x++)
+				for (y = 0; y < fNumRows; y++)
+					if (fRaster[x * fNumRows + y] == 1)
+						for (long i = (x > 0 ? x - 1 : 0); i <= x + 1 && i < fNumCols; i++)
+							for (long j = (y > 0 ? y - 1 : 0); j <= y + 1 && j < fNumRows; j++)
+								level[(i >> 1) * rows + (j >> 1)] = 1;
+		}
+		else
+		{
+			const std::vector<unsigned char> &finer = fLevels[fLevels.size() - 2];
+			for (x = 0; x < (long)finer.size() / prevRows; x++)
+				for (y = 0; y < prevRows; y++)
+					if (finer[x * prevRows + y])
+						level[(x >> 1) * rows + (y >> 1)] = 1;
+		}
+	}
+}
+
+// This is an adaptation of Bresenham's line algorithm, with an extra check when
+// the walk steps diagonally: if both pixels beside the step are land, the
+// move can't slip through between them and it is a hit.
+//
+// The walk moves one pixel along the major axis every step, so the pixel after
+// any step can be computed directly. Steps before the walk reaches the grid are
+// skipped, it stops once it has left the grid for good, and it jumps to the
+// end of any clear block it is in.
+Boolean RasterLandCheck::FindFirstPixel(long x0, long y0, long x1, long y1, long *prevX, long *prevY, long *hitX, long *hitY) const
+{
+	long long dx = labs(x1 - x0), dy = labs(y1 - y0);
+	long sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+	long long numSteps = dx > dy ? dx : dy;
+	long long err, e2, step, firstStep, lastStep, nx, ny;
+	long x, y, level, numLevels = fLevels.size();
+
+	// both ends off the same side of the grid
+	if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0) || (x0 >= fNumCols && x1 >= fNumCols) || (y0 >= fNumRows && y1 >= fNumRows))
+		return false;
+
+	// fixme: we should never be starting on land!
+	if (IsLand(x0, y0))
+	{
+		*prevX = *hitX = x0;
+		*prevY = *hitY = y0;
+		return true;
+	}
+
+	// the first step on the grid along both axes, and the last before it is off along either
+	firstStep = FirstStep(1, numSteps + 1, [&](long long s) {
+		WalkOffset(dx, dy, s, &nx, &ny);
+		long long px = x0 + sx * nx, py = y0 + sy * ny;
+		return (sx > 0 ? px >= 0 : px < fNumCols) && (sy > 0 ? py >= 0 : py < fNumRows);
+	});
+	lastStep = FirstStep(firstStep, numSteps + 1, [&](long long s) {
+		WalkOffset(dx, dy, s, &nx, &ny);
+		long long px = x0 + sx * nx, py = y0 + sy * ny;
+		return (sx > 0 ? px >= fNumCols : px < 0) || (sy > 0 ? py >= fNumRows : py < 0);
+	}) - 1;
+
+	// start from the pixel just before the grid, with the error term it would have had
+	WalkOffset(dx, dy, firstStep - 1, &nx, &ny);
+	x = x0 + sx * nx;
+	y = y0 + sy * ny;
+	err = dx * (1 + ny) - dy * (1 + nx);
+
+	for (step = firstStep; step <= lastStep; step++)
+	{
+		if (numLevels > 0 && IsOnGrid(x, y) && IsClearBlock(1, x, y))
+		{
+			long long blockEnd;
+			long loX, hiX, loY, hiY;
+
+			for (level = 1; level < numLevels && IsClearBlock(level + 1, x, y); level++) {}
+			loX = (x >> level) << level; hiX = loX + (1L << level) - 1;
+			loY = (y >> level) << level; hiY = loY + (1L << level) - 1;
+
+			// no step inside the block can hit, so go to the last one
+			blockEnd = FirstStep(step, lastStep + 1, [&](long long s) {
+				WalkOffset(dx, dy, s, &nx, &ny);
+				long long px = x0 + sx * nx, py = y0 + sy * ny;
+				return px < loX || px > hiX || py < loY || py > hiY;
+			});
+			if (blockEnd > lastStep)
+				return false;
+			if (blockEnd > step)
+			{
+				step = blockEnd;
+				WalkOffset(dx, dy, step - 1, &nx, &ny);
+				x = x0 + sx * nx;
+				y = y0 + sy * ny;
+				err = dx * (1 + ny) - dy * (1 + nx);
+			}
+		}
+
+		*prevX = x;
+		*prevY = y;
+		// advance to next point
+		e2 = 2 * err;
+		if (e2 > -dy) {err -= dy; x += sx;}
+		if (e2 < dx) {err += dx; y += sy;}
+
+		if (IsLand(x, y))
+		{
+			*hitX = x;
+			*hitY = y;
+			return true;
+		}
+		// a diagonal move -- only call it a hit if BOTH adjacent points are land
+		// (off the grid is water)
+		if (e2 > -dy && e2 < dx && IsLand(x, y - sy) && IsLand(x - sx, y))
+		{
+			*hitX = x;	// we have to pick one -- this is arbitrary
+			*hitY = y - sy;
+			return true;
+		}
+	}
+	return false;
+}
+
+void RasterLandCheck::CheckLand(long numLEs, int32_t *positions, int32_t *endPositions, short *statusCodes, int32_t *lastWaterPositions) const
+{
+	ForEachLE(numLEs, [=](long first, long last)
+	{
+		long prevX, prevY, hitX, hitY;
+
+		for (long i = first; i < last; i++)
+		{
+			if (statusCodes[i] == OILSTAT_ONLAND) continue;
+
+			if (FindFirstPixel(positions[2*i], positions[2*i+1], endPositions[2*i], endPositions[2*i+1], &prevX, &prevY, &hitX, &hitY))
+			{
+				lastWaterPositions[2*i] = prevX;
+				lastWaterPositions[2*i+1] = prevY;
+				endPositions[2*i] = hitX;
+				endPositions[2*i+1] = hitY;
+				statusCodes[i] = OILSTAT_ONLAND;
+			}
+			else
+			{	// didn't hit land -- can move the LE
+				positions[2*i] = endPositions[2*i];
+				positions[2*i+1] = endPositions[2*i+1];
+			}
+		}
+	});
+}
+
+void RasterLandCheck::BeachElements(const RasterProjection &p, long numLEs, const WorldPoint3D *positions,
+									WorldPoint3D *nextPositions, short *statusCodes, WorldPoint3D *lastWaterPositions) const
+{
+	ForEachLE(numLEs, [=, &p](long first, long last)
+	{
+		long prevX, prevY, hitX, hitY;
+
+		for (long i = first; i < last; i++)
+		{
+			long x1 = ToPixel(nextPositions[i].p.pLong, p.centerLong, p.scaleX, p.offsetX);
+			long y1 = ToPixel(nextPositions[i].p.pLat, p.centerLat, p.scaleY, p.offsetY);
+
+			if (statusCodes[i] == OILSTAT_ONLAND)
+			{
+				// as the pixel round trip always did, LEs already on land are put in the middle of their pixels
+				prevX = ToPixel(lastWaterPositions[i].p.pLong, p.centerLong, p.scaleX, p.offsetX);
+				prevY = ToPixel(lastWaterPositions[i].p.pLat, p.centerLat, p.scaleY, p.offsetY);
+				hitX = x1;
+				hitY = y1;
+			}
+			else if (!FindFirstPixel(ToPixel(positions[i].p.pLong, p.centerLong, p.scaleX, p.offsetX),
+									 ToPixel(positions[i].p.pLat, p.centerLat, p.scaleY, p.offsetY),
+									 x1, y1, &prevX, &prevY, &hitX, &hitY))
+				continue;
+
+			statusCodes[i] = OILSTAT_ONLAND;
+			nextPositions[i].p.pLong = ToCoord(hitX, p.centerLong, p.scaleX, p.offsetX);
+			nextPositions[i].p.pLat = ToCoord(hitY, p.centerLat, p.scaleY, p.offsetY);
+			lastWaterPositions[i].p.pLong = ToCoord(prevX, p.centerLong, p.scaleX, p.offsetX);
+			lastWaterPositions[i].p.pLat = ToCoord(prevY, p.centerLat, p.scaleY, p.offsetY);
+		}
+	});
+}
@@ -0,0 +1,67 @@
+/*
+ *  RasterLandCheck.h
+ *  gnome
+ *
+ *  Beaching on a land-water raster: each LE's move is walked pixel by
+ *  pixel with Bresenham's line algorithm and stops at the first land
+ *  pixel it crosses. Only the part of a move that is over the raster is
+ *  walked, and the LEs are split among threads when there are many.
+ *
+ *  With BuildLevels, the walk also jumps across blocks of pixels with no
+ *  land in or next to them, so a move in open water costs a few block
+ *  lookups rather than a step per pixel.
+ *
+ */
+
+#ifndef __RasterLandCheck__
+#define __RasterLandCheck__
+
+#include <stdint.h>
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+// pixel = floor((lon/lat - center) * scale + offset), as gnome.utilities.projections.GeoProjection
+typedef struct {
+	double	centerLong, centerLat;
+	double	scaleX, scaleY;
+	double	offsetX, offsetY;
+} RasterProjection;
+
+class DLL_API RasterLandCheck {
+
+public:
+	// pixel (x, y) is raster[x * numRows + y], a value of 1 is land
+	RasterLandCheck(const unsigned char *raster, long numCols, long numRows);
+
+	// level k marks the 2^k x 2^k pixel blocks that have land in or right beside them
+	void		BuildLevels();
+	long		GetNumLevels() const {return fLevels.size();}
+
+	// the last water pixel and the land pixel hit, false if the move stays in water
+	Boolean		FindFirstPixel(long x0, long y0, long x1, long y1, long *prevX, long *prevY, long *hitX, long *hitY) const;
+
+	// positions are (x, y) pixel pairs, as cy_land_check.check_land takes them; an LE that
+	// hits land gets the hit and last water pixels, one that doesn't moves to its end pixel
+	void		CheckLand(long numLEs, int32_t *positions, int32_t *endPositions, short *statusCodes, int32_t *lastWaterPositions) const;
+
+	// the same in degrees: beached LEs end at the center of the land pixel, and
+	// their last water position is the center of the pixel before it
+	void		BeachElements(const RasterProjection &projection, long numLEs, const WorldPoint3D *positions,
+							  WorldPoint3D *nextPositions, short *statusCodes, WorldPoint3D *lastWaterPositions) const;
+
+private:
+	const unsigned char	*fRaster;
+	long		fNumCols, fNumRows;
+	std::vector< std::vector<unsigned char> >	fLevels;	// levels 1, 2, ...
+	std::vector<long>	fLevelRows;
+
+	Boolean		IsOnGrid(long x, long y) const {return x >= 0 && x < fNumCols && y >= 0 && y < fNumRows;}
+	Boolean		IsLand(long x, long y) const {return IsOnGrid(x, y) && fRaster[x * fNumRows + y] == 1;}
+	Boolean		IsClearBlock(long level, long x, long y) const
+					{return !fLevels[level - 1][(x >> level) * fLevelRows[level - 1] + (y >> level)];}
+};
+
+#endif
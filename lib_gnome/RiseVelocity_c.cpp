@@ -169,25 +169,29 @@ OSErr RiseVelocity_c::get_move(int n, unsigned long model_time, unsigned long st
 		return 2;
 	}
 
-	LERec rec;
+	LEBlock les(n, ref, LE_status);
+	les.SetRiseVelocities(rise_velocity);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr RiseVelocity_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
+
 	WorldPoint3D zero_delta = { {0, 0}, 0.};
 
+	bool inParallel = fNumThreads > 1 && CanMoveLEsInParallel(spillType);
+
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
-		if (LE_status[i] != OILSTAT_INWATER) {
+		LERec rec;
+		if (!les.IsInWater(i)) {
 			delta[i] = zero_delta;
 			continue;
 		}
+		les.GetLE(i, &rec);
 
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-
-		rec.riseVelocity = rise_velocity[i];
-
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		//rec.p.pLat *= 1e6;	// not using the lat, lon at this point
-		//rec.p.pLong*= 1000000;
-
-		delta[i] = this->GetMove(model_time, step_len, spill_ID, i, &rec, spillType);
+		delta[i] = this->GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 
 		//delta[i].p.pLat /= 1e6;
 		//delta[i].p.pLong /= 1e6;
@@ -44,6 +44,8 @@ public:
 				  // double *rise_velocity, double *density, double *droplet_size,
 				   double *rise_velocity,
 				   short *LE_status, LEType spillType, long spill_ID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return true; }
 
 protected:
 
@@ -3,6 +3,7 @@
 
 #include "Basics.h"
 #include "TypeDefs.h"
+#include "ExportSymbols.h"
 #ifndef pyGNOME
 #include "Earl.h"
 #include "VLIST.H"
@@ -406,7 +407,7 @@ short GetWeights(double t,                 // the time to interpolate at hrs
 
 void ResetTime(COMPHEIGHTS *answers,double beginHour);
 
-double RStatHeight(double	theTime,	// time in hrs from begin of year
+DLL_API double RStatHeight(double	theTime,	// time in hrs from begin of year
                      double	*AMPA,		// amplitude corrected for year
 					 double	*epoch,		// epoch corrected for year
 					 short	ncoeff,		// number of coefficients to use
@@ -619,14 +620,18 @@ short RotToMajorMinor(CONSTITUENT *constituent,
 					  CURRENTOFFSET *offset,
                       COMPCURRENTS *answers);
 
-double RStatCurrent(double	theTime,	// time in hrs from begin of year
+DLL_API double RStatCurrent(double	theTime,	// time in hrs from begin of year
                      double	*AMPA,		// amplitude corrected for year
 					 double	*epoch,		// epoch corrected for year
 					 double	refCur,		// reference current in knots
 					 short	ncoeff,		// number of coefficients to use
 					 short	CFlag);		// hydraulic station flag
 
-double RStatCurrentRot(double		theTime,		// time in hrs from begin of year
+double RStatCurrentFromSum(double	current,	// sum of the constituents
+						   double	refCur,		// reference current in knots
+						   short	CFlag);		// hydraulic station flag
+
+DLL_API double RStatCurrentRot(double		theTime,		// time in hrs from begin of year
                      double			*AMPA,			// amplitude corrected for year
 					 double			*epoch,			// epoch corrected for year
 					 short			ncoeff,			// number of coefficients to use
@@ -639,6 +644,17 @@ double RStatCurrentRot(double		theTime,		// time in hrs from begin of year
 					 double			*vminor,		// minor axis velocity if computed
 					 short			*direcKey);		// direction key -1 ebb, 1 flood, 0 indeterminate
 
+DLL_API double RStatCurrentRotFromSums(double		uSum,			// sum of the east-west or minor axis constituents
+					 double			vSum,			// sum of the north-south or major axis constituents
+					 CONSTITUENT	*constituent,	// constituent handle
+					 double			twoValuesAgo,	// previous, previous value
+					 double			lastValue,		// previous value
+					 double			*uVelocity,		// east-west component of velocity
+					 double			*vVelocity,		// north-south component of velocity
+					 double			*vmajor,		// major axis velocity if computed
+					 double			*vminor,		// minor axis velocity if computed
+					 short			*direcKey);		// direction key -1 ebb, 1 flood, 0 indeterminate
+
 void short2Str(short sValue, char *theStr);
 
 void hr2TStr(double exHours, char *theStr);
@@ -7,6 +7,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "Shio.h"
+#include "ShioHarmonics.h"
 
 #ifndef pyGNOME
 #include "CROSS.H"
@@ -316,6 +317,7 @@ short GetRefCurrent(CONSTITUENT *constituent,	// Amplitude-phase array structs
 	double	zeroValue=0.0,lastValue=0.0;
 	double	*AMPAPtr=nil,*epochPtr=nil;
 	double	*CHdl=0,*MaxMinHdl=0,*uVelHdl=0,*vVelHdl=0;
+	double	*sumHdl=0,*uSumHdl=0;
 	EXTFLAG	*THdl=0,*MaxMinTHdl=0;
 	long	maxPeaks=0,NumOfSteps=0,pcnt=0;
 	short	*tHdl=0,findFlag=0,direcKey=0,zeroFlag=0,lastFlag=0;
@@ -460,6 +462,11 @@ short GetRefCurrent(CONSTITUENT *constituent,	// Amplitude-phase array structs
 		// This one is the current array - MKH ERROR
 		CHdl = new double[NumOfSteps];
 		
+		// These hold the constituent sums at each step, along the
+		// north-south (or major) and east-west axes for rotary currents
+		sumHdl = new double[NumOfSteps];
+		uSumHdl = new double[NumOfSteps];
+		
 		// This one is the time array
 		THdl = new EXTFLAG[NumOfSteps];
 		
@@ -545,6 +552,19 @@ short GetRefCurrent(CONSTITUENT *constituent,	// Amplitude-phase array structs
 
 	// Get reference cur
 	refCur = GetDatum(constituent);
+	
+	// Sum the constituents for all the steps at once, the same terms
+	// RStatCurrent and RStatCurrentRot would sum one time at a time
+	if( (rotFlag==1) || (rotFlag==2) ) {
+		HarmonicSeries vSeries(AMPAPtr,epochPtr,0,numOfConstituents/2);
+		HarmonicSeries uSeries(AMPAPtr,epochPtr,numOfConstituents/2,numOfConstituents - numOfConstituents/2);
+		vSeries.EvaluateSeries(beginHour,timestep/60.0,NumOfSteps,sumHdl);
+		uSeries.EvaluateSeries(beginHour,timestep/60.0,NumOfSteps,uSumHdl);
+	}
+	else {
+		HarmonicSeries series(AMPAPtr,epochPtr,0,numOfConstituents>0 ? numOfConstituents : 37);
+		series.EvaluateSeries(beginHour,timestep/60.0,NumOfSteps,sumHdl);
+	}
 		
 	findFlag = 0;
 	//stop=false;
@@ -570,8 +590,8 @@ short GetRefCurrent(CONSTITUENT *constituent,	// Amplitude-phase array structs
 				lastCurrent = theCurrent;
 			}
 			
- 			theCurrent = RStatCurrentRot(theTime,AMPAPtr,epochPtr,
- 		            	 numOfConstituents,constituent,twoCurrentsAgo,lastCurrent,
+ 			theCurrent = RStatCurrentRotFromSums(uSumHdl[i],sumHdl[i],
+ 		            	 constituent,twoCurrentsAgo,lastCurrent,
  						 &uVelocity,&vVelocity,&vMajor,&vMinor,&direcKey);
 		
 			if(direcKey==33){
@@ -582,8 +602,7 @@ short GetRefCurrent(CONSTITUENT *constituent,	// Amplitude-phase array structs
  			if(direcKey==0) THdl[i].flag = 1;  // don't plot the sucker
 		}
 		else {
- 			theCurrent = RStatCurrent(theTime,AMPAPtr,epochPtr,
- 		            	 refCur,numOfConstituents,CFlag);
+ 			theCurrent = RStatCurrentFromSum(sumHdl[i],refCur,CFlag);
 		}
   		THdl[i].val = theTime;
  		CHdl[i] = theCurrent;
@@ -948,6 +967,8 @@ Error:
 	//if(epochPtr) {free(epochPtr); epochPtr = NULL;}
 	if (AMPAPtr) delete [] AMPAPtr;
 	if (epochPtr) delete [] epochPtr;
+	if (sumHdl) delete [] sumHdl;
+	if (uSumHdl) delete [] uSumHdl;
 	
 	return(errorFlag);
 }
@@ -2324,128 +2345,7 @@ double RStatCurrent(double	theTime,	// time in hrs from begin of year
 {
 /*  Compute cosine stuff and return value */
 
-
-/*  initialize the basic 37 frequencies ... if we pickup more, like */
-/*  for Anchorage, we add them here */
-
-//                  frequency 1/hr     symbol  index   period      name
-
-	double f[] = {	28.9841042,   // M2         1   12.421 hrs. Principal lunar
-					30.0000000,   // S2         2   12.000 hrs  Principal solar
-					28.4397295,   // N2         3   12.685 hrs  Larger lunar elliptic
-					15.0410686,   // K1         4   23.934 hrs  Luni-solar diurnal
-					57.9682084,   // 6.21 hrs   5    6.210 hrs  
-					13.9430356,   // O1         6   25.819 hrs  Principal lunar diurnal
-					86.9523127,   // 4.14 hrs   7    4.14  hrs
-					44.0251729,   // 8.11 hrs   8    8.11  hrs
-					60.0000000,   // 6.00 hrs   9    6.00  hrs
-					57.4238337,   // 6.27 hrs  10    6.27  hrs
-					28.5125831,   // v2        11   12.626 hrs  Larger lunar evectional
-					90.0000000,   // 4.00 hrs  12    4.000 hrs
-					27.9682084,   // m2        13   12.872 hrs  Variational
-					27.8953548,   // 2N2       14   12.905 hrs  Lunar ellipic second order
-					16.1391017,   // 22.31 hrs 15   22.306 hrs  
-					29.4556253,   // l2        16   12.222 hrs  Smaller lunar elliptic
-					15.0000000,   // 24.00 hrs 17   24.000 hrs
-					14.4966939,   // 24.83 hrs 18   24.833 hrs
-					15.5854433,   // 23.10 hrs 19   23.098 hrs
-					0.5443747,    // 27.55 day 20   27.55  day  Lunar monthly
-					0.0821373,    // 182.6 day 21  182.6   day
-					0.0410686,    // 365.2 day 22  365.2   day  Annual
-					1.0158958,    // 14.7  day 23   14.7   day
-					1.0980331,    // 13.66 day 24   13.66  day  Lunar fortnightly
-					13.4715145,   // 26.72 hrs 25   26.72  hrs
-					13.3986609,   // Q1        26   26.868 hrs  Larger lunar elliptic
-					29.9589333,   // T2        27   12.016 hrs  Larger solar elliptic
-					30.0410667,   // 11.98 hrs 28   11.98  hrs
-					12.8542862,   // 28.01 hrs 29   28.01  hrs
-					14.9589314,   // P1        30   24.066 hrs  Principal solar diurnal
-					31.0158958,   // 11.61 hrs 31   11.61  hrs
-					43.4761563,   // 8.28  hrs 32    8.28  hrs
-					29.5284789,   // L2        33   12.192 hrs  Smaller lunar elliptic
-					42.9271398,   // 8.37  hrs 34    8.37  hrs
-					30.0821373,   // 11.97 hrs 35   11.97  hrs
-					115.9364169,  // 3.105 hrs 36    3.105 hrs
-					58.9841042,    // 6.103 hrs 37    6.103 hrs
-					12.9271398,   // Sigma(1)   38   27.848 hrs
-					14.0251729,   // MP(1)      39   25.668
-					14.5695476,   // Chi(1)     40   24.709
-					15.9748272,   // 2PO(1)     41   22.535
-					16.0569644,   // SO(1)      42   22.420
-					30.5443747,   // MSN(2)     43   11.786
-					27.4238337,   // MNS(2)     44   13.127
-					28.9019669,   // OP(2)      45   12.456
-					29.0662415,   // MKS(2)     46   12.386
-					26.8794590,   // 2NS(2)     47   13.393
-					26.9523126,   // MLN2S(2)   48   13.357
-					27.4966873,   // 2ML2S(2)   49   13.092
-					31.0980331,   // SKM(2)     50   11.576
-					27.8039338,   // 2MS2K(2)   51   12.948
-					28.5947204,   // MKL2S(2)   52   12.590
-					29.1483788,   // M2(KS)(2)  53   12.351
-					29.3734880,   // 2SN(MK)(2) 54   12.256
-					30.7086493,   // 2KM(SN)(2) 55   11.723
-					43.9430356,   // SO(3)      56    8.192
-					45.0410686,   // SK(3)      57    7.993
-					42.3827651,   // NO(3)      58    8.494
-					59.0662415,   // MK(4)      59    6.095
-					58.4397295,   // SN(4)      60    6.160
-					57.4966873,   // 2MLS(4)    61    6.261
-					56.9523127,   // 3MS(4)     62    6.321
-					58.5125831,   // ML(4)      63    6.153
-					56.8794590,   // N(4)       64    6.329
-					59.5284789,   // SL(4)      65    6.048
-					71.3668693,   // MNO(5)     66    5.044
-					71.9112440,   // 2MO(5)     67    5.006
-					73.0092770,   // 2MK(5)     68    4.931
-					74.0251728,   // MSK(5)     69    4.863
-					74.1073100,   // 3KM(5)     70    4.858
-					72.9271398,   // 2MP(5)     71    4.936
-					71.9933813,   // 3MP(5)     72    5.000
-					72.4649023,   // MNK(5)     73    4.968
-					88.9841042,   // 2SM(6)     74    4.046
-					86.4079380,   // 2MN(6)     75    4.166
-					87.4238337,   // MSN(6)     76    4.118
-					87.9682084,   // 2MS(6)     77    4.092
-					85.3920421,   // 2NMLS(6)   78    4.216
-					85.8635632,   // 2NM(6)     79    4.193
-					88.5125831,   // MSL(6)     80    4.067
-					87.4966873,   // 2ML(6)     81    4.114
-					89.0662415,   // MSK(6)     82    4.042
-					85.9364168,   // 2MLNS(6)   83    4.189
-					86.4807916,   // 3MLS(6)    84    4.163
-					88.0503457,   // 2MK(6)     85    4.089
-					100.3509735,  // 2MNO(7)    86   42.738 days
-					100.9046318,  // 2NMK(7)    87   16.581 days
-					101.9112440,  // 2MSO(7)    88    7.848 days
-					103.0092771,  // MSKO(7)    89    4.984 days
-					116.4079380,  // 2MSN(8)    90   21.941
-					116.9523127,  // 3MS(8)     91   21.236
-					117.9682084,  // 2(MS)(8)   92   20.035
-					114.8476674,  // 2(MN)(8)   93   24.246
-					115.3920422,  // 2MN(8)     94   23.389
-					117.4966873,  // 2MSL(8)    95   20.575
-					115.4648958,  // 4MLS(8)    96   23.279
-					116.4807916,  // 3ML(8)     97   21.844
-					117.0344500,  // 3MK(8)     98   21.134
-					118.0503457,  // 2MSK(8)    99   19.944
-					129.8887360,  // 2M2NK(9)  100   12.045
-					130.4331108,  // 3MNK(9)   101   11.829
-					130.9774855,  // 4MK(9)    102   11.621
-					131.9933813,  // 3MSK(9)   103   11.252
-					144.3761464,  // 4MN(10)   104    8.112
-					144.9205211,  // M(10)     105    8.014
-					145.3920422,  // 3MNS(10)  106    7.931
-					145.9364169,  // 4MS(10)   107    7.837
-					146.4807916,  // 3MSL(10)  108    7.745
-					146.9523127,  // 3M2S(10)  109    7.667
-					160.9774855,  // 4MSK(11)  110    5.904
-					174.3761464,  // 4MNS(12)  111    4.840
-					174.9205211,  // 5MS(12)   112    4.805
-					175.4648958,  // 4MSL(12)  113    4.770
-					175.9364169   // 4M2S(12)  114    4.741
-	};
-
+	const double *f = kConstituentSpeeds;
 	double DegreesToRadians = 0.01745329252;
 	double current,argu,degrees;
 	short i;					    
@@ -2466,6 +2366,15 @@ double RStatCurrent(double	theTime,	// time in hrs from begin of year
 	  }
 	}
 		
+	return RStatCurrentFromSum(current,refCur,CFlag);
+}
+
+
+/***************************************************************************************/
+double RStatCurrentFromSum(double	current,	// sum of the constituents
+						   double	refCur,		// reference current in knots
+						   short	CFlag)		// hydraulic station flag
+{
 	// Here check to see if we have hydraulic station
 	if(CFlag==1){
 		if(current>0.0){
@@ -2500,135 +2409,69 @@ double RStatCurrentRot(double		theTime,		// time in hrs from begin of year
 /*  Compute cosine stuff and return value */
 /* for rotary currents */
 
+	const double *f = kConstituentSpeeds;
+	double DegreesToRadians = 0.01745329252;		
+	double argu,degrees,u,v;
+	short i,j,start,istop;
 
-/*  initialize the basic 37 frequencies ... if we pickup more, like */
-/*  for Anchorage, we add them here */
-
-//                  frequency 1/hr     symbol  index   period      name
-
-	double f[] = {	28.9841042,   // M2         1   12.421 hrs. Principal lunar
-					30.0000000,   // S2         2   12.000 hrs  Principal solar
-					28.4397295,   // N2         3   12.685 hrs  Larger lunar elliptic
-					15.0410686,   // K1         4   23.934 hrs  Luni-solar diurnal
-					57.9682084,   // 6.21 hrs   5    6.210 hrs  
-					13.9430356,   // O1         6   25.819 hrs  Principal lunar diurnal
-					86.9523127,   // 4.14 hrs   7    4.14  hrs
-					44.0251729,   // 8.11 hrs   8    8.11  hrs
-					60.0000000,   // 6.00 hrs   9    6.00  hrs
-					57.4238337,   // 6.27 hrs  10    6.27  hrs
-					28.5125831,   // v2        11   12.626 hrs  Larger lunar evectional
-					90.0000000,   // 4.00 hrs  12    4.000 hrs
-					27.9682084,   // m2        13   12.872 hrs  Variational
-					27.8953548,   // 2N2       14   12.905 hrs  Lunar ellipic second order
-					16.1391017,   // 22.31 hrs 15   22.306 hrs  
-					29.4556253,   // l2        16   12.222 hrs  Smaller lunar elliptic
-					15.0000000,   // 24.00 hrs 17   24.000 hrs
-					14.4966939,   // 24.83 hrs 18   24.833 hrs
-					15.5854433,   // 23.10 hrs 19   23.098 hrs
-					0.5443747,    // 27.55 day 20   27.55  day  Lunar monthly
-					0.0821373,    // 182.6 day 21  182.6   day
-					0.0410686,    // 365.2 day 22  365.2   day  Annual
-					1.0158958,    // 14.7  day 23   14.7   day
-					1.0980331,    // 13.66 day 24   13.66  day  Lunar fortnightly
-					13.4715145,   // 26.72 hrs 25   26.72  hrs
-					13.3986609,   // Q1        26   26.868 hrs  Larger lunar elliptic
-					29.9589333,   // T2        27   12.016 hrs  Larger solar elliptic
-					30.0410667,   // 11.98 hrs 28   11.98  hrs
-					12.8542862,   // 28.01 hrs 29   28.01  hrs
-					14.9589314,   // P1        30   24.066 hrs  Principal solar diurnal
-					31.0158958,   // 11.61 hrs 31   11.61  hrs
-					43.4761563,   // 8.28  hrs 32    8.28  hrs
-					29.5284789,   // L2        33   12.192 hrs  Smaller lunar elliptic
-					42.9271398,   // 8.37  hrs 34    8.37  hrs
-					30.0821373,   // 11.97 hrs 35   11.97  hrs
-					115.9364169,  // 3.105 hrs 36    3.105 hrs
-					58.9841042,    // 6.103 hrs 37    6.103 hrs
-					12.9271398,   // Sigma(1)   38   27.848 hrs
-					14.0251729,   // MP(1)      39   25.668
-					14.5695476,   // Chi(1)     40   24.709
-					15.9748272,   // 2PO(1)     41   22.535
-					16.0569644,   // SO(1)      42   22.420
-					30.5443747,   // MSN(2)     43   11.786
-					27.4238337,   // MNS(2)     44   13.127
-					28.9019669,   // OP(2)      45   12.456
-					29.0662415,   // MKS(2)     46   12.386
-					26.8794590,   // 2NS(2)     47   13.393
-					26.9523126,   // MLN2S(2)   48   13.357
-					27.4966873,   // 2ML2S(2)   49   13.092
-					31.0980331,   // SKM(2)     50   11.576
-					27.8039338,   // 2MS2K(2)   51   12.948
-					28.5947204,   // MKL2S(2)   52   12.590
-					29.1483788,   // M2(KS)(2)  53   12.351
-					29.3734880,   // 2SN(MK)(2) 54   12.256
-					30.7086493,   // 2KM(SN)(2) 55   11.723
-					43.9430356,   // SO(3)      56    8.192
-					45.0410686,   // SK(3)      57    7.993
-					42.3827651,   // NO(3)      58    8.494
-					59.0662415,   // MK(4)      59    6.095
-					58.4397295,   // SN(4)      60    6.160
-					57.4966873,   // 2MLS(4)    61    6.261
-					56.9523127,   // 3MS(4)     62    6.321
-					58.5125831,   // ML(4)      63    6.153
-					56.8794590,   // N(4)       64    6.329
-					59.5284789,   // SL(4)      65    6.048
-					71.3668693,   // MNO(5)     66    5.044
-					71.9112440,   // 2MO(5)     67    5.006
-					73.0092770,   // 2MK(5)     68    4.931
-					74.0251728,   // MSK(5)     69    4.863
-					74.1073100,   // 3KM(5)     70    4.858
-					72.9271398,   // 2MP(5)     71    4.936
-					71.9933813,   // 3MP(5)     72    5.000
-					72.4649023,   // MNK(5)     73    4.968
-					88.9841042,   // 2SM(6)     74    4.046
-					86.4079380,   // 2MN(6)     75    4.166
-					87.4238337,   // MSN(6)     76    4.118
-					87.9682084,   // 2MS(6)     77    4.092
-					85.3920421,   // 2NMLS(6)   78    4.216
-					85.8635632,   // 2NM(6)     79    4.193
-					88.5125831,   // MSL(6)     80    4.067
-					87.4966873,   // 2ML(6)     81    4.114
-					89.0662415,   // MSK(6)     82    4.042
-					85.9364168,   // 2MLNS(6)   83    4.189
-					86.4807916,   // 3MLS(6)    84    4.163
-					88.0503457,   // 2MK(6)     85    4.089
-					100.3509735,  // 2MNO(7)    86   42.738 days
-					100.9046318,  // 2NMK(7)    87   16.581 days
-					101.9112440,  // 2MSO(7)    88    7.848 days
-					103.0092771,  // MSKO(7)    89    4.984 days
-					116.4079380,  // 2MSN(8)    90   21.941
-					116.9523127,  // 3MS(8)     91   21.236
-					117.9682084,  // 2(MS)(8)   92   20.035
-					114.8476674,  // 2(MN)(8)   93   24.246
-					115.3920422,  // 2MN(8)     94   23.389
-					117.4966873,  // 2MSL(8)    95   20.575
-					115.4648958,  // 4MLS(8)    96   23.279
-					116.4807916,  // 3ML(8)     97   21.844
-					117.0344500,  // 3MK(8)     98   21.134
-					118.0503457,  // 2MSK(8)    99   19.944
-					129.8887360,  // 2M2NK(9)  100   12.045
-					130.4331108,  // 3MNK(9)   101   11.829
-					130.9774855,  // 4MK(9)    102   11.621
-					131.9933813,  // 3MSK(9)   103   11.252
-					144.3761464,  // 4MN(10)   104    8.112
-					144.9205211,  // M(10)     105    8.014
-					145.3920422,  // 3MNS(10)  106    7.931
-					145.9364169,  // 4MS(10)   107    7.837
-					146.4807916,  // 3MSL(10)  108    7.745
-					146.9523127,  // 3M2S(10)  109    7.667
-					160.9774855,  // 4MSK(11)  110    5.904
-					174.3761464,  // 4MNS(12)  111    4.840
-					174.9205211,  // 5MS(12)   112    4.805
-					175.4648958,  // 4MSL(12)  113    4.770
-					175.9364169   // 4M2S(12)  114    4.741
-	};
+/* OK do the computational loop */
+/* Note that north-south component is first in data*/
 
-	double DegreesToRadians = 0.01745329252;		
-	double current,argu,degrees,floodAngle,ebbAngle;
+	v = 0.0;
+	istop = ncoeff/2;;
+	start = 0;
+	
+	for (i=start; i< istop; i++){
+	  // Don't do math if we don't have to.
+	  if(AMPA[i]!=0.0){
+	  	 degrees = (f[i] * theTime + epoch[i]);
+		 degrees = fmod(degrees,360.0);
+		 argu = degrees * DegreesToRadians;
+         v = v + AMPA[i]*cos(argu);
+	  }
+	}
+	
+	// now do the other axis
+	
+	start = istop;
+	istop = ncoeff;
+
+	u = 0.0;
+	
+		for (i=start; i< istop; i++){
+		  // Don't do math if we don't have to.
+		  if(AMPA[i]!=0.0){
+		  	 j=i-start;
+	 	 	 degrees = (f[j] * theTime + epoch[i]);
+			 degrees = fmod(degrees,360.0);
+			 argu = degrees * DegreesToRadians;
+       	  	 u = u + AMPA[i]*cos(argu);
+	 	 }
+		}		
+	
+	return RStatCurrentRotFromSums(u,v,constituent,twoValuesAgo,lastValue,
+								   uVelocity,vVelocity,vmajor,vminor,direcKey);
+}
+
+
+/***************************************************************************************/
+double RStatCurrentRotFromSums(double		uSum,			// sum of the east-west or minor axis constituents
+					 double			vSum,			// sum of the north-south or major axis constituents
+					 CONSTITUENT	*constituent,	// constituent handle
+					 double			twoValuesAgo,	// previous, previous value
+					 double			lastValue,		// previous value
+					 double			*uVelocity,		// east-west component of velocity
+					 double			*vVelocity,		// north-south component of velocity
+					 double			*vmajor,		// major axis velocity if computed
+					 double			*vminor,		// minor axis velocity if computed
+					 short			*direcKey)		// direction key -1 ebb, 1 flood, 0 indeterminate
+{
+	double current,argu,floodAngle,ebbAngle;
 	double u,v,uRefCur,vRefCur,absoluteCurrentValue;
 	double sign,lastSlope,absoluteLastValue;
 	double absoluteTwoValuesAgo,FDir,EDir,newSlope;
 	double xVel,yVel;
-	short i,j,start,istop,hardWayFlag,errorFlag;
+	short hardWayFlag,errorFlag;
 	short L2Flag,HFlag,RotFlag;
 	short MajorMinorKey=2;
 	short Undetermined = 0;
@@ -2660,50 +2503,11 @@ double RStatCurrentRot(double		theTime,		// time in hrs from begin of year
    		lastSlope = absoluteLastValue - absoluteTwoValuesAgo;
    }
    
-/* OK do the computational loop */
-/* Note that north-south component is first in data*/
-
-	v = 0.0;
-	istop = ncoeff/2;;
-	start = 0;
-	
 	vRefCur = GetDatum(constituent);
-	
-	for (i=start; i< istop; i++){
-	  // Don't do math if we don't have to.
-	  if(AMPA[i]!=0.0){
-	  	 degrees = (f[i] * theTime + epoch[i]);
-		 degrees = fmod(degrees,360.0);
-		 argu = degrees * DegreesToRadians;
-         v = v + AMPA[i]*cos(argu);
-	  }
-	}
-	
-	v = vRefCur + v;
-	
-	// now do the other axis
-	
-	start = istop;
-	istop = ncoeff;
-
-	u = 0.0;
-	uRefCur = 0.0;
-		 
+	v = vRefCur + vSum;
 	
  	uRefCur = GetDatum(constituent);
-	
-		for (i=start; i< istop; i++){
-		  // Don't do math if we don't have to.
-		  if(AMPA[i]!=0.0){
-		  	 j=i-start;
-	 	 	 degrees = (f[j] * theTime + epoch[i]);
-			 degrees = fmod(degrees,360.0);
-			 argu = degrees * DegreesToRadians;
-       	  	 u = u + AMPA[i]*cos(argu);
-	 	 }
-		}		
-	
- 	u = uRefCur + u;
+ 	u = uRefCur + uSum;
 	
 	// Now get the vector sum
 	
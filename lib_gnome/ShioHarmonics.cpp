@@ -0,0 +1,208 @@
+/*
+ *  ShioHarmonics.cpp
+ *  gnome
+ *
+ */
+
+#include <math.h>
+
+#include "ShioHarmonics.h"
+
+using namespace std;
+
+static const double kDegreesToRadians = 0.01745329252;	// the value the Shio routines have always used
+
+// rotating a phasor step after step drifts by a rounding error a step,
+// so the phasors are recomputed from the time this often
+static const long kStepsBetweenResets = 32;
+
+//					frequency 1/hr     symbol  index   period      name
+
+const double kConstituentSpeeds[kNumConstituentSpeeds] = {
+					28.9841042,   // M(2)        1   12.421 hrs. Principal lunar
+					30.0000000,   // S(2)        2   12.000 hrs  Principal solar
+					28.4397295,   // N(2)        3   12.685 hrs  Larger lunar elliptic
+					15.0410686,   // K(1)        4   23.934 hrs  Luni-solar diurnal
+					57.9682084,   // M(4)        5    6.210 hrs  
+					13.9430356,   // O(1)        6   25.819 hrs  Principal lunar diurnal
+					86.9523127,   // M(6)        7    4.14  hrs
+					44.0251729,   // MK(3)       8    8.11  hrs
+					60.0000000,   // S(4)        9    6.00  hrs
+					57.4238337,   // MN(4)      10    6.27  hrs
+					28.5125831,   // Nu(2)      11   12.626 hrs  Larger lunar evectional
+					90.0000000,   // S(6)       12    4.000 hrs
+					27.9682084,   // Mu(2)      13   12.872 hrs  Variational
+					27.8953548,   // 2N(2)      14   12.905 hrs  Lunar ellipic second order
+					16.1391017,   // OO(1)      15   22.306 hrs  
+					29.4556253,   // Lambda(2)  16   12.222 hrs  Smaller lunar elliptic
+					15.0000000,   // S(1)       17   24.000 hrs
+					14.4966939,   // M(1)       18   24.833 hrs
+					15.5854433,   // J(1)       19   23.098 hrs
+					0.5443747,    // Mm         20   27.55  day  Lunar monthly
+					0.0821373,    // Ssa        21  182.6   day
+					0.0410686,    // Sa         22  365.2   day  Annual
+					1.0158958,    // Msf        23   14.7   day
+					1.0980331,    // Mf         24   13.66  day  Lunar fortnightly
+					13.4715145,   // Rho(1)     25   26.72  hrs
+					13.3986609,   // Q(1)       26   26.868 hrs  Larger lunar elliptic
+					29.9589333,   // T(2)       27   12.016 hrs  Larger solar elliptic
+					30.0410667,   // R(2)       28   11.98  hrs
+					12.8542862,   // 2Q(1)      29   28.01  hrs
+					14.9589314,   // P(1)       30   24.066 hrs  Principal solar diurnal
+					31.0158958,   // 2SM(2)     31   11.61  hrs
+					43.4761563,   // M(3)       32    8.28  hrs
+					29.5284789,   // L(2)       33   12.192 hrs  Smaller lunar elliptic
+					42.9271398,   // 2MK(3)     34    8.37  hrs
+					30.0821373,   // K(2)       35   11.97  hrs
+					115.9364169,  // M(8)       36    3.105 hrs
+					58.9841042,   // MS(4)      37    6.103 hrs
+					12.9271398,   // Sigma(1)   38   27.848 hrs
+					14.0251729,   // MP(1)      39   25.668
+					14.5695476,   // Chi(1)     40   24.709
+					15.9748272,   // 2PO(1)     41   22.535
+					16.0569644,   // SO(1)      42   22.420
+					30.5443747,   // MSN(2)     43   11.786
+					27.4238337,   // MNS(2)     44   13.127
+					28.9019669,   // OP(2)      45   12.456
+					29.0662415,   // MKS(2)     46   12.386
+					26.8794590,   // 2NS(2)     47   13.393
+					26.9523126,   // MLN2S(2)   48   13.357
+					27.4966873,   // 2ML2S(2)   49   13.092
+					31.0980331,   // SKM(2)     50   11.576
+					27.8039338,   // 2MS2K(2)   51   12.948
+					28.5947204,   // MKL2S(2)   52   12.590
+					29.1483788,   // M2(KS)(2)  53   12.351
+					29.3734880,   // 2SN(MK)(2) 54   12.256
+					30.7086493,   // 2KM(SN)(2) 55   11.723
+					43.9430356,   // SO(3)      56    8.192
+					45.0410686,   // SK(3)      57    7.993
+					42.3827651,   // NO(3)      58    8.494
+					59.0662415,   // MK(4)      59    6.095
+					58.4397295,   // SN(4)      60    6.160
+					57.4966873,   // 2MLS(4)    61    6.261
+					56.9523127,   // 3MS(4)     62    6.321
+					58.5125831,   // ML(4)      63    6.153
+					56.8794590,   // N(4)       64    6.329
+					59.5284789,   // SL(4)      65    6.048
+					71.3668693,   // MNO(5)     66    5.044
+					71.9112440,   // 2MO(5)     67    5.006
+					73.0092770,   // 2MK(5)     68    4.931
+					74.0251728,   // MSK(5)     69    4.863
+					74.1073100,   // 3KM(5)     70    4.858
+					72.9271398,   // 2MP(5)     71    4.936
+					71.9933813,   // 3MP(5)     72    5.000
+					72.4649023,   // MNK(5)     73    4.968
+					88.9841042,   // 2SM(6)     74    4.046
+					86.4079380,   // 2MN(6)     75    4.166
+					87.4238337,   // MSN(6)     76    4.118
+					87.9682084,   // 2MS(6)     77    4.092
+					85.3920421,   // 2NMLS(6)   78    4.216
+					85.8635632,   // 2NM(6)     79    4.193
+					88.5125831,   // MSL(6)     80    4.067
+					87.4966873,   // 2ML(6)     81    4.114
+					89.0662415,   // MSK(6)     82    4.042
+					85.9364168,   // 2MLNS(6)   83    4.189
+					86.4807916,   // 3MLS(6)    84    4.163
+					88.0503457,   // 2MK(6)     85    4.089
+					100.3509735,  // 2MNO(7)    86   42.738 days
+					100.9046318,  // 2NMK(7)    87   16.581 days
+					101.9112440,  // 2MSO(7)    88    7.848 days
+					103.0092771,  // MSKO(7)    89    4.984 days
+					116.4079380,  // 2MSN(8)    90   21.941
+					116.9523127,  // 3MS(8)     91   21.236
+					117.9682084,  // 2(MS)(8)   92   20.035
+					114.8476674,  // 2(MN)(8)   93   24.246
+					115.3920422,  // 2MN(8)     94   23.389
+					117.4966873,  // 2MSL(8)    95   20.575
+					115.4648958,  // 4MLS(8)    96   23.279
+					116.4807916,  // 3ML(8)     97   21.844
+					117.0344500,  // 3MK(8)     98   21.134
+					118.0503457,  // 2MSK(8)    99   19.944
+					129.8887360,  // 2M2NK(9)  100   12.045
+					130.4331108,  // 3MNK(9)   101   11.829
+					130.9774855,  // 4MK(9)    102   11.621
+					131.9933813,  // 3MSK(9)   103   11.252
+					144.3761464,  // 4MN(10)   104    8.112
+					144.9205211,  // M(10)     105    8.014
+					145.3920422,  // 3MNS(10)  106    7.931
+					145.9364169,  // 4MS(10)   107    7.837
+					146.4807916,  // 3MSL(10)  108    7.745
+					146.9523127,  // 3M2S(10)  109    7.667
+					160.9774855,  // 4MSK(11)  110    5.904
+					174.3761464,  // 4MNS(12)  111    4.840
+					174.9205211,  // 5MS(12)   112    4.805
+					175.4648958,  // 4MSL(12)  113    4.770
+					175.9364169   // 4M2S(12)  114    4.741
+};
+
+HarmonicSeries::HarmonicSeries(const double *AMPA, const double *epoch, short firstTerm, short numTerms)
+{
+	for (short i = firstTerm; i < firstTerm + numTerms; i++)
+	{
+		// Don't do math if we don't have to.
+		if (AMPA[i] == 0 || i - firstTerm >= kNumConstituentSpeeds)
+			continue;
+		fAmp.push_back(AMPA[i]);
+		fSpeed.push_back(kConstituentSpeeds[i - firstTerm]);
+		fEpoch.push_back(epoch[i]);
+	}
+}
+
+double HarmonicSeries::Evaluate(double theTime)
+{
+	double sum = 0.0, degrees;
+
+	for (size_t k = 0; k < fAmp.size(); k++)
+	{
+		degrees = fmod(fSpeed[k] * theTime + fEpoch[k], 360.0);
+		sum = sum + fAmp[k] * cos(degrees * kDegreesToRadians);
+	}
+	return sum;
+}
+
+// each term is a phasor turned by its speed times timeStep from one time to the next
+void HarmonicSeries::EvaluateSeries(double startTime, double timeStep, long numTimes, double *sums)
+{
+	long numTerms = (long)fAmp.size(), k, n, first;
+	vector<double> re(numTerms), im(numTerms), stepRe(numTerms), stepIm(numTerms);
+
+	for (k = 0; k < numTerms; k++)
+	{
+		double argu = fmod(fSpeed[k] * timeStep, 360.0) * kDegreesToRadians;
+		stepRe[k] = cos(argu);
+		stepIm[k] = sin(argu);
+	}
+
+	for (first = 0; first < numTimes; first += kStepsBetweenResets)
+	{
+		long last = first + kStepsBetweenResets < numTimes ? first + kStepsBetweenResets : numTimes;
+		double theTime = startTime + first * timeStep;
+
+		for (k = 0; k < numTerms; k++)
+		{
+			double argu = fmod(fSpeed[k] * theTime + fEpoch[k], 360.0) * kDegreesToRadians;
+			re[k] = cos(argu);
+			im[k] = sin(argu);
+		}
+
+		for (n = first; n < last; n++)
+		{
+			double sum = 0.0;
+			const double *amp = &fAmp[0];
+			double *pre = &re[0], *pim = &im[0];
+			const double *sre = &stepRe[0], *sim = &stepIm[0];
+
+			for (k = 0; k < numTerms; k++)
+				sum += amp[k] * pre[k];
+			sums[n] = sum;
+
+			// each term turns on its own, so this loop vectorizes
+			for (k = 0; k < numTerms; k++)
+			{
+				double r = pre[k];
+				pre[k] = r * sre[k] - pim[k] * sim[k];
+				pim[k] = r * sim[k] + pim[k] * sre[k];
+			}
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/*
+ *  ShioHarmonics.h
+ *  gnome
+ *
+ *  Sums of tidal constituents for the Shio height and current routines.
+ *  A HarmonicSeries keeps a station's nonzero amplitudes, speeds and
+ *  epochs, so a curve of evenly spaced times can be summed without
+ *  a cosine per constituent per time.
+ *
+ */
+
+#ifndef __ShioHarmonics__
+#define __ShioHarmonics__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+#define kNumConstituentSpeeds 114
+
+// degrees per hour, in the order of the amplitude and epoch arrays
+extern const double kConstituentSpeeds[kNumConstituentSpeeds];
+
+class DLL_API HarmonicSeries {
+
+public:
+	// AMPA[i] and epoch[i] for firstTerm <= i < firstTerm + numTerms, at speed kConstituentSpeeds[i - firstTerm]
+	HarmonicSeries(const double *AMPA, const double *epoch, short firstTerm, short numTerms);
+
+	long	GetNumTerms() {return (long)fAmp.size();}
+
+	// the sum RStatHeight and RStatCurrent compute, term by term in the same order
+	double	Evaluate(double theTime);
+
+	// sums[n] for theTime = startTime + n * timeStep, to within rounding of Evaluate
+	void	EvaluateSeries(double startTime, double timeStep, long numTimes, double *sums);
+
+private:
+	std::vector<double>	fAmp, fSpeed, fEpoch;
+};
+
+#endif
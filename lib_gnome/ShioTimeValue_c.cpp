@@ -12,6 +12,7 @@
 #include "ShioTimeValue_c.h"
 #include "StringFunctions.h"
 #include "MemUtils.h"
+#include "YearDataStore.h"
 #include <iostream>
 
 #ifndef pyGNOME
@@ -402,6 +403,37 @@ OSErr ShioTimeValue_c::GetTimeValue(const Seconds& current_time, VelocityRec *va
 	endDate.minute = 0;
 	endDate.second = 0;
 	 
+#ifdef pyGNOME
+	// Shio times the values from the start of the first day's year, with that year's
+	// corrections. When the days span Jan 1 and the store has every year of them, they
+	// are cut at Jan 1 so the values around current_time get the corrections of its year;
+	// the other side is computed when the model gets there.
+	if (endDate.year > beginDate.year)
+	{
+		YearDataStore *store;
+		DateTimeRec newYear = endDate;
+		Seconds newYearSeconds;
+
+		GetYearDataDirectory(directoryPath);
+		store = YearDataStore::Get(directoryPath, errStr);
+		errStr[0] = 0;	// reported when the year data is read below
+		if (store && store->HasYears(beginDate.year, endDate.year))
+		{
+			newYear.year = endDate.year;
+			newYear.month = 1;
+			newYear.day = 1;
+			DateToSeconds(&newYear, &newYearSeconds);
+			if (current_time >= newYearSeconds)
+			{
+				beginDate = newYear;
+				beginSeconds = newYearSeconds;
+			}
+			else
+				SecondsToDate(newYearSeconds - 24*3600, &endDate);	// Shio runs to the end of the last day
+		}
+	}
+#endif
+
 	daylightSavings = this->DaylightSavingTimeInEffect(&beginDate);// code goes here, set the daylight flag
 #ifndef pyGNOME	
 #ifdef IBM	// code goes here - decide where to put the yeardata folder
@@ -1544,106 +1576,31 @@ Error:
 	
 }
 /////////////////////////////////////////////////
-YEARDATA2* gYearDataHdl1990Plus2[kMAXNUMSAVEDYEARS];
-
 YEARDATA2* ReadYearData(short year, const char *path, char *errStr)
 
 {
 	// Get year data which are amplitude corrections XODE and epoc correcton VPU
 	
-	// NOTE: as per Andy & Mikes code, this func provides only a single year's
-	// data: it does not handle requests spanning years. Both Andy and Mike would
-	// just ask for the year at the start of the data request.
-	
-	// Each year has its own file of data, named "#2002" for year 2002, for example
+	// Each year has its own file of data, named "#2002" for year 2002, for example.
+	// The files are read once per directory into a YearDataStore, which holds every
+	// year, so a request spanning years can ask for each of them (see YearDataStore::HasYears)
 	
 	// NOTE: you must pass in the file path because it is platform specific:
 	// the files live in the sub-directory "yeardata"
 	// - on Mac the path is ":yeardata:#2002" and works off the app dir as current directory
 	// - on Mac running in python in terminal, the path is "yeardata/#2002"
 	
-	// if errStr not empty then don't bother, something has already gone wrong
-	
-	YEARDATA2	*result = 0;
-	FILE		*stream = 0;
-	double		*xode = 0;
-	double		*vpu = 0;
-	double		data1, data2;
-	char		filePathName[256];
-	short		cnt, numPoints = 0, err = 0;
-	
-	short yearMinus1990 = year-1990;
-	
-	if(0<= yearMinus1990 && yearMinus1990 <kMAXNUMSAVEDYEARS)
-	{
-		if(gYearDataHdl1990Plus2[yearMinus1990]) return gYearDataHdl1990Plus2[yearMinus1990];
-	}
-	//if (errStr[0] != 0) return 0;
-	//errStr[0] = 0;
+	// the result belongs to the store, don't delete it
 	
-	// create the filename of the proper year data file
-	sprintf(filePathName, "%s#%d", path, year);
+	YearDataStore *store = YearDataStore::Get(path, errStr);
+	const YEARDATA2 *result;
 	
-	// It appears that there are 128 data values for XODE and VPU in each file
-	// NOTE: we only collect the first 128 data points (BUG if any more ever get added)
-	
-	try
-	{
-		result = new YEARDATA2;
-		xode = new double[128];
-		vpu = new double[128];
-	}
-	catch (...)
-	{
-		err = -1;
-		strcpy(errStr, "Memory error in ReadYearData");
-	}
-	
-	if (!err) stream = fopen(filePathName, "r");
-	
-	if (stream)
-	{
-		for (cnt = 0; cnt < 128; cnt++)
-		{
-			if (fscanf(stream, "%lf %lf", &data1, &data2) == 2)	// assigned 2 values
-			{
-				numPoints++;
-				xode[cnt] = data1;
-				vpu[cnt] = data2;
-			}
-			else	// we are not getting data points, init to zero
-			{
-				xode[cnt] = 0.0;
-				vpu[cnt] = 0.0;
-			}
-		}
-		fclose(stream);
-	}
-	else
-	{
-		err = -1;
-		sprintf(errStr, "Could not open file '%s'", filePathName);
-	}
-	
-	if (err)
-		
-	{
-		if (vpu) delete [] vpu;
-		if (xode) delete [] xode;
-		if (result) delete result;
-		return 0;
-	}	
-	
-	result->numElements = numPoints;
-	result->XODE = xode;
-	result->VPU = vpu;
-	
-	if(result && 0<= yearMinus1990 && yearMinus1990 <kMAXNUMSAVEDYEARS)
-	{
-		gYearDataHdl1990Plus2[yearMinus1990] = result;
-	}
+	if (!store) return 0;
 	
-	return result;
+	result = store->GetYearData(year);
+	if (!result)
+		sprintf(errStr, "Could not open file '%s#%d'", path, year);
 	
+	return (YEARDATA2*)result;
 }
 
@@ -89,6 +89,8 @@ public:
 	virtual long			GetNumEbbFloodValues ();	
 	virtual long			GetNumHighLowValues ();
 	virtual OSErr			GetTimeValue(const Seconds& current_time, VelocityRec *value);
+	// one time at a time, each may need the values recomputed
+	virtual OSErr			GetTimeValues(const Seconds *times, long numTimes, VelocityRec *values) {return TimeValue_c::GetTimeValues(times, numTimes, values);}
 	virtual WorldPoint		GetStationLocation (void);
 	
 	virtual	double			GetDeriv (Seconds t1, double val1, Seconds t2, double val2, Seconds theTime);
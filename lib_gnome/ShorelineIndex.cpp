@@ -0,0 +1,260 @@
+/*
+ *  ShorelineIndex.cpp
+ *  gnome
+ *
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#include "ShorelineIndex.h"
+#include "ForEachLE.h"
+
+static const long kMaxGridCells = 1L << 22;
+static const double kCellEpsilon = 1e-9;		// in cells, so sides on a cell boundary are in both cells
+static const double kLastWaterOffset = 1e-6;	// in degrees, from the shoreline back along the move
+
+ShorelineIndex::ShorelineIndex()
+{
+	fOriginX = fOriginY = 0;
+	fCellWidth = fCellHeight = 1;
+	fNumCols = fNumRows = 0;
+}
+
+OSErr ShorelineIndex::SetPolygons(const WorldPoint *points, const long *numPoints, long numPolygons)
+{
+	double minX = 0, minY = 0, maxX = 0, maxY = 0, width, height, cellSize;
+	long i, j, first = 0, numCells;
+
+	fSegments.clear();
+	fCellStart.clear();
+	fCellSegments.clear();
+	fNumCols = fNumRows = 0;
+
+	try
+	{
+		for (i = 0; i < numPolygons; first += numPoints[i++])
+		{
+			long n = numPoints[i];
+
+			// drop a repeated closing point, then close it ourselves
+			if (n > 1 && points[first].pLong == points[first + n - 1].pLong && points[first].pLat == points[first + n - 1].pLat)
+				n--;
+			if (n < 2) continue;
+
+			for (j = 0; j < n; j++)
+			{
+				const WorldPoint &a = points[first + j], &b = points[first + (j + 1) % n];
+				Segment s = {a.pLong, a.pLat, b.pLong, b.pLat};
+
+				if (fSegments.empty()) {minX = maxX = s.x0; minY = maxY = s.y0;}
+				minX = std::min(minX, std::min(s.x0, s.x1)); maxX = std::max(maxX, std::max(s.x0, s.x1));
+				minY = std::min(minY, std::min(s.y0, s.y1)); maxY = std::max(maxY, std::max(s.y0, s.y1));
+				fSegments.push_back(s);
+			}
+		}
+		if (fSegments.empty())
+			return 0;
+
+		// about one side to a cell
+		width = std::max(maxX - minX, 1e-9);
+		height = std::max(maxY - minY, 1e-9);
+		numCells = std::min((long)fSegments.size(), kMaxGridCells);
+		cellSize = sqrt(width * height / numCells);
+		fNumCols = std::max(1L, std::min((long)ceil(width / cellSize), numCells));
+		fNumRows = std::max(1L, std::min((long)ceil(height / cellSize), numCells / fNumCols));
+		fOriginX = minX;
+		fOriginY = minY;
+		fCellWidth = width / fNumCols;
+		fCellHeight = height / fNumRows;
+
+		// count the sides in each cell, then fill them in
+		fCellStart.assign(fNumCols * fNumRows + 1, 0);
+		for (i = 0; i < (long)fSegments.size(); i++)
+			VisitSegmentCells(fSegments[i], [&](long cell) {fCellStart[cell + 1]++;});
+		for (i = 0; i < fNumCols * fNumRows; i++)
+			fCellStart[i + 1] += fCellStart[i];
+
+		std::vector<long> next(fCellStart.begin(), fCellStart.end() - 1);
+		fCellSegments.resize(fCellStart.back());
+		for (i = 0; i < (long)fSegments.size(); i++)
+			VisitSegmentCells(fSegments[i], [&](long cell) {fCellSegments[next[cell]++] = i;});
+	}
+	catch (...)
+	{
+		fSegments.clear();
+		fCellStart.clear();
+		fCellSegments.clear();
+		fNumCols = fNumRows = 0;
+		return memFullErr;
+	}
+	return 0;
+}
+
+long ShorelineIndex::ColumnOf(double gx) const
+{
+	return gx < 0 ? 0 : (gx >= fNumCols ? fNumCols - 1 : (long)gx);
+}
+
+long ShorelineIndex::RowOf(double gy) const
+{
+	return gy < 0 ? 0 : (gy >= fNumRows ? fNumRows - 1 : (long)gy);
+}
+
+// every cell the side touches, and some it only comes close to
+template <class Visit> void ShorelineIndex::VisitSegmentCells(const Segment &s, const Visit &visit) const
+{
+	double gx0 = (s.x0 - fOriginX) / fCellWidth, gy0 = (s.y0 - fOriginY) / fCellHeight;
+	double gx1 = (s.x1 - fOriginX) / fCellWidth, gy1 = (s.y1 - fOriginY) / fCellHeight;
+	double loX = std::min(gx0, gx1), hiX = std::max(gx0, gx1);
+	long col, row, lastCol = ColumnOf(hiX + kCellEpsilon);
+
+	for (col = ColumnOf(loX - kCellEpsilon); col <= lastCol; col++)
+	{
+		// the part of the side over this column
+		double xa = std::max(loX, col - kCellEpsilon), xb = std::min(hiX, col + 1 + kCellEpsilon);
+		double ya = gy0, yb = gy1;
+
+		if (gx1 != gx0)
+		{
+			ya = gy0 + (xa - gx0) * (gy1 - gy0) / (gx1 - gx0);
+			yb = gy0 + (xb - gx0) * (gy1 - gy0) / (gx1 - gx0);
+		}
+		for (row = RowOf(std::min(ya, yb) - kCellEpsilon); row <= RowOf(std::max(ya, yb) + kCellEpsilon); row++)
+			visit(col * fNumRows + row);
+	}
+}
+
+// The cells the move may pass through, in the order it gets to them, with the
+// fraction of the move done by the time it leaves each one. Stops when visit
+// returns false.
+template <class Visit> void ShorelineIndex::VisitMoveCells(double x0, double y0, double x1, double y1, const Visit &visit) const
+{
+	double gx0 = (x0 - fOriginX) / fCellWidth, gy0 = (y0 - fOriginY) / fCellHeight;
+	double dx = (x1 - x0) / fCellWidth, dy = (y1 - y0) / fCellHeight;
+	long col, row, sx = dx < 0 ? -1 : 1, sy = dy < 0 ? -1 : 1;
+	long firstCol = ColumnOf(gx0), lastCol = ColumnOf(gx0 + dx);
+
+	if ((gx0 < 0 && gx0 + dx < 0) || (gy0 < 0 && gy0 + dy < 0)
+		|| (gx0 >= fNumCols && gx0 + dx >= fNumCols) || (gy0 >= fNumRows && gy0 + dy >= fNumRows))
+		return;
+
+	for (col = firstCol; ; col += sx)
+	{
+		// the part of the move over this column
+		double ta = 0, tb = 1, ya, yb;
+
+		if (dx != 0)
+		{
+			ta = std::max(0., std::min((col - gx0) / dx, (col + 1 - gx0) / dx));
+			tb = std::min(1., std::max((col - gx0) / dx, (col + 1 - gx0) / dx));
+		}
+		if (ta <= tb)
+		{
+			long firstRow, lastRow;
+
+			ya = gy0 + ta * dy;
+			yb = gy0 + tb * dy;
+			firstRow = RowOf((sy > 0 ? ya : yb) - sy * kCellEpsilon);
+			lastRow = RowOf((sy > 0 ? yb : ya) + sy * kCellEpsilon);
+
+			for (row = sy > 0 ? firstRow : lastRow; ; row += sy)
+			{
+				double tLeave = tb;
+
+				if (dy != 0)
+					tLeave = std::max(ta, std::min(tb, ((sy > 0 ? row + 1 : row) - gy0) / dy));
+				if (!visit(col * fNumRows + row, tLeave))
+					return;
+				if (row == (sy > 0 ? lastRow : firstRow)) break;
+			}
+		}
+		if (col == lastCol) break;
+	}
+}
+
+Boolean ShorelineIndex::FindFirstCrossing(const WorldPoint &start, const WorldPoint &end, WorldPoint *lastWater, WorldPoint *hit) const
+{
+	double rx = end.pLong - start.pLong, ry = end.pLat - start.pLat;
+	double bestT = 2, length, backT;
+
+	if (fSegments.empty() || (rx == 0 && ry == 0))
+		return false;
+
+	VisitMoveCells(start.pLong, start.pLat, end.pLong, end.pLat, [&](long cell, double tLeave) {
+		for (long k = fCellStart[cell]; k < fCellStart[cell + 1]; k++)
+		{
+			const Segment &s = fSegments[fCellSegments[k]];
+			double sx = s.x1 - s.x0, sy = s.y1 - s.y0;
+			double qx = s.x0 - start.pLong, qy = s.y0 - start.pLat;
+			double denom = rx * sy - ry * sx, t, u;
+
+			if (denom == 0) continue;	// parallel -- sliding along a side isn't crossing it
+			t = (qx * sy - qy * sx) / denom;
+			u = (qx * ry - qy * rx) / denom;
+			if (t >= 0 && t <= 1 && u >= 0 && u <= 1 && t < bestT)
+				bestT = t;
+		}
+		return bestT > tLeave;	// nothing in a later cell can come before it
+	});
+	if (bestT > 1)
+		return false;
+
+	length = sqrt(rx * rx + ry * ry);
+	backT = std::max(0., bestT - kLastWaterOffset / length);
+	hit->pLong = start.pLong + bestT * rx;
+	hit->pLat = start.pLat + bestT * ry;
+	lastWater->pLong = start.pLong + backT * rx;
+	lastWater->pLat = start.pLat + backT * ry;
+	return true;
+}
+
+// counts the sides crossed going east from the point
+Boolean ShorelineIndex::IsOnLand(const WorldPoint &p) const
+{
+	double gx = (p.pLong - fOriginX) / fCellWidth, gy = (p.pLat - fOriginY) / fCellHeight;
+	std::vector<long> crossed;
+	long col, row;
+
+	if (fSegments.empty() || gx >= fNumCols || gy < 0 || gy >= fNumRows)
+		return false;
+
+	row = RowOf(gy);
+	for (col = ColumnOf(gx); col < fNumCols; col++)
+	{
+		long cell = col * fNumRows + row;
+
+		for (long k = fCellStart[cell]; k < fCellStart[cell + 1]; k++)
+		{
+			const Segment &s = fSegments[fCellSegments[k]];
+
+			if ((s.y0 > p.pLat) != (s.y1 > p.pLat)
+				&& s.x0 + (p.pLat - s.y0) * (s.x1 - s.x0) / (s.y1 - s.y0) > p.pLong)
+				crossed.push_back(fCellSegments[k]);
+		}
+	}
+	// a side can be in more than one of the cells
+	std::sort(crossed.begin(), crossed.end());
+	return (std::unique(crossed.begin(), crossed.end()) - crossed.begin()) % 2 == 1;
+}
+
+void ShorelineIndex::BeachElements(long numLEs, const WorldPoint3D *positions, WorldPoint3D *nextPositions,
+								   short *statusCodes, WorldPoint3D *lastWaterPositions) const
+{
+	ForEachLE(numLEs, [=](long first, long last)
+	{
+		WorldPoint lastWater, hit;
+
+		for (long i = first; i < last; i++)
+		{
+			if (statusCodes[i] == OILSTAT_ONLAND) continue;
+
+			if (FindFirstCrossing(positions[i].p, nextPositions[i].p, &lastWater, &hit))
+			{
+				statusCodes[i] = OILSTAT_ONLAND;
+				nextPositions[i].p = hit;
+				lastWaterPositions[i].p = lastWater;
+			}
+		}
+	});
+}
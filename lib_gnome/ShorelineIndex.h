@@ -0,0 +1,62 @@
+/*
+ *  ShorelineIndex.h
+ *  gnome
+ *
+ *  Beaching against the shoreline polygons themselves, rather than a
+ *  raster drawn from them. The polygon sides are sorted into a grid of
+ *  cells, so a move is only tested against the sides in the cells it
+ *  passes through, nearest first. The land hit is where the move first
+ *  crosses the shoreline, to the accuracy of the polygons.
+ *
+ *  Lakes are just more shoreline: a move from water hits land at the
+ *  first side it crosses, whichever polygon that side is from.
+ *
+ */
+
+#ifndef __ShorelineIndex__
+#define __ShorelineIndex__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class DLL_API ShorelineIndex {
+
+public:
+	ShorelineIndex();
+
+	// the points of all the polygons one after the other, numPoints[i] of them for polygon i;
+	// a polygon is closed whether or not its last point repeats the first
+	OSErr		SetPolygons(const WorldPoint *points, const long *numPoints, long numPolygons);
+	long		GetNumSegments() const {return fSegments.size();}
+
+	// the point where the move first crosses the shoreline, and a point just
+	// back from it along the move; false if the move doesn't cross
+	Boolean		FindFirstCrossing(const WorldPoint &start, const WorldPoint &end, WorldPoint *lastWater, WorldPoint *hit) const;
+	Boolean		IsOnLand(const WorldPoint &p) const;
+
+	// as RasterLandCheck::BeachElements, but beached LEs end exactly on the shoreline
+	void		BeachElements(long numLEs, const WorldPoint3D *positions, WorldPoint3D *nextPositions,
+							  short *statusCodes, WorldPoint3D *lastWaterPositions) const;
+
+private:
+	typedef struct {
+		double	x0, y0, x1, y1;
+	} Segment;
+
+	std::vector<Segment>	fSegments;
+	std::vector<long>	fCellStart;		// the sides in cell i are fCellSegments[fCellStart[i]] up to fCellStart[i + 1]
+	std::vector<long>	fCellSegments;
+	double		fOriginX, fOriginY;		// lower left corner of the grid
+	double		fCellWidth, fCellHeight;
+	long		fNumCols, fNumRows;
+
+	long		ColumnOf(double gx) const;
+	long		RowOf(double gy) const;
+	template <class Visit> void	VisitSegmentCells(const Segment &s, const Visit &visit) const;
+	template <class Visit> void	VisitMoveCells(double x0, double y0, double x1, double y1, const Visit &visit) const;
+};
+
+#endif
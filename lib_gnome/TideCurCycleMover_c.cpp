@@ -272,12 +272,12 @@ OSErr TideCurCycleMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRe
 	//err = this -> UpdateUncertainty();
 	//if(err) return err;
 	
-	if(!fUncertaintyListH || !fLESetSizesH) return 0; // this is our clue to not add uncertainty
+	if(!fUncertainty.IsAllocated()) return 0; // this is our clue to not add uncertainty
 	
 	
-	if(fUncertaintyListH && fLESetSizesH)
+	if(fUncertainty.IsAllocated())
 	{
-		unrec=(*fUncertaintyListH)[(*fLESetSizesH)[setIndex]+leIndex];
+		unrec=fUncertainty.GetCurrentRec(setIndex,leIndex);
 		lengthS = sqrt(velocity->u*velocity->u + velocity->v * velocity->v);
 		
 		
@@ -302,7 +302,7 @@ OSErr TideCurCycleMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRe
 	}
 	else 
 	{
-		TechError("TideCurCycleMover::AddUncertainty()", "fUncertaintyListH==nil", 0);
+		TechError("TideCurCycleMover::AddUncertainty()", "fUncertainty not allocated", 0);
 		err = -1;
 		velocity->u=velocity->v=0;
 	}
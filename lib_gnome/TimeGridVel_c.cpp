@@ -19,11 +19,15 @@
 #include "StringFunctions.h"
 #include "DagTreeIO.h"
 #include "OUTILS.H"	// for the units
+#include "BlendedVelocityField.h"
+#include "TimeSlicePrefetcher.h"
 
 #ifndef pyGNOME
 #include "CROSS.H"
 #else
 #include "Replacements.h"
+#include "VelocitySliceCache.h"
+#include "NetCDFFilePool.h"
 #endif
 
 
@@ -107,6 +111,7 @@ Boolean IsNetCDFPathsFile (char *path, Boolean *isNetCDFPathsFile, char *fileNam
 /////////////////////////////////////////////////
 Boolean IsNetCDFFile (char *path, short *gridType)	
 {
+	NetCDFLock lock;	// the writer thread may be in the library
 	// separate into IsNetCDFFile and GetGridType
 	OSErr err = noErr;
 	Boolean	bIsValid = false;
@@ -278,10 +283,33 @@ TimeGridVel_c::TimeGridVel_c ()
 	fMaxDepthForExtrapolation = 0.;	// assume 2D is just surface
 	
 	fNumCols = fNumRows = 0;
+	fNumOwners = 1;
+
+	bPrefetchNextSlice = false;
+	fPrefetcher = 0;
+	fFilePool = 0;
+
+	fVelocityBlendMode = BLEND_TILES;
+	fMaxBlendedValuesPerLE = 10.;
+	fBlendedVelocities = 0;
 }
 
 void TimeGridVel_c::Dispose ()
 {
+	// the background read uses the file info below, stop it first
+	if (fPrefetcher)
+	{
+		delete fPrefetcher;
+		fPrefetcher = 0;
+	}
+	
+	// closes the files ReadTimeData kept open
+	if (fFilePool)
+	{
+		delete fFilePool;
+		fFilePool = 0;
+	}
+	
 	if (fGrid)
 	{
 		fGrid -> Dispose();
@@ -296,6 +324,11 @@ void TimeGridVel_c::Dispose ()
 	
 	if(fInputFilesHdl) {DisposeHandle((Handle)fInputFilesHdl); fInputFilesHdl=0;}
 	
+	if (fBlendedVelocities)
+	{
+		delete fBlendedVelocities;
+		fBlendedVelocities = 0;
+	}
 }
 
 
@@ -474,6 +507,219 @@ Boolean TimeGridVel_c::CheckInterval(long &timeDataInterval, const Seconds& mode
 	return false;
 }
 
+// the loaded interval is used as a constant current (single time or extrapolating in time)
+Boolean TimeGridVel_c::IsConstantInTime(const Seconds& model_time)
+{
+	if (GetNumTimesInFile()==1 && !(GetNumFiles()>1))
+		return true;
+	if (fEndData.timeIndex == UNASSIGNEDINDEX && fAllowExtrapolationInTime)
+	{
+		if (model_time > ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift) || model_time < ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift))
+			return true;
+	}
+	return false;
+}
+
+// time weight factor for the start data of the loaded interval, only valid if not IsConstantInTime
+double TimeGridVel_c::GetTimeAlpha(const Seconds& model_time)
+{
+	Seconds startTime, endTime;
+
+	if (GetNumFiles()>1 && fOverLap)
+		startTime = fOverLapStartTime + fTimeShift;
+	else
+		startTime = (*fTimeHdl)[fStartData.timeIndex] + fTimeShift;
+	endTime = (*fTimeHdl)[fEndData.timeIndex] + fTimeShift;
+
+	return (endTime - model_time)/(double)(endTime - startTime);
+}
+
+// LEs that are not in the water get a zero velocity
+// grids that can do their lookups for the whole array at once override this
+void TimeGridVel_c::GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris)
+{
+	long n = les.GetNumLEs();
+	WorldPoint3D refPoint;
+	VelocityRec zeroVel = {0.,0.};
+
+	for (int i = 0; i < n; i++)
+	{
+		if (!les.IsInWater(i))
+		{
+			vels[i] = zeroVel;
+			continue;
+		}
+		refPoint = les.GetScaledPosition(i);
+
+		vels[i] = GetScaledPatValue(model_time, refPoint);
+	}
+}
+
+void TimeGridVel_c::SetPrefetchNextSlice(bool prefetch)
+{
+	bPrefetchNextSlice = prefetch;
+
+	if (bPrefetchNextSlice && !fPrefetcher)
+		fPrefetcher = new TimeSlicePrefetcher();
+	else if (!bPrefetchNextSlice && fPrefetcher)
+		fPrefetcher->Cancel();
+}
+
+void TimeGridVel_c::GetPrefetchCounts(long *numHits, long *numMisses, long *numStalls)
+{
+	*numHits = *numMisses = *numStalls = 0;
+
+	if (fPrefetcher)
+	{
+		*numHits = fPrefetcher->fNumHits;
+		*numMisses = fPrefetcher->fNumMisses;
+		*numStalls = fPrefetcher->fNumStalls;
+	}
+}
+
+void TimeGridVel_c::SetUsePointIndex(bool usePointIndex)
+{
+	TTriGridVel *triGrid = dynamic_cast<TTriGridVel*>(fGrid);
+
+	if (triGrid)
+		triGrid->SetUsePointIndex(usePointIndex);
+}
+
+bool TimeGridVel_c::GetUsePointIndex()
+{
+	TTriGridVel *triGrid = dynamic_cast<TTriGridVel*>(fGrid);
+
+	return triGrid ? triGrid->GetUsePointIndex() : false;
+}
+
+void TimeGridVel_c::SetVelocityBlendMode(short blendMode)
+{
+	fVelocityBlendMode = blendMode;
+	if (fBlendedVelocities)
+		fBlendedVelocities->Invalidate();
+}
+
+void TimeGridVel_c::GetBlendedTileCounts(long *numTiles, long *numTilesBlended)
+{
+	*numTiles = *numTilesBlended = 0;
+
+	if (fBlendedVelocities)
+	{
+		*numTiles = fBlendedVelocities->GetNumTiles();
+		*numTilesBlended = fBlendedVelocities->GetNumTilesBlended();
+	}
+}
+
+// triangle number for each point, negative outside the grid
+OSErr TimeGridVel_c::LocateTriangles(long n, WorldPoint3D *points, long *triIndices, bool useDagTree)
+{
+	TTriGridVel *triGrid = dynamic_cast<TTriGridVel*>(fGrid);
+	TDagTree *dagTree = triGrid ? triGrid->GetDagTree() : 0;
+	LongPoint lp;
+
+	if (!dagTree)
+		return -1;
+
+	for (long i = 0; i < n; i++)
+	{
+		lp.h = points[i].p.pLong * 1000000;
+		lp.v = points[i].p.pLat * 1000000;
+		triIndices[i] = useDagTree ? dagTree->WhatTriAmIInDag(lp) : dagTree->WhatTriAmIIn(lp);
+	}
+	return noErr;
+}
+
+// the open files ReadTimeData reads from, only used with the NetCDFLock held
+NetCDFFilePool* TimeGridVel_c::GetFilePool()
+{
+	if (!fFilePool)
+		fFilePool = new NetCDFFilePool();
+	return fFilePool;
+}
+
+// where the ReadTimeData running on this thread puts the slice's fill value and
+// scale factor, 0 for the grid itself
+static thread_local SliceAttributes *tSliceAttributes = 0;
+
+void TimeGridVel_c::SetSliceFillValue(float fillValue)
+{
+	if (tSliceAttributes)
+	{
+		tSliceAttributes->fillValue = fillValue;
+		tSliceAttributes->hasFillValue = true;
+	}
+	else
+		fFillValue = fillValue;
+}
+
+void TimeGridVel_c::SetSliceScaleFactor(double scaleFactor)
+{
+	if (tSliceAttributes)
+	{
+		tSliceAttributes->scaleFactor = scaleFactor;
+		tSliceAttributes->hasScaleFactor = true;
+	}
+	else
+		fVar.fileScaleFactor = scaleFactor;
+}
+
+void TimeGridVel_c::SetSliceAttributes(const SliceAttributes &attributes)
+{
+	if (attributes.hasFillValue) fFillValue = attributes.fillValue;
+	if (attributes.hasScaleFactor) fVar.fileScaleFactor = attributes.scaleFactor;
+}
+
+// ReadTimeData, but takes the slice from the background read if it has it
+OSErr TimeGridVel_c::LoadTimeData(long index, VelocityFH *velocityH, char* errmsg)
+{
+	SliceAttributes attributes;
+
+	if (bPrefetchNextSlice && fPrefetcher && fPrefetcher->Take(index, velocityH, &attributes))
+	{
+		// the grid is only changed here, on the thread using it
+		SetSliceAttributes(attributes);
+		return noErr;
+	}
+
+	return ReadTimeDataCached(index, velocityH, errmsg);
+}
+
+// ReadTimeData through the process wide slice cache, the file is only read on a miss
+OSErr TimeGridVel_c::ReadTimeDataCached(long index, VelocityFH *velocityH, char* errmsg, SliceAttributes *attributes)
+{
+	OSErr err = 0;
+	VelocitySliceKey key;
+	SliceAttributes read = {false, false, 0.f, 1.};
+	Boolean useCache = VelocitySliceCache::GetBudget() > 0 && GetSliceCacheKey(index, &key);
+
+	if (useCache && VelocitySliceCache::Lookup(key, velocityH, &read.fillValue, &read.scaleFactor))
+	{
+		// ReadTimeData sets these along with the slice
+		read.hasFillValue = true;
+		read.hasScaleFactor = read.scaleFactor != 1.;
+	}
+	else
+	{
+		{
+			NetCDFLock lock;
+			tSliceAttributes = &read;
+			err = this->ReadTimeData(index, velocityH, errmsg);
+			tSliceAttributes = 0;
+		}
+		if (err) return err;
+
+		// the cached grids' reads all give the fill value
+		if (useCache && read.hasFillValue)
+			VelocitySliceCache::Insert(key, *velocityH, read.fillValue, read.hasScaleFactor ? read.scaleFactor : 1.);
+	}
+
+	if (attributes)
+		*attributes = read;
+	else
+		SetSliceAttributes(read);
+	return noErr;
+}
+
 void TimeGridVel_c::DisposeTimeHdl()
 {	
 	if(fTimeHdl) {DisposeHandle((Handle)fTimeHdl); fTimeHdl=0;}
@@ -493,6 +739,9 @@ void TimeGridVel_c::DisposeAllLoadedData()
 
 void TimeGridVel_c::ClearLoadedData(LoadedData *dataPtr)
 {
+	// the blended field reads the loaded handles
+	if (fBlendedVelocities)
+		fBlendedVelocities->Invalidate();
 	dataPtr -> dataHdl = 0;
 	dataPtr -> timeIndex = UNASSIGNEDINDEX;
 }
@@ -501,6 +750,7 @@ void TimeGridVel_c::ClearLoadedData(LoadedData *dataPtr)
 // for now leave this part out of the python and let the file path list be passed in
 OSErr TimeGridVel_c::ReadInputFileNames(char *fileNamesPath)
 {
+	NetCDFLock lock;
 	OSErr err = 0;
 	char errmsg[256] = "";
 	char s[1024], path[256], outPath[256], classicPath[kMaxNameLen];
@@ -716,6 +966,7 @@ long TimeGridVelRect_c::GetNumDepthLevelsInFile()
 /////////////////////////////////////////////////////////////////
 OSErr TimeGridVelRect_c::TextRead(const char *path, const char *topFilePath)
 {
+	NetCDFLock lock;
 	// this code is for regular grids
 	// For regridded data files don't have the real latitude/longitude values
 	// Also may want to get fill_Value and scale_factor here, rather than every time velocities are read
@@ -1072,17 +1323,27 @@ done:
 }
 
 
+Boolean TimeGridVelRect_c::GetSliceCacheKey(long index, VelocitySliceKey *key)
+{
+	if (!fVar.pathName[0]) return false;
+
+	key->path = fVar.pathName;
+	key->variable = fIsNavy ? "rect_navy" : "rect";
+	key->timeIndex = index;
+	key->depth = fNumDepthLevels;
+	return true;
+}
+
 OSErr TimeGridVelRect_c::ReadTimeData(long index,VelocityFH *velocityH, char* errmsg) 
 {
 	OSErr err = 0;
 	long i,j,k;
 	char path[256], outPath[256]; 
-	char *velUnits=0; 
+	string velUnits; 
 	int status, ncid, numdims, uv_ndims, numvars;
 	int curr_ucmp_id, curr_vcmp_id, depthid;
-	static size_t curr_index[] = {0,0,0,0};
-	static size_t curr_count[4];
-	size_t velunit_len;
+	size_t curr_index[] = {0,0,0,0};
+	size_t curr_count[4] = {0,0,0,0};
 	double *curr_uvals=0,*curr_vvals=0, fill_value, velConversion=1.;
 	long totalNumberOfVels = fNumRows * fNumCols;
 	VelocityFH velH = 0;
@@ -1092,23 +1353,25 @@ OSErr TimeGridVelRect_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 	double scale_factor = 1.;
 	Boolean bDepthIncluded = false;
 	
+	NetCDFFilePool *pool = GetFilePool();
+	
 	errmsg[0]=0;
 	
 	strcpy(path,fVar.pathName);
 	if (!path || !path[0]) return -1;
 	
-	status = nc_open(path, NC_NOWRITE, &ncid);
+	status = pool->Open(path, &ncid);
 	if (status != NC_NOERR) {err = -1; goto done;}
 	
-	status = nc_inq_ndims(ncid, &numdims);
+	status = pool->InqNDims(ncid, &numdims);
 	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	if (numdims>=4)
 	{	// code goes here, do we really want to use all the depths? 
-		status = nc_inq_dimid(ncid, "depth", &depthid);	//3D
+		status = pool->InqDimID(ncid, "depth", &depthid);	//3D
 		if (status != NC_NOERR) 
 		{
-			status = nc_inq_dimid(ncid, "sigma", &depthid);	//3D - need to check sigma values in TextRead...
+			status = pool->InqDimID(ncid, "sigma", &depthid);	//3D - need to check sigma values in TextRead...
 			if (status != NC_NOERR) bDepthIncluded = false;
 			else bDepthIncluded = true;
 		}
@@ -1136,25 +1399,25 @@ OSErr TimeGridVelRect_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 	curr_vvals = new double[latlength*lonlength*depthlength]; 
 	if(!curr_vvals) {TechError("TimeGridVel::ReadTimeData()", "new[]", 0); err = memFullErr; goto done;}
 	
-	status = nc_inq_varid(ncid, "water_u", &curr_ucmp_id);
+	status = pool->InqVarID(ncid, "water_u", &curr_ucmp_id);
 	if (status != NC_NOERR) 
 	{
-		status = nc_inq_varid(ncid, "curr_ucmp", &curr_ucmp_id); 
+		status = pool->InqVarID(ncid, "curr_ucmp", &curr_ucmp_id); 
 		if (status != NC_NOERR) 
 		{
-			status = nc_inq_varid(ncid, "u", &curr_ucmp_id); // allow u,v since so many people get confused
-			if (status != NC_NOERR) {status = nc_inq_varid(ncid, "U", &curr_ucmp_id); if (status != NC_NOERR)	// ferret uses CAPS
+			status = pool->InqVarID(ncid, "u", &curr_ucmp_id); // allow u,v since so many people get confused
+			if (status != NC_NOERR) {status = pool->InqVarID(ncid, "U", &curr_ucmp_id); if (status != NC_NOERR)	// ferret uses CAPS
 			{err = -1; goto LAS;}}	// broader check for variable names coming out of LAS
 		}	
 	}
-	status = nc_inq_varid(ncid, "water_v", &curr_vcmp_id);	// what if only input one at a time (u,v separate movers)?
+	status = pool->InqVarID(ncid, "water_v", &curr_vcmp_id);	// what if only input one at a time (u,v separate movers)?
 	if (status != NC_NOERR) 
 	{
-		status = nc_inq_varid(ncid, "curr_vcmp", &curr_vcmp_id); 
+		status = pool->InqVarID(ncid, "curr_vcmp", &curr_vcmp_id); 
 		if (status != NC_NOERR) 
 		{
-			status = nc_inq_varid(ncid, "v", &curr_vcmp_id); // allow u,v since so many people get confused
-			if (status != NC_NOERR) {status = nc_inq_varid(ncid, "V", &curr_vcmp_id); if (status != NC_NOERR)	// ferret uses CAPS
+			status = pool->InqVarID(ncid, "v", &curr_vcmp_id); // allow u,v since so many people get confused
+			if (status != NC_NOERR) {status = pool->InqVarID(ncid, "V", &curr_vcmp_id); if (status != NC_NOERR)	// ferret uses CAPS
 			{err = -1; goto done;}}
 		}	
 	}
@@ -1195,7 +1458,7 @@ LAS:
 	}
 	
 	
-	status = nc_inq_varndims(ncid, curr_ucmp_id, &uv_ndims);
+	status = pool->InqVarNDims(ncid, curr_ucmp_id, &uv_ndims);
 	if (status==NC_NOERR){if (uv_ndims < numdims && uv_ndims==3) {curr_count[1] = latlength; curr_count[2] = lonlength;}}	// could have more dimensions than are used in u,v
 	if (uv_ndims==4) {curr_count[1] = depthlength;curr_count[2] = latlength;curr_count[3] = lonlength;}
 	status = nc_get_vara_double(ncid, curr_ucmp_id, curr_index, curr_count, curr_uvals);
@@ -1204,35 +1467,27 @@ LAS:
 	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	
-	status = nc_inq_attlen(ncid, curr_ucmp_id, "units", &velunit_len);
+	status = pool->GetAttText(ncid, curr_ucmp_id, "units", &velUnits);
 	if (status == NC_NOERR)
 	{
-		velUnits = new char[velunit_len+1];
-		status = nc_get_att_text(ncid, curr_ucmp_id, "units", velUnits);
-		if (status == NC_NOERR)
-		{
-			velUnits[velunit_len] = '\0'; 
-			if (!strcmpnocase(velUnits,"cm/s") ||!strcmpnocase(velUnits,"Centimeters per second") )
-				velConversion = .01;
-			else if (!strcmpnocase(velUnits,"m/s"))
-				velConversion = 1.0;
-		}
+		if (!strcmpnocase(velUnits.c_str(),"cm/s") ||!strcmpnocase(velUnits.c_str(),"Centimeters per second") )
+			velConversion = .01;
+		else if (!strcmpnocase(velUnits.c_str(),"m/s"))
+			velConversion = 1.0;
 	}
 	
 	
-	status = nc_get_att_double(ncid, curr_ucmp_id, "_FillValue", &fill_value);	// should get this in text_read and store
+	status = pool->GetAttDouble(ncid, curr_ucmp_id, "_FillValue", &fill_value);	// should get this in text_read and store
 	if (status != NC_NOERR) 
-	{status = nc_get_att_double(ncid, curr_ucmp_id, "FillValue", &fill_value); 
-		if (status != NC_NOERR) {status = nc_get_att_double(ncid, curr_ucmp_id, "missing_value", &fill_value); /*if (status != NC_NOERR) {err = -1; goto done;}*/ }}	// require fill value (took this out 12.12.08)
+	{status = pool->GetAttDouble(ncid, curr_ucmp_id, "FillValue", &fill_value); 
+		if (status != NC_NOERR) {status = pool->GetAttDouble(ncid, curr_ucmp_id, "missing_value", &fill_value); /*if (status != NC_NOERR) {err = -1; goto done;}*/ }}	// require fill value (took this out 12.12.08)
 	
 	if (isnan(fill_value))
 		fill_value=-99999;
 	
-	status = nc_get_att_double(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
+	status = pool->GetAttDouble(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
 	if (status != NC_NOERR) {/*err = -1; goto done;*/}	// don't require scale factor
 	
-	status = nc_close(ncid);
-	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	velH = (VelocityFH)_NewHandleClear(totalNumberOfVels * sizeof(VelocityFRec) * depthlength);
 	if (!velH) {err = memFullErr; goto done;}
@@ -1258,8 +1513,8 @@ LAS:
 		}
 	}
 	*velocityH = velH;
-	fFillValue = fill_value;
-	if (scale_factor!=1.) fVar.fileScaleFactor = scale_factor;
+	SetSliceFillValue(fill_value);
+	if (scale_factor!=1.) SetSliceScaleFactor(scale_factor);
 	
 done:
 	if (err)
@@ -1271,7 +1526,6 @@ done:
 	}
 	if (curr_uvals) delete [] curr_uvals;
 	if (curr_vvals) delete [] curr_vvals;
-	if (velUnits) {delete [] velUnits;}
 	return err;
 }
 
@@ -1311,7 +1565,13 @@ OSErr TimeGridVel_c::SetInterval(char *errmsg, const Seconds& model_time)
 		//cerr << "GetNumFiles(): " << GetNumFiles() << endl;
 		// before the first step in the file
 		if (GetNumFiles() > 1) {
-			if ((err = CheckAndScanFile(errmsg, model_time)) || fOverLap)
+			// the next file replaces the times and path the prefetch was reading from
+			if (fPrefetcher) fPrefetcher->Cancel();
+			{
+				NetCDFLock lock;
+				err = CheckAndScanFile(errmsg, model_time);
+			}
+			if (err || fOverLap)
 				goto done;
 			
 			intervalLoaded = this->CheckInterval(timeDataInterval, model_time);
@@ -1370,23 +1630,29 @@ OSErr TimeGridVel_c::SetInterval(char *errmsg, const Seconds& model_time)
 		
 		if(fStartData.dataHdl == 0 && indexOfStart >= 0) 
 		{ // start data is not loaded
-			err = this -> ReadTimeData(indexOfStart,&fStartData.dataHdl,errmsg);
+			err = this -> LoadTimeData(indexOfStart,&fStartData.dataHdl,errmsg);
 			if(err) goto done;
 			fStartData.timeIndex = indexOfStart;
 		}	
 		
 		if(indexOfEnd < numTimesInFile && indexOfEnd != UNASSIGNEDINDEX)  // not past the last interval and not constant current
 		{
-			err = this -> ReadTimeData(indexOfEnd,&fEndData.dataHdl,errmsg);
+			err = this -> LoadTimeData(indexOfEnd,&fEndData.dataHdl,errmsg);
 			if(err) goto done;
 			fEndData.timeIndex = indexOfEnd;
 		}
+		
+		// start reading the slice the next interval will need while this one is used
+		if (bPrefetchNextSlice && fPrefetcher && !bIsCycleMover &&
+			indexOfEnd != UNASSIGNEDINDEX && indexOfEnd + 1 < numTimesInFile)
+			fPrefetcher->Start(this, indexOfEnd + 1);
 	}
 	
 done:	
 	if(err)
 	{
 		if(!errmsg[0])strcpy(errmsg,"Error in TimeGridVel::SetInterval()");
+		if (fPrefetcher) fPrefetcher->Cancel();
 		DisposeLoadedData(&fStartData);
 		DisposeLoadedData(&fEndData);
 	}
@@ -1524,6 +1790,7 @@ OSErr TimeGridVel_c::CheckAndScanFile(char *errmsg, const Seconds& model_time)
 
 long TimeGridVelRect_c::GetNumDepthLevels()
 {
+	NetCDFLock lock;
 	long numDepthLevels = 0;
 	
 	if (fDepthLevelsHdl) numDepthLevels = _GetHandleSize((Handle)fDepthLevelsHdl)/sizeof(**fDepthLevelsHdl);
@@ -1573,15 +1840,13 @@ long TimeGridVelRect_c::GetNumDepths(void)
 
 VelocityRec TimeGridVelRect_c::GetScaledPatValue(const Seconds& model_time, WorldPoint3D refPoint)
 {	// pull out the getpatval part
-	double timeAlpha, depthAlpha;
+	double timeAlpha = 1., depthAlpha = 1.;
 	float topDepth, bottomDepth;
 	long index;
 	long depthIndex1,depthIndex2;	// default to -1?
-	Seconds startTime,endTime;
-	char errmsg[256];
+	Boolean constantInTime, useBlended;
 
 	VelocityRec	scaledPatVelocity = {0.,0.};
-	OSErr err = 0;
 	
 	index = GetVelocityIndex(refPoint.p);  // regular grid
 	
@@ -1611,71 +1876,189 @@ VelocityRec TimeGridVelRect_c::GetScaledPatValue(const Seconds& model_time, Worl
 		depthAlpha = (bottomDepth - refPoint.z)/(double)(bottomDepth - topDepth);
 	}
 	
-	// Check for constant current
-	if((GetNumTimesInFile()==1 && !(GetNumFiles()>1)) || (fEndData.timeIndex == UNASSIGNEDINDEX && model_time > ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift) && fAllowExtrapolationInTime) || (fEndData.timeIndex == UNASSIGNEDINDEX && model_time < ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift) && fAllowExtrapolationInTime))
+	// the blended field is only prepared for a time varying current, otherwise
+	// check for constant current and calculate the time weight factor
+	useBlended = UseBlendedVelocities(model_time);
+	constantInTime = !useBlended && IsConstantInTime(model_time);
+	if (!constantInTime && !useBlended)
+		timeAlpha = GetTimeAlpha(model_time);
+	
+	// Calculate the interpolated velocity at the point
+	if (index >= 0 && useBlended)
+		scaledPatVelocity = InterpolateBlendedVelocity(index,depthIndex1,depthIndex2,depthAlpha);
+	else if (index >= 0)
+		scaledPatVelocity = InterpolateVelocity(index,depthIndex1,depthIndex2,depthAlpha,constantInTime,timeAlpha);
+	
+	//scaledPatVelocity.u *= fVar.curScale; 
+	//scaledPatVelocity.v *= fVar.curScale; // apply this on the outside
+	scaledPatVelocity.u *= fVar.fileScaleFactor; 
+	scaledPatVelocity.v *= fVar.fileScaleFactor; 
+	
+	
+	return scaledPatVelocity;
+}
+
+// blend the loaded data in depth and time at a grid index, the caller checks that index and depthIndex1 are valid
+VelocityRec TimeGridVelRect_c::InterpolateVelocity(long index, long depthIndex1, long depthIndex2, double depthAlpha, Boolean constantInTime, double timeAlpha)
+{
+	VelocityRec	velocity;
+	long index1 = index+depthIndex1*fNumRows*fNumCols;
+	long index2 = index+depthIndex2*fNumRows*fNumCols;
+	
+	if (constantInTime)
 	{
-		// Calculate the interpolated velocity at the point
-		if (index >= 0)
+		if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
 		{
-			if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
-			{
-				scaledPatVelocity.u = INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v;
-			}
-			else
-			{
-				scaledPatVelocity.u = depthAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = depthAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v;
-			}
+			velocity.u = INDEXH(fStartData.dataHdl,index1).u;
+			velocity.v = INDEXH(fStartData.dataHdl,index1).v;
 		}
-		else	// set vel to zero
+		else
 		{
-			scaledPatVelocity.u = 0.;
-			scaledPatVelocity.v = 0.;
+			velocity.u = depthAlpha*INDEXH(fStartData.dataHdl,index1).u+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index2).u;
+			velocity.v = depthAlpha*INDEXH(fStartData.dataHdl,index1).v+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index2).v;
 		}
 	}
 	else // time varying current 
 	{
-		// Calculate the time weight factor
-		if (GetNumFiles()>1 && fOverLap)
-			startTime = fOverLapStartTime + fTimeShift;
-		else
-			startTime = (*fTimeHdl)[fStartData.timeIndex] + fTimeShift;
-		endTime = (*fTimeHdl)[fEndData.timeIndex] + fTimeShift;
-		timeAlpha = (endTime - model_time)/(double)(endTime - startTime);
-		
-		// Calculate the interpolated velocity at the point
-		if (index >= 0) 
+		if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
 		{
-			if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
-			{
-				scaledPatVelocity.u = timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v;
-			}
-			else	// below surface velocity
-			{
-				scaledPatVelocity.u = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u);
-				scaledPatVelocity.u += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u);
-				scaledPatVelocity.v = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v);
-				scaledPatVelocity.v += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v);
-			}
+			velocity.u = timeAlpha*INDEXH(fStartData.dataHdl,index1).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index1).u;
+			velocity.v = timeAlpha*INDEXH(fStartData.dataHdl,index1).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index1).v;
 		}
-		else	// set vel to zero
+		else	// below surface velocity
 		{
-			scaledPatVelocity.u = 0.;
-			scaledPatVelocity.v = 0.;
+			velocity.u = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index1).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index1).u);
+			velocity.u += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index2).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index2).u);
+			velocity.v = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index1).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index1).v);
+			velocity.v += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index2).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index2).v);
 		}
 	}
-	
-scale:
+	return velocity;
+}
 
-	//scaledPatVelocity.u *= fVar.curScale; 
-	//scaledPatVelocity.v *= fVar.curScale; // apply this on the outside
-	scaledPatVelocity.u *= fVar.fileScaleFactor; 
-	scaledPatVelocity.v *= fVar.fileScaleFactor; 
+// InterpolateVelocity for a time varying current, with the time blend read from the field
+VelocityRec TimeGridVelRect_c::InterpolateBlendedVelocity(long index, long depthIndex1, long depthIndex2, double depthAlpha)
+{
+	VelocityRec	velocity;
+	long index1 = index+depthIndex1*fNumRows*fNumCols;
+	long index2 = index+depthIndex2*fNumRows*fNumCols;
+	const VelocityRec &velocity1 = fBlendedVelocities->GetVelocity(index1);
+	
+	if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
+		return velocity1;
+	
+	const VelocityRec &velocity2 = fBlendedVelocities->GetVelocity(index2);
+	velocity.u = depthAlpha*velocity1.u;
+	velocity.u += (1-depthAlpha)*velocity2.u;
+	velocity.v = depthAlpha*velocity1.v;
+	velocity.v += (1-depthAlpha)*velocity2.v;
+	return velocity;
+}
+
+// blend the loaded interval once for the step rather than for every LE lookup, unless
+// the slices are so much bigger than the number of LEs that most of it would go unread.
+// Once blended for a step a later call keeps it, whatever its number of LEs, so the
+// members of an ensemble sharing the grid never change it while others read it.
+void TimeGridVelRect_c::PrepareBlendedVelocities(const Seconds& model_time, long numLEs)
+{
+	long numValues;
 	
+	if (fBlendedVelocities && fBlendedVelocities->IsPreparedFor(model_time))
+		return;	// already blended for this step
 	
-	return scaledPatVelocity;
+	if (fVelocityBlendMode == BLEND_PER_LE || !fStartData.dataHdl || !fEndData.dataHdl || IsConstantInTime(model_time))
+	{
+		if (fBlendedVelocities) fBlendedVelocities->Invalidate();
+		return;
+	}
+	
+	numValues = _GetHandleSize((Handle)fStartData.dataHdl)/sizeof(**fStartData.dataHdl);
+	if (numValues > fMaxBlendedValuesPerLE * numLEs)
+	{
+		if (fBlendedVelocities) fBlendedVelocities->Invalidate();
+		return;
+	}
+	
+	if (!fBlendedVelocities)
+		fBlendedVelocities = new BlendedVelocityField();
+	fBlendedVelocities->Prepare(model_time, fStartData.dataHdl, fEndData.dataHdl, GetTimeAlpha(model_time), fVelocityBlendMode == BLEND_GRID);
+}
+
+Boolean TimeGridVelRect_c::UseBlendedVelocities(const Seconds& model_time)
+{
+	return fBlendedVelocities && fBlendedVelocities->IsPreparedFor(model_time);
+}
+
+// same result as calling GetScaledPatValue for each LE, but the grid scaling, 
+// time weight and depth level checks are only done once for the array
+void TimeGridVelRect_c::GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris)
+{
+	long n = les.GetNumLEs();
+	double timeAlpha = 1., depthAlpha = 1.;
+	float topDepth, bottomDepth;
+	long index, rowNum, colNum;
+	long depthIndex1 = 0, depthIndex2 = UNASSIGNEDINDEX;
+	Boolean constantInTime, useBlended, hasDepthLevels;
+	WorldPoint3D refPoint;
+	VelocityRec zeroVel = {0.,0.};
+
+	LongRect		gridLRect, geoRect;
+	ScaleRec		thisScaleRec;
+	WorldRect bounds = this->GetGridBounds();
+
+	SetLRect (&gridLRect, 0, fNumRows, fNumCols, 0);
+	SetLRect (&geoRect, bounds.loLong, bounds.loLat, bounds.hiLong, bounds.hiLat);	
+	GetLScaleAndOffsets (&geoRect, &gridLRect, &thisScaleRec);
+
+	hasDepthLevels = (fDepthLevelsHdl && GetNumDepthLevelsInFile()>0);
+	useBlended = UseBlendedVelocities(model_time);
+	constantInTime = !useBlended && IsConstantInTime(model_time);
+	if (!constantInTime && !useBlended)
+		timeAlpha = GetTimeAlpha(model_time);
+
+	for (int i = 0; i < n; i++)
+	{
+		vels[i] = zeroVel;
+		if (!les.IsInWater(i))
+			continue;
+
+		refPoint = les.GetScaledPosition(i);
+
+		// same as GetVelocityIndex
+		colNum = round((refPoint.p.pLong * thisScaleRec.XScale + thisScaleRec.XOffset) -.5);
+		rowNum = round((refPoint.p.pLat  * thisScaleRec.YScale + thisScaleRec.YOffset) -.5);
+		if (colNum < 0 || colNum >= fNumCols || rowNum < 0 || rowNum >= fNumRows)
+			continue;
+		index = rowNum * fNumCols + colNum;
+
+		if (refPoint.z>0 && fVar.gridType==TWO_D)
+		{
+			if (!fAllowVerticalExtrapolationOfCurrents)
+				continue;
+#ifndef pyGNOME
+			if (fAllowVerticalExtrapolationOfCurrents && fMaxDepthForExtrapolation < refPoint.z)
+				continue;
+#endif
+		}
+
+		if (hasDepthLevels)
+		{
+			GetDepthIndices(0,refPoint.z,&depthIndex1,&depthIndex2);
+			if (depthIndex2!=UNASSIGNEDINDEX)
+			{
+				topDepth = INDEXH(fDepthLevelsHdl,depthIndex1);
+				bottomDepth = INDEXH(fDepthLevelsHdl,depthIndex2);
+				depthAlpha = (bottomDepth - refPoint.z)/(double)(bottomDepth - topDepth);
+			}
+		}
+
+		if (useBlended)
+			vels[i] = InterpolateBlendedVelocity(index,depthIndex1,depthIndex2,depthAlpha);
+		else
+			vels[i] = InterpolateVelocity(index,depthIndex1,depthIndex2,depthAlpha,constantInTime,timeAlpha);
+		vels[i].u *= fVar.fileScaleFactor; 
+		vels[i].v *= fVar.fileScaleFactor; 
+	}
 }
 
 Seconds TimeGridVel_c::GetTimeValue(long index)
@@ -2023,14 +2406,13 @@ LongPoint TimeGridVelCurv_c::GetVelocityIndices(WorldPoint wp)
 
 VelocityRec TimeGridVelCurv_c::GetScaledPatValue(const Seconds& model_time, WorldPoint3D refPoint)
 {	
-	double timeAlpha, depthAlpha, depth = refPoint.z;
+	double timeAlpha = 1., depthAlpha = 1., depth = refPoint.z;
 	float topDepth, bottomDepth;
 	long index = -1, depthIndex1, depthIndex2; 
 	float totalDepth; 
-	Seconds startTime,endTime;
+	Boolean constantInTime, useBlended;
 	VelocityRec scaledPatVelocity = {0.,0.};
 	InterpolationVal interpolationVal;
-	OSErr err = 0;
 	
 	if (fGrid) 
 	{
@@ -2050,10 +2432,7 @@ VelocityRec TimeGridVelCurv_c::GetScaledPatValue(const Seconds& model_time, Worl
 	if (index < 0) return scaledPatVelocity;
 	
 	totalDepth = GetTotalDepth(refPoint.p,index);
-	if (index>=0)
-		GetDepthIndices(index,depth,totalDepth,&depthIndex1,&depthIndex2);	// if not ?? point is off grid but not beached (map mismatch)
-	else 
-		return scaledPatVelocity;
+	GetDepthIndices(index,depth,totalDepth,&depthIndex1,&depthIndex2);	// if not ?? point is off grid but not beached (map mismatch)
 	if (depthIndex1==UNASSIGNEDINDEX && depthIndex2==UNASSIGNEDINDEX)
 		return scaledPatVelocity;	// no value for this point at chosen depth - should this be an error? question of show currents below surface vs an actual LE moving
 	
@@ -2067,69 +2446,18 @@ VelocityRec TimeGridVelCurv_c::GetScaledPatValue(const Seconds& model_time, Worl
 			depthAlpha = (bottomDepth - depth)/(double)(bottomDepth - topDepth);
 	}
 	
-	// Check for constant current 
-	if((GetNumTimesInFile()==1 && !(GetNumFiles()>1)) || (fEndData.timeIndex == UNASSIGNEDINDEX && model_time > ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift) && fAllowExtrapolationInTime) || (fEndData.timeIndex == UNASSIGNEDINDEX && model_time < ((*fTimeHdl)[fStartData.timeIndex] + fTimeShift) && fAllowExtrapolationInTime))
-		//if(GetNumTimesInFile()==1)
-	{
-		// Calculate the interpolated velocity at the point
-		if (index >= 0 && depthIndex1 >= 0) 
-		{
-			//scaledPatVelocity.u = INDEXH(fStartData.dataHdl,index).u;
-			//scaledPatVelocity.v = INDEXH(fStartData.dataHdl,index).v;
-			if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
-			{
-				scaledPatVelocity.u = INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v;
-			}
-			else
-			{
-				scaledPatVelocity.u = depthAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = depthAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v+(1-depthAlpha)*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v;
-			}
-		}
-		else	// set vel to zero
-		{
-			scaledPatVelocity.u = 0.;
-			scaledPatVelocity.v = 0.;
-		}
-	}
-	else // time varying current 
-	{
-		// Calculate the time weight factor
-		if (GetNumFiles()>1 && fOverLap)
-			startTime = fOverLapStartTime + fTimeShift;
-		else
-			startTime = (*fTimeHdl)[fStartData.timeIndex] + fTimeShift;
-		//startTime = (*fTimeHdl)[fStartData.timeIndex] + fTimeShift;
-		endTime = (*fTimeHdl)[fEndData.timeIndex] + fTimeShift;
-		timeAlpha = (endTime - model_time)/(double)(endTime - startTime);
-		
-		// Calculate the interpolated velocity at the point
-		if (index >= 0 && depthIndex1 >= 0) 
-		{
-			//scaledPatVelocity.u = timeAlpha*INDEXH(fStartData.dataHdl,index).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index).u;
-			//scaledPatVelocity.v = timeAlpha*INDEXH(fStartData.dataHdl,index).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index).v;
-			if(depthIndex2==UNASSIGNEDINDEX) // surface velocity or special cases
-			{
-				scaledPatVelocity.u = timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u;
-				scaledPatVelocity.v = timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v;
-			}
-			else	// below surface velocity
-			{
-				scaledPatVelocity.u = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).u);
-				scaledPatVelocity.u += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex2*fNumRows*fNumCols).u);
-				scaledPatVelocity.v = depthAlpha*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex1*fNumRows*fNumCols).v);
-				scaledPatVelocity.v += (1-depthAlpha)*(timeAlpha*INDEXH(fStartData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v + (1-timeAlpha)*INDEXH(fEndData.dataHdl,index+depthIndex2*fNumRows*fNumCols).v);
-			}
-		}
-		else	// set vel to zero
-		{
-			scaledPatVelocity.u = 0.;
-			scaledPatVelocity.v = 0.;
-		}
-	}
+	// the blended field is only prepared for a time varying current, otherwise
+	// check for constant current and calculate the time weight factor
+	useBlended = UseBlendedVelocities(model_time);
+	constantInTime = !useBlended && IsConstantInTime(model_time);
+	if (!constantInTime && !useBlended)
+		timeAlpha = GetTimeAlpha(model_time);
 	
-scale:
+	// Calculate the interpolated velocity at the point
+	if (depthIndex1 >= 0 && useBlended)
+		scaledPatVelocity = InterpolateBlendedVelocity(index,depthIndex1,depthIndex2,depthAlpha);
+	else if (depthIndex1 >= 0) 
+		scaledPatVelocity = InterpolateVelocity(index,depthIndex1,depthIndex2,depthAlpha,constantInTime,timeAlpha);
 	
 	//scaledPatVelocity.u *= fVar.curScale; // is there a dialog scale factor?
 	//scaledPatVelocity.v *= fVar.curScale; 
@@ -2139,6 +2467,76 @@ scale:
 	return scaledPatVelocity;
 }
 
+// same result as calling GetScaledPatValue for each LE, but the grid cast, 
+// time weight and constant current checks are only done once for the array
+// lastTris, if given, holds each LE's triangle from the last call and the search starts there
+void TimeGridVelCurv_c::GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris)
+{
+	long n = les.GetNumLEs();
+	double timeAlpha = 1., depthAlpha = 1., depth;
+	float topDepth, bottomDepth, totalDepth;
+	long index, depthIndex1, depthIndex2;
+	Boolean constantInTime, useBlended;
+	InterpolationVal interpolationVal;
+	WorldPoint3D refPoint;
+	VelocityRec zeroVel = {0.,0.};
+	TTriGridVel *triGrid = dynamic_cast<TTriGridVel*>(fGrid);
+
+	for (int i = 0; i < n; i++)
+		vels[i] = zeroVel;
+
+	if (!fGrid) return;
+
+	useBlended = UseBlendedVelocities(model_time);
+	constantInTime = !useBlended && IsConstantInTime(model_time);
+	if (!constantInTime && !useBlended)
+		timeAlpha = GetTimeAlpha(model_time);
+
+	for (int i = 0; i < n; i++)
+	{
+		if (!les.IsInWater(i))
+			continue;
+
+		refPoint = les.GetScaledPosition(i);
+		depth = refPoint.z;
+
+		if (bVelocitiesOnNodes)
+		{
+			if (lastTris)
+				interpolationVal = triGrid->GetInterpolationValuesFromLastTri(refPoint.p, &lastTris[i]);
+			else
+				interpolationVal = fGrid -> GetInterpolationValues(refPoint.p);
+			if (interpolationVal.ptIndex1<0) continue;
+			index = (*fVerdatToNetCDFH)[interpolationVal.ptIndex1];
+		}
+		else if (lastTris)
+			index = triGrid->GetRectIndexFromLastTri(refPoint.p,fVerdatToNetCDFH,fNumCols+1,&lastTris[i]);
+		else
+			index = triGrid->GetRectIndexFromTriIndex(refPoint.p,fVerdatToNetCDFH,fNumCols+1);
+		if (index < 0) continue;
+
+		totalDepth = GetTotalDepth(refPoint.p,index);
+		GetDepthIndices(index,depth,totalDepth,&depthIndex1,&depthIndex2);
+		if (depthIndex1 < 0) continue;	// includes the no value at chosen depth case
+
+		if (depthIndex2!=UNASSIGNEDINDEX)
+		{
+			topDepth = GetDepthAtIndex(depthIndex1,totalDepth);
+			bottomDepth = GetDepthAtIndex(depthIndex2,totalDepth);
+			if (totalDepth == 0) depthAlpha = 1;
+			else
+				depthAlpha = (bottomDepth - depth)/(double)(bottomDepth - topDepth);
+		}
+
+		if (useBlended)
+			vels[i] = InterpolateBlendedVelocity(index,depthIndex1,depthIndex2,depthAlpha);
+		else
+			vels[i] = InterpolateVelocity(index,depthIndex1,depthIndex2,depthAlpha,constantInTime,timeAlpha);
+		vels[i].u *= fVar.fileScaleFactor;
+		vels[i].v *= fVar.fileScaleFactor;
+	}
+}
+
 
 float TimeGridVelCurv_c::GetTotalDepthFromTriIndex(long triNum)
 {
@@ -2501,6 +2899,7 @@ void TimeGridVelCurv_c::GetDepthIndices(long ptIndex, float depthAtPoint, float
 
 OSErr TimeGridVelCurv_c::TextRead(const char *path, const char *topFilePath)
 {
+	NetCDFLock lock;
 	// this code is for curvilinear grids
 	OSErr err = 0;
 	char errmsg[256] = "";
@@ -3011,6 +3410,17 @@ done:
 	return err;
 }
 
+Boolean TimeGridVelCurv_c::GetSliceCacheKey(long index, VelocitySliceKey *key)
+{
+	if (!fVar.pathName[0]) return false;
+
+	key->path = fVar.pathName;
+	key->variable = fIsNavy ? "curv_navy" : "curv";
+	key->timeIndex = index;
+	key->depth = fVar.maxNumDepths;
+	return true;
+}
+
 OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* errmsg) 
 {
 	OSErr err = 0;
@@ -3023,12 +3433,11 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 	long lonlength = fNumCols;
 	long totalNumberOfVels = fNumRows * fNumCols * fVar.maxNumDepths;
 	long numDepths = fVar.maxNumDepths;	// assume will always have full set of depths at each point for now
-	size_t velunit_len;
-	static size_t curr_index[] = {0, 0, 0, 0}, angle_index[] = {0, 0};
-	static size_t curr_count[4], angle_count[2];
+	size_t curr_index[] = {0, 0, 0, 0}, angle_index[] = {0, 0};
+	size_t curr_count[4] = {0, 0, 0, 0}, angle_count[2] = {0, 0};
 
 	double scale_factor = 1., angle = 0., u_grid, v_grid;
-	char *velUnits = 0;
+	string velUnits;
 	double *curr_uvals = 0, *curr_vvals = 0, *curr_wvals = 0, fill_value = -1e+34, test_value = 8e+10;
 	double *landmask = 0, velConversion = 1.;
 	double *angle_vals = 0, debug_mask;
@@ -3037,15 +3446,17 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 	FLOATH wvelH = 0;
 	Boolean bRotated = true, isLandMask = true, bIsWVel = false;
 	
+	NetCDFFilePool *pool = GetFilePool();
+	
 	errmsg[0] = 0;
 	
 	strcpy(path,fVar.pathName);
 	if (!path || !path[0]) return -1;
 	
-	status = nc_open(path, NC_NOWRITE, &ncid);
+	status = pool->Open(path, &ncid);
 	if (status != NC_NOERR) {err = -1; goto done;}
 
-	status = nc_inq_ndims(ncid, &numdims);
+	status = pool->InqNDims(ncid, &numdims);
 	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	curr_index[0] = index;	// time 
@@ -3075,26 +3486,26 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 		if(!curr_vvals) {TechError("TimeGridVelCurv_c::ReadTimeData()", "new[]", 0); err = memFullErr; goto done;}
 		angle_vals = new double[latlength*lonlength]; 
 		if(!angle_vals) {TechError("TimeGridVelCurv_c::ReadTimeData()", "new[]", 0); err = memFullErr; goto done;}
-		status = nc_inq_varid(ncid, "water_gridu", &curr_ucmp_id);
+		status = pool->InqVarID(ncid, "water_gridu", &curr_ucmp_id);
 		if (status != NC_NOERR) {err = -1; goto done;}
-		status = nc_inq_varid(ncid, "water_gridv", &curr_vcmp_id);	// what if only input one at a time (u,v separate movers)?
+		status = pool->InqVarID(ncid, "water_gridv", &curr_vcmp_id);	// what if only input one at a time (u,v separate movers)?
 		if (status != NC_NOERR) {err = -1; goto done;}
 		status = nc_get_vara_double(ncid, curr_ucmp_id, curr_index, curr_count, curr_uvals);
 		if (status != NC_NOERR) {err = -1; goto done;}
 		status = nc_get_vara_double(ncid, curr_vcmp_id, curr_index, curr_count, curr_vvals);
 		if (status != NC_NOERR) {err = -1; goto done;}
-		status = nc_get_att_double(ncid, curr_ucmp_id, "_FillValue", &fill_value);
-		status = nc_get_att_double(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
-		status = nc_inq_varid(ncid, "grid_orient", &angle_id);
+		status = pool->GetAttDouble(ncid, curr_ucmp_id, "_FillValue", &fill_value);
+		status = pool->GetAttDouble(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
+		status = pool->InqVarID(ncid, "grid_orient", &angle_id);
 		if (status != NC_NOERR) {err = -1; goto done;}
 		status = nc_get_vara_double(ncid, angle_id, angle_index, angle_count, angle_vals);
 		if (status != NC_NOERR) {/*err = -1; goto done;*/bRotated = false;}
 	}
 	else
 	{
-		status = nc_inq_varid(ncid, "mask", &mask_id);
+		status = pool->InqVarID(ncid, "mask", &mask_id);
 		if (status != NC_NOERR)	{/*err=-1; goto done;*/ isLandMask = false;}
-		status = nc_inq_varid(ncid, "ang", &angle_id);
+		status = pool->InqVarID(ncid, "ang", &angle_id);
 		if (status != NC_NOERR) {/*err = -1; goto done;*/bRotated = false;}
 		else
 		{
@@ -3125,35 +3536,35 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 			goto done;
 		}
 
-		status = nc_inq_varid(ncid, "U", &curr_ucmp_id);
+		status = pool->InqVarID(ncid, "U", &curr_ucmp_id);
 		if (status != NC_NOERR)
 		{
-			status = nc_inq_varid(ncid, "u", &curr_ucmp_id);
+			status = pool->InqVarID(ncid, "u", &curr_ucmp_id);
 			if (status != NC_NOERR)
 			{
-				status = nc_inq_varid(ncid, "water_u", &curr_ucmp_id);
+				status = pool->InqVarID(ncid, "water_u", &curr_ucmp_id);
 				if (status != NC_NOERR)
 				{err = -1; goto done;}
 			}
 		}
-		status = nc_inq_varid(ncid, "V", &curr_vcmp_id);
+		status = pool->InqVarID(ncid, "V", &curr_vcmp_id);
 		if (status != NC_NOERR) 
 		{
-			status = nc_inq_varid(ncid, "v", &curr_vcmp_id);
+			status = pool->InqVarID(ncid, "v", &curr_vcmp_id);
 			if (status != NC_NOERR) 
 			{
-				status = nc_inq_varid(ncid, "water_v", &curr_vcmp_id);
+				status = pool->InqVarID(ncid, "water_v", &curr_vcmp_id);
 				if (status != NC_NOERR)
 				{err = -1; goto done;}
 			}
 		}
-		status = nc_inq_varid(ncid, "W", &curr_wcmp_id);
+		status = pool->InqVarID(ncid, "W", &curr_wcmp_id);
 		if (status != NC_NOERR)
 		{
-			status = nc_inq_varid(ncid, "w", &curr_wcmp_id);
+			status = pool->InqVarID(ncid, "w", &curr_wcmp_id);
 			if (status != NC_NOERR)
 			{
-				status = nc_inq_varid(ncid, "water_w", &curr_wcmp_id);
+				status = pool->InqVarID(ncid, "water_w", &curr_wcmp_id);
 				if (status != NC_NOERR)
 					//{err = -1; goto done;}
 					bIsWVel = false;
@@ -3161,7 +3572,7 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 					bIsWVel = true;
 			}
 		}
-		status = nc_inq_varndims(ncid, curr_ucmp_id, &uv_ndims);
+		status = pool->InqVarNDims(ncid, curr_ucmp_id, &uv_ndims);
 		if (status==NC_NOERR){if (uv_ndims < numdims && uv_ndims==3) {curr_count[1] = latlength; curr_count[2] = lonlength;}}	// could have more dimensions than are used in u,v
 		//status = nc_get_vara_float(ncid, curr_ucmp_id, curr_index, curr_count, curr_uvals);
 		status = nc_get_vara_double(ncid, curr_ucmp_id, curr_index, curr_count, curr_uvals);
@@ -3174,31 +3585,23 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 			status = nc_get_vara_double(ncid, curr_wcmp_id, curr_index, curr_count, curr_wvals);
 			if (status != NC_NOERR) {err = -1; goto done;}
 		}
-		status = nc_inq_attlen(ncid, curr_ucmp_id, "units", &velunit_len);
+		status = pool->GetAttText(ncid, curr_ucmp_id, "units", &velUnits);
 		if (status == NC_NOERR)
 		{
-			velUnits = new char[velunit_len+1];
-			status = nc_get_att_text(ncid, curr_ucmp_id, "units", velUnits);
-			if (status == NC_NOERR)
-			{
-				velUnits[velunit_len] = '\0';
-				if (!strcmpnocase(velUnits,"cm/s"))
-					velConversion = .01;
-				else if (!strcmpnocase(velUnits,"m/s"))
-					velConversion = 1.0;
-			}
+			if (!strcmpnocase(velUnits.c_str(),"cm/s"))
+				velConversion = .01;
+			else if (!strcmpnocase(velUnits.c_str(),"m/s"))
+				velConversion = 1.0;
 		}
 		
 		
-		status = nc_get_att_double(ncid, curr_ucmp_id, "_FillValue", &fill_value);
-		if (status != NC_NOERR) {status = nc_get_att_double(ncid, curr_ucmp_id, "Fill_Value", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
-		if (status != NC_NOERR) {status = nc_get_att_double(ncid, curr_ucmp_id, "FillValue", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
-		if (status != NC_NOERR) {status = nc_get_att_double(ncid, curr_ucmp_id, "missing_value", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
+		status = pool->GetAttDouble(ncid, curr_ucmp_id, "_FillValue", &fill_value);
+		if (status != NC_NOERR) {status = pool->GetAttDouble(ncid, curr_ucmp_id, "Fill_Value", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
+		if (status != NC_NOERR) {status = pool->GetAttDouble(ncid, curr_ucmp_id, "FillValue", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
+		if (status != NC_NOERR) {status = pool->GetAttDouble(ncid, curr_ucmp_id, "missing_value", &fill_value);/*if (status != NC_NOERR){fill_value=-1e+32;}{err = -1; goto done;}*/}	// don't require
 		//if (status != NC_NOERR) {err = -1; goto done;}	// don't require
-		status = nc_get_att_double(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
+		status = pool->GetAttDouble(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
 	}	
-	status = nc_close(ncid);
-	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	// NOTE: if allow fill_value as NaN need to be sure to check for it wherever fill_value is used
 	if (isnan(fill_value))
@@ -3255,10 +3658,10 @@ OSErr TimeGridVelCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* er
 		}
 	}
 	*velocityH = velH;
-	fFillValue = fill_value * velConversion;
+	SetSliceFillValue(fill_value * velConversion);
 	
 	//if (scale_factor!=1.) fVar.curScale = scale_factor;	// hmm, this forces a reset of scale factor each time, overriding any set by hand
-	if (scale_factor!=1.) fVar.fileScaleFactor = scale_factor;
+	if (scale_factor!=1.) SetSliceScaleFactor(scale_factor);
 	
 done:
 	if (err)
@@ -3286,12 +3689,17 @@ done:
 	
 	if (landmask) {delete [] landmask; landmask = 0;}
 	if (angle_vals) {delete [] angle_vals; angle_vals = 0;}
-	if (velUnits) {delete [] velUnits;}
 	return err;
 }
 
 OSErr TimeGridVelCurv_c::ReorderPoints(DOUBLEH landmaskH, char* errmsg) 
 {
+	TopologyCache topologyCache(fVar.pathName, landmaskH, fNumRows, fNumCols, fVertexPtsH);
+	CurvilinearTopology cachedTopology;
+	
+	if (topologyCache.Read(false, &cachedTopology) == noErr)
+		return SetUpCachedGrid(&cachedTopology, errmsg);
+	
 	long i, j, n, ntri, numVerdatPts=0;
 	long fNumRows_ext = fNumRows+1, fNumCols_ext = fNumCols+1;
 	long nv = fNumRows * fNumCols, nv_ext = fNumRows_ext*fNumCols_ext;
@@ -3762,6 +4170,11 @@ findnextpoint:
 	triGrid -> SetDagTree(dagTree);
 	//triGrid -> SetDepths(totalDepthH);	// used by PtCurMap to check vertical movement
 	
+	{	// without the boundaries, a map on this grid traces them and writes it again
+		CurvilinearTopology topology = {pts, topo, tree.treeHdl, tree.numBranches, verdatPtsH, 0, 0, 0};
+		topologyCache.Write(topology);
+	}
+	
 	pts = 0;	// because fGrid is now responsible for it
 	topo = 0; // because fGrid is now responsible for it
 	velH = 0; // because fGrid is now responsible for it
@@ -3825,6 +4238,65 @@ done:
 	return err;
 }
 
+// the grid ReorderPoints would build, from what it saved in the topology cache
+OSErr TimeGridVelCurv_c::SetUpCachedGrid(CurvilinearTopology *topology, char* errmsg) 
+{
+	long i, numPts = _GetHandleSize((Handle)topology->pts)/sizeof(**topology->pts);
+	WorldRect triBounds = voidWorldRect;
+	TTriGridVel *triGrid = nil;
+	TDagTree *dagTree = 0;
+	OSErr err = 0;
+	
+	for (i=0;i<numPts;i++)
+		AddWPointToWRect(INDEXH(topology->pts,i).v, INDEXH(topology->pts,i).h, &triBounds);
+	
+	triGrid = new TTriGridVel;
+	if (!triGrid)
+	{		
+		err = true;
+		TechError("Error in TimeGridVelCurv_c::SetUpCachedGrid()","new TTriGridVel",err);
+		goto done;
+	}
+	
+	fGrid = (TTriGridVel*)triGrid;
+	
+	this->SetGridBounds(triBounds);
+	triGrid -> SetBounds(triBounds); 
+	
+	dagTree = new TDagTree(topology->pts,topology->topo,topology->tree,0,topology->numBranches); 
+	if(!dagTree)
+	{
+		err = -1;
+		printError("Unable to create dag tree.");
+		goto done;
+	}
+	
+	triGrid -> SetDagTree(dagTree);
+	
+	fVerdatToNetCDFH = topology->verdatToNetCDF;
+	topology->verdatToNetCDF = 0;
+	topology->pts = 0;	// because fGrid is now responsible for them
+	topology->topo = 0;
+	topology->tree = 0;
+	
+done:
+	TopologyCache::DisposeTopology(topology);
+	
+	if(err)
+	{
+		if(!errmsg[0])
+			strcpy(errmsg,"An error occurred in TimeGridVelCurv_c::SetUpCachedGrid");
+		printError(errmsg); 
+		if(fGrid)
+		{
+			fGrid ->Dispose();
+			delete fGrid;
+			fGrid = 0;
+		}
+	}
+	return err;
+}
+
 OSErr TimeGridVelCurv_c::ReorderPointsNoMask(char* errmsg) 
 {
 	long i, j, n, ntri, numVerdatPts=0;
@@ -4722,6 +5194,7 @@ OSErr TimeGridVelCurv_c::GetLatLonFromIndex(long iIndex, long jIndex, WorldPoint
 
 long TimeGridVelCurv_c::GetNumDepthLevels()
 {
+	NetCDFLock lock;
 	// should have only one version of this for all grid types, but will have to redo the regular grid stuff with depth levels
 	// and check both sigma grid and multilayer grid (and maybe others)
 	long numDepthLevels = 0;
@@ -5391,6 +5864,31 @@ void TimeGridVelTri_c::GetDepthIndices(long ptIndex, float depthAtPoint, long *d
 }
 
 VelocityRec TimeGridVelTri_c::GetScaledPatValue(const Seconds& model_time, WorldPoint3D refPoint)
+{
+	return GetScaledPatValueFromLastTri(model_time, refPoint, 0);
+}
+
+// lastTris, if given, holds each LE's triangle from the last call and the search starts there
+void TimeGridVelTri_c::GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris)
+{
+	long n = les.GetNumLEs();
+	WorldPoint3D refPoint;
+	VelocityRec zeroVel = {0.,0.};
+
+	for (int i = 0; i < n; i++)
+	{
+		if (!les.IsInWater(i))
+		{
+			vels[i] = zeroVel;
+			continue;
+		}
+		refPoint = les.GetScaledPosition(i);
+
+		vels[i] = GetScaledPatValueFromLastTri(model_time, refPoint, lastTris ? &lastTris[i] : 0);
+	}
+}
+
+VelocityRec TimeGridVelTri_c::GetScaledPatValueFromLastTri(const Seconds& model_time, WorldPoint3D refPoint, long *lastTri)
 {
 	double timeAlpha, depth = refPoint.z;
 	long ptIndex1,ptIndex2,ptIndex3,triIndex; 
@@ -5402,7 +5900,12 @@ VelocityRec TimeGridVelTri_c::GetScaledPatValue(const Seconds& model_time, World
 	
 	// Get the interpolation coefficients, alpha1,ptIndex1,alpha2,ptIndex2,alpha3,ptIndex3
 	if (!bVelocitiesOnTriangles)
-		interpolationVal = fGrid -> GetInterpolationValues(refPoint.p);
+	{
+		if (lastTri)
+			interpolationVal = (dynamic_cast<TTriGridVel*>(fGrid)) -> GetInterpolationValuesFromLastTri(refPoint.p, lastTri);
+		else
+			interpolationVal = fGrid -> GetInterpolationValues(refPoint.p);
+	}
 	else
 	{
 		LongPoint lp;
@@ -5411,7 +5914,7 @@ VelocityRec TimeGridVelTri_c::GetScaledPatValue(const Seconds& model_time, World
 		if(!dagTree) return scaledPatVelocity;
 		lp.h = refPoint.p.pLong;
 		lp.v = refPoint.p.pLat;
-		triIndex = dagTree -> WhatTriAmIIn(lp);
+		triIndex = lastTri ? dagTree -> WhatTriAmIIn(lp, lastTri) : dagTree -> WhatTriAmIIn(lp);
 		interpolationVal.ptIndex1 = -1;
 	}
 	
@@ -5727,6 +6230,7 @@ VelocityRec TimeGridVelTri_c::GetScaledPatValue3D(const Seconds& model_time, Int
 
 OSErr TimeGridVelTri_c::TextRead(const char *path, const char *topFilePath)
 {
+	NetCDFLock lock;
 	// needs to be updated once triangle grid format is set
 
 	OSErr err = 0;
@@ -6391,6 +6895,17 @@ done:
 }
 
 
+Boolean TimeGridVelTri_c::GetSliceCacheKey(long index, VelocitySliceKey *key)
+{
+	if (!fVar.pathName[0]) return false;
+
+	key->path = fVar.pathName;
+	key->variable = bVelocitiesOnTriangles ? "tri_eles" : "tri_nodes";
+	key->timeIndex = index;
+	key->depth = fVar.maxNumDepths;
+	return true;
+}
+
 OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* errmsg) 
 {	// - needs to be updated once triangle grid format is set
 	OSErr err = 0;
@@ -6398,8 +6913,8 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 	char path[256], outPath[256]; 
 	int status, ncid, numdims, uv_ndims;
 	int curr_ucmp_id, curr_vcmp_id, uv_dimid[3], nele_id;
-	static size_t curr_index[] = {0,0,0,0};
-	static size_t curr_count[4];
+	size_t curr_index[] = {0,0,0,0};
+	size_t curr_count[4] = {0,0,0,0};
 	float *curr_uvals,*curr_vvals, fill_value, dry_value = 0;
 	long totalNumberOfVels = fNumNodes * fVar.maxNumDepths, numVelsAtDepthLevel=0;
 	VelocityFH velH = 0;
@@ -6408,12 +6923,14 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 	long numDepths = fVar.maxNumDepths;	// assume will always have full set of depths at each point for now
 	double scale_factor = 1.;
 	
+	NetCDFFilePool *pool = GetFilePool();
+	
 	errmsg[0]=0;
 	
 	strcpy(path,fVar.pathName);
 	if (!path || !path[0]) return -1;
 	
-	status = nc_open(path, NC_NOWRITE, &ncid);
+	status = pool->Open(path, &ncid);
 	if (status != NC_NOERR) {err = -1; goto done;}
 	/*if (status != NC_NOERR)
 	{
@@ -6423,7 +6940,7 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 #endif
 		if (status != NC_NOERR) {err = -1; goto done;}
 	}*/
-	status = nc_inq_ndims(ncid, &numdims);	// in general it's not the total number of dimensions but the number the variable depends on
+	status = pool->InqNDims(ncid, &numdims);	// in general it's not the total number of dimensions but the number the variable depends on
 	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	curr_index[0] = index;	// time 
@@ -6441,18 +6958,18 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 	{
 		curr_count[1] = numNodes;	
 	}
-	status = nc_inq_varid(ncid, "u", &curr_ucmp_id);
+	status = pool->InqVarID(ncid, "u", &curr_ucmp_id);
 	if (status != NC_NOERR) {err = -1; goto done;}
-	status = nc_inq_varid(ncid, "v", &curr_vcmp_id);
+	status = pool->InqVarID(ncid, "v", &curr_vcmp_id);
 	if (status != NC_NOERR) {err = -1; goto done;}
-	status = nc_inq_varndims(ncid, curr_ucmp_id, &uv_ndims);
+	status = pool->InqVarNDims(ncid, curr_ucmp_id, &uv_ndims);
 	if (status==NC_NOERR){if (numdims < 6 && uv_ndims==3) {curr_count[1] = numDepths; curr_count[2] = numNodes;}}	// could have more dimensions than are used in u,v
 	if (status==NC_NOERR){if (numdims >= 6 && uv_ndims==2) {curr_count[1] = numNodes;}}	// could have more dimensions than are used in u,v
 	
 	status = nc_inq_vardimid (ncid, curr_ucmp_id, uv_dimid);	// see if dimid(1) or (2) == nele or node, depends on uv_ndims
 	if (status==NC_NOERR) 
 	{
-		status = nc_inq_dimid (ncid, "nele", &nele_id);
+		status = pool->InqDimID(ncid, "nele", &nele_id);
 		if (status==NC_NOERR)
 		{
 			if (uv_ndims == 3 && uv_dimid[2] == nele_id)
@@ -6478,14 +6995,12 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 	if (status != NC_NOERR) {err = -1; goto done;}
 	status = nc_get_vara_float(ncid, curr_vcmp_id, curr_index, curr_count, curr_vvals);
 	if (status != NC_NOERR) {err = -1; goto done;}
-	status = nc_get_att_float(ncid, curr_ucmp_id, "missing_value", &fill_value);// missing_value vs _FillValue
+	status = pool->GetAttFloat(ncid, curr_ucmp_id, "missing_value", &fill_value);// missing_value vs _FillValue
 	if (status != NC_NOERR) {/*err = -1; goto done;*/fill_value=-9999.;}
-	status = nc_get_att_double(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
+	status = pool->GetAttDouble(ncid, curr_ucmp_id, "scale_factor", &scale_factor);
 	//if (status != NC_NOERR) {err = -1; goto done;}
-	status = nc_get_att_float(ncid, curr_ucmp_id, "dry_value", &dry_value);// missing_value vs _FillValue
+	status = pool->GetAttFloat(ncid, curr_ucmp_id, "dry_value", &dry_value);// missing_value vs _FillValue
 	if (status != NC_NOERR) {/*err = -1; goto done;*/}  
-	status = nc_close(ncid);
-	if (status != NC_NOERR) {err = -1; goto done;}
 	
 	velH = (VelocityFH)_NewHandleClear(totalNumberOfVels * sizeof(VelocityFRec));
 	if (!velH) {err = memFullErr; goto done;}
@@ -6540,8 +7055,8 @@ OSErr TimeGridVelTri_c::ReadTimeData(long index,VelocityFH *velocityH, char* err
 		}
 	}
 	*velocityH = velH;
-	fFillValue = fill_value;
-	if (scale_factor!=1.) fVar.fileScaleFactor = scale_factor;
+	SetSliceFillValue(fill_value);
+	if (scale_factor!=1.) SetSliceScaleFactor(scale_factor);
 	
 done:
 	if (err)
@@ -7092,6 +7607,7 @@ done:
 
 long TimeGridVelTri_c::GetNumDepthLevels()
 {
+	NetCDFLock lock;
 	// should have only one version of this for all grid types, but will have to redo the regular grid stuff with depth levels
 	// and check both sigma grid and multilayer grid (and maybe others)
 	long numDepthLevels = 0;
@@ -7850,6 +8366,7 @@ OSErr TimeGridCurRect_c::GetEndTime(Seconds *endTime)
 //OSErr TimeGridVel_c::ScanFileForTimes(char *path,Seconds ***timeH,Boolean setStartTime)
 OSErr ScanFileForTimes(char *path,Seconds ***timeH)
 {
+	NetCDFLock lock;
 	OSErr err = 0;
 	long i,numScanned,line=0;
 	DateTimeRec time;
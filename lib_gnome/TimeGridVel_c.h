@@ -15,7 +15,9 @@
 #include "TypeDefs.h"
 #include "ExportSymbols.h"
 #include "DagTree.h"
+#include "LEBlock.h"
 #include "DagTreeIO.h"
+#include "TopologyCache.h"
 #include "my_build_list.h"
 
 #ifndef pyGNOME
@@ -28,6 +30,11 @@
 
 using namespace std;
 
+class TimeSlicePrefetcher;
+class NetCDFFilePool;
+class BlendedVelocityField;
+struct VelocitySliceKey;
+
 // code goes here, decide which fields go with the mover
 typedef struct {
 	char		pathName[kMaxNameLen];
@@ -40,6 +47,15 @@ typedef struct {
 	//
 } TimeGridVariables;
 
+// the fill value and scale factor a slice was read with, which ReadTimeData
+// sets on the grid along with reading the slice; a background read keeps them
+// here instead, and they are set on the grid when the slice is taken
+struct SliceAttributes {
+	Boolean	hasFillValue, hasScaleFactor;
+	float	fillValue;
+	double	scaleFactor;
+};
+
 Boolean IsNetCDFFile (char *path, short *gridType);
 Boolean IsNetCDFPathsFile (char *path, Boolean *isNetCDFPathsFile, char *fileNamesPath, short *gridType);
 //Boolean IsGridWindFile(char *path,short *selectedUnits);
@@ -77,6 +93,15 @@ public:
 	
 	WorldRect fGridBounds;
 
+	Boolean bPrefetchNextSlice;		// read the slice after fEndData in the background
+	TimeSlicePrefetcher *fPrefetcher;
+	NetCDFFilePool *fFilePool;		// files ReadTimeData keeps open between reads
+
+	short	fVelocityBlendMode;		// BLEND_PER_LE, BLEND_TILES or BLEND_GRID
+	double	fMaxBlendedValuesPerLE;	// blend per LE when the loaded slices hold more values than this for each LE
+	BlendedVelocityField *fBlendedVelocities;	// the loaded interval blended in time for the step
+	long	fNumOwners;				// movers sharing the grid, the last one disposes of it
+
 
 	TimeGridVel_c (/*TMover *owner, char *name*/);	// do we need an owner? or a name
 
@@ -89,6 +114,7 @@ public:
 	virtual long 		GetVelocityIndex(WorldPoint p);
 	virtual LongPoint 	GetVelocityIndices(WorldPoint wp);
 	virtual VelocityRec 		GetScaledPatValue(const Seconds& model_time, WorldPoint3D p) {VelocityRec vRec = {0,.0,}; return vRec;}
+	virtual void		GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris = 0);
 	
 	//virtual WorldRect GetGridBounds(){return fGrid->GetBounds();}	
 	//virtual void SetGridBounds(WorldRect gridBounds){return fGrid->SetBounds(gridBounds);}	
@@ -103,6 +129,28 @@ public:
 	
 	void SetTimeCycleInfo(float fraction, long offset) {fFraction = fraction; fOffset = offset;}
 	
+	void SetPrefetchNextSlice(bool prefetch);
+	bool GetPrefetchNextSlice(){return bPrefetchNextSlice;}
+	void GetPrefetchCounts(long *numHits, long *numMisses, long *numStalls);
+	
+	// triangle grids only, locate points with a bucket grid instead of the DAG tree
+	void SetUsePointIndex(bool usePointIndex);
+	bool GetUsePointIndex();
+	OSErr LocateTriangles(long n, WorldPoint3D *points, long *triIndices, bool useDagTree);	// points in degrees
+	
+	void SetVelocityBlendMode(short blendMode);
+	short GetVelocityBlendMode(){return fVelocityBlendMode;}
+	void SetMaxBlendedValuesPerLE(double maxValuesPerLE){fMaxBlendedValuesPerLE = maxValuesPerLE;}
+	double GetMaxBlendedValuesPerLE(){return fMaxBlendedValuesPerLE;}
+	void GetBlendedTileCounts(long *numTiles, long *numTilesBlended);
+	
+	// the movers of an ensemble share one grid; true when the last owner lets go
+	void AddOwner(){fNumOwners++;}
+	Boolean RemoveOwner(){return --fNumOwners <= 0;}
+	long GetNumOwners() const {return fNumOwners;}
+	// once the interval is set for a step, before the velocity lookups for numLEs LEs
+	virtual void		PrepareBlendedVelocities(const Seconds& model_time, long numLEs) {}
+	
 	virtual Seconds 		GetStartTimeValue(long index);
 	virtual Seconds 		GetTimeValue(long index);
 	virtual OSErr		GetStartTime(Seconds *startTime);
@@ -118,8 +166,18 @@ public:
 	virtual OSErr	 	SetInterval(char *errmsg, const Seconds& model_time);	
 	
 	virtual Boolean 	CheckInterval(long &timeDataInterval, const Seconds& model_time);	
+	Boolean				IsConstantInTime(const Seconds& model_time);
+	double				GetTimeAlpha(const Seconds& model_time);
 	virtual OSErr		TextRead(const char *path, const char *topFilePath) {return 0;}
 	virtual OSErr 		ReadTimeData(long index,VelocityFH *velocityH, char* errmsg) {return 0;}
+	OSErr 				LoadTimeData(long index,VelocityFH *velocityH, char* errmsg);
+	// with attributes, the slice's fill value and scale factor go there rather than to the grid
+	OSErr 				ReadTimeDataCached(long index,VelocityFH *velocityH, char* errmsg, SliceAttributes *attributes = 0);
+	void				SetSliceAttributes(const SliceAttributes &attributes);
+	void				SetSliceFillValue(float fillValue);			// for ReadTimeData
+	void				SetSliceScaleFactor(double scaleFactor);	// for ReadTimeData
+	NetCDFFilePool*		GetFilePool();
+	virtual Boolean		GetSliceCacheKey(long index, VelocitySliceKey *key) {return false;}	// false if the grid's slices are not cached
 	OSErr 				ReadInputFileNames(char *fileNamesPath);
 	//void				SetInputFilesHdl(PtCurFileInfoH inputFilesHdl) {if (fInputFilesHdl) {DisposeHandle((Handle)fInputFilesHdl)} fInputFilesHdl = inputFilesHdl;}
 	virtual	OSErr 		ExportTopology(char* path) {return 0;}
@@ -169,6 +227,11 @@ public:
 	//virtual Boolean	IAm(ClassID id) { if(id==TYPE_TIMEGRIDVELRECT) return TRUE; return TimeGridVel_c::IAm(id); }
 	
 	VelocityRec 		GetScaledPatValue(const Seconds& model_time, WorldPoint3D p);
+	virtual void		GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris = 0);
+	VelocityRec			InterpolateVelocity(long index, long depthIndex1, long depthIndex2, double depthAlpha, Boolean constantInTime, double timeAlpha);
+	VelocityRec			InterpolateBlendedVelocity(long index, long depthIndex1, long depthIndex2, double depthAlpha);
+	virtual void		PrepareBlendedVelocities(const Seconds& model_time, long numLEs);
+	Boolean				UseBlendedVelocities(const Seconds& model_time);
 	void 				GetDepthIndices(long ptIndex, float depthAtPoint, long *depthIndex1, long *depthIndex2);
 	float 				GetMaxDepth();
 	
@@ -182,6 +245,7 @@ public:
 	bool GetVerticalExtrapolation(){return fAllowVerticalExtrapolationOfCurrents;}
 	
 	virtual OSErr 		ReadTimeData(long index,VelocityFH *velocityH, char* errmsg);
+	virtual Boolean		GetSliceCacheKey(long index, VelocitySliceKey *key);
 	virtual long 		GetNumDepthLevelsInFile();	// eventually get rid of this
 	
 	virtual OSErr		TextRead(const char *path, const char *topFilePath);
@@ -205,9 +269,12 @@ public:
 	
 	LongPointHdl		GetPointsHdl();
 	OSErr 				ReadTimeData(long index,VelocityFH *velocityH, char* errmsg); 
+	virtual Boolean		GetSliceCacheKey(long index, VelocitySliceKey *key);
 	VelocityRec			GetScaledPatValue(const Seconds& model_time, WorldPoint3D refPoint);
+	virtual void		GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris = 0);
 
 	OSErr 				ReorderPoints(DOUBLEH landmaskH, char* errmsg); 
+	OSErr 				SetUpCachedGrid(CurvilinearTopology *topology, char* errmsg); 
 	OSErr 				ReorderPointsNoMask(char* errmsg); 
 	OSErr 				ReorderPointsCOOPSMask(DOUBLEH landmaskH, char* errmsg); 
 	Boolean				IsCOOPSFile();
@@ -246,7 +313,11 @@ public:
 	LongPointHdl			GetPointsHdl();
 	void					GetDepthIndices(long ptIndex, float depthAtPoint, long *depthIndex1, long *depthIndex2);
 	OSErr 				ReadTimeData(long index,VelocityFH *velocityH, char* errmsg); 
+	virtual Boolean		GetSliceCacheKey(long index, VelocitySliceKey *key);
 	VelocityRec 		GetScaledPatValue(const Seconds& model_time, WorldPoint3D refPoint);
+	VelocityRec 		GetScaledPatValueFromLastTri(const Seconds& model_time, WorldPoint3D refPoint, long *lastTri);
+	virtual void		GetScaledPatValues(const Seconds& model_time, const LEBlock &les, VelocityRec* vels, long* lastTris = 0);
+	virtual void		PrepareBlendedVelocities(const Seconds& model_time, long numLEs) {}	// interpolates on the triangles, nothing to blend
 	VelocityRec 		GetScaledPatValue3D(const Seconds& model_time, InterpolationVal interpolationVal,float depth);
 	OSErr					ReorderPoints(long *bndry_indices, long *bndry_nums, long *bndry_type, long numBoundaryPts); 
 	OSErr					ReorderPoints2(long *bndry_indices, long *bndry_nums, long *bndry_type, long numBoundaryPts, long *tri_verts, long *tri_neighbors, long ntri, Boolean isCCW);
@@ -16,6 +16,7 @@
 #endif
 
 #include "netcdf.h"
+#include "TimeSlicePrefetcher.h"
 
 /*Boolean IsGridWindFile(char *path,short *selectedUnitsP)
 {
@@ -134,6 +135,7 @@ scale:
 
 OSErr TimeGridWindRect_c::TextRead(const char *path, const char *topFilePath)
 {
+	NetCDFLock lock;
 	// this code is for regular grids
 	OSErr err = 0;
 	long i,j, numScanned;
@@ -409,8 +411,8 @@ OSErr TimeGridWindRect_c::ReadTimeData(long index,VelocityFH *velocityH, char* e
 	char path[256], outPath[256]; 
 	int status, ncid, numdims, numvars, uv_ndims;
 	int wind_ucmp_id, wind_vcmp_id, sigma_id;
-	static size_t wind_index[] = {0,0,0,0};
-	static size_t wind_count[4];
+	size_t wind_index[] = {0,0,0,0};
+	size_t wind_count[4] = {0,0,0,0};
 	double *wind_uvals=0,*wind_vvals=0, fill_value = -1e+10;
 	long totalNumberOfVels = fNumRows * fNumCols;
 	VelocityFH velH = 0;
@@ -548,9 +550,9 @@ LAS:
 		}
 	}
 	*velocityH = velH;
-	fFillValue = fill_value;
+	SetSliceFillValue(fill_value);
 	//fWindScale = scale_factor;
-	fVar.fileScaleFactor = scale_factor;
+	SetSliceScaleFactor(scale_factor);
 	
 done:
 	if (err)
@@ -659,6 +661,7 @@ scale:
 // this code is for curvilinear grids
 OSErr TimeGridWindCurv_c::TextRead(const char *path, const char *topFilePath) // don't want a map
 {
+	NetCDFLock lock;
 	OSErr err = 0;
 	char errmsg[256] = "";
 	char s[256], topPath[256];
@@ -1044,8 +1047,8 @@ OSErr TimeGridWindCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* e
 	char *velUnits=0;
 	int status, ncid, numdims;
 	int wind_ucmp_id, wind_vcmp_id, angle_id, uv_ndims;
-	static size_t wind_index[] = {0,0,0,0}, angle_index[] = {0,0};
-	static size_t wind_count[4], angle_count[2];
+	size_t wind_index[] = {0,0,0,0}, angle_index[] = {0,0};
+	size_t wind_count[4] = {0,0,0,0}, angle_count[2] = {0,0};
 	size_t velunit_len;
 	float *wind_uvals = 0,*wind_vvals = 0, fill_value=-1e-72, velConversion=1.;
 	short *wind_uvals_Navy = 0,*wind_vvals_Navy = 0, fill_value_Navy;
@@ -1264,10 +1267,10 @@ OSErr TimeGridWindCurv_c::ReadTimeData(long index,VelocityFH *velocityH, char* e
 		}
 	}
 	*velocityH = velH;
-	fFillValue = fill_value;
+	SetSliceFillValue(fill_value);
 	
 	//fWindScale = scale_factor;	// hmm, this forces a reset of scale factor each time, overriding any set by hand
-	fVar.fileScaleFactor = scale_factor;	// hmm, this forces a reset of scale factor each time, overriding any set by hand
+	SetSliceScaleFactor(scale_factor);	// hmm, this forces a reset of scale factor each time, overriding any set by hand
 	
 done:
 	if (err)
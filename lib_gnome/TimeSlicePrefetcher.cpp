@@ -0,0 +1,131 @@
+/*
+ *  TimeSlicePrefetcher.cpp
+ *  gnome
+ *
+ */
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "TimeSlicePrefetcher.h"
+#include "TimeGridVel_c.h"
+#include "MemUtils.h"
+
+static std::recursive_mutex &NetCDFMutex()
+{
+	static std::recursive_mutex netCDFMutex;
+	return netCDFMutex;
+}
+
+NetCDFLock::NetCDFLock()
+{
+	NetCDFMutex().lock();
+}
+
+NetCDFLock::~NetCDFLock()
+{
+	NetCDFMutex().unlock();
+}
+
+struct TimeSlicePrefetcher::PendingRead {
+	long				timeIndex;
+	VelocityFH			velocityH;
+	SliceAttributes		attributes;
+	OSErr				err;
+	std::atomic<bool>	done;
+	std::thread			reader;
+};
+
+// leaves the grid as it is, the slice's fill value and scale factor are kept with it
+static void ReadSlice(TimeGridVel_c *timeGrid, long timeIndex, VelocityFH *velocityH, SliceAttributes *attributes,
+					  OSErr *err, std::atomic<bool> *done)
+{
+	char errmsg[256];
+
+	errmsg[0] = 0;
+	*err = timeGrid->ReadTimeDataCached(timeIndex, velocityH, errmsg, attributes);
+	*done = true;
+}
+
+TimeSlicePrefetcher::TimeSlicePrefetcher()
+{
+	fPending = 0;
+	ResetCounts();
+}
+
+TimeSlicePrefetcher::~TimeSlicePrefetcher()
+{
+	Cancel();
+}
+
+void TimeSlicePrefetcher::ResetCounts()
+{
+	fNumHits = 0;
+	fNumMisses = 0;
+	fNumStalls = 0;
+}
+
+void TimeSlicePrefetcher::Start(TimeGridVel_c *timeGrid, long timeIndex)
+{
+	if (fPending && fPending->timeIndex == timeIndex)
+		return;	// already on its way
+
+	Cancel();
+
+	fPending = new PendingRead;
+	fPending->timeIndex = timeIndex;
+	fPending->velocityH = 0;
+	fPending->err = 0;
+	fPending->done = false;
+	fPending->reader = std::thread(ReadSlice, timeGrid, timeIndex, &fPending->velocityH, &fPending->attributes,
+								   &fPending->err, &fPending->done);
+}
+
+void TimeSlicePrefetcher::Finish()
+{
+	if (fPending->reader.joinable())
+		fPending->reader.join();
+}
+
+// hands the prefetched handle over if it is the slice asked for,
+// otherwise the caller reads it and the prefetch is kept for later
+Boolean TimeSlicePrefetcher::Take(long timeIndex, VelocityFH *velocityH, SliceAttributes *attributes)
+{
+	if (!fPending || fPending->timeIndex != timeIndex)
+	{
+		fNumMisses++;
+		return false;
+	}
+
+	if (!fPending->done)
+		fNumStalls++;
+	Finish();
+
+	if (fPending->err || !fPending->velocityH)
+	{
+		if (fPending->velocityH) DisposeHandle((Handle)fPending->velocityH);
+		delete fPending;
+		fPending = 0;
+		fNumMisses++;
+		return false;
+	}
+
+	*velocityH = fPending->velocityH;
+	*attributes = fPending->attributes;
+	delete fPending;
+	fPending = 0;
+	fNumHits++;
+	return true;
+}
+
+void TimeSlicePrefetcher::Cancel()
+{
+	if (!fPending)
+		return;
+
+	Finish();
+	if (fPending->velocityH) DisposeHandle((Handle)fPending->velocityH);
+	delete fPending;
+	fPending = 0;
+}
@@ -0,0 +1,53 @@
+/*
+ *  TimeSlicePrefetcher.h
+ *  gnome
+ *
+ *  Reads the next time slice of a TimeGridVel_c on a background thread
+ *  while the current interval is being used.
+ *
+ */
+
+#ifndef __TimeSlicePrefetcher__
+#define __TimeSlicePrefetcher__
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+class TimeGridVel_c;
+struct SliceAttributes;
+
+// the netCDF library is not thread safe, every ReadTimeData that may run
+// alongside a prefetch holds this for the length of the read, as do the
+// reads of a file's grid and times and the particle file writer's thread.
+// A thread already holding it can take it again.
+class DLL_API NetCDFLock {
+public:
+	NetCDFLock();
+	~NetCDFLock();
+};
+
+class DLL_API TimeSlicePrefetcher {
+
+public:
+	long	fNumHits;		// slice was prefetched when SetInterval asked for it
+	long	fNumMisses;		// slice had to be read in the foreground
+	long	fNumStalls;		// hits that still had to wait for the read to finish
+
+	TimeSlicePrefetcher();
+	~TimeSlicePrefetcher();
+
+	void	Start(TimeGridVel_c *timeGrid, long timeIndex);
+	// the slice's fill value and scale factor come with it, for the caller to set on the grid
+	Boolean	Take(long timeIndex, VelocityFH *velocityH, SliceAttributes *attributes);
+	void	Cancel();
+	void	ResetCounts();
+
+private:
+	struct PendingRead;
+	PendingRead	*fPending;
+
+	void	Finish();
+};
+
+#endif
@@ -0,0 +1,318 @@
+/*
+ *  TopologyCache.cpp
+ *  gnome
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <mutex>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "TopologyCache.h"
+#include "MemUtils.h"
+
+#define kTopologyFileVersion 1
+
+using std::lock_guard;
+using std::mutex;
+using std::string;
+
+static mutex sSettingsMutex;
+static string sCacheDir;
+static Boolean sEnabled = true;
+
+// The file is this header followed by the points, triangles, DAG, verdat-to-NetCDF
+// indices and the boundary segments, types and points, each as the handle holds it.
+// So the longs are the writer's (the longSize check fails on a machine with others).
+typedef struct {
+	char	magic[8];
+	int32_t	version;
+	int32_t	longSize;
+	uint64_t	key;
+	int32_t	numRows;
+	int32_t	numCols;
+	int64_t	numPoints;
+	int64_t	numTriangles;
+	int64_t	numBranches;
+	int64_t	numBoundarySegs;	// -1 if the boundaries weren't traced
+	int64_t	numBoundaryPts;
+} TopologyFileHeader;
+
+static const char kTopologyMagic[8] = {'G','N','T','O','P','O','L','O'};
+
+// FNV-1a
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char*)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static size_t HandleCount(Handle h, size_t elementSize)
+{
+	return h ? _GetHandleSize(h) / elementSize : 0;
+}
+
+// a new handle holding a copy of count elements, advancing data past them
+static Handle CopyToHandle(const char **data, size_t count, size_t elementSize)
+{
+	Handle h = _NewHandle(count * elementSize);
+
+	if (h && count > 0) memcpy(*h, *data, count * elementSize);
+	*data += count * elementSize;
+	return h;
+}
+
+void TopologyCache::SetCacheDir(const char *dir)
+{
+	lock_guard<mutex> lock(sSettingsMutex);
+
+	sCacheDir = dir ? dir : "";
+}
+
+string TopologyCache::GetCacheDir()
+{
+	lock_guard<mutex> lock(sSettingsMutex);
+
+	return sCacheDir;
+}
+
+void TopologyCache::SetEnabled(Boolean enabled)
+{
+	lock_guard<mutex> lock(sSettingsMutex);
+
+	sEnabled = enabled;
+}
+
+Boolean TopologyCache::IsEnabled()
+{
+	lock_guard<mutex> lock(sSettingsMutex);
+
+	return sEnabled;
+}
+
+TopologyCache::TopologyCache(const char *gridPath, DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH)
+{
+	int64_t dims[2] = {numRows, numCols};
+	int32_t builderVersion = kDagTreeBuilderVersion;
+	const char *separator;
+	size_t dirLength;
+	string cacheDir;
+
+	fNumRows = numRows;
+	fNumCols = numCols;
+	fFilePath[0] = 0;
+
+	fKey = HashBytes(14695981039346656037ULL, dims, sizeof(dims));
+	if (landMaskH) fKey = HashBytes(fKey, *landMaskH, numRows * numCols * sizeof(**landMaskH));
+	if (vertexPtsH) fKey = HashBytes(fKey, *vertexPtsH, numRows * numCols * sizeof(**vertexPtsH));
+	fKey = HashBytes(fKey, &builderVersion, sizeof(builderVersion));
+
+	if (!gridPath || !gridPath[0]) return;
+
+	{
+		lock_guard<mutex> lock(sSettingsMutex);
+
+		if (!sEnabled) return;
+		cacheDir = sCacheDir;
+	}
+
+	if (!cacheDir.empty())
+	{
+		char last = cacheDir[cacheDir.size() - 1];
+
+		if (last != '/' && last != '\\') cacheDir += NEWDIRDELIMITER;
+	}
+	else
+	{
+		// in the grid file's directory
+		separator = strrchr(gridPath, '/');
+		if (!separator) separator = strrchr(gridPath, '\\');
+		dirLength = separator ? separator - gridPath + 1 : 0;
+		cacheDir.assign(gridPath, dirLength);
+	}
+	dirLength = cacheDir.size();
+	if (dirLength + strlen(kTopologyCacheFilePrefix) + 21 > sizeof(fFilePath)) return;
+
+	memcpy(fFilePath, cacheDir.c_str(), dirLength);
+	sprintf(fFilePath + dirLength, "%s%016llx.bin", kTopologyCacheFilePrefix, (unsigned long long)fKey);
+}
+
+OSErr TopologyCache::Read(Boolean needBoundaries, CurvilinearTopology *topology) const
+{
+	TopologyFileHeader header;
+	const char *data = 0, *next;
+	size_t fileSize, expectedSize;
+	OSErr err = noErr;
+
+	memset(topology, 0, sizeof(*topology));
+	if (!fFilePath[0]) return -1;
+
+#ifdef _WIN32
+	FILE *stream = fopen(fFilePath, "rb");
+	char *buffer = 0;
+
+	if (!stream) return -1;
+	fseek(stream, 0, SEEK_END);
+	fileSize = ftell(stream);
+	fseek(stream, 0, SEEK_SET);
+	if (fileSize < sizeof(header)) {fclose(stream); return -1;}
+	try
+	{
+		buffer = new char[fileSize];
+	}
+	catch (...)
+	{
+		fclose(stream);
+		return -1;
+	}
+	if (fread(buffer, 1, fileSize, stream) != fileSize) {fclose(stream); delete [] buffer; return -1;}
+	fclose(stream);
+	data = buffer;
+#else
+	struct stat fileStat;
+	int fd = open(fFilePath, O_RDONLY);
+
+	if (fd < 0) return -1;
+	if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(header)) {close(fd); return -1;}
+	fileSize = fileStat.st_size;
+	data = (const char*)mmap(0, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);	// the mapping keeps the file open
+	if (data == (const char*)MAP_FAILED) return -1;
+#endif
+
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, kTopologyMagic, sizeof(header.magic)) != 0
+		|| header.version != kTopologyFileVersion
+		|| header.longSize != sizeof(long)
+		|| header.key != fKey
+		|| header.numRows != fNumRows || header.numCols != fNumCols
+		|| header.numPoints <= 0 || header.numTriangles <= 0 || header.numBranches <= 0
+		|| header.numBoundarySegs < -1 || header.numBoundaryPts < 0
+		|| (needBoundaries && header.numBoundarySegs < 0))
+	{
+		err = -1;
+		goto done;
+	}
+	expectedSize = sizeof(header)
+		+ header.numPoints * (sizeof(LongPoint) + sizeof(long))
+		+ header.numTriangles * sizeof(Topology)
+		+ header.numBranches * sizeof(DAG)
+		+ (header.numBoundarySegs >= 0 ? header.numBoundarySegs + 2 * header.numBoundaryPts : 0) * sizeof(long);
+	if (fileSize != expectedSize)
+	{
+		err = -1;
+		goto done;
+	}
+
+	next = data + sizeof(header);
+	topology->pts = (LongPointHdl)CopyToHandle(&next, header.numPoints, sizeof(LongPoint));
+	topology->topo = (TopologyHdl)CopyToHandle(&next, header.numTriangles, sizeof(Topology));
+	topology->tree = (DAGHdl)CopyToHandle(&next, header.numBranches, sizeof(DAG));
+	topology->numBranches = header.numBranches;
+	topology->verdatToNetCDF = (LONGH)CopyToHandle(&next, header.numPoints, sizeof(long));
+	if (!topology->pts || !topology->topo || !topology->tree || !topology->verdatToNetCDF)
+	{
+		err = memFullErr;
+		goto done;
+	}
+	if (header.numBoundarySegs >= 0 && needBoundaries)
+	{
+		topology->boundarySegs = (LONGH)CopyToHandle(&next, header.numBoundarySegs, sizeof(long));
+		topology->boundaryTypes = (LONGH)CopyToHandle(&next, header.numBoundaryPts, sizeof(long));
+		topology->boundaryPts = (LONGH)CopyToHandle(&next, header.numBoundaryPts, sizeof(long));
+		if (!topology->boundarySegs || !topology->boundaryTypes || !topology->boundaryPts)
+			err = memFullErr;
+	}
+
+done:
+#ifdef _WIN32
+	delete [] buffer;
+#else
+	munmap((void*)data, fileSize);
+#endif
+	if (err) DisposeTopology(topology);
+	return err;
+}
+
+OSErr TopologyCache::Write(const CurvilinearTopology &topology) const
+{
+	TopologyFileHeader header;
+	char tempPath[kMaxNameLen + 32];
+	FILE *stream;
+	Boolean hasBoundaries = topology.boundarySegs && topology.boundaryTypes && topology.boundaryPts;
+	OSErr err = noErr;
+
+	if (!fFilePath[0]) return -1;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kTopologyMagic, sizeof(header.magic));
+	header.version = kTopologyFileVersion;
+	header.longSize = sizeof(long);
+	header.key = fKey;
+	header.numRows = fNumRows;
+	header.numCols = fNumCols;
+	header.numPoints = HandleCount((Handle)topology.pts, sizeof(LongPoint));
+	header.numTriangles = HandleCount((Handle)topology.topo, sizeof(Topology));
+	header.numBranches = topology.numBranches;
+	header.numBoundarySegs = hasBoundaries ? HandleCount((Handle)topology.boundarySegs, sizeof(long)) : -1;
+	header.numBoundaryPts = hasBoundaries ? HandleCount((Handle)topology.boundaryPts, sizeof(long)) : 0;
+
+	if (header.numPoints <= 0 || header.numTriangles <= 0 || header.numBranches <= 0
+		|| HandleCount((Handle)topology.verdatToNetCDF, sizeof(long)) < (size_t)header.numPoints
+		|| HandleCount((Handle)topology.tree, sizeof(DAG)) < (size_t)header.numBranches
+		|| (hasBoundaries && HandleCount((Handle)topology.boundaryTypes, sizeof(long)) != (size_t)header.numBoundaryPts))
+		return -1;
+
+	// written under a name of our own and renamed, so no process ever reads half a file
+	sprintf(tempPath, "%s.%ld", fFilePath, (long)getpid());
+	stream = fopen(tempPath, "wb");
+	if (!stream) return -1;
+
+	if (fwrite(&header, sizeof(header), 1, stream) != 1
+		|| fwrite(*topology.pts, sizeof(LongPoint), header.numPoints, stream) != (size_t)header.numPoints
+		|| fwrite(*topology.topo, sizeof(Topology), header.numTriangles, stream) != (size_t)header.numTriangles
+		|| fwrite(*topology.tree, sizeof(DAG), header.numBranches, stream) != (size_t)header.numBranches
+		|| fwrite(*topology.verdatToNetCDF, sizeof(long), header.numPoints, stream) != (size_t)header.numPoints)
+		err = -1;
+	if (!err && hasBoundaries
+		&& (fwrite(*topology.boundarySegs, sizeof(long), header.numBoundarySegs, stream) != (size_t)header.numBoundarySegs
+			|| fwrite(*topology.boundaryTypes, sizeof(long), header.numBoundaryPts, stream) != (size_t)header.numBoundaryPts
+			|| fwrite(*topology.boundaryPts, sizeof(long), header.numBoundaryPts, stream) != (size_t)header.numBoundaryPts))
+		err = -1;
+	if (fclose(stream) != 0)
+		err = -1;
+	if (!err && rename(tempPath, fFilePath) != 0)
+		err = -1;
+	if (err)
+		remove(tempPath);
+	return err;
+}
+
+void TopologyCache::DisposeTopology(CurvilinearTopology *topology)
+{
+	if (topology->pts) {DisposeHandle((Handle)topology->pts); topology->pts = 0;}
+	if (topology->topo) {DisposeHandle((Handle)topology->topo); topology->topo = 0;}
+	if (topology->tree) {DisposeHandle((Handle)topology->tree); topology->tree = 0;}
+	if (topology->verdatToNetCDF) {DisposeHandle((Handle)topology->verdatToNetCDF); topology->verdatToNetCDF = 0;}
+	if (topology->boundarySegs) {DisposeHandle((Handle)topology->boundarySegs); topology->boundarySegs = 0;}
+	if (topology->boundaryTypes) {DisposeHandle((Handle)topology->boundaryTypes); topology->boundaryTypes = 0;}
+	if (topology->boundaryPts) {DisposeHandle((Handle)topology->boundaryPts); topology->boundaryPts = 0;}
+	topology->numBranches = 0;
+}
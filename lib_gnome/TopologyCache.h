@@ -0,0 +1,75 @@
+/*
+ *  TopologyCache.h
+ *  gnome
+ *
+ *  The triangulation of a curvilinear grid, saved in a binary file next to
+ *  the grid file so later loads can skip rebuilding it. The file is named
+ *  by a hash of the land mask, vertices and DAG builder version, so the map
+ *  and the current mover reading the same grid find the same file, and a
+ *  tree from another builder is never read.
+ *
+ *  The files can be kept in a directory of their own instead, for grids in
+ *  directories that can't or shouldn't be written to, and the cache can be
+ *  turned off, in which case grids are always rebuilt and nothing written.
+ *
+ *  The map traces the land-water boundaries as well. A file written by a
+ *  mover doesn't have them, so a map that needs them rebuilds the grid and
+ *  writes the file again.
+ *
+ */
+
+#ifndef __TopologyCache__
+#define __TopologyCache__
+
+#include <stdint.h>
+
+#include <string>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "DagTree.h"
+#include "ExportSymbols.h"
+
+#define kTopologyCacheFilePrefix "gnome_topology_"
+
+// the handles are the caller's, and stay the caller's after Write
+typedef struct {
+	LongPointHdl	pts;
+	TopologyHdl		topo;
+	DAGHdl			tree;
+	long			numBranches;
+	LONGH			verdatToNetCDF;		// index in the grid with the extra row and column, for each point
+	LONGH			boundarySegs;		// 0 if the boundaries weren't traced
+	LONGH			boundaryTypes;
+	LONGH			boundaryPts;
+} CurvilinearTopology;
+
+class DLL_API TopologyCache {
+
+public:
+	// a dir of 0 or "" puts the files next to the grid files (the default)
+	static void	SetCacheDir(const char *dir);
+	static std::string GetCacheDir();
+	static void	SetEnabled(Boolean enabled);
+	static Boolean IsEnabled();
+
+	// no file is read or written when gridPath is empty or the cache is off
+	TopologyCache(const char *gridPath, DOUBLEH landMaskH, long numRows, long numCols, WORLDPOINTFH vertexPtsH);
+
+	uint64_t	GetKey() const {return fKey;}
+	const char	*GetFilePath() const {return fFilePath;}
+
+	// new handles from the file, in topology; an error if there is no
+	// usable file, or the boundaries are needed and it doesn't have them
+	OSErr		Read(Boolean needBoundaries, CurvilinearTopology *topology) const;
+	OSErr		Write(const CurvilinearTopology &topology) const;
+
+	static void	DisposeTopology(CurvilinearTopology *topology);
+
+private:
+	uint64_t	fKey;
+	long		fNumRows, fNumCols;
+	char		fFilePath[kMaxNameLen];
+};
+
+#endif
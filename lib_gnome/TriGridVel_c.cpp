@@ -57,6 +57,12 @@ long TriGridVel_c::GetNumDepths(void)
 }
 
 InterpolationVal TriGridVel_c::GetInterpolationValues(WorldPoint refPoint)
+{
+	return GetInterpolationValuesFromLastTri(refPoint, 0);
+}
+
+// lastTri, if given, is where the search for the triangle starts and is updated to it
+InterpolationVal TriGridVel_c::GetInterpolationValuesFromLastTri(WorldPoint refPoint, long *lastTri)
 {
 	InterpolationVal interpolationVal;
 	LongPoint lp;
@@ -74,7 +80,7 @@ InterpolationVal TriGridVel_c::GetInterpolationValues(WorldPoint refPoint)
 	
 	lp.h = refPoint.pLong;
 	lp.v = refPoint.pLat;
-	ntri = fDagTree->WhatTriAmIIn(lp);
+	ntri = fDagTree->WhatTriAmIIn(lp, lastTri);
 	if (ntri < 0) 
 	{
 		interpolationVal.ptIndex1 = ntri; // flag it
@@ -168,6 +174,17 @@ long TriGridVel_c::GetRectIndexFromTriIndex2(long triIndex,LONGH ptrVerdatToNetC
 	return index;
 }
 
+long TriGridVel_c::GetRectIndexFromLastTri(WorldPoint refPoint,LONGH ptrVerdatToNetCDFH,long numCols_ext,long *lastTri)
+{
+	LongPoint lp;
+	
+	if(!fDagTree) return -1;
+	
+	lp.h = refPoint.pLong;
+	lp.v = refPoint.pLat;
+	return GetRectIndexFromTriIndex2(fDagTree->WhatTriAmIIn(lp, lastTri),ptrVerdatToNetCDFH,numCols_ext);
+}
+
 long TriGridVel_c::GetRectIndexFromTriIndex(WorldPoint refPoint,LONGH ptrVerdatToNetCDFH,long numCols_ext)
 {
 	// code goes here, may eventually want to get interpolation indices around point
@@ -386,6 +403,22 @@ VelocityRec TriGridVel_c::GetPatValue(WorldPoint p)
 	return r;
 }
 
+VelocityRec TriGridVel_c::GetPatValueFromLastTri(WorldPoint p, long *lastTri)
+{
+	VelocityRec r = {0.,0.};
+	LongPoint lp;
+	long ntri;
+
+	lp.h = p.pLong;
+	lp.v = p.pLat;
+
+	ntri = fDagTree->WhatTriAmIIn(lp, lastTri);
+	if (ntri > -1)
+		fDagTree->GetVelocity(ntri,&r);
+
+	return r;
+}
+
 double TriGridVel_c::GetDepthAtPoint(WorldPoint p)
 {
 	double depthAtPoint = 0;
@@ -27,6 +27,8 @@ public:
 	//virtual ClassID 	GetClassID 	() { return TYPE_TRIGRIDVEL; }
 	void SetDagTree(TDagTree *dagTree){fDagTree=dagTree;}
 	TDagTree*  GetDagTree(){return fDagTree;}
+	void SetUsePointIndex(Boolean usePointIndex){if (fDagTree) fDagTree->SetUsePointIndex(usePointIndex);}
+	Boolean GetUsePointIndex(){return fDagTree ? fDagTree->GetUsePointIndex() : false;}
 	LongPointHdl GetPointsHdl(void);
 	TopologyHdl GetTopologyHdl(void);
 	//DAGHdl GetDagTreeHdl(void);
@@ -37,10 +39,13 @@ public:
 	FLOATH  GetBathymetry(){return fBathymetryH;}
 	FLOATH  GetDepths(){return fBathymetryH;}
 	VelocityRec GetPatValue(WorldPoint p);
+	VelocityRec GetPatValueFromLastTri(WorldPoint p, long *lastTri);
 	VelocityRec GetSmoothVelocity(WorldPoint p);
 	virtual double GetDepthAtPoint(WorldPoint p);
 	virtual InterpolationVal GetInterpolationValues(WorldPoint refPoint);
+	InterpolationVal GetInterpolationValuesFromLastTri(WorldPoint refPoint, long *lastTri);
 	virtual	long GetRectIndexFromTriIndex(WorldPoint refPoint, LONGH ptrVerdatToNetCDFH, long numCols_ext);
+	long GetRectIndexFromLastTri(WorldPoint refPoint, LONGH ptrVerdatToNetCDFH, long numCols_ext, long *lastTri);
 	virtual	long GetRectIndexFromTriIndex2(long triIndex, LONGH ptrVerdatToNetCDFH, long numCols_ext);
 	virtual LongPoint GetRectIndicesFromTriIndex(WorldPoint refPoint,LONGH ptrVerdatToNetCDFH,long numCols_ext);
 	OSErr	GetRectCornersFromTriIndexOrPoint(long *index1, long *index2, long *index3, long *index4, WorldPoint refPoint,long triNum, Boolean useTriNum, LONGH ptrVerdatToNetCDFH,long numCols_ext);
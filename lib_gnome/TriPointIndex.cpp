@@ -0,0 +1,161 @@
+/*
+ *  TriPointIndex.cpp
+ *  gnome
+ *
+ */
+
+#include <math.h>
+
+#include "TriPointIndex.h"
+#include "MemUtils.h"
+
+using namespace std;
+
+static const double kTrisPerBucket = 2.;
+
+TriPointIndex::TriPointIndex(LongPointHdl ptsH, TopologyHdl topH)
+{
+	long i, row, col, numPts;
+	long right, top;
+
+	fNumTriangles = 0;
+	fLeft = fBottom = 0;
+	fBucketWidth = fBucketHeight = 1.;
+	fNumBucketCols = fNumBucketRows = 0;
+
+	if (!ptsH || !topH)
+		return;
+
+	numPts = _GetHandleSize((Handle)ptsH) / sizeof(**ptsH);
+	fNumTriangles = _GetHandleSize((Handle)topH) / sizeof(**topH);
+	if (numPts <= 0 || fNumTriangles <= 0)
+	{
+		fNumTriangles = 0;
+		return;
+	}
+
+	fPtH.resize(numPts);
+	fPtV.resize(numPts);
+	fLeft = right = (*ptsH)[0].h;
+	fBottom = top = (*ptsH)[0].v;
+	for (i = 0; i < numPts; i++)
+	{
+		fPtH[i] = (*ptsH)[i].h;
+		fPtV[i] = (*ptsH)[i].v;
+		if (fPtH[i] < fLeft) fLeft = fPtH[i];
+		if (fPtH[i] > right) right = fPtH[i];
+		if (fPtV[i] < fBottom) fBottom = fPtV[i];
+		if (fPtV[i] > top) top = fPtV[i];
+	}
+
+	fTriVertices.resize(3 * fNumTriangles);
+	for (i = 0; i < fNumTriangles; i++)
+	{
+		fTriVertices[3 * i] = (*topH)[i].vertex1;
+		fTriVertices[3 * i + 1] = (*topH)[i].vertex2;
+		fTriVertices[3 * i + 2] = (*topH)[i].vertex3;
+	}
+
+	// square-ish buckets, about kTrisPerBucket triangles each
+	double width = (double)right - fLeft + 1, height = (double)top - fBottom + 1;
+	double bucketSize = sqrt(width * height * kTrisPerBucket / fNumTriangles);
+
+	fNumBucketCols = (long)ceil(width / bucketSize);
+	fNumBucketRows = (long)ceil(height / bucketSize);
+	if (fNumBucketCols < 1) fNumBucketCols = 1;
+	if (fNumBucketRows < 1) fNumBucketRows = 1;
+	fBucketWidth = width / fNumBucketCols;
+	fBucketHeight = height / fNumBucketRows;
+
+	// count the triangles overlapping each bucket, then fill them in
+	fBucketStart.assign(fNumBucketCols * fNumBucketRows + 1, 0);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		vector<long> next;
+
+		if (pass == 1)
+		{
+			for (i = 0; i < fNumBucketCols * fNumBucketRows; i++)
+				fBucketStart[i + 1] += fBucketStart[i];
+			fBucketTris.resize(fBucketStart[fNumBucketCols * fNumBucketRows]);
+			next.assign(fBucketStart.begin(), fBucketStart.end() - 1);
+		}
+
+		for (i = 0; i < fNumTriangles; i++)
+		{
+			long *verts = &fTriVertices[3 * i];
+			long minH = min(fPtH[verts[0]], min(fPtH[verts[1]], fPtH[verts[2]]));
+			long maxH = max(fPtH[verts[0]], max(fPtH[verts[1]], fPtH[verts[2]]));
+			long minV = min(fPtV[verts[0]], min(fPtV[verts[1]], fPtV[verts[2]]));
+			long maxV = max(fPtV[verts[0]], max(fPtV[verts[1]], fPtV[verts[2]]));
+
+			for (row = GetBucketRow(minV); row <= GetBucketRow(maxV); row++)
+			{
+				for (col = GetBucketCol(minH); col <= GetBucketCol(maxH); col++)
+				{
+					long bucket = row * fNumBucketCols + col;
+					if (pass == 0)
+						fBucketStart[bucket + 1]++;
+					else
+						fBucketTris[next[bucket]++] = i;
+				}
+			}
+		}
+	}
+}
+
+long TriPointIndex::GetBucketCol(long h)
+{
+	long col = (long)floor((h - fLeft) / fBucketWidth);
+
+	if (col < 0) return 0;
+	if (col >= fNumBucketCols) return fNumBucketCols - 1;
+	return col;
+}
+
+long TriPointIndex::GetBucketRow(long v)
+{
+	long row = (long)floor((v - fBottom) / fBucketHeight);
+
+	if (row < 0) return 0;
+	if (row >= fNumBucketRows) return fNumBucketRows - 1;
+	return row;
+}
+
+// same cross product as Right_or_Left_of_Segment, a point on an edge counts as inside
+Boolean TriPointIndex::IsPtInTri(long triNum, LongPoint pt)
+{
+	long *verts = &fTriVertices[3 * triNum];
+
+	for (int edge = 0; edge < 3; edge++)
+	{
+		long p1 = verts[edge], p2 = verts[(edge + 1) % 3];
+		double ref_h = (fPtH[p2] - fPtH[p1]) / 1000000.;
+		double ref_v = (fPtV[p2] - fPtV[p1]) / 1000000.;
+		double test1_h = (pt.h - fPtH[p1]) / 1000000.;
+		double test1_v = (pt.v - fPtV[p1]) / 1000000.;
+
+		if (test1_h * ref_v - test1_v * ref_h > 0.)
+			return false;	// right of the edge
+	}
+	return true;
+}
+
+long TriPointIndex::WhatTriAmIIn(LongPoint pt)
+{
+	if (fNumTriangles == 0)
+		return -1;
+
+	if (pt.h < fLeft || pt.v < fBottom ||
+		pt.h >= fLeft + fBucketWidth * fNumBucketCols || pt.v >= fBottom + fBucketHeight * fNumBucketRows)
+		return -1;
+
+	long bucket = GetBucketRow(pt.v) * fNumBucketCols + GetBucketCol(pt.h);
+
+	for (long i = fBucketStart[bucket]; i < fBucketStart[bucket + 1]; i++)
+	{
+		if (IsPtInTri(fBucketTris[i], pt))
+			return fBucketTris[i];
+	}
+	return -1;
+}
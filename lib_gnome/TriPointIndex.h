@@ -0,0 +1,51 @@
+/*
+ *  TriPointIndex.h
+ *  gnome
+ *
+ *  Uniform bucket grid over a triangle mesh for point location. Built once
+ *  from the points and topology handles, a lookup tests only the few
+ *  triangles whose bounds overlap the point's bucket instead of walking
+ *  the DAG tree from its root.
+ *
+ */
+
+#ifndef __TriPointIndex__
+#define __TriPointIndex__
+
+#include <vector>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "DagTree.h"
+
+class TriPointIndex {
+
+public:
+	TriPointIndex(LongPointHdl ptsH, TopologyHdl topH);
+
+	long		WhatTriAmIIn(LongPoint pt);	// -1 if outside the mesh
+	long		GetNumTriangles() {return fNumTriangles;}
+
+private:
+	long		fNumTriangles;
+
+	// vertex coordinates, as in the points handle
+	std::vector<long>	fPtH;
+	std::vector<long>	fPtV;
+
+	// triangle vertex numbers, three per triangle
+	std::vector<long>	fTriVertices;
+
+	// buckets, the triangles in bucket i are fBucketTris[fBucketStart[i]] up to fBucketStart[i+1]
+	long		fLeft, fBottom;
+	double		fBucketWidth, fBucketHeight;
+	long		fNumBucketCols, fNumBucketRows;
+	std::vector<long>	fBucketStart;
+	std::vector<long>	fBucketTris;
+
+	Boolean		IsPtInTri(long triNum, LongPoint pt);
+	long		GetBucketCol(long h);
+	long		GetBucketRow(long v);
+};
+
+#endif
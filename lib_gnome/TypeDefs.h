@@ -334,6 +334,7 @@ typedef struct SegInfo
 
 enum { REGULAR=1, REGULAR_SWAFS, CURVILINEAR, TRIANGULAR, REGRIDDED};	// maybe eliminate regridded option
 enum {TWO_D=1, BAROTROPIC, SIGMA, MULTILAYER, SIGMA_ROMS};	// gridtypes
+enum {BLEND_PER_LE=0, BLEND_TILES, BLEND_GRID};	// how a time grid blends its loaded interval in time
 
 
 typedef struct {
@@ -0,0 +1,136 @@
+/*
+ *  UncertaintyArrays.cpp
+ *  gnome
+ *
+ */
+
+#include <new>
+
+#include "UncertaintyArrays.h"
+
+// LEs to a chunk when dropping removed LEs; each chunk is counted and then
+// copied down on its own, so the chunks can go on different threads
+const long kRemoveLEsChunk = 65536;
+
+LEUncertainRec UncertaintyArrays::GetCurrentRec(long setIndex, long leIndex) const
+{
+	LEUncertainRec rec;
+	long i = fSetStarts[setIndex] + leIndex;
+
+	rec.downStream = fFirstTerms[i];
+	rec.crossStream = fSecondTerms[i];
+	return rec;
+}
+
+LEWindUncertainRec UncertaintyArrays::GetWindRec(long setIndex, long leIndex) const
+{
+	LEWindUncertainRec rec;
+	long i = fSetStarts[setIndex] + leIndex;
+
+	rec.randCos = fFirstTerms[i];
+	rec.randSin = fSecondTerms[i];
+	return rec;
+}
+
+OSErr UncertaintyArrays::Allocate(int numLESets, int *LESetsSizesList)
+{
+	long i, numLEs = 0;
+
+	this->Dispose();
+	if (numLESets <= 0) return -1;
+
+	try
+	{
+		fSetStarts.resize(numLESets);
+		for (i = 0; i < numLESets; i++)
+		{
+			fSetStarts[i] = numLEs;
+			numLEs += LESetsSizesList[i];
+		}
+		fFirstTerms.resize(numLEs, 0);
+		fSecondTerms.resize(numLEs, 0);
+	}
+	catch (std::bad_alloc &)
+	{
+		this->Dispose();
+		return memFullErr;
+	}
+	return noErr;
+}
+
+OSErr UncertaintyArrays::Grow(long numLEs)
+{
+	if (numLEs < this->GetNumLEs()) return -1;
+
+	try
+	{
+		fFirstTerms.resize(numLEs, 0);
+		fSecondTerms.resize(numLEs, 0);
+	}
+	catch (std::bad_alloc &)
+	{
+		return memFullErr;
+	}
+	return noErr;
+}
+
+void UncertaintyArrays::Dispose()
+{
+	// swapping with empty vectors gives the memory back, clear() may not
+	std::vector<long>().swap(fSetStarts);
+	std::vector<float>().swap(fFirstTerms);
+	std::vector<float>().swap(fSecondTerms);
+}
+
+OSErr UncertaintyArrays::RemoveLEs(long numLEs, const short *statusCodes)
+{
+	long numChunks = (numLEs + kRemoveLEsChunk - 1) / kRemoveLEsChunk, c;
+	std::vector<long> chunkStarts(numChunks + 1, 0);
+	std::vector<float> firstTerms, secondTerms;
+
+	if (numLEs != this->GetNumLEs()) return -1;
+
+	// how many LEs each chunk keeps
+	ForEachLE(numChunks, [&](long firstChunk, long lastChunk) {
+		for (long c = firstChunk; c < lastChunk; c++)
+		{
+			long i, last = _min((c + 1) * kRemoveLEsChunk, numLEs), numKept = 0;
+			for (i = c * kRemoveLEsChunk; i < last; i++)
+				if (statusCodes[i] != OILSTAT_TO_BE_REMOVED) numKept++;
+			chunkStarts[c + 1] = numKept;
+		}
+	}, 1);
+	for (c = 0; c < numChunks; c++)
+		chunkStarts[c + 1] += chunkStarts[c];
+
+	if (chunkStarts[numChunks] == numLEs) return noErr;
+
+	try
+	{
+		firstTerms.resize(chunkStarts[numChunks]);
+		secondTerms.resize(chunkStarts[numChunks]);
+	}
+	catch (std::bad_alloc &)
+	{
+		return memFullErr;
+	}
+
+	// each chunk copies the LEs it keeps to where the chunks before it end
+	ForEachLE(numChunks, [&](long firstChunk, long lastChunk) {
+		for (long c = firstChunk; c < lastChunk; c++)
+		{
+			long i, last = _min((c + 1) * kRemoveLEsChunk, numLEs), j = chunkStarts[c];
+			for (i = c * kRemoveLEsChunk; i < last; i++)
+			{
+				if (statusCodes[i] == OILSTAT_TO_BE_REMOVED) continue;
+				firstTerms[j] = fFirstTerms[i];
+				secondTerms[j] = fSecondTerms[i];
+				j++;
+			}
+		}
+	}, 1);
+
+	fFirstTerms.swap(firstTerms);
+	fSecondTerms.swap(secondTerms);
+	return noErr;
+}
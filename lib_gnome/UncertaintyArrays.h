@@ -0,0 +1,74 @@
+/*
+ *  UncertaintyArrays.h
+ *  gnome
+ *
+ *  The per LE uncertainty factors of a mover, kept as two float arrays
+ *  rather than a handle of records: downStream and crossStream for the
+ *  current movers, randCos and randSin for the wind mover. Each LE set
+ *  starts at its own index into the arrays.
+ *
+ *  Filling the arrays and dropping removed LEs from them both run on
+ *  several threads when there are enough LEs.
+ *
+ */
+
+#ifndef __UncertaintyArrays__
+#define __UncertaintyArrays__
+
+#include <vector>
+#include <algorithm>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ForEachLE.h"
+#include "ExportSymbols.h"
+
+class DLL_API UncertaintyArrays {
+
+public:
+	UncertaintyArrays() {}
+
+	Boolean		IsAllocated() const {return !fSetStarts.empty();}
+	long		GetNumLESets() const {return fSetStarts.size();}
+	long		GetSetStart(long setIndex) const {return fSetStarts[setIndex];}
+	long		GetNumLEs() const {return fFirstTerms.size();}
+	const float	*GetFirstTerms() const {return fFirstTerms.empty() ? 0 : &fFirstTerms[0];}
+	const float	*GetSecondTerms() const {return fSecondTerms.empty() ? 0 : &fSecondTerms[0];}
+
+	LEUncertainRec		GetCurrentRec(long setIndex, long leIndex) const;
+	LEWindUncertainRec	GetWindRec(long setIndex, long leIndex) const;
+
+	// room for the LEs of each set, one set after the other; the values are zero until filled
+	OSErr		Allocate(int numLESets, int *LESetsSizesList);
+	// more room at the end for LEs released since, keeping the values there are
+	OSErr		Grow(long numLEs);
+	void		Dispose();
+
+	// drops the LEs whose status is OILSTAT_TO_BE_REMOVED, the others keeping their order
+	OSErr		RemoveLEs(long numLEs, const short *statusCodes);
+
+	// sets the terms of LEs first to last - 1 with fill(setIndex, leIndex, &firstTerm, &secondTerm),
+	// leIndex counting from the start of the LE's set
+	template <class Fill> void	FillTerms(long first, long last, const Fill &fill)
+	{
+		if (last <= first || !IsAllocated()) return;
+		float *firstTerms = &fFirstTerms[0], *secondTerms = &fSecondTerms[0];
+		const std::vector<long> &setStarts = fSetStarts;
+		ForEachLE(last - first, [&](long begin, long end) {
+			long setIndex = std::upper_bound(setStarts.begin(), setStarts.end(), first + begin) - setStarts.begin() - 1;
+			for (long i = first + begin; i < first + end; i++)
+			{
+				while (setIndex + 1 < (long)setStarts.size() && setStarts[setIndex + 1] <= i)
+					setIndex++;
+				fill(setIndex, i - setStarts[setIndex], &firstTerms[i], &secondTerms[i]);
+			}
+		});
+	}
+
+private:
+	std::vector<long>	fSetStarts;		// index of the first LE of each set
+	std::vector<float>	fFirstTerms;	// downStream or randCos
+	std::vector<float>	fSecondTerms;	// crossStream or randSin
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ *  VelocitySliceCache.cpp
+ *  gnome
+ *
+ */
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "VelocitySliceCache.h"
+#include "MemUtils.h"
+
+using namespace std;
+
+bool VelocitySliceKey::operator<(const VelocitySliceKey &other) const
+{
+	if (timeIndex != other.timeIndex) return timeIndex < other.timeIndex;
+	if (depth != other.depth) return depth < other.depth;
+	if (variable != other.variable) return variable < other.variable;
+	return path < other.path;
+}
+
+typedef struct {
+	VelocitySliceKey		key;
+	vector<VelocityFRec>		values;
+	float					fillValue;
+	double					scaleFactor;
+} CachedSlice;
+
+// most recently used slice at the front
+typedef list<CachedSlice> SliceList;
+
+static mutex sCacheMutex;
+static SliceList sSlices;
+static map<VelocitySliceKey, SliceList::iterator> sIndex;
+static size_t sSizeInBytes = 0;
+static size_t sBudgetInBytes = 0;
+static long sNumHits = 0, sNumMisses = 0, sNumEvictions = 0;
+
+static void EvictToBudget(size_t budgetInBytes)
+{
+	while (!sSlices.empty() && sSizeInBytes > budgetInBytes)
+	{
+		CachedSlice &oldest = sSlices.back();
+		sSizeInBytes -= oldest.values.size() * sizeof(VelocityFRec);
+		sIndex.erase(oldest.key);
+		sSlices.pop_back();
+		sNumEvictions++;
+	}
+}
+
+void VelocitySliceCache::SetBudget(double megabytes)
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	sBudgetInBytes = megabytes > 0 ? (size_t)(megabytes * 1024. * 1024.) : 0;
+	EvictToBudget(sBudgetInBytes);
+}
+
+double VelocitySliceCache::GetBudget()
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	return sBudgetInBytes / (1024. * 1024.);
+}
+
+Boolean VelocitySliceCache::Lookup(const VelocitySliceKey &key, VelocityFH *velocityH, float *fillValue, double *scaleFactor)
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	if (sBudgetInBytes == 0)
+		return false;
+
+	map<VelocitySliceKey, SliceList::iterator>::iterator found = sIndex.find(key);
+	if (found == sIndex.end())
+	{
+		sNumMisses++;
+		return false;
+	}
+
+	SliceList::iterator slice = found->second;
+	long numValues = slice->values.size();
+	VelocityFH h = (VelocityFH)_NewHandle(numValues * sizeof(VelocityFRec));
+	if (!h)
+		return false;
+	memcpy(*h, &slice->values[0], numValues * sizeof(VelocityFRec));
+
+	sSlices.splice(sSlices.begin(), sSlices, slice);
+	sNumHits++;
+	*velocityH = h;
+	*fillValue = slice->fillValue;
+	*scaleFactor = slice->scaleFactor;
+	return true;
+}
+
+void VelocitySliceCache::Insert(const VelocitySliceKey &key, VelocityFH velocityH, float fillValue, double scaleFactor)
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	if (sBudgetInBytes == 0 || !velocityH)
+		return;
+
+	long numValues = _GetHandleSize((Handle)velocityH) / sizeof(VelocityFRec);
+	size_t sizeInBytes = numValues * sizeof(VelocityFRec);
+	if (numValues <= 0 || sizeInBytes > sBudgetInBytes || sIndex.count(key))
+		return;
+
+	EvictToBudget(sBudgetInBytes - sizeInBytes);
+
+	sSlices.push_front(CachedSlice());
+	sSlices.front().key = key;
+	sSlices.front().values.assign(*velocityH, *velocityH + numValues);
+	sSlices.front().fillValue = fillValue;
+	sSlices.front().scaleFactor = scaleFactor;
+	sIndex[key] = sSlices.begin();
+	sSizeInBytes += sizeInBytes;
+}
+
+void VelocitySliceCache::Clear()
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	sSlices.clear();
+	sIndex.clear();
+	sSizeInBytes = 0;
+}
+
+void VelocitySliceCache::GetStats(VelocitySliceCacheStats *stats)
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	stats->numHits = sNumHits;
+	stats->numMisses = sNumMisses;
+	stats->numEvictions = sNumEvictions;
+	stats->numSlices = sSlices.size();
+	stats->sizeInMB = sSizeInBytes / (1024. * 1024.);
+	stats->budgetInMB = sBudgetInBytes / (1024. * 1024.);
+}
+
+void VelocitySliceCache::ResetStats()
+{
+	lock_guard<mutex> lock(sCacheMutex);
+
+	sNumHits = sNumMisses = sNumEvictions = 0;
+}
@@ -0,0 +1,54 @@
+/*
+ *  VelocitySliceCache.h
+ *  gnome
+ *
+ *  Process wide cache of decoded velocity time slices, so rewinds,
+ *  uncertainty runs and movers reading the same file share the decode.
+ *
+ */
+
+#ifndef __VelocitySliceCache__
+#define __VelocitySliceCache__
+
+#include <string>
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "ExportSymbols.h"
+
+typedef struct VelocitySliceKey {
+	std::string	path;		// file the slice was read from
+	std::string	variable;	// grid type and options that shape the decoded slice
+	long		timeIndex;	// index in the file
+	long		depth;		// depth levels in the slice, ReadTimeData reads them all at once
+
+	bool operator<(const VelocitySliceKey &other) const;
+} VelocitySliceKey;
+
+typedef struct {
+	long	numHits;
+	long	numMisses;
+	long	numEvictions;
+	long	numSlices;
+	double	sizeInMB;
+	double	budgetInMB;
+} VelocitySliceCacheStats;
+
+class DLL_API VelocitySliceCache {
+
+public:
+	// a budget of 0 turns the cache off and empties it
+	static void		SetBudget(double megabytes);
+	static double	GetBudget();
+
+	// on a hit, *velocityH is a new handle with a copy of the slice, and the
+	// fill value and scale factor are the ones ReadTimeData set with it
+	static Boolean	Lookup(const VelocitySliceKey &key, VelocityFH *velocityH, float *fillValue, double *scaleFactor);
+	static void		Insert(const VelocitySliceKey &key, VelocityFH velocityH, float fillValue, double scaleFactor);
+
+	static void		Clear();
+	static void		GetStats(VelocitySliceCacheStats *stats);
+	static void		ResetStats();
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "MemUtils.h"
 #include "GEOMETRY.H"
 #include "CompFunctions.h"
+#include "CounterRandom.h"
 //#include "OUTILS.H"
 
 #ifdef pyGNOME
@@ -45,9 +46,6 @@ void WindMover_c::Init()
 	fUncertainStartTime = 0;
 	fDuration = 3*3600; // 3 hours
 	
-	fWindUncertaintyList = 0;
-	fLESetSizes = 0;
-	
 	fSpeedScale = 2;
 	fAngleScale = .4;
 	fMaxSpeed = 30; //mps
@@ -85,10 +83,10 @@ void WindMover_c::Dispose()
 	Mover_c::Dispose ();
 }
 
-void rndv(float *rndv1,float *rndv2)
+static void rndv(CounterRandom &rng,float *rndv1,float *rndv2)
 {
-	float cosArg = 2 * PI * GetRandomFloat(0.0,1.0);
-	float srt = sqrt(-2 * log(GetRandomFloat(.001,.999)));
+	float cosArg = 2 * PI * (float)rng.Uniform(0.0,1.0);
+	float srt = sqrt(-2 * log((float)rng.Uniform(.001,.999)));
 	
 	*rndv1 = srt * cos(cosArg);
 	*rndv2 = srt * sin(cosArg);
@@ -114,86 +112,54 @@ void WindMover_c::DisposeUncertainty()
 {
 	fTimeUncertaintyWasSet = 0;
 	
-	if (fWindUncertaintyList)
-	{
-		DisposeHandle ((Handle) fWindUncertaintyList);
-		fWindUncertaintyList = nil;
-	}
-	
-	if (fLESetSizes)
-	{
-		DisposeHandle ((Handle) fLESetSizes);
-		fLESetSizes = 0;
-	}
+	fUncertainty.Dispose();
 }
 
 
 
-void WindMover_c::UpdateUncertaintyValues(Seconds elapsedTime)
+void WindMover_c::FillUncertaintyValues(Seconds elapsedTime, long first, long last)
 {
-	long i,j,n;
-	float cosTerm,sinTerm;
-	
-	fTimeUncertaintyWasSet = elapsedTime;
-	
-	if(!fWindUncertaintyList) return;
-	
-	n = _GetHandleSize((Handle)fWindUncertaintyList)/sizeof(LEWindUncertainRec);
-	
-	for(i=0;i<n;i++)
-	{
-		rndv(&cosTerm,&sinTerm);
-		for(j=0;j<10;j++)
+	fUncertainty.FillTerms(first, last, [&](long setIndex, long leIndex, float *randCos, float *randSin) {
+		// each uncertainty record draws from its own stream for this time
+		CounterRandom rng(fRandomSeed,GetRandomStream(kWindUncertaintyDraws),setIndex,leIndex,elapsedTime);
+		float cosTerm,sinTerm;
+		rndv(rng,&cosTerm,&sinTerm);
+		for(long j=0;j<10;j++)
 		{
 			if(TermsLessThanMax(cosTerm,sinTerm,
 								fMaxSpeed,fMaxAngle,fSigma2,fSigmaTheta))break;
-			rndv(&cosTerm,&sinTerm);
+			rndv(rng,&cosTerm,&sinTerm);
 		}
-		
-		(*fWindUncertaintyList)[i].randCos=cosTerm;
-		(*fWindUncertaintyList)[i].randSin = sinTerm;
-	}
+		*randCos = cosTerm;
+		*randSin = sinTerm;
+	});
+}
+
+void WindMover_c::UpdateUncertaintyValues(Seconds elapsedTime)
+{
+	fTimeUncertaintyWasSet = elapsedTime;
+	
+	if(!fUncertainty.IsAllocated()) return;
+	
+	this->FillUncertaintyValues(elapsedTime, 0, fUncertainty.GetNumLEs());
 }
 
 OSErr WindMover_c::ReallocateUncertainty(int numLEs, short* statusCodes)	// remove off map LEs
 {
-	long i,numrec=0,uncertListSize,numLESetsStored;
 	OSErr err=0;
 	
 	if (numLEs == 0 || ! statusCodes) return -1;	// shouldn't happen
 	
-	if(!fWindUncertaintyList || !fLESetSizes) return 0;	// assume uncertainty is not on
-	
-	// check that (*fLESetSizesH)[0]==numLEs and size of fLESetSizesH == 1
-	uncertListSize = _GetHandleSize((Handle)fWindUncertaintyList)/sizeof(LEWindUncertainRec);
-	numLESetsStored = _GetHandleSize((Handle)fLESetSizes)/sizeof(long);
+	if(!fUncertainty.IsAllocated()) return 0;	// assume uncertainty is not on
 	
-	if (uncertListSize != numLEs) return -1;
-	if (numLESetsStored != 1) return -1;
+	if (fUncertainty.GetNumLEs() != numLEs) return -1;
+	if (fUncertainty.GetNumLESets() != 1) return -1;
 	
-	for (i = 0; i < numLEs ; i++) {
-		if( statusCodes[i] == OILSTAT_TO_BE_REMOVED)	// for OFF_MAPS, EVAPORATED, etc
-		{
-			//continue;
-		}
-		else {
-			(*fWindUncertaintyList)[numrec] = (*fWindUncertaintyList)[i];
-			numrec++;
-		}
-	}
+	err = fUncertainty.RemoveLEs(numLEs, statusCodes);	// for OFF_MAPS, EVAPORATED, etc
+	if (err) return err;
 
-	if (numrec == 0)
-	{	
+	if (fUncertainty.GetNumLEs() == 0)
 		this->DisposeUncertainty();
-		return noErr;
-	}
-	
-	if (numrec < uncertListSize)
-	{
-		//(*fLESetSizes)[0] = numrec;
-		//(*fLESetSizes)[0] = 0;	// index into array, should never change
-		_SetHandleSize((Handle)fWindUncertaintyList,numrec*sizeof(LEWindUncertainRec)); 
-	}
 	
 	return noErr;
 }
@@ -201,34 +167,25 @@ OSErr WindMover_c::ReallocateUncertainty(int numLEs, short* statusCodes)	// remo
 
 OSErr WindMover_c::AllocateUncertainty(int numLESets, int* LESetsSizesList)	// only passing in uncertainty list information
 {
-	long i,j,numrec=0;
 	OSErr err=0;
 	
 	this->DisposeUncertainty(); // get rid of any old values
 		
 	if (numLESets == 0) return -1;	// shouldn't happen - if we get here there should be an uncertainty set
 	
-	if(!(fLESetSizes = (LONGH)_NewHandle(sizeof(long)*numLESets)))goto errHandler;
-	
-	for (i = 0,numrec=0; i < numLESets ; i++) {
-		(*fLESetSizes)[i]=numrec;	// this is really storing an index to the fWindUncertaintyList
-		numrec += LESetsSizesList[i];
+	if ((err = fUncertainty.Allocate(numLESets, LESetsSizesList)) != noErr)
+	{
+		this->DisposeUncertainty(); // get rid of any values allocated
+		TechError("TWindMover_c::AllocateUncertainty()", "Allocate()", 0);
 	}
-	if(!(fWindUncertaintyList = 
-		 (LEWindUncertainRecH)_NewHandle(sizeof(LEWindUncertainRec)*numrec)))goto errHandler;
-	
-	return noErr;
-errHandler:
-	this->DisposeUncertainty(); // get rid of any values allocated
-	TechError("TWindMover_c::AllocateUncertainty()", "_NewHandle()", 0);
-	return memFullErr;
+	return err;
 }
 
 
 OSErr WindMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESets, int* LESetsSizesList)
 {
 	OSErr err = noErr;
-	long i,j;
+	long i;
 	Boolean needToReInit = false, needToReAllocate = false;
 	//Boolean bAddUncertainty = (elapsedTime >= fUncertainStartTime) && model->IsUncertain();
 	Boolean bAddUncertainty = (elapsedTime >= fUncertainStartTime);
@@ -236,12 +193,12 @@ OSErr WindMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESets,
 	
 	if(!bAddUncertainty)
 	{	// we will not be adding uncertainty
-		// make sure fWindUncertaintyList  && fLESetSizes are unallocated
-		if(fWindUncertaintyList) this->DisposeUncertainty();
+		// make sure fUncertainty is unallocated
+		if(fUncertainty.IsAllocated()) this->DisposeUncertainty();
 		return 0;
 	}
 	
-	if(!fWindUncertaintyList || !fLESetSizes)
+	if(!fUncertainty.IsAllocated())
 		needToReInit = true;
 	
 	if(elapsedTime < fTimeUncertaintyWasSet) 
@@ -249,23 +206,23 @@ OSErr WindMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESets,
 		needToReInit = true;
 	}
 	
-	if(fLESetSizes)
+	if(fUncertainty.IsAllocated())
 	{	// check the LE sets are still the same, JLM 9/18/98
 		// code goes here, if LEs were added instead of needToReInit use needToReAllocate - save uncertainty if duration has not been exceeded
 		long numrec, uncertListSize = 0, numLESetsStored;
-		numLESetsStored = _GetHandleSize((Handle)fLESetSizes)/sizeof(long);
+		numLESetsStored = fUncertainty.GetNumLESets();
 		if(numLESets != numLESetsStored) needToReInit = true;
 		else
 		{
 			for (i = 0,numrec=0; i < numLESets ; i++) {
-				if(numrec != (*fLESetSizes)[i])
+				if(numrec != fUncertainty.GetSetStart(i))
 				{
 					needToReInit = true;
 					break;
 				}
 				numrec += LESetsSizesList[i];
 			}
-			uncertListSize = _GetHandleSize((Handle)fWindUncertaintyList)/sizeof(LEWindUncertainRec); 
+			uncertListSize = fUncertainty.GetNumLEs(); 
 			if (numrec != uncertListSize)// this should not happen for gui gnome
 			{
 #ifdef pyGNOME
@@ -281,30 +238,17 @@ OSErr WindMover_c::UpdateUncertainty(const Seconds& elapsedTime, int numLESets,
 		}
 		
 		if (needToReAllocate)
-		{	// move to separate function, and probably should combine with 
-			char errmsg[256] = "";
-			float cosTerm,sinTerm;
-			_SetHandleSize((Handle)fWindUncertaintyList, numrec*sizeof(LEWindUncertainRec));
-			//sprintf(errmsg,"Num LEs to Allocate = %ld, previous Size = %ld\n",numrec,uncertListSize);
-			//printNote(errmsg);
-			//for pyGNOME there should only be one uncertainty spill so fLESetSizes has only 1 value which is zero and doesn't need to be updated.
+		{	// the LEs released since are added on the end, the others keep their values
+			//for pyGNOME there should only be one uncertainty spill so there is only 1 set, which starts at zero and doesn't need to be updated.
 			if (numLESets != 1 || numLESetsStored != 1) {printError("num uncertainty spills not equal 1\n"); return -1;}
 			if (needToReInit) printNote("Uncertainty arrays are being reset\n");	// this shouldn't happen
-			//if(elapsedTime >= fTimeUncertaintyWasSet + fDuration) // we exceeded the persistance, time to update - either update whole list or just add on
 			// but would also need to update fSigmas - maybe move this section lower
-			for(i=uncertListSize;i<numrec;i++)
+			if ((err = fUncertainty.Grow(numrec)) != noErr)
 			{
-				rndv(&cosTerm,&sinTerm);
-				for(j=0;j<10;j++)
-				{
-					if(TermsLessThanMax(cosTerm,sinTerm,
-										fMaxSpeed,fMaxAngle,fSigma2,fSigmaTheta))break;
-					rndv(&cosTerm,&sinTerm);
-				}
-				
-				(*fWindUncertaintyList)[i].randCos=cosTerm;
-				(*fWindUncertaintyList)[i].randSin = sinTerm;
+				TechError("TWindMover_c::UpdateUncertainty()", "Grow()", 0);
+				return err;
 			}
+			this->FillUncertaintyValues(elapsedTime, uncertListSize, numrec);
 		}
 	}
 	
@@ -337,7 +281,7 @@ OSErr WindMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *patVe
 	float rand1,rand2, eddyDiffusion = 100000, value;
 	OSErr err = 0;
 	
-	if(!fWindUncertaintyList || !fLESetSizes) 
+	if(!fUncertainty.IsAllocated()) 
 		return 0; // this is our clue to not add uncertainty
 	
 	norm = sqrt(tempV.v*tempV.v + tempV.u*tempV.u);
@@ -352,7 +296,7 @@ OSErr WindMover_c::AddUncertainty(long setIndex, long leIndex,VelocityRec *patVe
 		return 0;
 	}
 	
-	unrec=(*fWindUncertaintyList)[(*fLESetSizes)[setIndex]+leIndex];
+	unrec=fUncertainty.GetWindRec(setIndex,leIndex);
 	w=norm;
 	s = w*w-fSigma2;
 	
@@ -495,29 +439,33 @@ OSErr WindMover_c::get_move(int n, Seconds model_time, Seconds step_len, WorldPo
 		return 2;
 	}
 
-	LERec* prec;
-	LERec rec;
-	prec = &rec;
+	LEBlock les(n, ref, LE_status);
+	les.SetWindages(windages);
+	return GetMoves(les, model_time, step_len, delta, spillType, spill_ID);
+}
+
+OSErr WindMover_c::GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID)
+{
+	long n = les.GetNumLEs();
 
 	WorldPoint3D zero_delta ={0,0,0.};
 
+	// the uncertainty draws random numbers in LE order, so only forecast LEs are split across threads
+	Boolean inParallel = fNumThreads > 1 && CanMoveLEsInParallel(spillType);
+
+	#pragma omp parallel for num_threads(fNumThreads) if(inParallel)
 	for (int i = 0; i < n; i++) {
+		LERec rec;
 
 		// only operate on LE if the status is in water
-		if( LE_status[i] != OILSTAT_INWATER)
+		if( !les.IsInWater(i))
 		{
 			delta[i] = zero_delta;
 			continue;
 		}
-		rec.p = ref[i].p;
-		rec.z = ref[i].z;
-		rec.windage = windages[i];	// define the windage for the current LE
-
-		// let's do the multiply by 1000000 here - this is what gnome expects
-		rec.p.pLat *= 1000000;	// really only need this for the latitude
-		//rec.p.pLong*= 1000000;
-
-		delta[i] = GetMove(model_time, step_len, spill_ID, i, prec, spillType);
+		les.GetLE(i, &rec);
+		
+		delta[i] = GetMove(model_time, step_len, spill_ID, les.GetSpillIndex(i), &rec, spillType);
 		
 		delta[i].p.pLat /= 1000000;
 		delta[i].p.pLong /= 1000000;
@@ -616,3 +564,29 @@ WindMover_c::~WindMover_c()
 {
 	 Dispose ();
 }
+
+// the member shares the wind's time series, which in pyGNOME belongs to the
+// python side rather than to the mover; the wind is looked up once a step in
+// PrepareForModelStep, when the members are prepared one after another
+Mover_c *WindMover_c::NewEnsembleMember(unsigned long randomSeed)
+{
+	WindMover_c *member = 0;
+	
+#ifndef pyGNOME
+	if (timeDep) return 0;	// the mover disposes of its time series
+#endif
+	try
+	{
+		member = new WindMover_c(*this);
+	}
+	catch (...)
+	{
+		return 0;
+	}
+	
+	member->DisposeUncertainty();
+	member->fRandomSeed = randomSeed;
+	member->bIsFirstStep = true;
+	
+	return member;
+}
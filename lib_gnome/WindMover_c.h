@@ -13,6 +13,7 @@
 #include "Basics.h"
 #include "TypeDefs.h"
 #include "Mover_c.h"
+#include "UncertaintyArrays.h"
 #include "ExportSymbols.h"
 
 #ifdef pyGNOME
@@ -26,8 +27,7 @@ class TMap;
 class DLL_API WindMover_c : virtual public Mover_c {
 	
 protected:
-	LONGH				fLESetSizes;		// cumulative total num le's in each set
-	LEWindUncertainRecH	fWindUncertaintyList;
+	UncertaintyArrays	fUncertainty;		// randCos and randSin of each LE, by LE set
 	void				Init();	// initializes local variables to defaults - called by constructor
 	
 public:
@@ -68,8 +68,11 @@ public:
 	virtual OSErr		AllocateUncertainty (int numLESets, int* LESetsSizesList);
 	virtual OSErr		ReallocateUncertainty(int numLEs, short* statusCodes);	
 	virtual void		DisposeUncertainty ();
+	virtual Mover_c		*NewEnsembleMember(unsigned long randomSeed);
+	virtual const UncertaintyArrays *GetUncertainty() const { return fUncertainty.IsAllocated() ? &fUncertainty : 0; }
 	virtual OSErr		AddUncertainty(long setIndex,long leIndex,VelocityRec *v);
 	virtual void 		UpdateUncertaintyValues(Seconds elapsedTime);
+	void				FillUncertaintyValues(Seconds elapsedTime, long first, long last);
 	virtual OSErr		UpdateUncertainty(const Seconds& elapsedTime, int numLESets, int* LESetsSizesList);
 
 	virtual OSErr 		PrepareForModelRun(); 
@@ -84,6 +87,8 @@ public:
 	OSErr				GetTimeValue(const Seconds& current_time, VelocityRec *value);
 	OSErr				CheckStartTime(Seconds time);
 	OSErr				get_move(int n, Seconds model_time, Seconds step_len, WorldPoint3D* ref, WorldPoint3D* delta, double* windage, short* LE_status, LEType spillType, long spillID);
+	virtual OSErr		GetMoves(const LEBlock &les, Seconds model_time, Seconds step_len, WorldPoint3D *delta, LEType spillType, long spill_ID);
+	virtual Boolean		CanMoveLEsInParallel(LEType spillType) { return spillType == FORECAST_LE; }
 };
 
 #undef TOSSMTimeValue
@@ -0,0 +1,351 @@
+/*
+ *  YearDataStore.cpp
+ *  gnome
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "YearDataStore.h"
+
+#define kFirstScannedYear 1900	// range of "#YYYY" files looked for
+#define kLastScannedYear 2100
+#define kYearDataFileVersion 2
+
+// yeardata.bin is this header followed by one record per year from firstYear on,
+// in the byte order of the machine that wrote it (the version check fails otherwise)
+typedef struct {
+	char	magic[8];
+	int32_t	version;
+	int32_t	firstYear;
+	int32_t	numYears;
+	int32_t	numValues;
+	uint64_t	sourceStamp;	// of the text files the table was made from, see SourceStamp
+} YearDataFileHeader;
+
+typedef struct {
+	int32_t	numElements;	// pairs read from the text file, 0 if there was no file
+	int32_t	unused;
+	double	XODE[kNumYearDataValues];
+	double	VPU[kNumYearDataValues];
+} YearDataFileRecord;
+
+static const char kYearDataMagic[8] = {'G','N','Y','E','A','R','D','T'};
+
+// a hash of the year, size and modification time of each "#YYYY" file in the directory
+static uint64_t SourceStamp(const char *directoryPath)
+{
+	uint64_t stamp = 14695981039346656037ULL;	// FNV-1a
+	char filePathName[512];
+	struct stat fileStat;
+
+	for (int32_t year = kFirstScannedYear; year <= kLastScannedYear; year++)
+	{
+		if (snprintf(filePathName, sizeof(filePathName), "%s#%d", directoryPath, year) >= (int)sizeof(filePathName))
+			break;
+		if (stat(filePathName, &fileStat) != 0)
+			continue;
+
+		int64_t fields[3] = {year, (int64_t)fileStat.st_size, (int64_t)fileStat.st_mtime};
+		const unsigned char *bytes = (const unsigned char*)fields;
+		for (size_t i = 0; i < sizeof(fields); i++)
+		{
+			stamp ^= bytes[i];
+			stamp *= 1099511628211ULL;
+		}
+	}
+	return stamp;
+}
+
+struct YearDataStore::Table {
+	std::vector<YearDataFileRecord>	parsed;	// filled when read from the text files
+	const char	*mapped;				// or the whole mapped file
+	size_t		mappedSize;
+
+	Table() : mapped(0), mappedSize(0) {}
+	~Table()
+	{
+#ifdef _WIN32
+		delete [] mapped;
+#else
+		if (mapped) munmap((void*)mapped, mappedSize);
+#endif
+	}
+
+	const YearDataFileRecord *GetRecords()
+	{
+		if (mapped) return (const YearDataFileRecord*)(mapped + sizeof(YearDataFileHeader));
+		return parsed.empty() ? 0 : &parsed[0];
+	}
+};
+
+YearDataStore::YearDataStore()
+{
+	fFirstYear = 0;
+	fNumYears = 0;
+	fTable = new Table();
+	fYears = 0;
+}
+
+YearDataStore::~YearDataStore()
+{
+	delete [] fYears;
+	delete fTable;
+}
+
+YearDataStore *YearDataStore::Get(const char *directoryPath, char *errStr)
+{
+	static std::mutex storesMutex;
+	static std::map<std::string, YearDataStore*> stores;
+
+	std::lock_guard<std::mutex> lock(storesMutex);
+	std::map<std::string, YearDataStore*>::iterator found = stores.find(directoryPath);
+	char filePath[512];
+	YearDataStore *store;
+	uint64_t sourceStamp;
+
+	if (found != stores.end())
+		return found->second;
+
+	try
+	{
+		store = new YearDataStore();
+	}
+	catch (...)
+	{
+		strcpy(errStr, "Memory error in YearDataStore");
+		return 0;
+	}
+
+	sourceStamp = SourceStamp(directoryPath);
+	// too long a path just parses the text files each time
+	if (snprintf(filePath, sizeof(filePath), "%s%s", directoryPath, kYearDataFileName) >= (int)sizeof(filePath)
+		|| store->MapBinaryFile(filePath, sourceStamp) != noErr)
+	{
+		if (store->ReadTextFiles(directoryPath, errStr) != noErr)
+		{
+			delete store;
+			return 0;
+		}
+		// so the next process can map it, if the directory is read only it just parses again
+		if (store->fNumYears > 0)
+			store->WriteTable(directoryPath, sourceStamp, errStr);
+		errStr[0] = 0;
+	}
+	store->SetYears();
+
+	stores[directoryPath] = store;
+	return store;
+}
+
+Boolean YearDataStore::HasYear(short year)
+{
+	return fYears && year >= fFirstYear && year < fFirstYear + fNumYears && fYears[year - fFirstYear].numElements > 0;
+}
+
+Boolean YearDataStore::HasYears(short firstYear, short lastYear)
+{
+	for (short year = firstYear; year <= lastYear; year++)
+	{
+		if (!HasYear(year)) return false;
+	}
+	return true;
+}
+
+Boolean YearDataStore::IsMapped()
+{
+	return fTable->mapped != 0;
+}
+
+const YEARDATA2 *YearDataStore::GetYearData(short year)
+{
+	if (!HasYear(year)) return 0;
+	return &fYears[year - fFirstYear];
+}
+
+OSErr YearDataStore::MapBinaryFile(const char *filePath, unsigned long long sourceStamp)
+{
+	YearDataFileHeader header;
+	size_t fileSize;
+	char *data = 0;
+
+#ifdef _WIN32
+	FILE *stream = fopen(filePath, "rb");
+
+	if (!stream) return -1;
+	fseek(stream, 0, SEEK_END);
+	fileSize = ftell(stream);
+	fseek(stream, 0, SEEK_SET);
+	if (fileSize < sizeof(header)) {fclose(stream); return -1;}
+	try
+	{
+		data = new char[fileSize];
+	}
+	catch (...)
+	{
+		fclose(stream);
+		return -1;
+	}
+	if (fread(data, 1, fileSize, stream) != fileSize) {fclose(stream); delete [] data; return -1;}
+	fclose(stream);
+#else
+	struct stat fileStat;
+	int fd = open(filePath, O_RDONLY);
+
+	if (fd < 0) return -1;
+	if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(header)) {close(fd); return -1;}
+	fileSize = fileStat.st_size;
+	data = (char*)mmap(0, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);	// the mapping keeps the file open
+	if (data == (char*)MAP_FAILED) return -1;
+#endif
+
+	fTable->mapped = data;
+	fTable->mappedSize = fileSize;
+
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, kYearDataMagic, sizeof(header.magic)) != 0
+		|| header.version != kYearDataFileVersion
+		|| header.numValues != kNumYearDataValues
+		|| header.numYears <= 0
+		|| header.sourceStamp != sourceStamp
+		|| fileSize != sizeof(header) + header.numYears * sizeof(YearDataFileRecord))
+	{
+		delete fTable;	// frees the data
+		fTable = new Table();
+		return -1;
+	}
+
+	fFirstYear = header.firstYear;
+	fNumYears = header.numYears;
+	return noErr;
+}
+
+OSErr YearDataStore::ReadTextFiles(const char *directoryPath, char *errStr)
+{
+	// NOTE: we only collect the first 128 data points (BUG if any more ever get added)
+	YearDataFileRecord record;
+	char filePathName[512];
+	FILE *stream;
+	double data1, data2;
+	short year, cnt, firstYear = 0, lastYear = 0;
+
+	try
+	{
+		for (year = kFirstScannedYear; year <= kLastScannedYear; year++)
+		{
+			if (snprintf(filePathName, sizeof(filePathName), "%s#%d", directoryPath, year) >= (int)sizeof(filePathName))
+				break;
+			stream = fopen(filePathName, "r");
+			if (!stream) continue;
+
+			memset(&record, 0, sizeof(record));
+			for (cnt = 0; cnt < kNumYearDataValues; cnt++)
+			{
+				if (fscanf(stream, "%lf %lf", &data1, &data2) != 2)	// the rest stay zero
+					break;
+				record.numElements++;
+				record.XODE[cnt] = data1;
+				record.VPU[cnt] = data2;
+			}
+			fclose(stream);
+
+			if (fTable->parsed.empty())
+				firstYear = year;
+			else	// a year with no file in between is left empty
+				fTable->parsed.resize(year - firstYear);
+			fTable->parsed.push_back(record);
+			lastYear = year;
+		}
+	}
+	catch (...)
+	{
+		strcpy(errStr, "Memory error in YearDataStore");
+		fTable->parsed.clear();
+		return -1;
+	}
+
+	fFirstYear = firstYear;
+	fNumYears = fTable->parsed.empty() ? 0 : lastYear - firstYear + 1;
+	return noErr;
+}
+
+void YearDataStore::SetYears()
+{
+	const YearDataFileRecord *records = fTable->GetRecords();
+
+	fYears = fNumYears > 0 ? new YEARDATA2[fNumYears] : 0;
+	for (long i = 0; i < fNumYears; i++)
+	{
+		fYears[i].numElements = records[i].numElements;
+		fYears[i].XODE = (double*)records[i].XODE;	// read only, YEARDATA2 just has no const
+		fYears[i].VPU = (double*)records[i].VPU;
+	}
+}
+
+OSErr YearDataStore::WriteTable(const char *directoryPath, unsigned long long sourceStamp, char *errStr)
+{
+	YearDataFileHeader header;
+	char filePath[512], tempPath[512];
+	FILE *stream;
+	OSErr err = noErr;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kYearDataMagic, sizeof(header.magic));
+	header.version = kYearDataFileVersion;
+	header.firstYear = fFirstYear;
+	header.numYears = fNumYears;
+	header.numValues = kNumYearDataValues;
+	header.sourceStamp = sourceStamp;
+
+	// written under a name of our own and renamed, so no process ever maps half a file
+	if (snprintf(filePath, sizeof(filePath), "%s%s", directoryPath, kYearDataFileName) >= (int)sizeof(filePath)
+		|| snprintf(tempPath, sizeof(tempPath), "%s.%ld", filePath, (long)getpid()) >= (int)sizeof(tempPath))
+	{
+		strcpy(errStr, "Path of the year data file is too long");
+		return -1;
+	}
+	stream = fopen(tempPath, "wb");
+	if (!stream)
+	{
+		sprintf(errStr, "Could not create file '%.200s'", tempPath);
+		return -1;
+	}
+	if (fwrite(&header, sizeof(header), 1, stream) != 1
+		|| fwrite(&fTable->parsed[0], sizeof(YearDataFileRecord), fNumYears, stream) != (size_t)fNumYears)
+		err = -1;
+	if (fclose(stream) != 0)
+		err = -1;
+#ifdef _WIN32
+	// rename won't replace a file there; the store reads the file rather than
+	// mapping it, so a stale one can go
+	if (!err)
+		remove(filePath);
+#endif
+	if (!err && rename(tempPath, filePath) != 0)
+		err = -1;
+	if (err)
+	{
+		remove(tempPath);
+		sprintf(errStr, "Could not write file '%.200s'", filePath);
+	}
+	return err;
+}
@@ -0,0 +1,57 @@
+/*
+ *  YearDataStore.h
+ *  gnome
+ *
+ *  All the Shio year data (the XODE amplitude and VPU epoch corrections)
+ *  of a yeardata directory in one packed table. The first process to use a
+ *  directory parses the "#YYYY" text files and leaves a yeardata.bin next
+ *  to them; after that the table is mapped straight from that file.
+ *  The table keeps a stamp of the text files' sizes and times, and one that
+ *  no longer matches them is parsed again and rewritten.
+ *  A store never changes once loaded, so any number of threads can read it.
+ *
+ */
+
+#ifndef __YearDataStore__
+#define __YearDataStore__
+
+#include "Basics.h"
+#include "TypeDefs.h"
+#include "Shio.h"
+#include "ExportSymbols.h"
+
+#define kNumYearDataValues 128	// XODE/VPU pairs in each year's file
+#define kYearDataFileName "yeardata.bin"
+
+class DLL_API YearDataStore {
+
+public:
+	// the store for a directory, loaded on first use and kept for the life of the process
+	static YearDataStore	*Get(const char *directoryPath, char *errStr);
+
+	short		GetFirstYear() {return fFirstYear;}
+	short		GetLastYear() {return fFirstYear + fNumYears - 1;}
+	Boolean		HasYear(short year);
+	Boolean		HasYears(short firstYear, short lastYear);	// every year of a request that spans years
+	Boolean		IsMapped();	// from yeardata.bin rather than the text files
+
+	// points into the store, the caller must not free it; 0 if there is no data for the year
+	const YEARDATA2	*GetYearData(short year);
+
+private:
+	struct Table;
+
+	short		fFirstYear, fNumYears;
+	Table		*fTable;
+	YEARDATA2	*fYears;
+
+	YearDataStore();
+	~YearDataStore();
+
+	OSErr		MapBinaryFile(const char *filePath, unsigned long long sourceStamp);
+	OSErr		ReadTextFiles(const char *directoryPath, char *errStr);
+	OSErr		WriteTable(const char *directoryPath, unsigned long long sourceStamp, char *errStr);
+	void		SetYears();
+};
+
+#endif
@@ -1,5 +1,7 @@
 #ifndef __BUILDLIST__
 #define __BUILDLIST__
+#include <stdint.h>
+#include <vector>
 //#include "DagTri.h"
 //#include "DagStruct.h"
 #include "DagTree.h"
@@ -52,62 +54,48 @@ Boolean maketriangles2(TopologyHdl *topoHdl, LongPointHdl ptsH, long nv, LONGH b
 //																								//
 //////////////////////////////////////////////////////////////////////////
 
+// a side with its end points, as it is passed down the branches of the tree
+typedef struct DagTreeSide
+{
+	long			p1, p2;
+	double			x1, y1, x2, y2;		// the points, scaled as in LatLongTransform
+	long			sideNum;			// in the full side list
+} DagTreeSide;
 
-//////////////////////////////////////////////////////////////////////////
-//																								//
-//  Increment the DagTree length in memory as we write dag					//
-//																								//
-//////////////////////////////////////////////////////////////////////////
-void IncrementGDagTree(void);
-
-//////////////////////////////////////////////////////////////////////////
-// 																							//
-// Here we pick a node to split another branch of the DAG tree				//
-//		Select the new node randomly among the list of sides.					//
-//		(Picking a non boundary side first will make the DAG tree flatter)//
-// 																							//
-//////////////////////////////////////////////////////////////////////////
-long newNodexx(Side_List **sides_node);
-
-//////////////////////////////////////////////////////////////////////////
-// 																		//
-// Here we find the original node number from the side list				//
-// 																		//
-//////////////////////////////////////////////////////////////////////////
-long oldNodeNum(long pt1, long pt2);
-
-//////////////////////////////////////////////////////////////////////////
-// 																							//
-// Here we split the segments into the DAG tree									//
-// 																							//
-//////////////////////////////////////////////////////////////////////////
-void split(Side_List **sideListH, long nodeNum);
+// The numbers rand() gives with the GNU C library. The trees have always been
+// built from them, and having our own keeps other users of rand() out of it.
+class DagTreeRandom
+{
+	public:
+		DagTreeRandom(unsigned int seed);
+		long		Next();
+	private:
+		int32_t		fState[34];		// the last 34 values
+		long		fIndex;
+};
 
-/////////////////////////////////////////////////////////////////////////////////////////
-// 																												//
-// Right_or_Left decides if a segement is to the right or left									//
-//		of a reference segment, or is neither.															//
-//																													//
-//	Given: ref_seg_pt1, ref_seg_pt2, test_seg_pt1, test_seg_pt2									//
-//	Return:																										//
-//			location																								//
-//				+1 = Right means the entire segment is to the right of the reference			//
-//				0  = Neither.  The segment is either along a line created by extending		//
-//							the reference segment infinitly OR the segment intersects a 		//
-//							line created by extending the reference segment infinitely			//
-//				-1 = Left means the entire segment is to the left of the reference			//
-//			NOTE: A Segment that has only one point on the line created by extending		//
-//							the reference segment infinitely will be determined as right		//
-//							or left, not both																	//
-// 																												//
-/////////////////////////////////////////////////////////////////////////////////////////
-int	Right_or_Left(long ref_p1,long ref_p2, long test_seg_p1, long test_seg_p2);
+// Builds the tree for one side list. The builder has all the state, so trees
+// for different grids can be built at once. The nodes are picked in the same
+// order as always, so the tree is too; the tests for a node are what run in
+// parallel.
+class DagTreeBuilder
+{
+	public:
+		DagTreeBuilder(Side_List **sidesList, LongPointHdl pointList);
+		OSErr		Build(DAGTreeStruct *dagTree, char *errStr);
+	private:
+		Side_List	**fSidesList;
+		LongPointHdl	fPointList;
+		long		fNumSides;
+		DagTreeRandom	fRandom;
+		
+		long		PickNode(const std::vector<DagTreeSide> &sides);
+};
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 int SideListCompare(void const *x1, void const *x2);
-int NodeTestCompare(void const *x1, void const *x2);
 #ifdef __cplusplus
 }
 #endif
@@ -78,5 +78,16 @@ from TypeDefs.h:
 ts_format = enum(magnitude_direction=M19MAGNITUDEDIRECTION,
                    uv=M19REALREAL)
 
+"""
+How a gridded current blends its two loaded time slices for a step:
+  per_le - each LE lookup blends the values it reads
+  tiles  - the blended values are kept for the step, a tile of the grid
+           is blended the first time an LE lands in it
+  grid   - the whole grid is blended once for the step
+"""
+velocity_blend = enum(per_le=BLEND_PER_LE,
+                      tiles=BLEND_TILES,
+                      grid=BLEND_GRID)
+
 cdef Seconds temp
 seconds = type(temp)
@@ -133,6 +133,18 @@ cdef class CyCatsMover(cy_mover.CyMover):
         def __set__(self, value):
             self.cats.fEddyV0 = value
 
+    property walk_from_last_triangle:
+        """
+        if True (default), triangle lookups start from the triangle each LE
+        was in on the last step and walk to its neighbors, only searching
+        the whole grid when the walk fails
+        """
+        def __get__(self):
+            return self.cats.bUseLastTriangle
+
+        def __set__(self, value):
+            self.cats.bUseLastTriangle = value
+
     property ref_point:
         def __get__(self):
             """
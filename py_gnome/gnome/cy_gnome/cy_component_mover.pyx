@@ -141,6 +141,42 @@ cdef class CyComponentMover(cy_mover.CyMover):
         def __set__(self,value):
             self.component.pat2ScaleToValue = value    
     
+    property use_averaged_winds:
+        def __get__(self):
+            return self.component.bUseAveragedWinds
+
+        def __set__(self,value):
+            self.component.bUseAveragedWinds = value
+
+    property extrapolate_winds:
+        def __get__(self):
+            return self.component.bExtrapolateWinds
+
+        def __set__(self,value):
+            self.component.bExtrapolateWinds = value
+
+    property past_hours_to_average:
+        def __get__(self):
+            return self.component.fPastHoursToAverage
+
+        def __set__(self,value):
+            self.component.fPastHoursToAverage = value
+
+    property averaged_wind_component:
+        def __get__(self):
+            """
+            the averaged wind along pattern 1 the last step was prepared
+            with, after the power factor
+            """
+            return self.component.fAveragedWindVelocity.u
+
+    property power_factor_averaged_winds:
+        def __get__(self):
+            return self.component.fPowerFactorAveragedWinds
+
+        def __set__(self,value):
+            self.component.fPowerFactorAveragedWinds = value
+
     property ref_point:
         def __get__(self):
             """
@@ -0,0 +1,169 @@
+"""
+cython wrapper around lib_gnome's ElementStore -- a run's element data
+arrays appended to one file, and any step's arrays mapped from it in place
+"""
+
+import os
+
+import cython
+
+cimport numpy as cnp
+import numpy as np
+from libcpp.vector cimport vector
+
+from type_defs cimport OSErr
+from utils cimport ElementStore, StoredArray
+from gnome.cy_gnome.cy_helpers cimport to_bytes
+
+
+cdef class CyElementStore:
+    """
+    save_step appends a step's arrays to the file, load_step maps the step's
+    block of the file and returns the arrays over it. Loading doesn't read
+    or copy the data, nor look at any other step.
+
+    The arrays are mapped copy-on-write: they can be changed, but the
+    changes aren't seen by the file or other loads of the step.
+
+    Only arrays of plain numeric dtypes are stored.
+    """
+    cdef ElementStore *store
+
+    def __cinit__(self):
+        self.store = new ElementStore()
+
+    def __dealloc__(self):
+        del self.store
+
+    def create(self, filename):
+        """
+        Creates the store's file, truncating one already there
+        """
+        cdef bytes path = to_bytes(unicode(os.path.normpath(filename)))
+
+        if self.store.Create(path) != 0:
+            raise IOError('could not create {0}'.format(filename))
+
+    def open(self, filename, read_only=True):
+        """
+        Opens a store made by create, with the steps saved in it, from the
+        index the file keeps. It is opened to load steps from, or to save
+        more to if read_only is False.
+        """
+        cdef bytes path = to_bytes(unicode(os.path.normpath(filename)))
+
+        if self.store.Open(path, bool(read_only)) != 0:
+            raise IOError('could not open {0} as an element store'
+                          .format(filename))
+
+    def close(self):
+        """
+        Closes the file and forgets the steps in it. Arrays already loaded
+        stay mapped.
+        """
+        self.store.Close()
+
+    property is_open:
+        def __get__(self):
+            return bool(self.store.IsOpen())
+
+    property filename:
+        def __get__(self):
+            return self.store.GetPath()
+
+    property file_size:
+        def __get__(self):
+            return self.store.GetFileSize()
+
+    def save_step(self, long step_num, uncertain, data_arrays,
+                  time_stamp=None):
+        """
+        Appends a step's arrays, replacing the step if it was saved before
+
+        :param data_arrays: dict of the step's arrays by name
+        :param time_stamp: a float the step is saved with, or None
+        """
+        cdef OSErr err
+        cdef bytes name, type_code
+        cdef cnp.ndarray arr
+        cdef vector[long] shape
+        cdef long *shape_ptr
+        cdef int d
+
+        for key, val in data_arrays.items():
+            if val.dtype.hasobject or val.dtype.fields is not None:
+                raise TypeError('{0} is not of a numeric dtype'.format(key))
+
+        err = self.store.BeginStep(step_num, bool(uncertain),
+                                   time_stamp is not None,
+                                   0. if time_stamp is None else time_stamp)
+        if err != 0:
+            raise IOError('could not add step {0} to {1}'
+                          .format(step_num, self.filename))
+
+        for key, val in data_arrays.items():
+            arr = np.ascontiguousarray(val)
+            name = to_bytes(unicode(key))
+            type_code = arr.dtype.str
+
+            shape.clear()
+            for d in range(arr.ndim):
+                shape.push_back(arr.shape[d])
+            shape_ptr = &shape[0] if arr.ndim > 0 else NULL
+
+            err = self.store.AddArray(name, type_code, arr.ndim, shape_ptr,
+                                      arr.data, arr.nbytes)
+            if err != 0:
+                raise IOError('could not write {0} of step {1} to {2}'
+                              .format(key, step_num, self.filename))
+
+        if self.store.EndStep() != 0:
+            raise IOError('could not write step {0} to {1}'
+                          .format(step_num, self.filename))
+
+    def has_step(self, long step_num, uncertain=False):
+        return bool(self.store.HasStep(step_num, bool(uncertain)))
+
+    def time_stamp(self, long step_num, uncertain=False):
+        """
+        The float the step was saved with, None if it had none
+        """
+        cdef double time_stamp
+
+        if self.store.GetTimeStamp(step_num, bool(uncertain), &time_stamp):
+            return time_stamp
+        return None
+
+    def load_step(self, long step_num, uncertain=False):
+        """
+        The step's arrays, mapped from the file
+
+        :returns: dict of the arrays by name, None if the step isn't saved
+        """
+        cdef long long block_offset, block_bytes
+        cdef const StoredArray *stored
+        cdef long i
+
+        if self.store.GetStepBlock(step_num, bool(uncertain), &block_offset,
+                                   &block_bytes) != 0:
+            return None
+
+        block = None
+        if block_bytes > 0:
+            block = np.memmap(self.filename, dtype=np.uint8, mode='c',
+                              offset=block_offset, shape=(block_bytes, ))
+
+        data_arrays = {}
+        for i in range(self.store.GetNumArrays(step_num, bool(uncertain))):
+            stored = self.store.GetArray(step_num, bool(uncertain), i)
+            dtype = np.dtype(stored.typeCode)
+            shape = tuple(stored.shape)
+
+            if stored.numBytes == 0:
+                arr = np.empty(shape, dtype=dtype)
+            else:
+                arr = np.ndarray(shape, dtype=dtype, buffer=block,
+                                 offset=stored.offset - block_offset)
+            data_arrays[stored.name] = arr
+
+        return data_arrays
@@ -0,0 +1,154 @@
+"""
+cython wrapper around lib_gnome's EnsembleRunner -- many members of an
+ensemble moved a step at a time, sharing the movers' grids
+"""
+
+import cython
+
+cimport numpy as cnp
+import numpy as np
+
+from movers cimport EnsembleRunner, EnsembleRunner_GetMoverSeed
+from type_defs cimport WorldPoint3D, LEType, OSErr
+from cy_mover cimport CyMover
+
+
+cdef class CyEnsembleRunner:
+    """
+    Each member gets its own copy of the movers added to the runner, with
+    its own random draws and uncertainty. The copies share the gridded
+    movers' grids and loaded time slices, so a member costs its elements
+    rather than another copy of the grids.
+
+    Only the movers that can share are allowed: the gridded current and
+    wind movers, the wind mover and the random mover. add_member raises a
+    ValueError for the others (the CATS and component movers among them,
+    as they own their grids and tide series). The runner isn't used by
+    gnome.Model; it is driven directly, as in the unit tests.
+
+    The runner holds on to the cython movers added to it, and to the
+    arrays each member's elements are in.
+    """
+    cdef EnsembleRunner *runner
+    cdef readonly list movers
+    cdef list elements
+
+    def __cinit__(self):
+        self.runner = new EnsembleRunner()
+        self.movers = []
+        self.elements = []
+
+    def __dealloc__(self):
+        del self.runner
+
+    def add_mover(self, CyMover mover):
+        if self.elements:
+            raise ValueError('movers must be added before the first member')
+        self.runner.AddMover(mover.mover)
+        self.movers.append(mover)
+
+    def add_member(self, unsigned long random_seed):
+        """
+        adds a member whose movers draw from streams seeded by random_seed
+        and their place in the runner (see mover_seed)
+
+        :returns: the index of the new member
+        """
+        member = self.runner.AddMember(random_seed)
+        if member < 0:
+            raise ValueError('each mover must be a gridded current, gridded '
+                             'wind, wind or random mover, with its data '
+                             'loaded')
+        self.elements.append(None)
+        return member
+
+    @staticmethod
+    def mover_seed(unsigned long random_seed, long mover_index):
+        """
+        The seed a member added with random_seed gives its copy of the
+        mover_index'th mover. Each mover of a member gets a different one.
+        """
+        return EnsembleRunner_GetMoverSeed(random_seed, mover_index)
+
+    def __len__(self):
+        return self.runner.GetNumMembers()
+
+    def set_member_elements(self,
+                            member,
+                            cnp.ndarray[WorldPoint3D, ndim=1] ref_points,
+                            cnp.ndarray[WorldPoint3D, ndim=1] next_positions,
+                            cnp.ndarray[short] LE_status,
+                            cnp.ndarray[cnp.npy_double] windages=None,
+                            cnp.ndarray[cnp.npy_double] rise_velocities=None):
+        """
+        The elements the member moves on the next steps. The moves are
+        added to next_positions in place, as CyMoverChain.get_move does.
+        """
+        cdef OSErr err
+        cdef double *windages_ptr = NULL
+        cdef double *rise_velocities_ptr = NULL
+        cdef WorldPoint3D *ref_ptr = NULL
+        cdef WorldPoint3D *next_ptr = NULL
+        cdef short *status_ptr = NULL
+        N = len(ref_points)
+
+        if member < 0 or member >= len(self):
+            raise IndexError('no member {0}'.format(member))
+        if len(next_positions) != N or len(LE_status) != N:
+            raise ValueError('ref_points, next_positions and LE_status must '
+                             'be the same length')
+        if windages is not None:
+            if len(windages) != N:
+                raise ValueError('windages must be the same length as '
+                                 'ref_points')
+            if N > 0:
+                windages_ptr = &windages[0]
+        if rise_velocities is not None:
+            if len(rise_velocities) != N:
+                raise ValueError('rise_velocities must be the same length as '
+                                 'ref_points')
+            if N > 0:
+                rise_velocities_ptr = &rise_velocities[0]
+        if N > 0:
+            ref_ptr = &ref_points[0]
+            next_ptr = &next_positions[0]
+            status_ptr = &LE_status[0]
+
+        err = self.runner.SetMemberLEs(member, N, ref_ptr, next_ptr,
+                                       status_ptr, windages_ptr,
+                                       rise_velocities_ptr)
+        if err != 0:
+            raise ValueError('SetMemberLEs returned an error: {0}'
+                             .format(err))
+
+        self.elements[member] = (ref_points, next_positions, LE_status,
+                                 windages, rise_velocities)
+
+    def prepare_for_model_run(self):
+        cdef OSErr err
+
+        err = self.runner.PrepareForModelRun()
+        if err != 0:
+            raise OSError('PrepareForModelRun returned an error: {0}'
+                          .format(err))
+
+    def step(self, model_time, step_len, LEType spill_type):
+        """
+        Adds every member's moves over the step to its next_positions
+
+        :param model_time: current model time
+        :param step_len: step length over which the moves are computed
+        :param spill_type: LEType defining whether the members' elements are
+                           forecast or uncertain
+        """
+        cdef OSErr err
+
+        err = self.runner.Step(model_time, step_len, spill_type)
+        if err == 2:
+            raise ValueError("The value for spill type can only be "
+                             "'forecast' or 'uncertainty' - you've chosen: "
+                             + str(spill_type))
+
+        if err != 0:
+            raise OSError('EnsembleRunner.Step returned an error: {0}'
+                          .format(err))
@@ -2,11 +2,63 @@ cimport numpy as cnp
 import numpy as np
 import os
 
+from libc.string cimport memcpy
+
 from type_defs cimport *
-from movers cimport GridMap_c
+from movers cimport GridMap_c, Topology, TopologyHdl, DAG, DAGTreeStruct, MakeDagTree
+from utils cimport _NewHandle, _DisposeHandleReally
 from gnome.cy_gnome.cy_helpers cimport to_bytes
 #cimport cy_mover
 
+
+def make_dag_tree(points, triangles):
+    """
+    Builds the DAG tree of a triangulation the way a grid does when it's
+    read, to test the builder
+
+    :param points: (n, 2) array of the vertices, longitude and latitude in
+                   millionths of a degree
+    :param triangles: (m, 6) array of each triangle's three vertices, then
+                      the triangle opposite each vertex, -1 for none
+    :returns: (k, 3) array of the branches: triangle, left and right
+    """
+    cdef cnp.ndarray[long, ndim=2, mode='c'] pts
+    cdef cnp.ndarray[long, ndim=2, mode='c'] tris
+    cdef cnp.ndarray[long, ndim=2, mode='c'] tree
+    cdef LongPoint **ptsH = NULL
+    cdef TopologyHdl topoH = NULL
+    cdef DAGTreeStruct dag
+    cdef char errmsg[256]
+
+    pts = np.ascontiguousarray(points, dtype=np.int_).reshape((-1, 2))
+    tris = np.ascontiguousarray(triangles, dtype=np.int_).reshape((-1, 6))
+    if len(pts) == 0 or len(tris) == 0:
+        raise ValueError('make_dag_tree needs points and triangles')
+
+    errmsg[0] = 0
+    ptsH = <LongPoint **>_NewHandle(pts.nbytes)
+    topoH = <TopologyHdl>_NewHandle(tris.nbytes)
+    if ptsH == NULL or topoH == NULL:
+        if ptsH != NULL:
+            _DisposeHandleReally(<Handle>ptsH)
+        if topoH != NULL:
+            _DisposeHandleReally(<Handle>topoH)
+        raise MemoryError()
+    memcpy(ptsH[0], pts.data, pts.nbytes)
+    memcpy(topoH[0], tris.data, tris.nbytes)
+
+    dag = MakeDagTree(topoH, ptsH, errmsg)
+    _DisposeHandleReally(<Handle>ptsH)
+    _DisposeHandleReally(<Handle>topoH)
+    if dag.treeHdl == NULL:
+        raise ValueError('MakeDagTree failed: {0}'.format(errmsg))
+
+    tree = np.empty((dag.numBranches, 3), dtype=np.int_)
+    memcpy(tree.data, dag.treeHdl[0], dag.numBranches * sizeof(DAG))
+    _DisposeHandleReally(<Handle>dag.treeHdl)
+
+    return tree
+
 cdef class CyGridMap:
 
     cdef GridMap_c *map
@@ -172,6 +172,129 @@ cdef class CyGridCurrentMover(cy_mover.CyMover):
         def __set__(self, value):
             self.grid_current.SetTimeShift(value)
         
+    property prefetch_next_slice:
+        """
+        if True, the time slice after the current interval is read on a
+        background thread, so moving into the next interval does not wait
+        on the file
+        """
+        def __get__(self):
+            return self.grid_current.timeGrid.GetPrefetchNextSlice()
+        
+        def __set__(self, value):
+            self.grid_current.timeGrid.SetPrefetchNextSlice(value)
+        
+    def get_prefetch_counts(self):
+        """
+        returns (hits, misses, stalls) for the background slice reads:
+        slices that were already read when needed, slices read in the
+        foreground, and hits that still had to wait for the read to finish
+        """
+        cdef long hits, misses, stalls
+        self.grid_current.timeGrid.GetPrefetchCounts(&hits, &misses, &stalls)
+        return (hits, misses, stalls)
+        
+    property num_grid_owners:
+        """
+        the number of movers sharing this mover's time grid: 1 for the
+        mover alone, plus one for each ensemble member's copy of it
+        """
+        def __get__(self):
+            if self.grid_current.timeGrid == NULL:
+                return 0
+            return self.grid_current.timeGrid.GetNumOwners()
+        
+    property use_point_index:
+        """
+        if True, triangle grids locate points with a bucket grid built over
+        the triangles instead of walking the DAG tree. Has no effect on
+        grids without triangles.
+        """
+        def __get__(self):
+            return self.grid_current.timeGrid.GetUsePointIndex()
+        
+        def __set__(self, value):
+            self.grid_current.timeGrid.SetUsePointIndex(value)
+        
+    def locate_triangles(self,
+                         cnp.ndarray[WorldPoint3D, ndim=1] points,
+                         use_dag_tree=False):
+        """
+        returns the triangle each point is in, negative if it is outside
+        the grid. Uses the DAG tree if use_dag_tree is True, otherwise
+        whatever use_point_index selects.
+        """
+        cdef OSErr err
+        cdef cnp.ndarray[long, ndim=1] tri_indices
+
+        tri_indices = np.empty((len(points), ), dtype=np.long)
+        if len(points) == 0:
+            return tri_indices
+
+        err = self.grid_current.timeGrid.LocateTriangles(len(points),
+                                                         &points[0],
+                                                         &tri_indices[0],
+                                                         use_dag_tree)
+        if err:
+            raise ValueError('the grid has no triangles')
+
+        return tri_indices
+        
+    property batched_get_move:
+        """
+        if True (default), get_move looks up the velocities for all the LEs
+        in one call to the time grid instead of calling GetMove per LE
+        """
+        def __get__(self):
+            return self.grid_current.bUseBatchedGetMove
+        
+        def __set__(self, value):
+            self.grid_current.bUseBatchedGetMove = value
+        
+    property walk_from_last_triangle:
+        """
+        if True (default), triangle lookups in the batched get_move start
+        from the triangle each LE was in on the last step and walk to its
+        neighbors, only searching the whole grid when the walk fails
+        """
+        def __get__(self):
+            return self.grid_current.bUseLastTriangle
+        
+        def __set__(self, value):
+            self.grid_current.bUseLastTriangle = value
+        
+
+    property velocity_blend_mode:
+        """
+        how the two loaded time slices are blended for a step, one of the
+        basic_types.velocity_blend values. Defaults to tiles.
+        """
+        def __get__(self):
+            return self.grid_current.timeGrid.GetVelocityBlendMode()
+        
+        def __set__(self, value):
+            self.grid_current.timeGrid.SetVelocityBlendMode(value)
+        
+    property max_blended_values_per_le:
+        """
+        when the loaded slices hold more values than this for each LE moved,
+        the step falls back to blending per LE lookup
+        """
+        def __get__(self):
+            return self.grid_current.timeGrid.GetMaxBlendedValuesPerLE()
+        
+        def __set__(self, value):
+            self.grid_current.timeGrid.SetMaxBlendedValuesPerLE(value)
+        
+    def get_blended_tile_counts(self):
+        """
+        returns (tiles, tiles blended) for the blended velocities of the
+        last step, (0, 0) if no step has used them
+        """
+        cdef long num_tiles, num_blended
+        self.grid_current.timeGrid.GetBlendedTileCounts(&num_tiles, &num_blended)
+        return (num_tiles, num_blended)
+        
 
     def extrapolate_in_time(self, extrapolate):
         self.grid_current.SetExtrapolationInTime(extrapolate)
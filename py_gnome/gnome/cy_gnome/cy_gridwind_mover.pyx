@@ -129,6 +129,28 @@ cdef class CyGridWindMover(cy_mover.CyMover):
         def __set__(self, value):
             self.grid_wind.SetTimeShift(value)
         
+    property prefetch_next_slice:
+        """
+        if True, the time slice after the current interval is read on a
+        background thread, so moving into the next interval does not wait
+        on the file
+        """
+        def __get__(self):
+            return self.grid_wind.timeGrid.GetPrefetchNextSlice()
+        
+        def __set__(self, value):
+            self.grid_wind.timeGrid.SetPrefetchNextSlice(value)
+        
+    def get_prefetch_counts(self):
+        """
+        returns (hits, misses, stalls) for the background slice reads:
+        slices that were already read when needed, slices read in the
+        foreground, and hits that still had to wait for the read to finish
+        """
+        cdef long hits, misses, stalls
+        self.grid_wind.timeGrid.GetPrefetchCounts(&hits, &misses, &stalls)
+        return (hits, misses, stalls)
+        
     def extrapolate_in_time(self, extrapolate):
         self.grid_wind.SetExtrapolationInTime(extrapolate)
 
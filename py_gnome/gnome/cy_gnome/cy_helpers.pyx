@@ -1,11 +1,12 @@
 from libc cimport stdlib
 import locale
+import os
 
 cimport numpy as cnp
 import numpy as np
 
 from gnome import basic_types
-from type_defs cimport Seconds, DateTimeRec
+from type_defs cimport Seconds, DateTimeRec, Handle
 cimport utils
 
 cdef class CyDateTime:
@@ -50,6 +51,132 @@ def rand():
     return stdlib.rand()
 
 
+def set_slice_cache_budget(double megabytes):
+    """
+    Sets the memory budget, in MB, of the cache of decoded velocity slices
+    shared by all gridded current movers. 0 turns the cache off.
+    """
+    utils.VelocitySliceCache.SetBudget(megabytes)
+
+
+def get_slice_cache_budget():
+    return utils.VelocitySliceCache.GetBudget()
+
+
+def get_slice_cache_stats():
+    """
+    Returns a dict with the hits, misses, evictions, number of slices and
+    size in MB of the velocity slice cache
+    """
+    cdef utils.VelocitySliceCacheStats stats
+
+    utils.VelocitySliceCache.GetStats(&stats)
+
+    return {'hits': stats.numHits,
+            'misses': stats.numMisses,
+            'evictions': stats.numEvictions,
+            'slices': stats.numSlices,
+            'size_mb': stats.sizeInMB,
+            'budget_mb': stats.budgetInMB}
+
+
+def clear_slice_cache(reset_stats=True):
+    """
+    Empties the velocity slice cache, the budget is kept
+    """
+    utils.VelocitySliceCache.Clear()
+    if reset_stats:
+        utils.VelocitySliceCache.ResetStats()
+
+
+def set_topology_cache_dir(cache_dir=None):
+    """
+    Sets the directory the triangulations of curvilinear grids are cached
+    in. None puts each next to its grid file (the default).
+    """
+    cdef bytes path = b''
+
+    if cache_dir is not None:
+        path = to_bytes(unicode(os.path.normpath(cache_dir)))
+    utils.TopologyCache.SetCacheDir(path)
+
+
+def get_topology_cache_dir():
+    """
+    The directory set by set_topology_cache_dir, None if there is none
+    """
+    cache_dir = utils.TopologyCache.GetCacheDir()
+
+    return cache_dir if cache_dir else None
+
+
+def set_topology_cache_enabled(enabled):
+    """
+    Turns the cache of curvilinear grid triangulations on (default) or off.
+    Off, every grid is triangulated as it is read and nothing is written.
+    """
+    utils.TopologyCache.SetEnabled(enabled)
+
+
+def get_topology_cache_enabled():
+    return bool(utils.TopologyCache.IsEnabled())
+
+
+def set_handle_pool_enabled(enabled):
+    """
+    Turns the pooled allocator behind lib_gnome's handles on (default) or
+    off. Blocks already handed out keep working either way.
+    """
+    utils._SetHandlePoolEnabled(enabled)
+
+
+def get_handle_pool_enabled():
+    return bool(utils._GetHandlePoolEnabled())
+
+
+def trim_handle_pool():
+    """
+    Frees the pooled memory no handle is using any more
+    """
+    utils._TrimHandlePool()
+
+
+def get_handle_pool_stats():
+    """
+    Returns a dict with the allocation counters of lib_gnome's handle pool
+    and the bytes in use and held by it
+    """
+    cdef utils.HandlePoolStats stats
+
+    utils._GetHandlePoolStats(&stats)
+
+    return {'allocations': stats.numAllocations,
+            'frees': stats.numFrees,
+            'resizes': stats.numResizes,
+            'resizes_in_place': stats.numResizesInPlace,
+            'reused': stats.numReused,
+            'system_allocations': stats.numSystemAllocations,
+            'bytes_in_use': stats.bytesInUse,
+            'bytes_reserved': stats.bytesReserved}
+
+
+def reset_handle_pool_stats():
+    utils._ResetHandlePoolStats()
+
+
+def _churn_handles(long count, long size):
+    """
+    Makes, grows and disposes of count handles, for testing the pool
+    """
+    cdef Handle h
+    cdef long i
+
+    for i in range(count):
+        h = utils._NewHandle(size)
+        utils._SetHandleSize(h, size + i)
+        utils._DisposeHandleReally(h)
+
+
 cdef bytes to_bytes(unicode ucode):
     """
     Encode a string to its unicode type to default file system encoding for
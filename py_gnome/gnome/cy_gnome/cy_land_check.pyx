@@ -13,6 +13,8 @@ from libc.stdint cimport int16_t, int32_t, uint8_t, uint32_t
 from libcpp cimport bool
 
 cimport type_defs
+from type_defs cimport OSErr, WorldPoint, WorldPoint3D
+from utils cimport RasterLandCheck, RasterProjection, ShorelineIndex
 
 def overlap_grid(int32_t m, int32_t n, pt1, pt2):
     """
@@ -58,101 +60,6 @@ cdef int32_t c_overlap_grid(int32_t m,
         return 1
 
 
-@cython.boundscheck(False)
-cdef bool c_find_first_pixel( cnp.ndarray[uint8_t, ndim=2, mode="c"] grid,
-                             int32_t m,
-                             int32_t n,
-                             int32_t x0,
-                             int32_t y0,
-                             int32_t x1,
-                             int32_t y1,
-                             int32_t *prev_x,
-                             int32_t *prev_y,
-                             int32_t *hit_x,
-                             int32_t *hit_y,
-                             ):
-
-    cdef int32_t dx, dy, sx, sy, err, e2,
-    cdef int32_t pt1_x, pt1_y, pt2_x, pt2_y
-
-    # check if totally off the grid
-    if not c_overlap_grid(m, n, x0, y0, x1, y1):
-        return False
-
-    #pixels = []
-    #hit_point = previous_pt = None
-    #Set it up to march in the right direction depending on slope.
-
-    dx = abs(x1-x0)
-    dy = abs(y1-y0) 
-    if x0 < x1:
-        sx = 1
-    else:
-        sx = -1
-    if y0 < y1:
-        sy = 1
-    else:
-        sy = -1
-    err = dx-dy
-    # check the first point
-    if not (x0 < 0 or x0 >= m or y0 < 0 or y0 >= n):#  is the point off the grid? if so, it's not land!
-        ##fixme: we should never be starting on land! 
-        ## should this raise an Error instead ?
-        if grid[x0, y0] == 1: #we've hit "land"
-            prev_x[0] = x0
-            prev_y[0] = y0
-            hit_x[0] = x0
-            hit_y[0] = y0
-            return True
-            #return (x0, y0), (x0, y0)
-    
-    while True: #keep going till hit land or the final point
-        if x0 == x1 and y0 == y1:
-            break
-        prev_x[0] = x0
-        prev_y[0] = y0
-        # advance to next point
-        e2 = 2*err
-        if e2 > -dy:
-            err = err - dy
-            x0 = x0 + sx
-        if e2 <  dx:
-            err = err + dx
-            y0 = y0 + sy
-        # check for land hit
-
-        if x0 < 0 or x0 >= m or y0 < 0 or y0 >= n:# is the point off the grid? if so, it's not land!
-            ## fixme -- if we've moved off the grid for good, no need to keep going.
-            continue                             # note: a diagonal movement, off the grid wouldn't be a hit either
-        else:
-            if grid[x0, y0] == 1:
-                hit_x[0] = x0
-                hit_y[0] = y0
-                # return (*prev_x, *prev_y), (*hit_x, *hit_y)
-                return True
-            else:
-                if (e2 > -dy) and (e2 < dx): # there is a diagonal move -- test adjacent points also
-                    ## only call it a hit if BOTH adjacent points are land.
-                    pt1_x = x0
-                    pt1_y = y0-sy
-                    pt2_x = x0-sx
-                    pt2_y = y0
-                    try: # replace with real check???
-                        if ( (grid[pt1_x, pt1_y] == 1) and #is the y-adjacent point on land? 
-                             (grid[pt2_x, pt2_y] == 1)     #is the x-adjacent point on land?
-                            ): 
-                            hit_x[0] = pt1_x # we have to pick one -- this is arbitrary
-                            hit_y[0] = pt1_y # we have to pick one -- this is arbitrary
-                            #return (*prev_x, *prev_y), (*hit_x, *hit_y)
-                            return True
-                    except IndexError:
-                        pass
-
-    # if we get here, no hit
-    return False
-
-
-
 def find_first_pixel(grid, pt1, pt2):
     """
     This finds the first non-zero pixel that is is encountered when followoing
@@ -177,28 +84,18 @@ def find_first_pixel(grid, pt1, pt2):
     
     """
 
-    cdef int32_t m, n
-    m, n = grid.shape
-
-    cdef int32_t  prev_x, prev_y, hit_x, hit_y  
-
-    cdef int32_t x1 = pt1[0]
-    cdef int32_t y1 = pt1[1]
-    cdef int32_t x2 = pt2[0]
-    cdef int32_t y2 = pt2[1]
+    cdef cnp.ndarray[uint8_t, ndim=2, mode='c'] raster = \
+        np.ascontiguousarray(grid, dtype=np.uint8)
+    cdef RasterLandCheck *land_check = new RasterLandCheck(&raster[0, 0],
+                                                           raster.shape[0],
+                                                           raster.shape[1])
+    cdef long prev_x, prev_y, hit_x, hit_y
 
-    result = c_find_first_pixel(grid,
-                                m,
-                                n,
-                                x1,
-                                y1,
-                                x2,
-                                y2,
-                                &prev_x,
-                                &prev_y,
-                                &hit_x,
-                                &hit_y,
-                                )
+    try:
+        result = land_check.FindFirstPixel(pt1[0], pt1[1], pt2[0], pt2[1],
+                                           &prev_x, &prev_y, &hit_x, &hit_y)
+    finally:
+        del land_check
 
     if result:
         return (prev_x, prev_y), (hit_x, hit_y)
@@ -221,41 +118,281 @@ def check_land(cnp.ndarray[uint8_t, ndim=2, mode='c'] grid not None,
         NOTE: these are the integer versions -- having already have been projected to the raster coordinates
 
         """
-        cdef int32_t  prev_x, prev_y, hit_x, hit_y  
-        cdef uint32_t i, num_le
-        cdef int32_t m, n
-        cdef bool did_hit
-
-        num_le = positions.shape[0]
-        m = grid.shape[0]
-        n = grid.shape[1]
-
-        for i in range(num_le):
-            if status_codes[i] == type_defs.OILSTAT_ONLAND:
-                continue
-            
-            did_hit = c_find_first_pixel(grid,
-                                         m,
-                                         n,
-                                         positions[i, 0],
-                                         positions[i, 1],
-                                         end_positions[i, 0],
-                                         end_positions[i, 1],
-                                         &prev_x,
-                                         &prev_y,
-                                         &hit_x,
-                                         &hit_y,
-                                         )
-            if did_hit:
-                last_water_positions[i, 0] = prev_x
-                last_water_positions[i, 1] = prev_y
-                end_positions[i,0] = hit_x
-                end_positions[i,1] = hit_y
-                status_codes[i] = type_defs.OILSTAT_ONLAND
-            else:
-                # didn't hit land -- can move the LE
-                positions[i, 0] = end_positions[i, 0]
-                positions[i, 1] = end_positions[i, 1]
+        cdef long num_le = positions.shape[0]
+        cdef RasterLandCheck *land_check
+
+        if num_le == 0:
+            return None
+
+        land_check = new RasterLandCheck(&grid[0, 0], grid.shape[0],
+                                         grid.shape[1])
+        with nogil:
+            land_check.CheckLand(num_le, &positions[0, 0],
+                                 &end_positions[0, 0], &status_codes[0],
+                                 &last_water_positions[0, 0])
+        del land_check
+
         return None
 
 
+def _check_beach_arrays(positions, next_positions, status_codes,
+                        last_water_positions):
+    num_le = len(positions)
+    for a in (next_positions, last_water_positions):
+        if a.shape[0] != num_le:
+            raise ValueError('all position arrays must be the same length')
+    for a in (positions, next_positions, last_water_positions):
+        if a.shape[1] != 3:
+            raise ValueError('positions must be (long, lat, z)')
+    if status_codes.shape[0] != num_le:
+        raise ValueError('status_codes must have one value per LE')
+
+
+@cython.boundscheck(False)
+def beach_elements(cnp.ndarray[uint8_t, ndim=2, mode='c'] grid not None,
+                   projection not None,
+                   cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] positions not None,
+                   cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] next_positions not None,
+                   cnp.ndarray[int16_t, ndim=1, mode='c'] status_codes not None,
+                   cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] last_water_positions not None):
+        """
+        check_land for (long, lat, z) positions: the projection to pixels
+        and back is done in lib_gnome, one LE at a time, so no pixel arrays
+        are made.
+
+        projection must have the center, scale and offset of a
+        gnome.utilities.projections.GeoProjection.
+
+        status_codes, next_positions and last_water_positions are altered in
+        place: beached LEs end up in the middle of the land pixel they hit,
+        and their last water position in the middle of the pixel before it.
+        """
+        cdef long num_le = positions.shape[0]
+        cdef RasterProjection proj
+        cdef RasterLandCheck *land_check
+
+        _check_beach_arrays(positions, next_positions, status_codes,
+                            last_water_positions)
+        if num_le == 0:
+            return None
+
+        proj.centerLong, proj.centerLat = projection.center
+        proj.scaleX, proj.scaleY = projection.scale
+        proj.offsetX, proj.offsetY = projection.offset
+
+        land_check = new RasterLandCheck(&grid[0, 0], grid.shape[0],
+                                         grid.shape[1])
+        with nogil:
+            land_check.BeachElements(proj, num_le,
+                                     <WorldPoint3D *>&positions[0, 0],
+                                     <WorldPoint3D *>&next_positions[0, 0],
+                                     &status_codes[0],
+                                     <WorldPoint3D *>&last_water_positions[0, 0])
+        del land_check
+
+        return None
+
+
+cdef class CyRasterLandCheck:
+    """
+    The land check for one raster, kept with the coarse levels built for
+    it, so that moves in open water are checked a block at a time.
+
+    RasterMap makes one of these for its bitmap. The raster is not copied,
+    so changing it in place needs a new CyRasterLandCheck.
+    """
+    cdef RasterLandCheck *land_check
+    cdef readonly cnp.ndarray grid
+
+    def __cinit__(self, grid):
+        self.grid = np.ascontiguousarray(grid, dtype=np.uint8)
+        if self.grid.ndim != 2 or self.grid.size == 0:
+            raise ValueError('grid must be a non-empty 2-d array')
+
+        self.land_check = new RasterLandCheck(<uint8_t *>self.grid.data,
+                                              self.grid.shape[0],
+                                              self.grid.shape[1])
+        self.land_check.BuildLevels()
+
+    def __dealloc__(self):
+        del self.land_check
+
+    def __reduce__(self):
+        return (CyRasterLandCheck, (self.grid,))
+
+    property num_levels:
+        def __get__(self):
+            return self.land_check.GetNumLevels()
+
+    def find_first_pixel(self, pt1, pt2):
+        """
+        same as find_first_pixel() for this grid
+        """
+        cdef long prev_x, prev_y, hit_x, hit_y
+
+        if self.land_check.FindFirstPixel(pt1[0], pt1[1], pt2[0], pt2[1],
+                                          &prev_x, &prev_y, &hit_x, &hit_y):
+            return (prev_x, prev_y), (hit_x, hit_y)
+        else:
+            return None
+
+    @cython.boundscheck(False)
+    def check_land(self,
+                   cnp.ndarray[int32_t, ndim=2, mode='c'] positions not None,
+                   cnp.ndarray[int32_t, ndim=2, mode='c'] end_positions not None,
+                   cnp.ndarray[int16_t, ndim=1, mode='c'] status_codes not None,
+                   cnp.ndarray[int32_t, ndim=2, mode='c'] last_water_positions not None):
+        """
+        same as check_land() for this grid
+        """
+        cdef long num_le = positions.shape[0]
+
+        if num_le == 0:
+            return None
+
+        with nogil:
+            self.land_check.CheckLand(num_le, &positions[0, 0],
+                                      &end_positions[0, 0], &status_codes[0],
+                                      &last_water_positions[0, 0])
+        return None
+
+    @cython.boundscheck(False)
+    def beach_elements(self,
+                       projection not None,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] positions not None,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] next_positions not None,
+                       cnp.ndarray[int16_t, ndim=1, mode='c'] status_codes not None,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] last_water_positions not None):
+        """
+        same as beach_elements() for this grid
+        """
+        cdef long num_le = positions.shape[0]
+        cdef RasterProjection proj
+
+        _check_beach_arrays(positions, next_positions, status_codes,
+                            last_water_positions)
+        if num_le == 0:
+            return None
+
+        proj.centerLong, proj.centerLat = projection.center
+        proj.scaleX, proj.scaleY = projection.scale
+        proj.offsetX, proj.offsetY = projection.offset
+
+        with nogil:
+            self.land_check.BeachElements(proj, num_le,
+                                          <WorldPoint3D *>&positions[0, 0],
+                                          <WorldPoint3D *>&next_positions[0, 0],
+                                          &status_codes[0],
+                                          <WorldPoint3D *>&last_water_positions[0, 0])
+        return None
+
+
+cdef class CyShorelineIndex:
+    """
+    Land checks against the shoreline polygons themselves -- see
+    lib_gnome/ShorelineIndex.h
+
+    polygons is a sequence of (N, 2) arrays of (long, lat) points: the land
+    polygons and the lakes in them. Beached LEs end exactly on the
+    shoreline, and their last water position is just back from it along
+    the move.
+    """
+    cdef ShorelineIndex *index
+    cdef readonly list polygons
+
+    def __cinit__(self, polygons):
+        cdef OSErr err
+        cdef cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] points
+        cdef cnp.ndarray[long, ndim=1, mode='c'] num_points
+
+        self.polygons = [np.asarray(p, dtype=np.float64).reshape(-1, 2)
+                         for p in polygons]
+        self.index = new ShorelineIndex()
+
+        num_points = np.array([len(p) for p in self.polygons], dtype=np.long)
+        points = np.ascontiguousarray(np.vstack(self.polygons +
+                                                [np.zeros((0, 2))]))
+        if num_points.size == 0 or points.shape[0] == 0:
+            return
+
+        err = self.index.SetPolygons(<WorldPoint *>&points[0, 0],
+                                     &num_points[0], num_points.size)
+        if err != 0:
+            raise MemoryError('not enough memory to index the shoreline')
+
+    def __dealloc__(self):
+        del self.index
+
+    def __reduce__(self):
+        return (CyShorelineIndex, (self.polygons,))
+
+    property num_segments:
+        def __get__(self):
+            return self.index.GetNumSegments()
+
+    def find_first_crossing(self, pt1, pt2):
+        """
+        the first place the move from pt1 to pt2 crosses the shoreline
+
+        :param pt1: (long, lat) start of the move
+        :param pt2: (long, lat) end of the move
+
+        return: None if land is not hit
+                (last_water_pt, hit_pt) if land is hit
+        """
+        cdef WorldPoint start, end, last_water, hit
+
+        start.pLong, start.pLat = pt1[0], pt1[1]
+        end.pLong, end.pLat = pt2[0], pt2[1]
+
+        if self.index.FindFirstCrossing(start, end, &last_water, &hit):
+            return ((last_water.pLong, last_water.pLat), (hit.pLong, hit.pLat))
+        else:
+            return None
+
+    def on_land(self, points):
+        """
+        :param points: (long, lat) or (long, lat, z) point, or an Nx2 or Nx3
+                       array of them
+
+        return: bool array: True for the points on land
+        """
+        cdef cnp.ndarray[cnp.float64_t, ndim=2] pts
+        cdef WorldPoint pt
+        cdef Py_ssize_t i
+
+        points = np.asarray(points, dtype=np.float64)
+        pts = points.reshape(-1, points.shape[-1])
+        result = np.zeros((len(pts),), dtype=np.bool)
+
+        for i in range(len(pts)):
+            pt.pLong = pts[i, 0]
+            pt.pLat = pts[i, 1]
+            result[i] = self.index.IsOnLand(pt)
+
+        return result
+
+    @cython.boundscheck(False)
+    def beach_elements(self,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] positions not None,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] next_positions not None,
+                       cnp.ndarray[int16_t, ndim=1, mode='c'] status_codes not None,
+                       cnp.ndarray[cnp.float64_t, ndim=2, mode='c'] last_water_positions not None):
+        """
+        status_codes, next_positions and last_water_positions are altered in
+        place, as with beach_elements()
+        """
+        cdef long num_le = positions.shape[0]
+
+        _check_beach_arrays(positions, next_positions, status_codes,
+                            last_water_positions)
+        if num_le == 0:
+            return None
+
+        with nogil:
+            self.index.BeachElements(num_le,
+                                     <WorldPoint3D *>&positions[0, 0],
+                                     <WorldPoint3D *>&next_positions[0, 0],
+                                     &status_codes[0],
+                                     <WorldPoint3D *>&last_water_positions[0, 0])
+        return None
@@ -2,8 +2,10 @@
 from libc.stdint cimport int32_t
 
 cimport numpy as cnp
+import numpy as np
 
 from type_defs cimport OSErr, Seconds
+from movers cimport UncertaintyArrays
 
 from gnome import basic_types
 
@@ -44,6 +46,66 @@ cdef class CyMover(object):
 
         return info
 
+    property num_threads:
+        """
+        Number of threads the C++ get_move may split the LEs across.
+        1 (the default) runs serially; the results are the same either way.
+        Movers whose moves draw random numbers always run serially.
+        """
+        def __get__(self):
+            if self.mover:
+                return self.mover.GetNumThreads()
+            return 1
+
+        def __set__(self, value):
+            if self.mover:
+                self.mover.SetNumThreads(value)
+
+    property random_stream:
+        """
+        Keys the mover's random draws along with its seed. Movers of different
+        types draw apart; two movers of one type with the same seed need
+        different streams not to make the same draws. 0 by default.
+        """
+        def __get__(self):
+            if self.mover:
+                return self.mover.fRandomStream
+            return 0
+
+        def __set__(self, unsigned long value):
+            if self.mover:
+                self.mover.fRandomStream = value
+
+    property uncertainty_terms:
+        """
+        Copies of the per LE uncertainty factors of the current and wind
+        movers: (down_stream, cross_stream) or (rand_cos, rand_sin), as float32
+        arrays. None if the mover has none, or uncertainty isn't allocated.
+        """
+        def __get__(self):
+            cdef const UncertaintyArrays *uncertainty
+            cdef const float *first
+            cdef const float *second
+            cdef long num_les, i
+            cdef cnp.ndarray[cnp.float32_t] first_terms, second_terms
+
+            if not self.mover:
+                return None
+            uncertainty = self.mover.GetUncertainty()
+            if uncertainty == NULL:
+                return None
+
+            num_les = uncertainty.GetNumLEs()
+            first = uncertainty.GetFirstTerms()
+            second = uncertainty.GetSecondTerms()
+            first_terms = np.empty((num_les, ), dtype=np.float32)
+            second_terms = np.empty((num_les, ), dtype=np.float32)
+            for i in range(num_les):
+                first_terms[i] = first[i]
+                second_terms[i] = second[i]
+
+            return (first_terms, second_terms)
+
     def prepare_for_model_run(self):
         """
         default implementation. It calls the C++ objects's PrepareForModelRun() method
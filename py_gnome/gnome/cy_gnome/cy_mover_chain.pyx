@@ -0,0 +1,144 @@
+"""
+cython wrapper around lib_gnome's MoverChain -- the moves of several cython
+movers added into the next positions in one call
+"""
+
+import cython
+
+cimport numpy as cnp
+import numpy as np
+from libc.stdint cimport int32_t
+
+from movers cimport MoverChain
+from type_defs cimport WorldPoint3D, LEType, OSErr, Seconds
+from cy_mover cimport CyMover
+
+
+cdef class CyMoverChain:
+    """
+    The movers added to the chain move a block of LEs at a time, and their
+    moves are added to next_positions in the order they were added -- so
+    next_positions comes out the same as adding each mover's get_move delta
+    to it in turn, without the delta arrays.
+
+    The blocks after the first are split across threads when every mover
+    in the chain can move LEs in parallel, unless blocks_in_parallel is
+    turned off.
+
+    The chain holds on to the cython movers added to it.
+    """
+    cdef MoverChain *chain
+    cdef readonly list movers
+
+    def __cinit__(self):
+        self.chain = new MoverChain()
+        self.movers = []
+
+    def __dealloc__(self):
+        del self.chain
+
+    def add_mover(self, CyMover mover):
+        self.chain.AddMover(mover.mover)
+        self.movers.append(mover)
+
+    def clear(self):
+        self.chain.ClearMovers()
+        self.movers = []
+
+    def __len__(self):
+        return self.chain.GetNumMovers()
+
+    property blocks_in_parallel:
+        def __get__(self):
+            return bool(self.chain.GetBlocksInParallel())
+
+        def __set__(self, value):
+            self.chain.SetBlocksInParallel(bool(value))
+
+    def prepare_for_model_step(self, Seconds model_time, Seconds step_len,
+                               numSets=0,
+                               cnp.ndarray[int32_t] setSizes=None):
+        """
+        calls PrepareForModelStep on each of the movers -- see
+        CyMover.prepare_for_model_step
+        """
+        cdef OSErr err
+
+        if numSets == 0:
+            err = self.chain.PrepareForModelStep(model_time, step_len,
+                                                 False, 0, NULL)
+        else:
+            err = self.chain.PrepareForModelStep(model_time, step_len,
+                                                 True, numSets, &setSizes[0])
+        if err != 0:
+            raise OSError("PrepareForModelStep returned an error: {0}"
+                          .format(err))
+
+    def get_move(self,
+                 model_time,
+                 step_len,
+                 cnp.ndarray[WorldPoint3D, ndim=1] ref_points,
+                 cnp.ndarray[WorldPoint3D, ndim=1] next_positions,
+                 cnp.ndarray[cnp.npy_double] windages,
+                 cnp.ndarray[cnp.npy_double] rise_velocities,
+                 cnp.ndarray[short] LE_status,
+                 LEType spill_type):
+        """
+        Adds the move of every mover in the chain to next_positions
+
+        :param model_time: current model time
+        :param step_len: step length over which the moves are computed
+        :param ref_points: current locations of LE particles
+        :type ref_points: numpy array of WorldPoint3D
+        :param next_positions: the positions the moves are added to, in place
+        :type next_positions: numpy array of WorldPoint3D
+        :param windages: windage of each particle, or None if no mover in the
+                         chain needs it
+        :param rise_velocities: rise velocity of each particle, or None if no
+                                mover in the chain needs it
+        :param LE_status: status of each particle - movement is only on
+                          particles in water
+        :param spill_type: LEType defining whether spill is forecast
+                           or uncertain
+        """
+        cdef OSErr err
+        cdef double *windages_ptr = NULL
+        cdef double *rise_velocities_ptr = NULL
+        N = len(ref_points)
+
+        if N == 0:
+            return
+        if len(next_positions) != N or len(LE_status) != N:
+            raise ValueError('ref_points, next_positions and LE_status must '
+                             'be the same length')
+        if windages is not None:
+            if len(windages) != N:
+                raise ValueError('windages must be the same length as '
+                                 'ref_points')
+            windages_ptr = &windages[0]
+        if rise_velocities is not None:
+            if len(rise_velocities) != N:
+                raise ValueError('rise_velocities must be the same length as '
+                                 'ref_points')
+            rise_velocities_ptr = &rise_velocities[0]
+
+        err = self.chain.get_move(N, model_time, step_len,
+                                  &ref_points[0],
+                                  &next_positions[0],
+                                  windages_ptr,
+                                  rise_velocities_ptr,
+                                  &LE_status[0],
+                                  spill_type,
+                                  0)
+        if err == 1:
+            raise ValueError('Make sure numpy arrays for ref_points, '
+                             'next_positions and LE_status are defined')
+
+        if err == 2:
+            raise ValueError("The value for spill type can only be "
+                             "'forecast' or 'uncertainty' - you've chosen: "
+                             + str(spill_type))
+
+        if err != 0:
+            raise OSError('MoverChain.get_move returned an error: {0}'
+                          .format(err))
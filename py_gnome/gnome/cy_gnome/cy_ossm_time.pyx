@@ -191,26 +191,27 @@ cdef class CyOSSMTime(object):
                          it returns the values.
         """
         cdef cnp.ndarray[Seconds, ndim = 1] modelTimeArray
-        modelTimeArray = np.asarray(modelTime,
-                                    basic_types.seconds).reshape((-1,))
+        modelTimeArray = np.ascontiguousarray(modelTime,
+                                              basic_types.seconds).reshape((-1,))
 
         # velocity record passed to OSSMTimeValue_c methods and
         # returned back to python
         cdef cnp.ndarray[VelocityRec, ndim = 1] vel_rec
         cdef VelocityRec * velrec
 
-        cdef unsigned int i
         cdef OSErr err
 
         vel_rec = np.empty((modelTimeArray.size,),
                            dtype=basic_types.velocity_rec)
-
-        for i in range(0, modelTimeArray.size):
-            err = self.time_dep.GetTimeValue(modelTimeArray[i], &vel_rec[i])
-            if err != 0:
-                raise ValueError('Error invoking TimeValue_c.GetTimeValue '
-                                 'method in CyOSSMTime: '
-                                 'C++ OSERR = {0}'.format(err))
+        if modelTimeArray.size == 0:
+            return vel_rec
+
+        err = self.time_dep.GetTimeValues(&modelTimeArray[0],
+                                          modelTimeArray.size, &vel_rec[0])
+        if err != 0:
+            raise ValueError('Error invoking TimeValue_c.GetTimeValues '
+                             'method in CyOSSMTime: '
+                             'C++ OSERR = {0}'.format(err))
 
         return vel_rec
 
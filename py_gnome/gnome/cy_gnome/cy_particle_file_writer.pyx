@@ -0,0 +1,237 @@
+"""
+cython wrapper around lib_gnome's ParticleFileWriter -- a run's particles
+appended to a NetCDF-4 file a step at a time, with the compression and
+writes done on a background thread
+"""
+
+import os
+
+import cython
+
+cimport numpy as cnp
+import numpy as np
+from libcpp.vector cimport vector
+
+from utils cimport ParticleFileWriter, ParticleFileWriter_GetErrorMessage
+from gnome.cy_gnome.cy_helpers cimport to_bytes
+
+
+# netCDF external types by numpy (kind, itemsize)
+_nc_types = {('i', 1): 1,
+             ('i', 2): 3,
+             ('i', 4): 4,
+             ('f', 4): 5,
+             ('f', 8): 6,
+             ('u', 1): 7,
+             ('b', 1): 7,
+             ('u', 2): 8,
+             ('u', 4): 9,
+             ('i', 8): 10,
+             ('u', 8): 11,
+             }
+
+
+cdef class CyParticleFileWriter:
+    """
+    The file is laid out as NetCDFOutput has always written it: a contiguous
+    ragged array, with the steps' 'time' and 'particle_count' along the
+    'time' dimension and the particles' variables along 'data'.
+
+    append_step copies the step's arrays and returns before they are
+    written, so netCDF4 must not be used on the file -- or on any file, as
+    the library isn't thread safe -- until flush or close is called.
+    """
+    cdef ParticleFileWriter *writer
+    cdef readonly list variables
+    cdef list dtypes
+    cdef list num_components
+    cdef object __weakref__
+
+    def __cinit__(self):
+        self.writer = new ParticleFileWriter()
+        self.variables = []
+        self.dtypes = []
+        self.num_components = []
+
+    def __dealloc__(self):
+        del self.writer
+
+    def _check(self, int status, what):
+        if status != 0:
+            raise IOError('{0}: {1}'.format(what,
+                          ParticleFileWriter_GetErrorMessage(status)))
+
+    def create(self, filename, compress=True, chunksize=1024):
+        """
+        Creates the file, with its dimensions and the 'time' and
+        'particle_count' variables. Attributes and variables are added until
+        end_definitions is called.
+        """
+        cdef bytes path = to_bytes(unicode(os.path.normpath(filename)))
+
+        self._check(self.writer.Create(path, compress, chunksize),
+                    'creating {0}'.format(filename))
+        self._forget_variables()
+
+    def open_for_append(self, filename):
+        """
+        Opens a file an earlier writer left, to append steps after its last
+        one. The variables are named with use_variable.
+        """
+        cdef bytes path = to_bytes(unicode(os.path.normpath(filename)))
+
+        self._check(self.writer.OpenForAppend(path),
+                    'opening {0}'.format(filename))
+        self._forget_variables()
+
+    def _forget_variables(self):
+        self.variables = []
+        self.dtypes = []
+        self.num_components = []
+
+    def put_attributes(self, var_name, attributes):
+        """
+        Adds text attributes to a variable, or to the file if var_name is
+        None. Values that aren't strings are written as str(value).
+        """
+        cdef bytes name, value
+        cdef bytes var = None
+        cdef char *var_ptr = NULL
+
+        if var_name is not None:
+            var = to_bytes(unicode(var_name))
+            var_ptr = var
+
+        for key, val in attributes.items():
+            name = to_bytes(unicode(key))
+            value = to_bytes(unicode(val))
+            self._check(self.writer.PutAttribute(var_ptr, name, value),
+                        'adding attribute {0}'.format(key))
+
+    def _nc_type(self, dtype):
+        dtype = np.dtype(dtype)
+        try:
+            return _nc_types[(dtype.kind, dtype.itemsize)]
+        except KeyError:
+            raise TypeError('no netCDF type for {0}'.format(dtype))
+
+    def define_variable(self, name, dtype, num_components=1):
+        """
+        Adds a variable of num_components values of dtype per particle.
+
+        :returns: the index of its array in append_step's arrays
+        """
+        cdef int status = 0
+        cdef bytes var = to_bytes(unicode(name))
+        cdef long index
+
+        index = self.writer.DefineVariable(var, self._nc_type(dtype),
+                                           num_components, &status)
+        self._check(status, 'defining {0}'.format(name))
+        self._add_variable(name, dtype, num_components)
+        return index
+
+    def use_variable(self, name, dtype, num_components=1):
+        """
+        Names a variable already in a file opened for append, which must be
+        of the dtype and num_components given.
+
+        :returns: the index of its array in append_step's arrays
+        """
+        cdef int status = 0
+        cdef bytes var = to_bytes(unicode(name))
+        cdef long index
+
+        index = self.writer.UseVariable(var, self._nc_type(dtype),
+                                        num_components, &status)
+        self._check(status, 'using {0}'.format(name))
+        self._add_variable(name, dtype, num_components)
+        return index
+
+    def _add_variable(self, name, dtype, num_components):
+        self.variables.append(name)
+        self.dtypes.append(np.dtype(dtype))
+        self.num_components.append(num_components)
+
+    def end_definitions(self):
+        self._check(self.writer.EndDefinitions(), 'ending definitions')
+
+    def append_step(self, double time, arrays):
+        """
+        Queues a step to be written.
+
+        :param time: the step's value of the 'time' variable
+        :param arrays: an array per variable, in the order they were defined,
+                       all of the step's number of particles. A column of a
+                       larger array, such as positions[:, 0], is copied from
+                       in place.
+        """
+        cdef vector[char *] columns
+        cdef vector[long] strides
+        cdef char **columns_ptr = NULL
+        cdef long *strides_ptr = NULL
+        cdef cnp.ndarray arr
+        cdef long num_particles = 0
+
+        if len(arrays) != len(self.variables):
+            raise ValueError('an array is needed for each of the {0} '
+                             'variables'.format(len(self.variables)))
+
+        kept = []
+        for i, a in enumerate(arrays):
+            arr = np.asarray(a, dtype=self.dtypes[i])
+            if i == 0:
+                num_particles = len(arr)
+            elif len(arr) != num_particles:
+                raise ValueError('the arrays must all be the same length')
+
+            if arr.size != num_particles * self.num_components[i]:
+                raise ValueError('{0} has {1} values per particle'
+                                 .format(self.variables[i],
+                                         self.num_components[i]))
+
+            # a particle's values must be contiguous, the particles needn't be
+            if arr.ndim > 1 and not arr[:1].flags['C_CONTIGUOUS']:
+                arr = np.ascontiguousarray(arr)
+            kept.append(arr)
+
+            columns.push_back(arr.data)
+            strides.push_back(arr.strides[0])
+
+        if kept:
+            columns_ptr = &columns[0]
+            strides_ptr = &strides[0]
+
+        self._check(self.writer.AppendStep(time, num_particles, columns_ptr,
+                                           strides_ptr),
+                    'appending a step')
+
+    def flush(self):
+        """
+        waits for the queued steps to be written
+        """
+        self._check(self.writer.Flush(), 'writing')
+
+    def close(self):
+        """
+        Writes the queued steps and closes the file. An error writing them is
+        raised here if it hasn't been already.
+        """
+        self._forget_variables()
+        self._check(self.writer.Close(), 'closing')
+
+    property is_open:
+        def __get__(self):
+            return bool(self.writer.IsOpen())
+
+    property num_steps:
+        """
+        steps in the file once the queue is written, those of an earlier
+        writer included
+        """
+        def __get__(self):
+            return self.writer.GetNumSteps()
+
+    property num_particles:
+        def __get__(self):
+            return self.writer.GetNumParticles()
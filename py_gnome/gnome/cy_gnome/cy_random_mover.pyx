@@ -63,6 +63,18 @@ cdef class CyRandomMover(cy_mover.CyMover):
                                  'for uncertain_factor')
             self.rand.fUncertaintyFactor = value
 
+    property seed:
+        """
+        Key for the counter based random draws. With the same seed each LE
+        gets the same diffusion for a given spill, LE index and model time,
+        whatever the order or number of threads the LEs are moved in.
+        """
+        def __get__(self):
+            return self.rand.fRandomSeed
+
+        def __set__(self, value):
+            self.rand.fRandomSeed = value
+
     def __repr__(self):
         """
         unambiguous repr of object, reuse for str() method
@@ -10,11 +10,189 @@ from type_defs cimport *
 from utils cimport (ShioTimeValue_c,
                     EbbFloodData, EbbFloodDataH,
                     HighLowData, HighLowDataH,
+                    YEARDATA2, YearDataStore, YearDataStore_Get,
+                    CONSTITUENT, HarmonicSeries,
+                    RStatHeight, RStatCurrent,
+                    RStatCurrentRot, RStatCurrentRotFromSums,
                     _NewHandle, _GetHandleSize)
 
 from cy_helpers cimport to_bytes
 
 
+cdef YearDataStore *year_data_store(yeardata_path_) except NULL:
+    """
+    The store for a yeardata directory, as ShioTimeValue_c gets it
+    """
+    cdef bytes yeardata_path
+    cdef char errStr[256]
+    cdef YearDataStore *store
+
+    yeardata_path = to_bytes(unicode(os.path.normpath(yeardata_path_)))
+    yeardata_path += os.sep
+
+    errStr[0] = 0
+    store = YearDataStore_Get(yeardata_path, errStr)
+    if store == NULL:
+        raise IOError('could not read the year data in {0}: {1}'
+                      .format(yeardata_path_, errStr))
+    return store
+
+
+def year_data(yeardata_path, short year):
+    """
+    The Shio XODE and VPU corrections of a year, as a copy of the arrays the
+    yeardata directory's store has for it, or None if it has no data for
+    the year
+    """
+    cdef YearDataStore *store = year_data_store(yeardata_path)
+    cdef const YEARDATA2 *data = store.GetYearData(year)
+    cdef short i
+
+    if data == NULL:
+        return None
+
+    xode = np.empty((data.numElements,), dtype=np.float64)
+    vpu = np.empty((data.numElements,), dtype=np.float64)
+    for i in range(data.numElements):
+        xode[i] = data.XODE[i]
+        vpu[i] = data.VPU[i]
+
+    return (xode, vpu)
+
+
+def year_data_info(yeardata_path):
+    """
+    (first year, last year, whether the store was mapped from yeardata.bin)
+    of a yeardata directory
+    """
+    cdef YearDataStore *store = year_data_store(yeardata_path)
+
+    return (store.GetFirstYear(), store.GetLastYear(), bool(store.IsMapped()))
+
+
+def has_year_data(yeardata_path, short first_year, short last_year):
+    """
+    True if there is data for every year from first_year to last_year
+    """
+    cdef YearDataStore *store = year_data_store(yeardata_path)
+
+    return bool(store.HasYears(first_year, last_year))
+
+
+def harmonic_sums(amplitudes, epochs, short first_term, short num_terms,
+                  double start_hour, double step_hours, long num_times):
+    """
+    The sums of constituents first_term to first_term + num_terms, at
+    num_times evenly spaced hours, as the Shio height and current routines
+    sum them now, all at once
+    """
+    cdef cnp.ndarray[double, ndim=1] amp = np.ascontiguousarray(amplitudes,
+                                                                 np.float64)
+    cdef cnp.ndarray[double, ndim=1] epoch = np.ascontiguousarray(epochs,
+                                                                   np.float64)
+    cdef cnp.ndarray[double, ndim=1] sums = np.empty((num_times,),
+                                                     dtype=np.float64)
+    cdef HarmonicSeries *series
+
+    if first_term < 0 or first_term + num_terms > min(len(amp), len(epoch)):
+        raise ValueError('the terms are past the ends of the arrays')
+
+    series = new HarmonicSeries(&amp[0], &epoch[0], first_term, num_terms)
+    if num_times > 0:
+        series.EvaluateSeries(start_hour, step_hours, num_times, &sums[0])
+    del series
+
+    return sums
+
+
+cdef CONSTITUENT datum_constituent(datum_controls):
+    cdef CONSTITUENT constituent
+
+    constituent.DatumControls.datum = datum_controls.get('datum', 0.)
+    constituent.DatumControls.FDir = datum_controls.get('FDir', 0)
+    constituent.DatumControls.EDir = datum_controls.get('EDir', 180)
+    constituent.DatumControls.L2Flag = datum_controls.get('L2Flag', 0)
+    constituent.DatumControls.HFlag = datum_controls.get('HFlag', 0)
+    constituent.DatumControls.RotFlag = datum_controls.get('RotFlag', 0)
+    constituent.H = 0
+    constituent.kPrime = 0
+
+    return constituent
+
+
+def rstat_values(hours, amplitudes, epochs, short ncoeff, station_type,
+                 datum_controls=None, sums=None):
+    """
+    A station's values at each of hours, from the Shio routines that sum
+    the constituents one time at a time: RStatHeight for 'H', RStatCurrent
+    for 'C' and RStatCurrentRot for 'R', the rotary currents.
+
+    With sums, the rotary values come from RStatCurrentRotFromSums instead,
+    with the v then the u sums given, as the current routines get them from
+    harmonic_sums.
+
+    :returns: the values, and for rotary currents (values, u, v)
+    """
+    cdef cnp.ndarray[double, ndim=1] times = np.ascontiguousarray(hours,
+                                                                   np.float64)
+    cdef cnp.ndarray[double, ndim=1] amp = np.ascontiguousarray(amplitudes,
+                                                                 np.float64)
+    cdef cnp.ndarray[double, ndim=1] epoch = np.ascontiguousarray(epochs,
+                                                                   np.float64)
+    cdef cnp.ndarray[double, ndim=1] values = np.empty_like(times)
+    cdef cnp.ndarray[double, ndim=1] u_vel = np.zeros_like(times)
+    cdef cnp.ndarray[double, ndim=1] v_vel = np.zeros_like(times)
+    cdef cnp.ndarray[double, ndim=1] v_sums, u_sums
+    cdef CONSTITUENT constituent
+    cdef double two_ago = 999., last = 999., v_major, v_minor
+    cdef short direc_key
+    cdef long i
+
+    if datum_controls is None:
+        datum_controls = {}
+    constituent = datum_constituent(datum_controls)
+
+    if sums is not None:
+        v_sums = np.ascontiguousarray(sums[0], np.float64)
+        u_sums = np.ascontiguousarray(sums[1], np.float64)
+        if len(v_sums) < len(times) or len(u_sums) < len(times):
+            raise ValueError('fewer sums than hours')
+    elif len(amp) < max(ncoeff, 37) or len(epoch) < max(ncoeff, 37):
+        raise ValueError('fewer amplitudes or epochs than ncoeff')
+
+    for i in range(len(times)):
+        if station_type == 'H':
+            values[i] = RStatHeight(times[i], &amp[0], &epoch[0], ncoeff,
+                                    constituent.DatumControls.datum)
+        elif station_type == 'C':
+            values[i] = RStatCurrent(times[i], &amp[0], &epoch[0],
+                                     constituent.DatumControls.datum, ncoeff,
+                                     constituent.DatumControls.HFlag)
+        elif station_type == 'R':
+            # as GetRefCurrent keeps the last two values
+            if i > 0:
+                two_ago = last
+                last = values[i - 1]
+
+            if sums is not None:
+                values[i] = RStatCurrentRotFromSums(u_sums[i], v_sums[i],
+                                                    &constituent, two_ago,
+                                                    last, &u_vel[i],
+                                                    &v_vel[i], &v_major,
+                                                    &v_minor, &direc_key)
+            else:
+                values[i] = RStatCurrentRot(times[i], &amp[0], &epoch[0],
+                                            ncoeff, &constituent, two_ago,
+                                            last, &u_vel[i], &v_vel[i],
+                                            &v_major, &v_minor, &direc_key)
+        else:
+            raise ValueError('station_type is H, C or R')
+
+    if station_type == 'R':
+        return (values, u_vel, v_vel)
+    return values
+
+
 cdef class CyShioTime(object):
     """
     Cython wrapper around instantiating and using ShioTimeValue_c object
@@ -137,6 +315,25 @@ cdef class CyShioTime(object):
             sName = self.shio.fStationName
             return sName
 
+    property constituents:
+        def __get__(self):
+            """
+            (H, kPrime) of the station's constituents, as read from the file
+            """
+            cdef long num, i
+
+            if self.shio.fConstituent.H == NULL:
+                return (np.zeros((0,)), np.zeros((0,)))
+
+            num = _GetHandleSize(<Handle>self.shio.fConstituent.H) / sizeof(float)
+            h = np.empty((num,), dtype=np.float64)
+            k_prime = np.empty((num,), dtype=np.float64)
+            for i in range(num):
+                h[i] = self.shio.fConstituent.H[0][i]
+                k_prime[i] = self.shio.fConstituent.kPrime[0][i]
+
+            return (h, k_prime)
+
     property station_type:
         def __get__(self):
             """
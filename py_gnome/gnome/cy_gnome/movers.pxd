@@ -26,6 +26,24 @@ cdef extern from "TimeGridVel_c.h":
         void                 DisposeLoadedData(LoadedData * dataPtr)
         void                 ClearLoadedData(LoadedData * dataPtr)
         void                 DisposeAllLoadedData()
+        void                 SetPrefetchNextSlice(bool prefetch)
+        bool                 GetPrefetchNextSlice()
+        void                 GetPrefetchCounts(long *numHits, long *numMisses, long *numStalls)
+        void                 SetUsePointIndex(bool usePointIndex)
+        bool                 GetUsePointIndex()
+        OSErr                LocateTriangles(long n, WorldPoint3D *points, long *triIndices, bool useDagTree)
+        void                 SetVelocityBlendMode(short blendMode)
+        short                GetVelocityBlendMode()
+        void                 SetMaxBlendedValuesPerLE(double maxValuesPerLE)
+        double               GetMaxBlendedValuesPerLE()
+        void                 GetBlendedTileCounts(long *numTiles, long *numTilesBlended)
+        long                 GetNumOwners()
+
+cdef extern from "UncertaintyArrays.h":
+    cdef cppclass UncertaintyArrays:
+        long GetNumLEs()
+        const float *GetFirstTerms()
+        const float *GetSecondTerms()
     
 # TODO: pre-processor directive for cython, but what is its purpose?
 # comment for now so it doesn't give compile time errors - not sure LELIST_c is used anywhere either
@@ -50,6 +68,11 @@ cdef extern from "Mover_c.h":
                                   bool uncertain, int numLESets, int32_t *LESetsSizesList)    # currently this happens in C++ get_move command
         void ModelStepIsDone()
         OSErr ReallocateUncertainty(int numLEs, short* LE_status)
+        const UncertaintyArrays *GetUncertainty()
+        unsigned long fRandomSeed
+        unsigned long fRandomStream
+        void SetNumThreads(long numThreads)
+        long GetNumThreads()
 
 cdef extern from "CurrentMover_c.h":
     cdef cppclass CurrentMover_c(Mover_c):
@@ -117,6 +140,7 @@ cdef extern from "CATSMover_c.h":
         short           scaleType                 
         double          scaleValue
         Boolean         bTimeFileActive
+        Boolean         bUseLastTriangle
         WorldPoint      refP
         long            refZ
         #=======================================================================
@@ -168,6 +192,7 @@ cdef extern from "ComponentMover_c.h":
         double          fScaleFactorAveragedWinds
         double          fPowerFactorAveragedWinds
         long            fPastHoursToAverage
+        VelocityRec     fAveragedWindVelocity
 	
         int   TextRead(char* catsPath1, char* catsPath2)
         void  SetRefPosition (WorldPoint p)    
@@ -190,6 +215,8 @@ cdef extern from "GridCurrentMover_c.h":
         double fCurScale
         TimeGridVel_c    *timeGrid
         Boolean fIsOptimizedForStep
+        Boolean bUseBatchedGetMove
+        Boolean bUseLastTriangle
         Boolean fAllowVerticalExtrapolationOfCurrents
         
         GridCurrentMover_c ()
@@ -258,3 +285,46 @@ cdef extern from "GridMap_c.h":
         OSErr 		    SaveAsNetCDF(char *path)
         OSErr           TextRead(char *path)
         
+
+cdef extern from "DagTree.h":
+    ctypedef struct Topology:
+        long vertex1
+        long vertex2
+        long vertex3
+        long adjTri1
+        long adjTri2
+        long adjTri3
+    ctypedef Topology **TopologyHdl
+
+    ctypedef struct DAG:
+        long topoIndex
+        long branchLeft
+        long branchRight
+
+    ctypedef struct DAGTreeStruct:
+        long numBranches
+        DAG **treeHdl
+
+    DAGTreeStruct MakeDagTree(TopologyHdl topoHdl, LongPoint **pointList, char *errStr)
+
+cdef extern from "MoverChain.h":
+    cdef cppclass MoverChain:
+        void AddMover(Mover_c *mover)
+        void ClearMovers()
+        long GetNumMovers()
+        void SetBlocksInParallel(Boolean inParallel)
+        Boolean GetBlocksInParallel()
+        OSErr PrepareForModelStep(Seconds &time, Seconds &time_step,
+                                  bool uncertain, int numLESets, int32_t *LESetsSizesList)
+        OSErr get_move(int n, unsigned long model_time, unsigned long step_len, WorldPoint3D* ref, WorldPoint3D* next_positions, double* windages, double* rise_velocities, short* LE_status, LEType spillType, long spillID)
+
+cdef extern from "EnsembleRunner.h":
+    cdef cppclass EnsembleRunner:
+        void AddMover(Mover_c *mover)
+        long GetNumMovers()
+        long AddMember(unsigned long randomSeed)
+        long GetNumMembers()
+        OSErr SetMemberLEs(long member, long numLEs, WorldPoint3D* ref, WorldPoint3D* next_positions, short* LE_status, double* windages, double* rise_velocities)
+        OSErr PrepareForModelRun()
+        OSErr Step(unsigned long model_time, unsigned long step_len, LEType spillType)
+    unsigned long EnsembleRunner_GetMoverSeed "EnsembleRunner::GetMoverSeed" (unsigned long randomSeed, long moverIndex)
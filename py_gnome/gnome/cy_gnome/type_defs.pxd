@@ -45,6 +45,10 @@ cdef extern from "TypeDefs.h":
         double value
         double uncertaintyValue
 
+    ctypedef struct LongPoint:
+        long h
+        long v
+
     ctypedef struct LERec:
         long leUnits
         long leKey
@@ -119,6 +123,11 @@ cdef extern from "TypeDefs.h":
 #         REMOVE
 #         HAVE_REMOVED
 #         
+    ctypedef enum:
+        BLEND_PER_LE = 0
+        BLEND_TILES
+        BLEND_GRID
+
     ctypedef enum:
         M19REALREAL = 1
         M19HILITEDEFAULT    
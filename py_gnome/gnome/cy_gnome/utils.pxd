@@ -4,14 +4,32 @@ lib_gnome utils
 from type_defs cimport *    
 from libcpp cimport bool
 from libcpp.string cimport string
+from libcpp.vector cimport vector
+from libc.stdint cimport int32_t
 
 """
 MemUtils functions available from lib_gnome 
 """
 cdef extern from "MemUtils.h":
+    ctypedef struct HandlePoolStats:
+        long numAllocations
+        long numFrees
+        long numResizes
+        long numResizesInPlace
+        long numReused
+        long numSystemAllocations
+        double bytesInUse
+        double bytesReserved
+
     Handle _NewHandle(long )
     void _DisposeHandleReally(Handle)
     long _GetHandleSize(Handle)
+    void _SetHandleSize(Handle, long)
+    void _SetHandlePoolEnabled(Boolean)
+    Boolean _GetHandlePoolEnabled()
+    void _TrimHandlePool()
+    void _GetHandlePoolStats(HandlePoolStats *)
+    void _ResetHandlePoolStats()
 
 """
 Expose DateTime conversion functions from the lib_gnome/StringFunctions.h
@@ -20,6 +38,45 @@ cdef extern from "StringFunctions.h":
     void DateToSeconds (DateTimeRec *, Seconds *)
     void SecondsToDate (Seconds, DateTimeRec *)
 
+"""
+Process wide cache of decoded velocity slices from lib_gnome/VelocitySliceCache.h
+"""
+cdef extern from "VelocitySliceCache.h":
+    ctypedef struct VelocitySliceCacheStats:
+        long numHits
+        long numMisses
+        long numEvictions
+        long numSlices
+        double sizeInMB
+        double budgetInMB
+
+    cdef cppclass VelocitySliceCache:
+        @staticmethod
+        void SetBudget(double)
+        @staticmethod
+        double GetBudget()
+        @staticmethod
+        void Clear()
+        @staticmethod
+        void GetStats(VelocitySliceCacheStats *)
+        @staticmethod
+        void ResetStats()
+
+"""
+Where the triangulations of curvilinear grids are cached, from
+lib_gnome/TopologyCache.h
+"""
+cdef extern from "TopologyCache.h":
+    cdef cppclass TopologyCache:
+        @staticmethod
+        void SetCacheDir(const char *)
+        @staticmethod
+        string GetCacheDir()
+        @staticmethod
+        void SetEnabled(Boolean)
+        @staticmethod
+        Boolean IsEnabled()
+
 """
 Declare methods for interpolation of timeseries from 
 lib_gnome/OSSMTimeValue_c class and ShioTimeValue
@@ -34,6 +91,7 @@ cdef extern from "OSSMTimeValue_c.h":
         
         # Methods
         OSErr   GetTimeValue(Seconds &, VelocityRec *)
+        OSErr   GetTimeValues(Seconds *, long, VelocityRec *)
         OSErr   ReadTimeValues (char *, short, short)
         void    SetTimeValueHandle(TimeValuePairH)    # sets all time values 
         TimeValuePairH GetTimeValueHandle()
@@ -60,6 +118,24 @@ cdef extern from "ShioTimeValue_c.h":
     
     ctypedef HighLowData *HighLowDataP
     ctypedef HighLowData **HighLowDataH
+
+    ctypedef struct CONTROLVAR:
+        float datum
+        short FDir
+        short EDir
+        short L2Flag
+        short HFlag
+        short RotFlag
+
+    ctypedef struct CONSTITUENT:
+        CONTROLVAR DatumControls
+        float H
+        float kPrime
+
+    ctypedef struct CONSTITUENT2:
+        CONTROLVAR DatumControls
+        float **H
+        float **kPrime
     #==================
     cdef cppclass ShioTimeValue_c(OSSMTimeValue_c):
         ShioTimeValue_c() except +
@@ -69,6 +145,7 @@ cdef extern from "ShioTimeValue_c.h":
         bool        daylight_savings_off    # is this required?
         EbbFloodDataH   fEbbFloodDataHdl    # values to show on list for tidal currents - not sure if these should be available
         HighLowDataH    fHighLowDataHdl
+        CONSTITUENT2    fConstituent
         
         OSErr       ReadTimeValues (char *path)
         OSErr       SetYearDataPath (char *path)
@@ -78,4 +155,127 @@ cdef extern from "ShioTimeValue_c.h":
         OSErr       GetConvertedHeightValue(Seconds  , VelocityRec *)
         OSErr       GetProgressiveWaveValue(Seconds &, VelocityRec *)
 
-    
\ No newline at end of file
+"""
+The year data ShioTimeValue_c reads, from lib_gnome/YearDataStore.h
+"""
+cdef extern from "YearDataStore.h":
+    ctypedef struct YEARDATA2:
+        short numElements
+        double *XODE
+        double *VPU
+
+    cdef cppclass YearDataStore:
+        short GetFirstYear()
+        short GetLastYear()
+        Boolean HasYears(short, short)
+        Boolean IsMapped()
+        const YEARDATA2 *GetYearData(short)
+
+    YearDataStore *YearDataStore_Get "YearDataStore::Get" (const char *, char *)
+
+"""
+The sums of tidal constituents, from lib_gnome/ShioHarmonics.h, and the
+Shio routines that sum them one time at a time
+"""
+cdef extern from "ShioHarmonics.h":
+    cdef cppclass HarmonicSeries:
+        HarmonicSeries(const double *, const double *, short, short) except +
+        long GetNumTerms()
+        double Evaluate(double)
+        void EvaluateSeries(double, double, long, double *)
+
+cdef extern from "Shio.h":
+    double RStatHeight(double, double *, double *, short, double)
+    double RStatCurrent(double, double *, double *, double, short, short)
+    double RStatCurrentRot(double, double *, double *, short, CONSTITUENT *,
+                           double, double, double *, double *, double *,
+                           double *, short *)
+    double RStatCurrentRotFromSums(double, double, CONSTITUENT *, double,
+                                   double, double *, double *, double *,
+                                   double *, short *)
+
+    
+"""
+Raster land check from lib_gnome/RasterLandCheck.h, used by cy_land_check
+"""
+cdef extern from "RasterLandCheck.h":
+    ctypedef struct RasterProjection:
+        double centerLong
+        double centerLat
+        double scaleX
+        double scaleY
+        double offsetX
+        double offsetY
+
+    cdef cppclass RasterLandCheck:
+        RasterLandCheck(unsigned char *, long, long)
+        void BuildLevels()
+        long GetNumLevels()
+        Boolean FindFirstPixel(long, long, long, long,
+                               long *, long *, long *, long *) nogil
+        void CheckLand(long, int32_t *, int32_t *, short *, int32_t *) nogil
+        void BeachElements(RasterProjection &, long, WorldPoint3D *,
+                           WorldPoint3D *, short *, WorldPoint3D *) nogil
+
+cdef extern from "ShorelineIndex.h":
+    cdef cppclass ShorelineIndex:
+        ShorelineIndex()
+        OSErr SetPolygons(WorldPoint *, long *, long)
+        long GetNumSegments()
+        Boolean FindFirstCrossing(WorldPoint &, WorldPoint &,
+                                  WorldPoint *, WorldPoint *)
+        Boolean IsOnLand(WorldPoint &)
+        void BeachElements(long, WorldPoint3D *, WorldPoint3D *, short *,
+                           WorldPoint3D *) nogil
+
+"""
+NetCDF particle output from lib_gnome/ParticleFileWriter.h, used by
+cy_particle_file_writer
+"""
+cdef extern from "ParticleFileWriter.h":
+    cdef cppclass ParticleFileWriter:
+        ParticleFileWriter()
+        int Create(char *, Boolean, long)
+        int OpenForAppend(char *)
+        int Close()
+        Boolean IsOpen()
+        int PutAttribute(char *, char *, char *)
+        long DefineVariable(char *, int, long, int *)
+        long UseVariable(char *, int, long, int *)
+        int EndDefinitions()
+        long GetNumVariables()
+        int AppendStep(double, long, char **, long *)
+        int Flush()
+        long GetNumSteps()
+        long GetNumParticles()
+
+    const char *ParticleFileWriter_GetErrorMessage "ParticleFileWriter::GetErrorMessage" (int)
+
+"""
+The element cache's store from lib_gnome/ElementStore.h, used by
+cy_element_store
+"""
+cdef extern from "ElementStore.h":
+    cdef struct StoredArray:
+        string name
+        string typeCode
+        vector[long] shape
+        long long offset
+        long long numBytes
+
+    cdef cppclass ElementStore:
+        ElementStore()
+        OSErr Create(char *)
+        OSErr Open(char *, Boolean)
+        void Close()
+        Boolean IsOpen()
+        const char *GetPath()
+        OSErr BeginStep(long, Boolean, Boolean, double)
+        OSErr AddArray(char *, char *, long, long *, char *, long long)
+        OSErr EndStep()
+        Boolean HasStep(long, Boolean)
+        OSErr GetStepBlock(long, Boolean, long long *, long long *)
+        Boolean GetTimeStamp(long, Boolean, double *)
+        long GetNumArrays(long, Boolean)
+        const StoredArray *GetArray(long, Boolean, long)
+        long long GetFileSize()
@@ -39,7 +39,8 @@ from gnome.utilities.serializable import Serializable, Field
 from gnome.utilities.file_tools import haz_files
 
 from gnome.basic_types import oil_status, world_point_type
-from gnome.cy_gnome.cy_land_check import check_land
+from gnome.cy_gnome.cy_land_check import CyRasterLandCheck, CyShorelineIndex
+from gnome.utilities.projections import GeoProjection
 
 from gnome.utilities.geometry.cy_point_in_polygon import (points_in_poly,
                                                           point_in_poly)
@@ -231,7 +232,98 @@ class GnomeMap(Serializable):
         return None
 
 
-class RasterMap(GnomeMap):
+class LandWaterMap(GnomeMap):
+    """
+    The part of a map with land that doesn't depend on how the land is
+    kept: elements beached on it refloat with a constant half-life in
+    hours.
+    """
+    seconds_in_hour = 60 * 60
+
+    def __init__(self, refloat_halflife, **kwargs):
+        """
+        :param refloat_halflife: The halflife for refloating off land
+                                 -- assumed to be the same for all land.
+                                 0.0 means all refloat every time step
+                                 < 0.0 means never re-float.
+        :type refloat_halflife: float. Units are hours
+
+        Optional arguments (kwargs) are those of GnomeMap
+        """
+        self._refloat_halflife = refloat_halflife * self.seconds_in_hour
+
+        GnomeMap.__init__(self, **kwargs)
+
+    @property
+    def refloat_halflife(self):
+        return self._refloat_halflife / self.seconds_in_hour
+
+    @refloat_halflife.setter
+    def refloat_halflife(self, value):
+        self._refloat_halflife = value * self.seconds_in_hour
+
+    def refloat_elements(self, spill_container, time_step):
+        """
+        This method performs the re-float logic -- changing the element
+        status flag, and moving the element to the last known water position
+
+        :param spill_container: the current spill container
+        :type spill_container:  :class:`gnome.spill_container.SpillContainer`
+        """
+        # index into array of particles on_land
+
+        r_idx = np.where(spill_container['status_codes']
+                         == oil_status.on_land)[0]
+
+        if r_idx.size == 0:  # no particles on land
+            return
+
+        if self._refloat_halflife > 0.0:
+            #if 0.0, then r_idx is all of them -- they will all refloat.
+            # refloat particles based on probability
+
+            refloat_probability = 1.0 - 0.5 ** (float(time_step)
+                                                / self._refloat_halflife)
+            rnd = np.random.uniform(0, 1, len(r_idx))
+
+            # subset of indices that will refloat
+            # maybe we should rename refloat_probability since
+            # rnd <= refloat_probability to
+            # refloat, maybe call it stay_on_land_probability
+            r_idx = r_idx[np.where(rnd <= refloat_probability)[0]]
+        elif self._refloat_halflife < 0.0:
+            # fake for nothing gets refloated.
+            r_idx = np.array((), np.bool)
+
+        if r_idx.size > 0:
+            # check is not required, but why do this operation if no particles
+            # need to be refloated
+            spill_container['positions'][r_idx] = \
+                spill_container['last_water_positions'][r_idx]
+            spill_container['status_codes'][r_idx] = oil_status.in_water
+
+    def allowable_spill_position(self, coord):
+        """
+        Returns true is the spill position is in the allowable spill area
+
+        .. note::
+            This may not be the same as in_water!
+
+        :param coord: (lon, lat, depth) coordinate
+        """
+        if self.on_map(coord):
+            if not self.on_land(coord):
+                if self.spillable_area is None:
+                    return True
+                else:
+                    return points_in_poly(self.spillable_area, coord)
+            else:
+                return False
+        else:
+            return False
+
+
+class RasterMap(LandWaterMap):
     """
     A land water map implemented as a raster
 
@@ -252,8 +344,6 @@ class RasterMap(GnomeMap):
     # in theory -- it could be used for other data:
     #  refloat, other properties?
     # note the BW map_canvas only does 1, though.
-    seconds_in_hour = 60 * 60
-
     land_flag = 1
 
     def __init__(self, refloat_halflife, bitmap_array, projection,
@@ -288,20 +378,23 @@ class RasterMap(GnomeMap):
 
         :type id: string
         """
-        self._refloat_halflife = refloat_halflife * self.seconds_in_hour
-
         self.bitmap = bitmap_array
         self.projection = projection
 
-        GnomeMap.__init__(self, **kwargs)
+        LandWaterMap.__init__(self, refloat_halflife, **kwargs)
 
     @property
-    def refloat_halflife(self):
-        return self._refloat_halflife / self.seconds_in_hour
+    def bitmap(self):
+        return self._bitmap
 
-    @refloat_halflife.setter
-    def refloat_halflife(self, value):
-        self._refloat_halflife = value * self.seconds_in_hour
+    @bitmap.setter
+    def bitmap(self, bitmap_array):
+        """
+        the coarse levels of the land check are built here, once for each
+        bitmap -- so don't change a bitmap in place
+        """
+        self._bitmap = bitmap_array
+        self._land_check = CyRasterLandCheck(bitmap_array)
 
     def save_as_image(self, filename):
         '''
@@ -421,6 +514,15 @@ class RasterMap(GnomeMap):
         status_codes = spill['status_codes']
         last_water_positions = spill['last_water_positions']
 
+        if isinstance(self.projection, GeoProjection):
+            # lib_gnome can do the projection itself, one LE at a time
+            self._land_check.beach_elements(self.projection,
+                                            start_pos, next_pos,
+                                            status_codes,
+                                            last_water_positions)
+            self._set_off_map_status(spill)
+            return
+
         # transform to pixel coords:
         # NOTE: must be integers!
 
@@ -432,7 +534,7 @@ class RasterMap(GnomeMap):
         # call the actual hit code:
         # the status_code and last_water_point arrays are altered in-place
         # only check the ones that aren't already beached?
-        self._check_land(self.bitmap, start_pos_pixel, next_pos_pixel,
+        self._check_land(start_pos_pixel, next_pos_pixel,
                          status_codes, last_water_pos_pixel)
 
         # transform the points back to lat-long.
@@ -444,77 +546,17 @@ class RasterMap(GnomeMap):
 
         self._set_off_map_status(spill)
 
-    def refloat_elements(self, spill_container, time_step):
-        """
-        This method performs the re-float logic -- changing the element
-        status flag, and moving the element to the last known water position
-
-        :param spill_container: the current spill container
-        :type spill_container:  :class:`gnome.spill_container.SpillContainer`
-        """
-        # index into array of particles on_land
-
-        r_idx = np.where(spill_container['status_codes']
-                         == oil_status.on_land)[0]
-
-        if r_idx.size == 0:  # no particles on land
-            return
-
-        if self._refloat_halflife > 0.0:
-            #if 0.0, then r_idx is all of them -- they will all refloat.
-            # refloat particles based on probability
-
-            refloat_probability = 1.0 - 0.5 ** (float(time_step)
-                                                / self._refloat_halflife)
-            rnd = np.random.uniform(0, 1, len(r_idx))
-
-            # subset of indices that will refloat
-            # maybe we should rename refloat_probability since
-            # rnd <= refloat_probability to
-            # refloat, maybe call it stay_on_land_probability
-            r_idx = r_idx[np.where(rnd <= refloat_probability)[0]]
-        elif self._refloat_halflife < 0.0:
-            # fake for nothing gets refloated.
-            r_idx = np.array((), np.bool)
-
-        if r_idx.size > 0:
-            # check is not required, but why do this operation if no particles
-            # need to be refloated
-            spill_container['positions'][r_idx] = \
-                spill_container['last_water_positions'][r_idx]
-            spill_container['status_codes'][r_idx] = oil_status.in_water
-
-    def _check_land(self, raster_map, positions, end_positions,
+    def _check_land(self, positions, end_positions,
                     status_codes, last_water_positions):
         """
         Do the actual land-checking.  This method calls a Cython version:
-            gnome.cy_gnome.cy_land_check.check_land()
+            gnome.cy_gnome.cy_land_check.CyRasterLandCheck.check_land()
 
         The arguments 'status_codes', 'positions' and 'last_water_positions'
         are altered in place.
         """
-        check_land(raster_map, positions, end_positions, status_codes,
-                   last_water_positions)
-
-    def allowable_spill_position(self, coord):
-        """
-        Returns true is the spill position is in the allowable spill area
-
-        .. note::
-            This may not be the same as in_water!
-
-        :param coord: (lon, lat, depth) coordinate
-        """
-        if self.on_map(coord):
-            if not self.on_land(coord):
-                if self.spillable_area is None:
-                    return True
-                else:
-                    return points_in_poly(self.spillable_area, coord)
-            else:
-                return False
-        else:
-            return False
+        self._land_check.check_land(positions, end_positions,
+                                    status_codes, last_water_positions)
 
     def to_pixel_array(self, coords):
         """
@@ -528,6 +570,49 @@ class RasterMap(GnomeMap):
         return self.projection.to_pixel(coords)
 
 
+def _read_bna_map(filename, kwargs):
+    """
+    Reads the land polygons, map bounds and spillable area of a BNA map.
+
+    The map bounds and spillable area default to the bounding box of the
+    land, if they aren't in the BNA. They are overridden by 'map_bounds' and
+    'spillable_area' in kwargs, which are popped from it.
+    """
+    polygons = haz_files.ReadBNA(filename, 'PolygonSet')
+    map_bounds = None
+    spillable_area = None
+
+    # find the spillable area and map bounds:
+    # and create a new polygonset without them
+    #  fixme -- adding a "pop" method to PolygonSet might be better
+    #      or a gnome_map_data object...
+
+    just_land = PolygonSet()  # and lakes....
+
+    for p in polygons:
+        if p.metadata[1].lower() == 'spillablearea':
+            spillable_area = p
+        elif p.metadata[1].lower() == 'map bounds':
+            map_bounds = p
+        else:
+            just_land.append(p)
+
+    # create spillable area and  bounds if they weren't in the BNA
+    if map_bounds is None:
+        map_bounds = just_land.bounding_box.AsPoly()
+
+    if spillable_area is None:
+        spillable_area = map_bounds
+
+    # user defined spillable_area, map_bounds overrides data obtained
+    # from polygons
+
+    spillable_area = kwargs.pop('spillable_area', spillable_area)
+    map_bounds = kwargs.pop('map_bounds', map_bounds)
+
+    return (just_land, map_bounds, spillable_area)
+
+
 class MapFromBNA(RasterMap):
     """
     A raster land-water map, created from a BNA file
@@ -564,44 +649,16 @@ class MapFromBNA(RasterMap):
         :type id: string
         """
         self.filename = filename
-        polygons = haz_files.ReadBNA(filename, 'PolygonSet')
-        map_bounds = None
-        spillable_area = None
         self.name = kwargs.pop('name', os.path.split(filename)[1])
 
-        # find the spillable area and map bounds:
-        # and create a new polygonset without them
-        #  fixme -- adding a "pop" method to PolygonSet might be better
-        #      or a gnome_map_data object...
-
-        just_land = PolygonSet()  # and lakes....
-
-        for p in polygons:
-            if p.metadata[1].lower() == 'spillablearea':
-                spillable_area = p
-            elif p.metadata[1].lower() == 'map bounds':
-                map_bounds = p
-            else:
-                just_land.append(p)
+        (just_land, map_bounds, spillable_area) = _read_bna_map(filename,
+                                                                kwargs)
 
         # now draw the raster map with a map_canvas:
         # determine the size:
 
         BB = just_land.bounding_box
 
-        # create spillable area and  bounds if they weren't in the BNA
-        if map_bounds is None:
-            map_bounds = BB.AsPoly()
-
-        if spillable_area is None:
-            spillable_area = map_bounds
-
-        # user defined spillable_area, map_bounds overrides data obtained
-        # from polygons
-
-        spillable_area = kwargs.pop('spillable_area', spillable_area)
-        map_bounds = kwargs.pop('map_bounds', map_bounds)
-
         # stretch the bounding box, to get approximate aspect ratio in
         # projected coords.
 
@@ -629,3 +686,120 @@ class MapFromBNA(RasterMap):
                            **kwargs)
 
         return None
+
+
+class VectorMap(LandWaterMap):
+    """
+    A land water map that keeps the shoreline polygons themselves, so
+    land hits are exact rather than to the nearest pixel of a raster.
+
+    It requires a constant refloat half-life in hours
+
+    This will usually be initialized in a sub-class (from a BNA, etc)
+    NOTE: Nothing new added to _state attribute for serialization
+    """
+    def __init__(self, refloat_halflife, shoreline_polygons, **kwargs):
+        """
+        create a new VectorMap
+
+        :param refloat_halflife: The halflife for refloating off land
+                                 -- assumed to be the same for all land.
+                                 0.0 means all refloat every time step
+                                 < 0.0 means never re-float.
+        :type refloat_halflife: float. Units are hours
+
+        :param shoreline_polygons: the land polygons, and any lakes in them
+        :type shoreline_polygons: sequence of (N,2) numpy arrays of floats
+
+        Optional arguments (kwargs) are those of GnomeMap
+        """
+        self._shoreline = CyShorelineIndex(shoreline_polygons)
+
+        LandWaterMap.__init__(self, refloat_halflife, **kwargs)
+
+    def on_land(self, coord):
+        """
+        :param coord: (long, lat, depth) location -- depth is ignored here.
+        :type coord: 3-tuple of floats -- (long, lat, depth)
+
+        :return:
+         - True if point on land
+         - False if not on land
+        """
+        return bool(self._shoreline.on_land(coord)[0])
+
+    def in_water(self, coord):
+        """
+        checks if it's on the map, first.
+            (depth is ignored in this version)
+
+        :param coord: (lon, lat, depth) coordinate
+
+        :return: true if the point given by coord is in the water
+        """
+        if not self.on_map(coord):
+            return False
+        else:
+            return not self.on_land(coord)
+
+    def beach_elements(self, spill):
+        """
+        Determines which elements were or weren't beached.
+
+        Any that are beached are moved to where they first crossed the
+        shoreline, and a "last known water position" just back from there
+        along the move is set.
+
+        :param spill: the current spill container
+        :type spill:  :class:`gnome.spill_container.SpillContainer`
+        """
+        self.resurface_airborne_elements(spill)
+
+        self._shoreline.beach_elements(spill['positions'],
+                                       spill['next_positions'],
+                                       spill['status_codes'],
+                                       spill['last_water_positions'])
+
+        self._set_off_map_status(spill)
+
+
+class VectorMapFromBNA(VectorMap):
+    """
+    A vector land-water map, created from a BNA file
+    """
+    _state = copy.deepcopy(VectorMap._state)
+    _state.update(['map_bounds', 'spillable_area'], save=False)
+    _state.add(save=['refloat_halflife'], update=['refloat_halflife'])
+    _state.add_field(Field('filename', isdatafile=True, save=True,
+                            read=True, test_for_eq=False))
+    _schema = MapFromBNASchema
+
+    def __init__(self, filename, refloat_halflife, **kwargs):
+        """
+        Creates a VectorMap from a bna file. As with MapFromBNA, the
+        spillable area and map bounds come from the BNA, if they are there.
+
+        Required arguments:
+
+        :param bna_file: full path to a bna file
+        :param refloat_halflife: the half-life (in hours) for the re-floating.
+
+        Optional arguments (kwargs):
+
+        :param map_bounds: The polygon bounding the map -- could be larger or
+                           smaller than the land
+        :param spillable_area: The polygon bounding the spillable_area
+        :param id: unique ID of the object. Using UUID as a string.
+                   This is only used when loading object from save file.
+        :type id: string
+        """
+        self.filename = filename
+        self.name = kwargs.pop('name', os.path.split(filename)[1])
+
+        (just_land, map_bounds, spillable_area) = _read_bna_map(filename,
+                                                                kwargs)
+
+        VectorMap.__init__(self, refloat_halflife, list(just_land),
+                           map_bounds=map_bounds,
+                           spillable_area=spillable_area,
+                           **kwargs)
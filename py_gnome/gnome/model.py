@@ -19,13 +19,16 @@ from colander import (MappingSchema, SchemaNode,
 from gnome.environment import Environment
 
 import gnome.utilities.cache
-from gnome.utilities.time_utils import round_time
+from gnome.utilities.time_utils import round_time, date_to_sec
 from gnome.utilities.orderedcollection import OrderedCollection
 from gnome.utilities.serializable import Serializable, Field
 
 from gnome.spill_container import SpillContainerPair
 
+from gnome.basic_types import world_point, spill_type
 from gnome.movers import Mover
+from gnome.cy_gnome.cy_helpers import trim_handle_pool
+from gnome.cy_gnome.cy_mover_chain import CyMoverChain
 from gnome.weatherers import Weatherer
 
 from gnome.outputters import Outputter, NetCDFOutput
@@ -213,6 +216,9 @@ class Model(Serializable):
         self._cache = gnome.utilities.cache.ElementCache()
         self._cache.enabled = cache_enabled
 
+        # the CyMoverChains move_elements runs the chainable movers with
+        self._mover_chains = []
+
         # list of output objects
         self.outputters = OrderedCollection(dtype=Outputter)
 
@@ -258,6 +264,9 @@ class Model(Serializable):
         # clear the cache:
         self._cache.rewind()
 
+        # give back the memory of the last run's handles in one go
+        trim_handle_pool()
+
         for outputter in self.outputters:
             outputter.rewind()
 
@@ -437,10 +446,13 @@ class Model(Serializable):
         '''
         Moves elements:
          - loops through all the movers. and moves the elements
+           (each run of chainable movers in one CyMoverChain call)
          - sets new_position array for each spill
          - calls the beaching code to beach the elements that need beaching.
          - sets the new position
         '''
+        runs = self._mover_runs()
+
         for sc in self.spills.items():
             if sc.num_released > 0:  # can this check be removed?
 
@@ -451,8 +463,12 @@ class Model(Serializable):
                 (sc['next_positions'])[:] = sc['positions']
 
                 # loop through the movers
-                for m in self.movers:
-                    delta = m.get_move(sc, self.time_step, self.model_time)
+                for run in runs:
+                    if isinstance(run, CyMoverChain):
+                        self._chain_moves(sc, run)
+                        continue
+
+                    delta = run.get_move(sc, self.time_step, self.model_time)
                     sc['next_positions'] += delta
 
                 self.map.beach_elements(sc)
@@ -460,6 +476,58 @@ class Model(Serializable):
                 # the final move to the new positions
                 (sc['positions'])[:] = sc['next_positions']
 
+    def _mover_runs(self):
+        '''
+        the movers in order, with each run of active chainable movers as a
+        CyMoverChain. The chains are kept on the model from step to step and
+        only rebuilt when the movers in a run change.
+        '''
+        runs = []
+        chained = []
+        for m in self.movers:
+            if m.chainable:
+                if m.active:
+                    chained.append(m.mover)
+                continue
+
+            if chained:
+                runs.append(chained)
+                chained = []
+            runs.append(m)
+
+        if chained:
+            runs.append(chained)
+
+        chains = [run for run in runs if isinstance(run, list)]
+        if [c.movers for c in self._mover_chains] != chains:
+            self._mover_chains = []
+            for movers in chains:
+                chain = CyMoverChain()
+                for cy_mover in movers:
+                    chain.add_mover(cy_mover)
+                self._mover_chains.append(chain)
+
+        chains = iter(self._mover_chains)
+        return [next(chains) if isinstance(run, list) else run
+                for run in runs]
+
+    def _chain_moves(self, sc, chain):
+        '''
+        adds the moves of a run of cython movers to next_positions in one
+        pass over the elements -- the same as adding their get_move deltas
+        in turn
+        '''
+        chain.get_move(date_to_sec(self.model_time),
+                       self.time_step,
+                       sc['positions'].view(dtype=world_point).reshape(-1),
+                       sc['next_positions'].view(dtype=world_point)
+                       .reshape(-1),
+                       sc['windages'] if 'windages' in sc else None,
+                       sc['rise_vel'] if 'rise_vel' in sc else None,
+                       sc['status_codes'],
+                       spill_type.uncertainty if sc.uncertain
+                       else spill_type.forecast)
+
     def weather_elements(self):
         '''
         Weathers elements:
@@ -773,6 +841,7 @@ class Model(Serializable):
                                      uncertain=self.uncertain,
                                      spills=self.spills)
         nc_out.write_output(self.current_time_step)
+        nc_out.close()
 
     def _load_spill_data(self, spill_data):
         """
@@ -2,7 +2,7 @@ import copy
 
 import numpy
 np = numpy
-from colander import (SchemaNode, MappingSchema, Bool, drop)
+from colander import (SchemaNode, MappingSchema, Bool, Int, drop)
 
 from gnome.persist.validators import convertible_to_seconds
 from gnome.persist.extend_colander import LocalDateTime
@@ -24,6 +24,7 @@ class MoverSchema(MappingSchema):
                               validator=convertible_to_seconds)
     active_stop = SchemaNode(LocalDateTime(), missing=drop,
                              validator=convertible_to_seconds)
+    random_stream = SchemaNode(Int(), missing=drop)
 
 
 class Mover(object):
@@ -44,6 +45,10 @@ class Mover(object):
               save=['on', 'active_start', 'active_stop'],
               read=['active'])
 
+    # True if the model can leave the move to the mover's cython mover in a
+    # CyMoverChain rather than calling get_move -- see Model.move_elements
+    chainable = False
+
     def __init__(self, **kwargs):   # default min + max values for timespan
         """
         Initialize default Mover parameters
@@ -151,6 +156,13 @@ class Mover(object):
 
 class CyMover(Mover):
 
+    _state = copy.deepcopy(Mover._state)
+    _state.add(update=['random_stream'], save=['random_stream'])
+
+    # a derived class whose get_move does more than call the cython mover's
+    # get_move should set this to False
+    chainable = True
+
     def __init__(self, **kwargs):
         """
         Base class for python wrappers around cython movers.
@@ -180,6 +192,29 @@ class CyMover(Mover):
         # either a 1, or 2 depending on whether spill is certain or not
         self.spill_type = 0
 
+    @property
+    def random_stream(self):
+        """
+        keys the cython mover's random draws along with its seed, so two
+        movers of a type draw apart -- see CyMover.random_stream
+        """
+        return self.mover.random_stream
+
+    @random_stream.setter
+    def random_stream(self, value):
+        self.mover.random_stream = value
+
+    @property
+    def num_threads(self):
+        """
+        number of threads the cython mover's get_move splits the LEs across
+        """
+        return self.mover.num_threads
+
+    @num_threads.setter
+    def num_threads(self, value):
+        self.mover.num_threads = value
+
     def prepare_for_model_run(self):
         """
         Calls the contained cython mover's prepare_for_model_run()
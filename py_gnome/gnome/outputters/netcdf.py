@@ -5,6 +5,7 @@ NetCDF output writer
 
 import copy
 import os
+import weakref
 from datetime import datetime
 from collections import OrderedDict
 
@@ -16,6 +17,7 @@ from colander import SchemaNode, String, drop, Int, Bool
 
 from gnome import __version__, array_types
 from gnome.basic_types import oil_status, world_point_type
+from gnome.cy_gnome.cy_particle_file_writer import CyParticleFileWriter
 
 from gnome.utilities.serializable import Serializable, Field
 from gnome.utilities.time_utils import round_time
@@ -73,6 +75,25 @@ var_attributes = {
     'last_water_positions': {},
     }
 
+# the files being written, by their real path
+_open_writers = weakref.WeakValueDictionary()
+
+
+def _release_files(netcdf_file=None):
+    '''
+    The writers write on threads of their own and the netCDF library isn't
+    thread safe, so wait for their queued steps before netCDF4 is used.
+    The writer of netcdf_file, the file about to be read, is closed; the
+    next step written to it opens it again.
+    '''
+    if netcdf_file is not None:
+        writer = _open_writers.pop(os.path.realpath(netcdf_file), None)
+        if writer is not None:
+            writer.close()
+
+    for writer in list(_open_writers.values()):
+        writer.flush()
+
 
 class NetCDFOutputSchema(BaseSchema):
     'colander schema for serialize/deserialize object'
@@ -137,6 +158,12 @@ class NetCDFOutput(Outputter, Serializable):
                        'age',
                        ]
 
+    # the netcdf variables pulled from the 'positions' array, and their column
+    position_columns = {'longitude': 0,
+                        'latitude': 1,
+                        'depth': 2,
+                        }
+
     ## the list of arrays that we usually don't want -- i.e. for internal use
     ## these will get skipped if "most" is asked for
     ## "all" will output everything.
@@ -240,6 +267,10 @@ class NetCDFOutput(Outputter, Serializable):
         # number of particles are released
         self._start_idx = 0
 
+        # CyParticleFileWriter for each file, by filename
+        self._writers = {}
+        self._time_units = None
+
         # spill_num's attributes are instance attributes.
         # 'spill_names' is set based on the names of spill's as defined by user
         self._var_attributes = {
@@ -406,107 +437,104 @@ class NetCDFOutput(Outputter, Serializable):
         else:
             filenames = (self.netcdf_filename,)
 
+        self.close()
+        self._time_units = 'seconds since {0}'.format(
+                                    self._model_start_time.isoformat())
+
         for file_ in filenames:
             self._nc_file_exists_error(file_)
             ## create the netcdf files and write the standard stuff:
-            with nc.Dataset(file_, 'w', format=self._format) as rootgrp:
-                ## fixme: why remove the "T" ??
-                self.cf_attributes['creation_date'] = \
-                            round_time(datetime.now(), roundTo=1).isoformat()
-                rootgrp.setncatts(self.cf_attributes)
-                    #rootgrp.comment = self.cf_attributes['comment']
-                    #rootgrp.source = self.cf_attributes['source']
-                    #rootgrp.references = self.cf_attributes['references']
-                    #rootgrp.feature_type = self.cf_attributes['feature_type']
-                    #rootgrp.institution = self.cf_attributes['institution']
-                    #rootgrp.convention = self.cf_attributes['conventions']
-
-                # create the dimensions we need
-                # not sure if it's a convention or if dimensions
-                # need to be names...
-                rootgrp.createDimension('time')  # unlimited
-                rootgrp.createDimension('data')  # unlimited
-                rootgrp.createDimension('two', 2)
-                rootgrp.createDimension('three', 3)
-                rootgrp.createDimension('four', 4)
-                rootgrp.createDimension('five', 5)
-
-                # create the time variable
-                time_ = rootgrp.createVariable('time',
-                                               np.float64,
-                                               ('time', ),
-                                               zlib=self._compress,
-                                               chunksizes=(self._chunksize,))
-                time_.setncatts(var_attributes['time'])
-                time_.units = 'seconds since {0}'.format(
-                        self._model_start_time.isoformat())
-
-                # create the particle count variable
-                pc_ = rootgrp.createVariable('particle_count',
-                                            np.int32,
-                                            ('time', ),
-                                            zlib=self._compress,
-                                            chunksizes=(self._chunksize,))
-                pc_.setncatts(var_attributes['particle_count'])
-
-                ## create the list of variables that we want to put in the file
-                if self.which_data in ('all', 'most'):
-                    for var_name in spills.items()[0].array_types:
-                        if var_name != 'positions':
-                            # handled by latitude, longitude, depth
-                            self.arrays_to_output.add(var_name)
-
-                    if self.which_data == 'most':
-                        # remove the ones we don't want
-                        for var_name in self.usually_skipped_arrays:
-                            self.arrays_to_output.discard(var_name)
-
-                for var_name in self.arrays_to_output:
-                    # the special cases:
-                    if var_name in ('latitude', 'longitude', 'depth'):
-                        # these don't  map directly to an array_type
-                        dt = world_point_type
-                        shape = ('data', )
-                        chunksizes = (self._chunksize,)
-                    else:
-                        at = getattr(array_types, var_name)
-                        dt = at.dtype
-
-                        # total kludge for the cases we happen to have...
-                        if at.shape == (5,):
-                            shape = ('data', 'five')
-                            chunksizes = (self._chunksize, 5)
-                        elif at.shape == (4,):
-                            shape = ('data', 'four')
-                            chunksizes = (self._chunksize, 4)
-                        elif at.shape == (3,):
-                            shape = ('data', 'three')
-                            chunksizes = (self._chunksize, 3)
-                        elif at.shape == (2,):
-                            shape = ('data', 'two')
-                            chunksizes = (self._chunksize, 2)
-                        else:
-                            shape = ('data',)
-                            chunksizes = (self._chunksize,)
-
-                    var = rootgrp.createVariable(var_name,
-                                                 dt,
-                                                 shape,
-                                                 zlib=self._compress,
-                                                 chunksizes=chunksizes,
-                                                 )
-
-                    # add attributes
-                    if var_name in var_attributes:
-                        var.setncatts(var_attributes[var_name])
-                    elif var_name in self._var_attributes:
-                        var.setncatts(self._var_attributes[var_name])
+            writer = CyParticleFileWriter()
+            writer.create(file_, self._compress, self._chunksize)
+
+            ## fixme: why remove the "T" ??
+            self.cf_attributes['creation_date'] = \
+                        round_time(datetime.now(), roundTo=1).isoformat()
+            writer.put_attributes(None, self.cf_attributes)
+
+            # the time and particle count variables are created with the file
+            time_attributes = dict(var_attributes['time'])
+            time_attributes['units'] = self._time_units
+            writer.put_attributes('time', time_attributes)
+            writer.put_attributes('particle_count',
+                                  var_attributes['particle_count'])
+
+            ## create the list of variables that we want to put in the file
+            if self.which_data in ('all', 'most'):
+                for var_name in spills.items()[0].array_types:
+                    if var_name != 'positions':
+                        # handled by latitude, longitude, depth
+                        self.arrays_to_output.add(var_name)
+
+                if self.which_data == 'most':
+                    # remove the ones we don't want
+                    for var_name in self.usually_skipped_arrays:
+                        self.arrays_to_output.discard(var_name)
+
+            for var_name in self.arrays_to_output:
+                (dt, num_components) = self._variable_type(var_name)
+                writer.define_variable(var_name, dt, num_components)
+
+                # add attributes
+                if var_name in var_attributes:
+                    writer.put_attributes(var_name, var_attributes[var_name])
+                elif var_name in self._var_attributes:
+                    writer.put_attributes(var_name,
+                                          self._var_attributes[var_name])
+
+            writer.end_definitions()
+            self._add_writer(file_, writer)
 
         # need to keep track of starting index for writing data since variable
         # number of particles are released
         self._start_idx = 0
         self._middle_of_run = True
 
+    def _variable_type(self, var_name):
+        '''
+        the dtype of a netcdf variable and its number of values per particle
+        '''
+        if var_name in self.position_columns:
+            # these don't  map directly to an array_type
+            return (world_point_type, 1)
+
+        at = getattr(array_types, var_name)
+
+        # total kludge for the cases we happen to have...
+        if at.shape in ((2,), (3,), (4,), (5,)):
+            return (at.dtype, at.shape[0])
+        else:
+            return (at.dtype, 1)
+
+    def _add_writer(self, file_, writer):
+        self._writers[file_] = writer
+        _open_writers[os.path.realpath(file_)] = writer
+
+    def _writer(self, file_):
+        '''
+        The writer for file_. One that was closed -- at the end of a run, to
+        read the file, or by a save mid-run -- is opened again to append
+        the file's variables from where they end.
+        '''
+        writer = self._writers.get(file_)
+        if writer is not None and writer.is_open:
+            return writer
+
+        _release_files(file_)
+        with nc.Dataset(file_) as rootgrp:
+            self._time_units = rootgrp.variables['time'].units
+            variables = [(name, var.dtype, var.shape[1:])
+                         for name, var in rootgrp.variables.items()
+                         if name not in ('time', 'particle_count')]
+
+        writer = CyParticleFileWriter()
+        writer.open_for_append(file_)
+        for (name, dt, shape) in variables:
+            writer.use_variable(name, dt, shape[0] if shape else 1)
+
+        self._add_writer(file_, writer)
+        return writer
+
     def write_output(self, step_num, islast_step=False):
         """
         Write NetCDF output at the end of the step
@@ -523,6 +551,8 @@ class NetCDFOutput(Outputter, Serializable):
         super(NetCDFOutput, self).write_output(step_num, islast_step)
 
         if not self._write_step:
+            if islast_step:
+                self.close()
             return None
 
         for sc in self.cache.load_timestep(step_num).items():
@@ -532,43 +562,43 @@ class NetCDFOutput(Outputter, Serializable):
                 file_ = self.netcdf_filename
 
             time_stamp = sc.current_time_stamp
+            writer = self._writer(file_)
 
-            with nc.Dataset(file_, 'a') as rootgrp:
-                curr_idx = len(rootgrp.variables['time'])
-                rootgrp.variables['time'][curr_idx] = nc.date2num(time_stamp,
-                                                                  rootgrp.variables['time'].units,
-                                                                  rootgrp.variables['time'].calendar)
-                pc = rootgrp.variables['particle_count']
-                pc[curr_idx] = len(sc)
-
-                _end_idx = self._start_idx + pc[curr_idx]
-
-                # add the data:
-                for var_name in self.arrays_to_output:
-                    ## special case positions:
-                    if var_name == 'longitude':
-                        rootgrp.variables['longitude'][self._start_idx:_end_idx] = \
-                                    sc['positions'][:, 0]
-                    elif var_name == 'latitude':
-                        rootgrp.variables['latitude'][self._start_idx:_end_idx] = \
-                                    sc['positions'][:, 1]
-                    elif var_name == 'depth':
-                        rootgrp.variables['depth'][self._start_idx:_end_idx] = \
-                                    sc['positions'][:, 2]
-                    else:
-                        rootgrp.variables[var_name][self._start_idx:_end_idx] = \
-                                    sc[var_name]
+            # the positions columns are copied from in place
+            positions = sc['positions']
+            arrays = [positions[:, self.position_columns[var_name]]
+                      if var_name in self.position_columns else sc[var_name]
+                      for var_name in writer.variables]
+
+            writer.append_step(nc.date2num(time_stamp, self._time_units,
+                                           var_attributes['time']['calendar']),
+                               arrays)
 
-        self._start_idx = _end_idx  # set _start_idx for the next timestep
+            # set _start_idx for the next timestep
+            self._start_idx = writer.num_particles
 
         # update self._next_output_time if data is successfully written
         self._update_next_output_time(step_num, sc.current_time_stamp)
 
+        if islast_step:
+            self.close()
+
         return {'step_num': step_num,
                 'netcdf_filename': (self.netcdf_filename,
                                     self._u_netcdf_filename),
                 'time_stamp': time_stamp}
 
+    def close(self):
+        '''
+        Write out the steps still queued and close the files. This is done at
+        the last step; a run stopped short of it calls this to finish the
+        files. Writing another step opens them again.
+        '''
+        writers, self._writers = self._writers, {}
+        for file_, writer in writers.items():
+            _open_writers.pop(os.path.realpath(file_), None)
+            writer.close()
+
     def rewind(self):
         '''
         If rewound, delete both the files and expect prepare_for_model_run to
@@ -577,6 +607,7 @@ class NetCDFOutput(Outputter, Serializable):
         Also call base class rewind to reset internal variables. Using super
         '''
         super(NetCDFOutput, self).rewind()
+        self.close()
 
         if os.path.exists(self.netcdf_filename):
             os.remove(self.netcdf_filename)
@@ -639,6 +670,8 @@ class NetCDFOutput(Outputter, Serializable):
         if not os.path.exists(netcdf_file):
             raise IOError('File not found: {0}'.format(netcdf_file))
 
+        _release_files(netcdf_file)
+
         arrays_dict = {}
         with nc.Dataset(netcdf_file) as data:
             _start_ix = 0
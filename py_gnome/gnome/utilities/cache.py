@@ -11,12 +11,17 @@ import warnings
 import tempfile
 import shutil
 import copy
+from datetime import datetime, timedelta
 
 import numpy
 np = numpy
 
 from gnome.spill_container import (SpillContainerData,
                                    SpillContainerPairData)
+from gnome.cy_gnome.cy_element_store import CyElementStore
+
+# the store keeps time stamps as seconds from this
+_epoch = datetime(1970, 1, 1)
 
 # create a temp dir for this python instance
 # this should happen once, on first import
@@ -70,6 +75,11 @@ class ElementCache(object):
     This caches UncertainSpillContainerPair
     The cache can be accessed to re-draw the LE movies, etc.
 
+    The steps of a run are appended to one file, by a CyElementStore, which
+    keeps an index of where each step is in it. Loading a step maps that
+    part of the file: the data arrays aren't read or copied, and no other
+    step is looked at.
+
     TODO: This is a really fragile module in terms of handling multiple
           instances.  The __del__() method of previous instances can clear
           the _cache_dir at the whim of the GC.
@@ -96,24 +106,31 @@ class ElementCache(object):
         # flag for whether to enable disk cache
         self.enabled = enabled
 
+        # the store for this run's steps, created with the first one saved.
+        # Each run gets a file of its own, as arrays loaded from the last
+        # one may still be mapped.
+        self._store = None
+        self._num_runs = 0
+
     def __del__(self):
         'Clear out the cache when this object is deleted'
+        if self._store is not None:
+            self._store.close()
         clean_up_cache(dir_name=self._cache_dir)
 
-    def _make_filename(self, step_num, uncertain=False):
+    def _make_filename(self):
+        """
+        Returns the filename of the current run's store
         """
-        Returns a filename of the temp file generated from step_num
+        return os.path.join(self._cache_dir,
+                            'elements_%03i.dat' % self._num_runs)
 
-        :param step_num: the model step number that is saved/reloaded
+    def _get_store(self):
+        if self._store is None:
+            self._store = CyElementStore()
+            self._store.create(self._make_filename())
 
-        This here so that loading and saving use the same code
-        """
-        if uncertain:
-            return os.path.join(self._cache_dir,
-                                'step_%06i_uncert.npz' % step_num)
-        else:
-            return os.path.join(self._cache_dir,
-                                'step_%06i.npz' % step_num)
+        return self._store
 
     def save_timestep(self, step_num, spill_container_pair):
         """
@@ -123,7 +140,21 @@ class ElementCache(object):
         :param spill_container: the spill container at this step
         """
         for sc in spill_container_pair.items():
-            data = copy.deepcopy(sc.data_arrays)
+            if self.enabled:
+                time_stamp = None
+                if sc.current_time_stamp:
+                    time_stamp = (sc.current_time_stamp -
+                                  _epoch).total_seconds()
+
+                store = self._get_store()
+                store.save_step(step_num, sc.uncertain, sc.data_arrays,
+                                time_stamp)
+
+                # the step as it is in the file, kept mapped in case the
+                # file goes away
+                data = store.load_step(step_num, sc.uncertain)
+            else:
+                data = copy.deepcopy(sc.data_arrays)
 
             if sc.current_time_stamp:
                 data['current_time_stamp'] = np.array(sc.current_time_stamp)
@@ -136,14 +167,26 @@ class ElementCache(object):
                 # this creates a new dict, so only one step is saved
                 self.recent = {step_num: [data, None]}
 
-            # write the data if enabled
-            # could be threaded -- data is a copy, so doesn't need to be
-            #                      re-used by anything
-            if self.enabled:
-                if sc.uncertain:
-                    np.savez(self._make_filename(step_num, True), **data)
-                else:
-                    np.savez(self._make_filename(step_num), **data)
+    def _load_from_store(self, step_num, uncertain):
+        """
+        The step's data arrays and time stamp, mapped from the store; None
+        if it isn't there, or the file is gone
+        """
+        if self._store is None or not self._store.has_step(step_num,
+                                                           uncertain):
+            return None
+
+        try:
+            data_arrays = self._store.load_step(step_num, uncertain)
+        except (IOError, OSError):
+            return None
+
+        time_stamp = self._store.time_stamp(step_num, uncertain)
+        if time_stamp is not None:
+            data_arrays['current_time_stamp'] = \
+                np.array(_epoch + timedelta(seconds=time_stamp))
+
+        return data_arrays
 
     def load_timestep(self, step_num):
         """
@@ -151,41 +194,33 @@ class ElementCache(object):
 
         :param step_num: the step number you want to load.
         """
-        # look first in in-memory cache.
-        try:
-            # make a copy because we pop out the current_time_stamp
-            # make these changes to the copy so the self.recent does not change
-
-            (data_arrays, u_data_arrays) = copy.deepcopy(self.recent[step_num])
+        data_arrays = self._load_from_store(step_num, False)
+        if data_arrays is not None:
+            u_data_arrays = self._load_from_store(step_num, True)
+        else:
+            # not in the store: look in the in-memory cache.
+            try:
+                # make a copy because we pop out the current_time_stamp
+                # make these changes to the copy so the self.recent does
+                # not change
+                (data_arrays, u_data_arrays) = \
+                    copy.deepcopy(self.recent[step_num])
+            except KeyError:
+                raise CacheError('step: {0} is not in the cache'
+                                 .format(step_num))
 
             # copy.deepcopy(self.recent[step_num]) converts
             # 'current_time_stamp' to datetime object
-            # To be consistent with np.load() operation below,
-            # make this an array.
+            # To be consistent with the store, make this an array.
             if 'current_time_stamp' in data_arrays:
                 data_arrays['current_time_stamp'] = \
                     np.array(data_arrays['current_time_stamp'])
                 if u_data_arrays:
                     u_data_arrays['current_time_stamp'] = \
                         np.array(u_data_arrays['current_time_stamp'])
-        except KeyError:
-            # not in the recent dict: try to load from disk
-            try:
-                data_arrays = \
-                    dict(np.load(self._make_filename(step_num)))
-            except IOError:
-                raise CacheError('step: {0} is not in the cache'
-                                 .format(step_num))
 
-            try:
-                u_data_arrays = \
-                    dict(np.load(self._make_filename(step_num, True)))
-            except IOError:
-                u_data_arrays = None
-
-        # HOWEVER, loading numpy arrays
-        #     data_arrays = dict(np.load(self._make_filename(step_num)))
-        # converts current_time_stamp to numpy.ndarray objects
+        # current_time_stamp is kept as a numpy.ndarray object with the
+        # arrays, pull the datetime back out
         current_time_stamp = None
         if 'current_time_stamp' in data_arrays:
             current_time_stamp = data_arrays.pop('current_time_stamp').item()
@@ -216,7 +251,15 @@ class ElementCache(object):
         # clean out the in-memory cache
         self.recent = {}
 
-        # clean out the disk cache
+        # the next run goes in a new store
+        if self._store is not None:
+            self._store.close()
+            self._store = None
+        self._num_runs += 1
+
+        # clean out the disk cache; a file that is still mapped may not
+        # go, on Windows, and is left for clean_up_cache at exit
         if os.path.isdir(self._cache_dir):
-            shutil.rmtree(self._cache_dir)
-        os.mkdir(self._cache_dir)
+            shutil.rmtree(self._cache_dir, ignore_errors=True)
+        if not os.path.isdir(self._cache_dir):
+            os.mkdir(self._cache_dir)
@@ -234,11 +234,16 @@ extension_names = ['cy_mover',
                    'cy_land_check',
                    'cy_grid_map',
                    'cy_shio_time',
+                   'cy_mover_chain',
+                   'cy_ensemble_runner',
+                   'cy_particle_file_writer',
+                   'cy_element_store',
                    ]
 
 cpp_files = ['RectGridVeL_c.cpp',
              'MemUtils.cpp',
              'Mover_c.cpp',
+             'LEBlock.cpp',
              'Replacements.cpp',
              'ClassID_c.cpp',
              'Random_c.cpp',
@@ -249,6 +254,7 @@ cpp_files = ['RectGridVeL_c.cpp',
              'RectUtils.cpp',
              'WindMover_c.cpp',
              'CompFunctions.cpp',
+             'CounterRandom.cpp',
              #'CMYLIST.cpp',
              #'GEOMETR2.cpp',
              'StringFunctions.cpp',
@@ -257,22 +263,38 @@ cpp_files = ['RectGridVeL_c.cpp',
              'CATSMover_c.cpp',
              'CurrentMover_c.cpp',
              'ComponentMover_c.cpp',
+             'AveragedWindSeries.cpp',
              'ShioTimeValue_c.cpp',
+             'YearDataStore.cpp',
              'ShioHeight.cpp',
+             'ShioHarmonics.cpp',
              'TriGridVel_c.cpp',
              'DagTree.cpp',
              'DagTreeIO.cpp',
+             'TriPointIndex.cpp',
              'ShioCurrent1.cpp',
              'ShioCurrent2.cpp',
              'GridCurrentMover_c.cpp',
              'GridWindMover_c.cpp',
              'CurrentCycleMover_c.cpp',
              'TimeGridVel_c.cpp',
+             'BlendedVelocityField.cpp',
              'TimeGridWind_c.cpp',
+             'TimeSlicePrefetcher.cpp',
+             'VelocitySliceCache.cpp',
+             'NetCDFFilePool.cpp',
              'MakeTriangles.cpp',
              'MakeDagTree.cpp',
              'GridMap_c.cpp',
              'GridMapUtils.cpp',
+             'RasterLandCheck.cpp',
+             'ShorelineIndex.cpp',
+             'TopologyCache.cpp',
+             'MoverChain.cpp',
+             'EnsembleRunner.cpp',
+             'ParticleFileWriter.cpp',
+             'ElementStore.cpp',
+             'UncertaintyArrays.cpp',
              'RandomVertical_c.cpp',
              'RiseVelocity_c.cpp',
              ]
@@ -316,13 +338,16 @@ static_lib_files = netcdf_lib_files
 #          lib_gnome in the following Extension.
 
 if sys.platform == "darwin":
+    # lib_gnome uses C++11 threads and atomics, from libc++ on darwin
+    compile_args = ['-std=c++11', '-stdlib=libc++', '-pthread']
+    link_args = ['-stdlib=libc++', '-pthread']
 
     basic_types_ext = Extension(r'gnome.cy_gnome.cy_basic_types',
             ['gnome/cy_gnome/cy_basic_types.pyx'] + cpp_files,
             language='c++',
             define_macros=macros,
             extra_compile_args=compile_args,
-            extra_link_args=['-lz', '-lcurl'],
+            extra_link_args=link_args + ['-lz', '-lcurl'],
             extra_objects=static_lib_files,
             include_dirs=include_dirs,
             )
@@ -335,7 +360,8 @@ elif sys.platform == "win32":
     macros.append(('_EXPORTS', 1))
     macros.append(('_CRT_SECURE_NO_WARNINGS', 1))
 
-    compile_args = ['/EHsc']
+    # /openmp lets the movers' get_move split the LEs across threads
+    compile_args = ['/EHsc', '/openmp']
 
     link_args.append('/MANIFEST')
 
@@ -383,6 +409,10 @@ elif sys.platform == "linux2":
                                  define_macros=macros,
                                  libraries=['netcdf'],
                                  include_dirs=[cpp_code_dir],
+                                 extra_compile_args=['-fopenmp',
+                                                     '-std=c++11',
+                                                     '-pthread'],
+                                 extra_link_args=['-fopenmp', '-pthread'],
                                  )])
 
     ## In install mode, it compiles and builds libgnome inside
@@ -460,7 +490,7 @@ setup(name='pyGnome',
       ext_modules=extensions,
       packages=find_packages(),
       package_dir={'gnome': 'gnome'},
-      package_data={'gnome': ['data/yeardata/*']},
+      package_data={'gnome': ['data/yeardata/#*']},
       requires=['numpy'],   # want other packages here?
       cmdclass={'build_ext': build_ext},
       #scripts,
@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+
+"""
+Time loading grids that have to be triangulated and have their DAG tree
+built, which is most of the time it takes to read a grid with no topology
+file. The synthetic grids are curvilinear grids of increasing size with a
+random land mask; the real ones are the sample grids.
+
+Any topology cache next to a grid is removed first, so every load builds
+the tree.
+
+Run from this directory after building py_gnome:
+
+python dag_tree_build.py [largest grid side]
+"""
+
+import os
+import sys
+import glob
+import time
+import tempfile
+
+import numpy as np
+import netCDF4
+
+from gnome.cy_gnome.cy_grid_map import CyGridMap
+from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.utilities.remote_data import get_datafile
+
+here = os.path.dirname(__file__)
+cur_dir = os.path.join(here, '..', 'unit_tests', 'sample_data', 'currents')
+
+largest_side = int(sys.argv[1]) if len(sys.argv) > 1 else 400
+
+
+def remove_topology_cache(grid_file):
+    for cache_file in glob.glob(os.path.join(os.path.dirname(grid_file),
+                                             'gnome_topology_*.bin')):
+        os.remove(cache_file)
+
+
+def write_curvilinear_grid(filename, num_rows, num_cols):
+    """
+    a slightly sheared grid with 15% of the cells land
+    """
+    rows, cols = np.mgrid[0:num_rows, 0:num_cols]
+    lat = 40. + .001 * rows + .0002 * np.sin(cols * .1)
+    lon = -74. + .001 * cols + .0002 * np.sin(rows * .1)
+    mask = (np.random.uniform(size=(num_rows, num_cols)) >= .15) * 1.
+
+    nc = netCDF4.Dataset(filename, 'w', format='NETCDF3_CLASSIC')
+    nc.grid_type = 'curvilinear'
+    nc.createDimension('y', num_rows)
+    nc.createDimension('x', num_cols)
+    for (name, values) in (('lat', lat), ('lon', lon), ('mask', mask)):
+        var = nc.createVariable(name, 'f8', ('y', 'x'))
+        var[:] = values
+    nc.close()
+
+
+def time_load(load, grid_file):
+    remove_topology_cache(grid_file)
+    start = time.time()
+    load(grid_file)
+    elapsed = time.time() - start
+    remove_topology_cache(grid_file)
+    return elapsed
+
+
+def load_map(grid_file):
+    CyGridMap().text_read(grid_file)
+
+
+def load_mover(grid_file):
+    CyGridCurrentMover().text_read(grid_file)
+
+
+temp_dir = tempfile.mkdtemp()
+side = 50
+while side <= largest_side:
+    grid_file = os.path.join(temp_dir, 'grid_{0}.nc'.format(side))
+    write_curvilinear_grid(grid_file, side, side)
+    print 'synthetic %d x %d grid:  %.3f s' % (side, side,
+                                              time_load(load_map, grid_file))
+    os.remove(grid_file)
+    side *= 2
+os.rmdir(temp_dir)
+
+for (filename, load) in (('ny_cg.nc', load_map),
+                         ('ChesBay.nc', load_mover)):
+    grid_file = get_datafile(os.path.join(cur_dir, filename))
+    print '%s:  %.3f s' % (filename, time_load(load, grid_file))
@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+
+"""
+Compare the batched GridCurrentMover_c get_move with the original per LE
+GetMove path.
+
+Run from this directory after building py_gnome:
+
+python gridcurrent_get_move.py [num_les]
+"""
+
+import os
+import sys
+import time
+import datetime
+
+import numpy as np
+
+from gnome.basic_types import world_point, status_code_type, \
+    spill_type, oil_status
+from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.utilities import time_utils
+from gnome.utilities.remote_data import get_datafile
+
+here = os.path.dirname(__file__)
+cur_dir = os.path.join(here, '..', 'unit_tests', 'sample_data', 'currents')
+
+# (grid file, topology file, model time, center of the spill)
+cases = [('test.cdf', None, datetime.datetime(1999, 11, 29, 21),
+          (3.104588, 52.016468)),
+         ('ny_cg.nc', 'NYTopology.dat', datetime.datetime(2008, 1, 29, 17),
+          (-74.03988, 40.536092)),
+         ('ChesBay.nc', 'ChesBay.dat', datetime.datetime(2004, 12, 31, 13),
+          (-76.149368, 37.74496)),
+         ]
+
+num_le = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+num_steps = 10
+time_step = 900
+
+
+def time_moves(gcm, model_time, ref, delta, status):
+    gcm.prepare_for_model_run()
+    start = time.time()
+    for i in range(num_steps):
+        gcm.prepare_for_model_step(model_time, time_step)
+        gcm.get_move(model_time, time_step, ref, delta, status,
+                     spill_type.forecast)
+        gcm.model_step_is_done()
+    return (time.time() - start) / num_steps
+
+
+for (filename, topology, model_time, position) in cases:
+    model_time = time_utils.date_to_sec(model_time)
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = position[0] + np.random.uniform(-.02, .02, num_le)
+    ref[:]['lat'] = position[1] + np.random.uniform(-.02, .02, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+
+    gcm = CyGridCurrentMover()
+    if topology is None:
+        gcm.text_read(get_datafile(os.path.join(cur_dir, filename)))
+    else:
+        gcm.text_read(get_datafile(os.path.join(cur_dir, filename)),
+                      get_datafile(os.path.join(cur_dir, topology)))
+
+    gcm.batched_get_move = False
+    per_le = np.zeros((num_le, ), dtype=world_point)
+    per_le_time = time_moves(gcm, model_time, ref, per_le, status)
+
+    gcm.batched_get_move = True
+    batched = np.zeros((num_le, ), dtype=world_point)
+    batched_time = time_moves(gcm, model_time, ref, batched, status)
+
+    print '%s, %d LEs:' % (filename, num_le)
+    print '    per LE get_move:  %.4f s/step' % per_le_time
+    print '    batched get_move: %.4f s/step' % batched_time
+    print '    speedup: %.2f, identical: %s' % (per_le_time / batched_time,
+                                                np.array_equal(per_le, batched))
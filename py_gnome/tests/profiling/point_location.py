@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+
+"""
+Compare point location with the DAG tree and with the bucket grid index
+on the triangle grids.
+
+Run from this directory after building py_gnome:
+
+python point_location.py [num_points]
+"""
+
+import os
+import sys
+import time
+
+import numpy as np
+
+from gnome.basic_types import world_point
+from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.utilities.remote_data import get_datafile
+
+here = os.path.dirname(__file__)
+cur_dir = os.path.join(here, '..', 'unit_tests', 'sample_data', 'currents')
+
+# (grid file, topology file, center of the points)
+cases = [('ChesBay.nc', 'ChesBay.dat', (-76.149368, 37.74496)),
+         ('ny_cg.nc', 'NYTopology.dat', (-74.03988, 40.536092)),
+         ]
+
+num_pts = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+num_repeats = 5
+
+
+def time_lookups(gcm, points, use_dag_tree):
+    start = time.time()
+    for i in range(num_repeats):
+        tri_indices = gcm.locate_triangles(points, use_dag_tree)
+    return ((time.time() - start) / num_repeats, tri_indices)
+
+
+for (filename, topology, position) in cases:
+    gcm = CyGridCurrentMover()
+    gcm.text_read(get_datafile(os.path.join(cur_dir, filename)),
+                  get_datafile(os.path.join(cur_dir, topology)))
+
+    points = np.zeros((num_pts, ), dtype=world_point)
+    points[:]['long'] = position[0] + np.random.uniform(-.2, .2, num_pts)
+    points[:]['lat'] = position[1] + np.random.uniform(-.2, .2, num_pts)
+
+    start = time.time()
+    gcm.use_point_index = True
+    build_time = time.time() - start
+
+    (dag_time, from_dag) = time_lookups(gcm, points, True)
+    (index_time, from_index) = time_lookups(gcm, points, False)
+
+    inside = from_dag >= 0
+    print '%s, %d points, %d inside the grid:' % (filename, num_pts,
+                                                  inside.sum())
+    print '    index build:  %.4f s' % build_time
+    print '    DAG tree:     %.2f M lookups/s' % (num_pts / dag_time / 1e6)
+    print '    bucket grid:  %.2f M lookups/s' % (num_pts / index_time / 1e6)
+    print '    speedup: %.2f, same triangles: %s' % (
+        dag_time / index_time,
+        np.array_equal(from_dag[inside], from_index[inside]))
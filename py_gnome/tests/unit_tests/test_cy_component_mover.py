@@ -10,6 +10,9 @@ import cy_fixtures
 
 from gnome.utilities.remote_data import get_datafile
 
+import pytest
+from pytest import raises
+
 datadir = os.path.join(os.path.dirname(__file__), r"sample_data")
 
 
@@ -131,6 +134,90 @@ def test_uncertain_move():
     assert np.all(tgt.u_delta['z'] == 0)
 
 
+def test_averaged_winds_move():
+    """
+    averaging a constant wind gives the same move at every step
+    """
+    tgt = ComponentMove()
+    tgt.component.use_averaged_winds = True
+    tgt.component.extrapolate_winds = True
+    tgt.component.prepare_for_model_run()
+
+    deltas = []
+    for step in range(3):
+        model_time = tgt.model_time + step * tgt.time_step
+        tgt.component.prepare_for_model_step(model_time, tgt.time_step)
+        tgt.delta[:] = (0, 0, 0)
+        tgt.component.get_move(model_time, tgt.time_step, tgt.ref,
+                               tgt.delta, tgt.status,
+                               basic_types.spill_type.forecast)
+        tgt.component.model_step_is_done()
+        deltas.append(tgt.delta.copy())
+
+    assert np.all(deltas[0]['lat'] != 0)
+    for delta in deltas[1:]:
+        assert np.all(delta == deltas[0])
+
+
+def test_averaged_winds_extrapolate():
+    """
+    averaging over hours before the wind data starts is an error unless
+    the winds may be extrapolated
+    """
+    tgt = ComponentMove()
+    ossm = cy_ossm_time.CyOSSMTime(filename=os.path.join(datadir,
+                                   'WindDataFromGnome.WND'),
+                                   file_contains=basic_types.ts_format.magnitude_direction)
+    tgt.component.set_ossm(ossm)
+    tgt.component.use_averaged_winds = True
+    model_time = ossm.timeseries['time'][0]
+
+    tgt.component.prepare_for_model_run()
+    with raises(OSError):
+        tgt.component.prepare_for_model_step(model_time, tgt.time_step)
+
+    tgt.component.extrapolate_winds = True
+    tgt.component.prepare_for_model_step(model_time, tgt.time_step)
+
+
+@pytest.mark.parametrize('time_step', (900, 901, 1000, 7 * 3600 + 1))
+def test_averaged_winds_per_hour(time_step):
+    """
+    the averaged wind is the mean, over each of the hours before the model
+    time, of the wind's component along pattern 1 -- the same whether the
+    time step has the hour in common with the step or only the second
+    """
+    np.random.seed(7)
+    start = 3600 * 24 * 365 * 30
+    tval = np.zeros((200, ), dtype=basic_types.time_value_pair)
+    tval['time'] = start + np.arange(200) * 1800 + np.random.randint(0, 900,
+                                                                      200)
+    tval['value']['u'] = np.random.uniform(-10, 10, 200)
+    tval['value']['v'] = np.random.uniform(-10, 10, 200)
+    ossm = cy_ossm_time.CyOSSMTime(timeseries=tval)
+
+    tgt = ComponentMove()
+    tgt.component.set_ossm(ossm)
+    tgt.component.use_averaged_winds = True
+    tgt.component.extrapolate_winds = True
+    tgt.component.past_hours_to_average = 5
+    theta = np.pi * -(0.5 + tgt.component.pat1_angle / 180.)
+    tgt.component.prepare_for_model_run()
+
+    model_time = start + 6 * 3600
+    while model_time < tval['time'][-1]:
+        tgt.component.prepare_for_model_step(model_time, time_step)
+        tgt.component.model_step_is_done()
+
+        hours = model_time - 5 * 3600 + np.arange(5) * 3600
+        wind = ossm.get_time_value(hours)
+        mean = np.mean(wind['u'] * np.cos(theta) + wind['v'] * np.sin(theta))
+        assert np.allclose(tgt.component.averaged_wind_component, mean,
+                           rtol=0, atol=1e-10)
+
+        model_time += time_step
+
+
 c_component = cy_component_mover.CyComponentMover()
 
 
@@ -0,0 +1,161 @@
+"""
+unit tests for the cython wrapper around ElementStore
+
+designed to be run with py.test
+"""
+
+import os
+
+import numpy as np
+
+from gnome.basic_types import world_point_type, status_code_type
+from gnome.cy_gnome.cy_element_store import CyElementStore
+
+import pytest
+
+
+def step_arrays(step):
+    num = 10 * step
+    positions = np.zeros((num, 3), dtype=world_point_type)
+    positions[:, 0] = np.arange(num)
+    positions[:, 1] = step
+
+    return {'positions': positions,
+            'status_codes': np.ones((num, ), dtype=status_code_type) * step,
+            'id': np.arange(num, dtype=np.uint32),
+            }
+
+
+def test_save_and_load(tmpdir):
+    store = CyElementStore()
+    store.create(os.path.join(str(tmpdir), 'elements.dat'))
+
+    for step in range(5):
+        store.save_step(step, False, step_arrays(step), step * 900.)
+        if step != 3:
+            store.save_step(step, True, step_arrays(step + 1))
+
+    assert store.has_step(3)
+    assert not store.has_step(3, True)
+    assert not store.has_step(5)
+    assert store.load_step(5) is None
+
+    # any step, in any order
+    for step in (4, 0, 2, 1):
+        data = store.load_step(step)
+        for name, arr in step_arrays(step).items():
+            assert data[name].dtype == arr.dtype
+            assert np.all(data[name] == arr)
+        assert store.time_stamp(step) == step * 900.
+        assert store.time_stamp(step, True) is None
+
+    data = store.load_step(1, True)
+    assert np.all(data['positions'] == step_arrays(2)['positions'])
+
+
+def test_loaded_arrays_are_mapped(tmpdir):
+    store = CyElementStore()
+    store.create(os.path.join(str(tmpdir), 'elements.dat'))
+    store.save_step(0, False, step_arrays(2))
+
+    data = store.load_step(0)
+    base = data['positions']
+    while not isinstance(base, np.memmap):
+        base = base.base
+    assert base.filename == store.filename
+
+    # copy on write: the store isn't changed
+    data['positions'] += 1
+    assert np.all(store.load_step(0)['positions'] ==
+                  step_arrays(2)['positions'])
+
+
+def test_exceptions(tmpdir):
+    store = CyElementStore()
+    with pytest.raises(IOError):
+        # not created yet
+        store.save_step(0, False, step_arrays(1))
+
+    store.create(os.path.join(str(tmpdir), 'elements.dat'))
+    with pytest.raises(TypeError):
+        store.save_step(0, False, {'mixed': np.zeros((3, ),
+                                                     dtype=object)})
+
+
+def test_reopen(tmpdir):
+    filename = os.path.join(str(tmpdir), 'elements.dat')
+    store = CyElementStore()
+    store.create(filename)
+    for step in range(3):
+        store.save_step(step, False, step_arrays(step), step * 900.)
+    store.save_step(1, True, step_arrays(4))
+    store.close()
+
+    store = CyElementStore()
+    store.open(filename)
+    assert store.has_step(2)
+    assert store.has_step(1, True)
+    assert not store.has_step(0, True)
+    assert store.time_stamp(1) == 900.
+    for name, arr in step_arrays(4).items():
+        assert np.all(store.load_step(1, True)[name] == arr)
+
+    with pytest.raises(IOError):
+        # opened read only
+        store.save_step(3, False, step_arrays(3))
+
+    # another store can add steps after the ones the file had
+    writer = CyElementStore()
+    writer.open(filename, read_only=False)
+    writer.save_step(3, False, step_arrays(3))
+    writer.close()
+
+    store.open(filename)
+    for step in range(4):
+        for name, arr in step_arrays(step).items():
+            assert np.all(store.load_step(step)[name] == arr)
+    assert store.time_stamp(3) is None
+
+
+def test_open_after_cut_off_step(tmpdir):
+    """
+    a step whose record never made it to the file is lost, the steps
+    before it aren't, and the next step goes where it was
+    """
+    filename = os.path.join(str(tmpdir), 'elements.dat')
+    store = CyElementStore()
+    store.create(filename)
+    for step in range(3):
+        store.save_step(step, False, step_arrays(step))
+    store.save_step(1, False, step_arrays(5))
+    file_size = store.file_size
+    store.close()
+
+    # as if the writer died part way through the next step's block
+    with open(filename, 'ab') as f:
+        f.write(b'\1' * 5000)
+
+    store.open(filename, read_only=False)
+    assert store.file_size == file_size
+    assert not store.has_step(3)
+    for name, arr in step_arrays(5).items():
+        assert np.all(store.load_step(1)[name] == arr)
+
+    store.save_step(3, False, step_arrays(3))
+    store.close()
+
+    store.open(filename)
+    for step in (0, 2, 3):
+        for name, arr in step_arrays(step).items():
+            assert np.all(store.load_step(step)[name] == arr)
+
+
+def test_open_not_a_store(tmpdir):
+    filename = os.path.join(str(tmpdir), 'elements.dat')
+    with open(filename, 'wb') as f:
+        f.write(b'\0' * 100)
+
+    store = CyElementStore()
+    with pytest.raises(IOError):
+        store.open(filename)
+    assert not store.is_open
@@ -0,0 +1,263 @@
+"""
+unit tests for the cython wrapper around EnsembleRunner
+
+designed to be run with py.test
+"""
+
+import os
+import datetime
+
+import numpy as np
+
+from gnome.basic_types import (spill_type, world_point, oil_status,
+                               status_code_type)
+
+from gnome.cy_gnome.cy_random_mover import CyRandomMover
+from gnome.cy_gnome.cy_cats_mover import CyCatsMover
+from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.cy_gnome.cy_wind_mover import CyWindMover
+from gnome.cy_gnome.cy_mover_chain import CyMoverChain
+from gnome.cy_gnome.cy_ensemble_runner import CyEnsembleRunner
+
+from gnome.utilities import time_utils
+from gnome.utilities.remote_data import get_datafile
+
+import pytest
+
+here = os.path.dirname(__file__)
+cur_dir = os.path.join(here, 'sample_data', 'currents')
+
+num_le = 1000
+time_step = 900
+
+
+def elements(lon, lat):
+    np.random.seed(1)
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref['long'] = lon + np.random.uniform(-.005, .005, num_le)
+    ref['lat'] = lat + np.random.uniform(-.005, .005, num_le)
+
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[::9] = oil_status.on_land
+
+    return (ref, status)
+
+
+def chain_move(movers, model_time, ref, status, sp_type):
+    """
+    the template movers moving the elements themselves
+    """
+    chain = CyMoverChain()
+    for m in movers:
+        m.prepare_for_model_run()
+        chain.add_mover(m)
+    if sp_type == spill_type.uncertainty:
+        chain.prepare_for_model_step(model_time, time_step, 1,
+                                     np.array((num_le, ), dtype=np.int32))
+    else:
+        chain.prepare_for_model_step(model_time, time_step)
+
+    next_positions = ref.copy()
+    chain.get_move(model_time, time_step, ref, next_positions, None, None,
+                   status, sp_type)
+    return next_positions
+
+
+def ensemble_move(movers, seeds, model_time, ref, status, sp_type):
+    runner = CyEnsembleRunner()
+    for m in movers:
+        runner.add_mover(m)
+
+    next_positions = []
+    for seed in seeds:
+        member = runner.add_member(seed)
+        next_positions.append(ref.copy())
+        runner.set_member_elements(member, ref, next_positions[-1], status)
+    assert len(runner) == len(seeds)
+
+    runner.prepare_for_model_run()
+    runner.step(model_time, time_step, sp_type)
+    return next_positions
+
+
+@pytest.mark.parametrize("sp_type", [spill_type.forecast,
+                                     spill_type.uncertainty])
+def test_random_members(sp_type):
+    """
+    a member moves as the template does with the member's seed for it,
+    the others move differently
+    """
+    model_time = 1345467600
+    (ref, status) = elements(-72, 41)
+    rand = CyRandomMover(diffusion_coef=100000)
+    rand.seed = CyEnsembleRunner.mover_seed(3, 0)
+
+    expected = chain_move([rand], model_time, ref, status, sp_type)
+    members = ensemble_move([rand], [3, 4, 5], model_time, ref, status,
+                            sp_type)
+
+    assert np.all(members[0] == expected)
+    assert np.all(members[1][::9] == ref[::9])
+    assert np.any(members[1]['lat'] != members[0]['lat'])
+    assert np.any(members[2]['lat'] != members[1]['lat'])
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize("sp_type", [spill_type.forecast,
+                                     spill_type.uncertainty])
+def test_grid_current_members(sp_type):
+    """
+    the members share the current mover's grid, and move their elements as
+    the mover itself does
+    """
+    time = datetime.datetime(2008, 1, 29, 17)
+    model_time = time_utils.date_to_sec(time)
+    (ref, status) = elements(-74.03988, 40.536092)
+
+    gcm = CyGridCurrentMover()
+    gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                  get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+    rand = CyRandomMover(diffusion_coef=10000)
+    rand.seed = CyEnsembleRunner.mover_seed(3, 1)
+
+    expected = chain_move([gcm, rand], model_time, ref, status, sp_type)
+    members = ensemble_move([gcm, rand], [3, 3, 8], model_time, ref, status,
+                            sp_type)
+
+    assert np.any(expected['lat'] != ref['lat'])
+    assert np.all(members[0] == members[1])
+    assert np.any(members[2]['lat'] != members[0]['lat'])
+    if sp_type == spill_type.forecast:
+        # the current mover's uncertainty draws don't come into it
+        assert np.allclose(members[0]['lat'], expected['lat'], 0, 1e-12)
+        assert np.allclose(members[0]['long'], expected['long'], 0, 1e-12)
+
+
+@pytest.mark.slow
+def test_members_share_grid():
+    """
+    the members' copies of a gridded mover hold on to its one time grid,
+    which outlives the runner
+    """
+    gcm = CyGridCurrentMover()
+    gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                  get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+    assert gcm.num_grid_owners == 1
+
+    runner = CyEnsembleRunner()
+    runner.add_mover(gcm)
+    for seed in range(5):
+        runner.add_member(seed)
+    assert gcm.num_grid_owners == 6
+
+    del runner
+    assert gcm.num_grid_owners == 1
+
+    time = datetime.datetime(2008, 1, 29, 17)
+    (ref, status) = elements(-74.03988, 40.536092)
+    next_positions = chain_move([gcm], time_utils.date_to_sec(time), ref,
+                                status, spill_type.forecast)
+    assert np.any(next_positions['lat'] != ref['lat'])
+
+
+@pytest.mark.parametrize("sp_type", [spill_type.forecast,
+                                     spill_type.uncertainty])
+def test_wind_members(sp_type):
+    """
+    the wind mover's members blow the elements as the mover does, and have
+    their own uncertainty
+    """
+    model_time = 1345467600
+    (ref, status) = elements(-72, 41)
+    windages = np.linspace(.01, .04, num_le)
+
+    wm = CyWindMover()
+    wm.set_constant_wind(5., 5.)
+    runner = CyEnsembleRunner()
+    runner.add_mover(wm)
+
+    next_positions = []
+    for seed in (3, 4):
+        member = runner.add_member(seed)
+        next_positions.append(ref.copy())
+        runner.set_member_elements(member, ref, next_positions[-1], status,
+                                   windages)
+    runner.prepare_for_model_run()
+    runner.step(model_time, time_step, sp_type)
+
+    wm.prepare_for_model_run()
+    chain = CyMoverChain()
+    chain.add_mover(wm)
+    if sp_type == spill_type.uncertainty:
+        chain.prepare_for_model_step(model_time, time_step, 1,
+                                     np.array((num_le, ), dtype=np.int32))
+    else:
+        chain.prepare_for_model_step(model_time, time_step)
+    expected = ref.copy()
+    chain.get_move(model_time, time_step, ref, expected, windages, None,
+                   status, sp_type)
+
+    assert np.any(expected['lat'] != ref['lat'])
+    if sp_type == spill_type.forecast:
+        assert np.all(next_positions[0] == expected)
+        assert np.all(next_positions[1] == expected)
+    else:
+        assert np.any(next_positions[0]['lat'] != next_positions[1]['lat'])
+
+
+def test_mover_seeds():
+    """
+    the movers of a member, and the same mover in different members, are
+    all seeded differently
+    """
+    seeds = [CyEnsembleRunner.mover_seed(seed, index)
+             for seed in range(1, 11) for index in range(4)]
+
+    assert len(set(seeds)) == len(seeds)
+    assert CyEnsembleRunner.mover_seed(3, 1) == \
+        CyEnsembleRunner.mover_seed(3, 1)
+
+
+def test_members_draw_apart():
+    """
+    the copies of two random movers on different streams, in members with
+    the same seed, don't make the same moves
+    """
+    model_time = 1345467600
+    (ref, status) = elements(-72, 41)
+
+    rand1 = CyRandomMover(diffusion_coef=100000)
+    rand2 = CyRandomMover(diffusion_coef=100000)
+    rand2.random_stream = 1
+    moves = []
+    for rand in (rand1, rand2):
+        next_positions = ensemble_move([rand], [7], model_time, ref, status,
+                                       spill_type.forecast)[0]
+        moves.append(next_positions['lat'] - ref['lat'])
+
+    in_water = status == oil_status.in_water
+    assert abs(np.corrcoef(moves[0][in_water],
+                           moves[1][in_water])[0, 1]) < .15
+
+
+def test_exceptions():
+    (ref, status) = elements(-72, 41)
+
+    runner = CyEnsembleRunner()
+    runner.add_mover(CyCatsMover())
+    with pytest.raises(ValueError):
+        runner.add_member(1)
+    assert len(runner) == 0
+
+    runner = CyEnsembleRunner()
+    runner.add_mover(CyRandomMover())
+    runner.add_member(1)
+    with pytest.raises(ValueError):
+        runner.add_mover(CyRandomMover())
+
+    with pytest.raises(ValueError):
+        runner.set_member_elements(0, ref, ref[:-1].copy(), status)
+
+    with pytest.raises(IndexError):
+        runner.set_member_elements(1, ref, ref.copy(), status)
@@ -5,13 +5,40 @@ designed to be run with py.test
 """
 
 import os
-from gnome.cy_gnome.cy_grid_map import CyGridMap
+import glob
+
+import numpy as np
+
+from gnome.cy_gnome import cy_helpers
+from gnome.cy_gnome.cy_grid_map import CyGridMap, make_dag_tree
 from gnome.utilities.remote_data import get_datafile
 
 import pytest
 
 here = os.path.dirname(__file__)
 cur_dir = os.path.join(here, 'sample_data', 'currents')
+dag_dir = os.path.join(here, 'sample_data', 'dag_tree')
+
+
+def test_make_dag_tree_reference():
+    """
+    The DAG tree of a curvilinear grid with land cells is the one the
+    builder made before it was rewritten -- branch for branch, so points
+    are found in the same triangles as they were. The second build checks
+    nothing is carried over from the first.
+    """
+    points = np.loadtxt(os.path.join(dag_dir, 'grid_points.txt'),
+                        dtype=np.int_)
+    triangles = np.loadtxt(os.path.join(dag_dir, 'grid_triangles.txt'),
+                           dtype=np.int_)
+    reference = np.loadtxt(os.path.join(dag_dir, 'grid_dag_reference.txt'),
+                           dtype=np.int_)
+
+    for i in range(2):
+        tree = make_dag_tree(points, triangles)
+
+        assert tree.shape == reference.shape
+        assert np.all(tree == reference)
 
 
 # def test_exceptions():
@@ -45,6 +72,61 @@ class TestGridMap:
         netcdf_file = os.path.join(cur_dir, 'ny_cg_top.nc')
         gcm1.save_netcdf(netcdf_file)
 
+    def test_grid_map_curv_topology_cache(self):
+        """
+        The second read of a curvilinear grid comes from the topology
+        cache, and has to give the same grid as the first
+        """
+
+        grid_map_file = get_datafile(os.path.join(cur_dir, 'ny_cg.nc'))
+        for cache_file in glob.glob(os.path.join(cur_dir,
+                                                 'gnome_topology_*.bin')):
+            os.remove(cache_file)
+
+        topology_files = []
+        for i in range(2):
+            gcm = CyGridMap()
+            gcm.text_read(grid_map_file)
+            assert len(glob.glob(os.path.join(cur_dir,
+                                              'gnome_topology_*.bin'))) == 1
+
+            topology_files.append(os.path.join(cur_dir,
+                                               'ny_cg_top{0}.dat'.format(i)))
+            gcm.export_topology(topology_files[-1])
+
+        with open(topology_files[0]) as built:
+            with open(topology_files[1]) as cached:
+                assert built.read() == cached.read()
+
+    def test_grid_map_curv_topology_cache_dir(self, tmpdir):
+        """
+        With a cache directory set, the topology file is written there and
+        not next to the grid, and with the cache off none is written
+        """
+        grid_map_file = get_datafile(os.path.join(cur_dir, 'ny_cg.nc'))
+        for cache_file in glob.glob(os.path.join(cur_dir,
+                                                 'gnome_topology_*.bin')):
+            os.remove(cache_file)
+
+        try:
+            cy_helpers.set_topology_cache_dir(str(tmpdir))
+            assert cy_helpers.get_topology_cache_dir() == str(tmpdir)
+            for i in range(2):
+                CyGridMap().text_read(grid_map_file)
+                assert len(tmpdir.listdir('gnome_topology_*.bin')) == 1
+                assert not glob.glob(os.path.join(cur_dir,
+                                                  'gnome_topology_*.bin'))
+
+            tmpdir.listdir('gnome_topology_*.bin')[0].remove()
+            cy_helpers.set_topology_cache_enabled(False)
+            CyGridMap().text_read(grid_map_file)
+            assert not tmpdir.listdir('gnome_topology_*.bin')
+        finally:
+            cy_helpers.set_topology_cache_enabled(True)
+            cy_helpers.set_topology_cache_dir(None)
+
+        assert cy_helpers.get_topology_cache_dir() is None
+
     def test_grid_map_tri(self):
         """
         Test a grid map - read and write out
@@ -8,9 +8,10 @@ import os
 import numpy as np
 
 from gnome.basic_types import world_point, status_code_type, \
-    spill_type, oil_status
+    spill_type, oil_status, velocity_blend
 
 from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.cy_gnome import cy_helpers
 
 from gnome.utilities import time_utils
 from gnome.utilities.remote_data import get_datafile
@@ -565,6 +566,336 @@ class TestGridCurrentMover:
         np.all(self.cm.delta['z'] == 0)
 
 
+@pytest.mark.slow
+@pytest.mark.parametrize(('filename', 'topology', 'time', 'position'), [
+    ('test.cdf', None, datetime.datetime(1999, 11, 29, 21),
+     (3.104588, 52.016468)),
+    ('ny_cg.nc', 'NYTopology.dat', datetime.datetime(2008, 1, 29, 17),
+     (-74.03988, 40.536092)),
+    ('ChesBay.nc', 'ChesBay.dat', datetime.datetime(2004, 12, 31, 13),
+     (-76.149368, 37.74496)),
+    ])
+def test_batched_get_move(filename, topology, time, position):
+    """
+    the batched get_move must give exactly the same deltas as calling
+    GetMove for each LE
+    """
+    num_le = 100
+    model_time = time_utils.date_to_sec(time)
+    time_step = 900
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = position[0] + np.linspace(-.01, .01, num_le)
+    ref[:]['lat'] = position[1] + np.linspace(-.01, .01, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[::10] = oil_status.on_land
+
+    gcm = CyGridCurrentMover()
+    if topology is None:
+        gcm.text_read(get_datafile(os.path.join(cur_dir, filename)))
+    else:
+        gcm.text_read(get_datafile(os.path.join(cur_dir, filename)),
+                      get_datafile(os.path.join(cur_dir, topology)))
+
+    deltas = []
+    for batched in (True, False):
+        gcm.batched_get_move = batched
+        delta = np.zeros((num_le, ), dtype=world_point)
+        gcm.prepare_for_model_run()
+        gcm.prepare_for_model_step(model_time, time_step)
+        gcm.get_move(model_time, time_step, ref, delta, status,
+                     spill_type.forecast)
+        gcm.model_step_is_done()
+        deltas.append(delta)
+
+    assert np.any(deltas[0]['lat'] != 0)
+    assert np.all(deltas[0][::10]['lat'] == 0)
+    assert np.array_equal(deltas[0], deltas[1])
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize('batched', [True, False])
+def test_threaded_get_move(batched):
+    """
+    splitting the LEs across threads must not change the deltas
+    """
+    num_le = 1000
+    model_time = time_utils.date_to_sec(datetime.datetime(2008, 1, 29, 17))
+    time_step = 900
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = -74.03988 + np.linspace(-.01, .01, num_le)
+    ref[:]['lat'] = 40.536092 + np.linspace(-.01, .01, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[::10] = oil_status.on_land
+
+    gcm = CyGridCurrentMover()
+    gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                  get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+    gcm.batched_get_move = batched
+
+    deltas = []
+    for num_threads in (1, 4):
+        gcm.num_threads = num_threads
+        assert gcm.num_threads == num_threads
+        delta = np.zeros((num_le, ), dtype=world_point)
+        gcm.prepare_for_model_run()
+        gcm.prepare_for_model_step(model_time, time_step)
+        gcm.get_move(model_time, time_step, ref, delta, status,
+                     spill_type.forecast)
+        gcm.model_step_is_done()
+        deltas.append(delta)
+
+    assert np.any(deltas[0]['lat'] != 0)
+    assert np.array_equal(deltas[0], deltas[1])
+
+
+
+@pytest.mark.slow
+def test_prefetch_next_slice():
+    """
+    reading the next slice in the background must give the same moves as
+    reading it when the interval changes
+    """
+    num_le = 100
+    start_time = time_utils.date_to_sec(datetime.datetime(2008, 1, 29, 17))
+    time_step = 1800
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = -74.03988 + np.linspace(-.01, .01, num_le)
+    ref[:]['lat'] = 40.536092 + np.linspace(-.01, .01, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+
+    deltas = []
+    for prefetch in (False, True):
+        gcm = CyGridCurrentMover()
+        gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                      get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+        gcm.prefetch_next_slice = prefetch
+        assert gcm.prefetch_next_slice == prefetch
+
+        gcm.prepare_for_model_run()
+        steps = []
+        for i in range(6):
+            model_time = start_time + i * time_step
+            delta = np.zeros((num_le, ), dtype=world_point)
+            gcm.prepare_for_model_step(model_time, time_step)
+            gcm.get_move(model_time, time_step, ref, delta, status,
+                         spill_type.forecast)
+            gcm.model_step_is_done()
+            steps.append(delta)
+        deltas.append(steps)
+
+        (hits, misses, stalls) = gcm.get_prefetch_counts()
+        if prefetch:
+            # the first interval can never come from the background read
+            assert misses >= 1
+            assert stalls <= hits
+        else:
+            assert (hits, misses, stalls) == (0, 0, 0)
+
+    for (delta, prefetched) in zip(*deltas):
+        assert np.array_equal(delta, prefetched)
+
+
+def test_slice_cache():
+    """
+    a second run over the same file takes its slices from the cache and
+    gives the same moves, a budget too small for one slice caches nothing
+    """
+    num_le = 10
+    start_time = time_utils.date_to_sec(datetime.datetime(2008, 1, 29, 17))
+    time_step = 1800
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = -74.03988 + np.linspace(-.01, .01, num_le)
+    ref[:]['lat'] = 40.536092 + np.linspace(-.01, .01, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+
+    def run():
+        gcm = CyGridCurrentMover()
+        gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                      get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+        gcm.prepare_for_model_run()
+        steps = []
+        for i in range(4):
+            model_time = start_time + i * time_step
+            delta = np.zeros((num_le, ), dtype=world_point)
+            gcm.prepare_for_model_step(model_time, time_step)
+            gcm.get_move(model_time, time_step, ref, delta, status,
+                         spill_type.forecast)
+            gcm.model_step_is_done()
+            steps.append(delta)
+        return steps
+
+    try:
+        cy_helpers.set_slice_cache_budget(64)
+        cy_helpers.clear_slice_cache()
+
+        first = run()
+        stats = cy_helpers.get_slice_cache_stats()
+        assert stats['hits'] == 0
+        assert stats['slices'] == stats['misses'] > 0
+
+        second = run()
+        assert cy_helpers.get_slice_cache_stats()['hits'] > 0
+        for (delta, cached) in zip(first, second):
+            assert np.array_equal(delta, cached)
+
+        cy_helpers.set_slice_cache_budget(1e-6)
+        stats = cy_helpers.get_slice_cache_stats()
+        assert stats['slices'] == 0
+        assert stats['evictions'] > 0
+    finally:
+        cy_helpers.set_slice_cache_budget(0)
+        cy_helpers.clear_slice_cache()
+
+
+@pytest.mark.parametrize(('filename', 'topology', 'position'),
+                         [('ChesBay.nc', 'ChesBay.dat', (-76.149368, 37.74496)),
+                          ('ny_cg.nc', 'NYTopology.dat', (-74.03988, 40.536092))])
+def test_point_index(filename, topology, position):
+    """
+    the bucket grid finds the same triangles as the DAG tree
+    """
+    gcm = CyGridCurrentMover()
+    gcm.text_read(get_datafile(os.path.join(cur_dir, filename)),
+                  get_datafile(os.path.join(cur_dir, topology)))
+
+    assert not gcm.use_point_index
+    gcm.use_point_index = True
+    assert gcm.use_point_index
+
+    np.random.seed(2)
+    num_pts = 1000
+    points = np.zeros((num_pts, ), dtype=world_point)
+    points[:]['long'] = position[0] + np.random.uniform(-.5, .5, num_pts)
+    points[:]['lat'] = position[1] + np.random.uniform(-.5, .5, num_pts)
+
+    from_dag = gcm.locate_triangles(points, use_dag_tree=True)
+    from_index = gcm.locate_triangles(points)
+
+    # the DAG tree flags some points outside the grid with -8
+    assert np.array_equal(from_dag < 0, from_index < 0)
+    inside = from_dag >= 0
+    assert inside.any()
+    assert np.array_equal(from_dag[inside], from_index[inside])
+
+
+@pytest.mark.parametrize(('filename', 'topology', 'time', 'position'), [
+    ('ny_cg.nc', 'NYTopology.dat', datetime.datetime(2008, 1, 29, 17),
+     (-74.03988, 40.536092)),
+    ('ChesBay.nc', 'ChesBay.dat', datetime.datetime(2004, 12, 31, 13),
+     (-76.149368, 37.74496)),
+    ])
+def test_walk_from_last_triangle(filename, topology, time, position):
+    """
+    starting the triangle search from each LE's last triangle moves the LEs
+    the same as searching the whole grid every step
+    """
+    num_le = 100
+    start_time = time_utils.date_to_sec(time)
+    time_step = 900
+
+    tracks = []
+    for walk in (False, True):
+        gcm = CyGridCurrentMover()
+        gcm.text_read(get_datafile(os.path.join(cur_dir, filename)),
+                      get_datafile(os.path.join(cur_dir, topology)))
+        assert gcm.walk_from_last_triangle
+        gcm.walk_from_last_triangle = walk
+
+        ref = np.zeros((num_le, ), dtype=world_point)
+        ref[:]['long'] = position[0] + np.linspace(-.01, .01, num_le)
+        ref[:]['lat'] = position[1] + np.linspace(-.01, .01, num_le)
+        status = np.empty((num_le, ), dtype=status_code_type)
+        status[:] = oil_status.in_water
+
+        gcm.prepare_for_model_run()
+        steps = []
+        for i in range(8):
+            model_time = start_time + i * time_step
+            delta = np.zeros((num_le, ), dtype=world_point)
+            gcm.prepare_for_model_step(model_time, time_step)
+            gcm.get_move(model_time, time_step, ref, delta, status,
+                         spill_type.forecast)
+            gcm.model_step_is_done()
+            for key in ('long', 'lat'):
+                ref[:][key] += delta[:][key]
+            steps.append(delta)
+        tracks.append(steps)
+
+    assert np.any(tracks[0][0]['lat'] != 0)
+    for (searched, walked) in zip(*tracks):
+        assert np.array_equal(searched, walked)
+
+
+@pytest.mark.parametrize(('files', 'time', 'position'), [
+    (('test.cdf', ), datetime.datetime(1999, 11, 29, 21),
+     (3.104588, 52.016468)),
+    (('ny_cg.nc', 'NYTopology.dat'), datetime.datetime(2008, 1, 29, 17),
+     (-74.03988, 40.536092)),
+    ])
+def test_velocity_blend_mode(files, time, position):
+    """
+    blending the loaded interval once for the step, by tile or for the
+    whole grid, moves the LEs the same as blending for each LE
+    """
+    num_le = 100
+    start_time = time_utils.date_to_sec(time)
+    time_step = 900
+
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref[:]['long'] = position[0] + np.linspace(-.01, .01, num_le)
+    ref[:]['lat'] = position[1] + np.linspace(-.01, .01, num_le)
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+
+    def run(mode, max_values_per_le=1e9):
+        gcm = CyGridCurrentMover()
+        gcm.text_read(*[get_datafile(os.path.join(cur_dir, f))
+                        for f in files])
+        assert gcm.velocity_blend_mode == velocity_blend.tiles
+        gcm.velocity_blend_mode = mode
+        gcm.max_blended_values_per_le = max_values_per_le
+
+        gcm.prepare_for_model_run()
+        steps = []
+        for i in range(4):
+            model_time = start_time + i * time_step
+            delta = np.zeros((num_le, ), dtype=world_point)
+            gcm.prepare_for_model_step(model_time, time_step)
+            gcm.get_move(model_time, time_step, ref, delta, status,
+                         spill_type.forecast)
+            gcm.model_step_is_done()
+            steps.append(delta)
+        return (steps, gcm.get_blended_tile_counts())
+
+    (per_le, counts) = run(velocity_blend.per_le)
+    assert counts[1] == 0
+    assert np.any(per_le[0]['lat'] != 0)
+
+    (tiles, (num_tiles, num_blended)) = run(velocity_blend.tiles)
+    assert 0 < num_blended <= num_tiles
+
+    (grid, (num_tiles, num_blended)) = run(velocity_blend.grid)
+    assert 0 < num_blended == num_tiles
+
+    # a grid with more values than allowed for 100 LEs falls back to per LE
+    (fallback, counts) = run(velocity_blend.grid, max_values_per_le=1)
+    assert counts[1] == 0
+
+    for steps in (tiles, grid, fallback):
+        for (delta, blended) in zip(per_le, steps):
+            for key in ('long', 'lat'):
+                assert np.allclose(delta[key], blended[key], rtol=1e-12,
+                                   atol=0)
+
+
 if __name__ == '__main__':
     tgc = TestGridCurrentMover()
     tgc.test_move_reg()
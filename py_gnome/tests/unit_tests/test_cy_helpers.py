@@ -91,6 +91,45 @@ class TestCyDateTime:
         assert tgt == act
 
 
+def test_handle_pool():
+    """
+    handles made and disposed of over and over come back from the pool
+    instead of the heap, and growing within a size class stays in place
+    """
+    assert cy_helpers.get_handle_pool_enabled()
+
+    cy_helpers.trim_handle_pool()
+    cy_helpers.reset_handle_pool_stats()
+    cy_helpers._churn_handles(100, 100)
+    stats = cy_helpers.get_handle_pool_stats()
+
+    assert stats['allocations'] == 100
+    assert stats['frees'] == 100
+    assert stats['resizes'] == 100
+    assert stats['resizes_in_place'] > 0
+    assert stats['reused'] >= 98
+    assert stats['system_allocations'] <= 2
+
+    cy_helpers.trim_handle_pool()
+    trimmed = cy_helpers.get_handle_pool_stats()
+    assert trimmed['bytes_reserved'] <= stats['bytes_reserved']
+
+
+def test_handle_pool_disabled():
+    try:
+        cy_helpers.set_handle_pool_enabled(False)
+        assert not cy_helpers.get_handle_pool_enabled()
+
+        cy_helpers.reset_handle_pool_stats()
+        cy_helpers._churn_handles(10, 100)
+        stats = cy_helpers.get_handle_pool_stats()
+
+        assert stats['reused'] == 0
+        assert stats['resizes_in_place'] == 0
+    finally:
+        cy_helpers.set_handle_pool_enabled(True)
+
+
 if __name__ == '__main__':
     a = TestCyDateTime()
     a.test_date_to_sec()
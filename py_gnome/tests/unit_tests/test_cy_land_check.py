@@ -14,7 +14,11 @@ Designed to be run with py.test
 import pytest
 
 import numpy as np
-from gnome.cy_gnome.cy_land_check import overlap_grid, find_first_pixel
+from gnome.basic_types import oil_status, world_point_type
+from gnome.cy_gnome.cy_land_check import (overlap_grid, find_first_pixel,
+                                          check_land, beach_elements,
+                                          CyRasterLandCheck)
+from gnome.utilities.projections import GeoProjection
 
 
 class Test_overlap_grid:
@@ -231,6 +235,84 @@ def test_points_outside_grid(
     assert result[0] == prev_pt
     assert result[1] == hit_pt
 
+def test_beach_elements_matches_pixels():
+    """
+    beaching (long, lat) positions in one call gives the same result as
+    projecting to pixels, check_land, and projecting back
+    """
+    (w, h) = (40, 30)
+    raster = np.zeros((w, h), dtype=np.uint8)
+    raster[20, :] = 1
+    raster[:, 5] = 1
+    raster[30:35, 20:25] = 1
+
+    proj = GeoProjection(((-10., 40.), (-6., 43.)), (w, h))
+
+    np.random.seed(1)
+    num_le = 500
+    bounds = np.array(((-11., 39.), (-5., 44.)))
+    start = np.zeros((num_le, 3), dtype=world_point_type)
+    end = np.zeros((num_le, 3), dtype=world_point_type)
+    for pos in (start, end):
+        pos[:, :2] = bounds[0] + (np.random.random((num_le, 2)) *
+                                  (bounds[1] - bounds[0]))
+    # don't start on land
+    start_pixel = proj.to_pixel(start, asint=True)
+    on_grid = np.all((start_pixel >= 0) & (start_pixel < (w, h)), axis=1)
+    start = start[~on_grid |
+                  (raster[np.clip(start_pixel[:, 0], 0, w - 1),
+                          np.clip(start_pixel[:, 1], 0, h - 1)] == 0)]
+    end = end[:len(start)]
+    num_le = len(start)
+
+    status = np.empty((num_le,), dtype=np.int16)
+    status[:] = oil_status.in_water
+    status[:10] = oil_status.on_land
+    last_water = start.copy()
+
+    # the pixel pipeline, as RasterMap does it for other projections
+    start_pixel = proj.to_pixel(start, asint=True)
+    end_pixel = proj.to_pixel(end, asint=True)
+    last_water_pixel = proj.to_pixel(last_water, asint=True)
+    pixel_status = status.copy()
+    check_land(raster, start_pixel, end_pixel, pixel_status, last_water_pixel)
+    beached = pixel_status == oil_status.on_land
+    pixel_end = end.copy()
+    pixel_end[beached, :2] = proj.to_lonlat(end_pixel[beached])
+    pixel_last_water = last_water.copy()
+    pixel_last_water[beached, :2] = proj.to_lonlat(last_water_pixel[beached])
+
+    beach_elements(raster, proj, start, end, status, last_water)
+
+    assert np.sum(beached) > 10
+    assert np.all(status == pixel_status)
+    assert np.all(end == pixel_end)
+    assert np.all(last_water == pixel_last_water)
+
+
+def test_raster_land_check_levels():
+    """
+    skipping the blocks with no land nearby finds the same pixels as
+    walking every one
+    """
+    (w, h) = (300, 200)
+    raster = np.zeros((w, h), dtype=np.uint8)
+    raster[150:160, 100:103] = 1
+    raster[40, :] = 1
+    raster[200:300, 190:] = 1
+    raster[77, 33] = 1
+
+    land_check = CyRasterLandCheck(raster)
+    assert land_check.num_levels == 9
+
+    np.random.seed(2)
+    for i in range(2000):
+        pt1, pt2 = [tuple(p) for p in np.random.randint(-50, 350, (2, 2))]
+
+        assert (land_check.find_first_pixel(pt1, pt2) ==
+                find_first_pixel(raster, pt1, pt2))
+
+
 # def test_outside_raster(self):
 #         """
 #         test LEs starting form outside the raster bounds
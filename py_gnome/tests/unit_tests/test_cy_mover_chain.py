@@ -0,0 +1,220 @@
+"""
+unit tests for the cython wrapper around MoverChain
+
+designed to be run with py.test
+"""
+
+import os
+import datetime
+
+import numpy as np
+
+from gnome.basic_types import (spill_type, world_point, time_value_pair,
+                               oil_status, status_code_type, velocity_blend)
+from gnome.utilities import time_utils
+from gnome.utilities.remote_data import get_datafile
+
+from gnome.cy_gnome.cy_ossm_time import CyOSSMTime
+from gnome.cy_gnome.cy_gridcurrent_mover import CyGridCurrentMover
+from gnome.cy_gnome.cy_wind_mover import CyWindMover
+from gnome.cy_gnome.cy_random_mover import CyRandomMover
+from gnome.cy_gnome.cy_rise_velocity_mover import CyRiseVelocityMover
+from gnome.cy_gnome.cy_mover_chain import CyMoverChain
+
+import pytest
+
+here = os.path.dirname(__file__)
+cur_dir = os.path.join(here, 'sample_data', 'currents')
+
+# as kMoverChainBlockLEs in MoverChain.h, and kMinLEsPerThread in
+# ForEachLE.h over it
+block_les = 4096
+min_blocks_per_thread = 4
+
+# enough of the chain's blocks of LEs, after the first, for two threads
+num_le = (2 * min_blocks_per_thread + 1) * block_les + 1000
+model_time = 1345467600
+time_step = 900
+
+
+@pytest.fixture(scope='module')
+def les():
+    np.random.seed(1)
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref['long'] = np.random.uniform(-72, -71, num_le)
+    ref['lat'] = np.random.uniform(41, 42, num_le)
+
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[::7] = oil_status.on_land
+
+    windages = np.random.uniform(.01, .04, num_le)
+    rise_velocities = np.random.uniform(.001, .01, num_le)
+
+    return (ref, status, windages, rise_velocities)
+
+
+@pytest.fixture(scope='module')
+def movers():
+    time_val = np.zeros((2, ), dtype=time_value_pair)
+    time_val['time'][:] = [model_time, model_time + 3600]
+    time_val['value']['u'][:] = [5, 10]
+    time_val['value']['v'][:] = [3, -2]
+
+    ossm = CyOSSMTime(timeseries=time_val)
+    wind = CyWindMover()
+    wind.set_ossm(ossm)
+
+    # the wind mover only points at the time series, so keep it too
+    return (ossm, wind, CyRandomMover(diffusion_coef=100000),
+            CyRiseVelocityMover())
+
+
+def prepare(movers, sp_type):
+    for m in movers[1:]:
+        m.prepare_for_model_run()
+        if sp_type == spill_type.uncertainty:
+            m.prepare_for_model_step(model_time, time_step, 1,
+                                     np.array((num_le, ), dtype=np.int32))
+        else:
+            m.prepare_for_model_step(model_time, time_step)
+
+
+@pytest.mark.parametrize("sp_type", [spill_type.forecast,
+                                     spill_type.uncertainty])
+def test_same_as_get_move(les, movers, sp_type):
+    """
+    the chain moves the LEs exactly as adding each mover's get_move delta
+    """
+    (ref, status, windages, rise_velocities) = les
+    (wind, rand, rise_vel) = movers[1:]
+
+    prepare(movers, sp_type)
+    expected = ref.copy()
+    delta = np.zeros((num_le, ), dtype=world_point)
+    for m in (wind, rand, rise_vel):
+        if m is wind:
+            m.get_move(model_time, time_step, ref, delta, windages, status,
+                       sp_type)
+        elif m is rise_vel:
+            m.get_move(model_time, time_step, ref, delta, rise_velocities,
+                       status, sp_type)
+        else:
+            m.get_move(model_time, time_step, ref, delta, status, sp_type)
+
+        for name in ('long', 'lat', 'z'):
+            expected[name] += delta[name]
+
+    chain = CyMoverChain()
+    for m in (wind, rand, rise_vel):
+        chain.add_mover(m)
+    assert len(chain) == 3
+    assert chain.blocks_in_parallel
+
+    for in_parallel in (True, False):
+        prepare(movers, sp_type)
+        chain.blocks_in_parallel = in_parallel
+        next_positions = ref.copy()
+        chain.get_move(model_time, time_step, ref, next_positions, windages,
+                       rise_velocities, status, sp_type)
+
+        assert np.all(next_positions == expected)
+        assert np.all(next_positions[::7] == ref[::7])
+        assert np.any(next_positions['lat'] != ref['lat'])
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize("sp_type", [spill_type.forecast,
+                                     spill_type.uncertainty])
+def test_gridded_current(sp_type):
+    """
+    a gridded current moved a block at a time moves the LEs as get_move
+    over all of them does, step after step: the last triangle of each LE
+    is kept by its index in the spill, and the step's blended velocities
+    are sized for the whole spill
+    """
+    n = (2 * min_blocks_per_thread + 1) * block_les + 100
+    start_time = time_utils.date_to_sec(datetime.datetime(2008, 1, 29, 17))
+    sizes = np.array((n, ), dtype=np.int32)
+
+    np.random.seed(2)
+    ref = np.zeros((n, ), dtype=world_point)
+    ref['long'] = -74.03988 + np.random.uniform(-.01, .01, n)
+    ref['lat'] = 40.536092 + np.random.uniform(-.01, .01, n)
+    status = np.empty((n, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[::10] = oil_status.on_land
+
+    def run(chained, in_parallel=True):
+        gcm = CyGridCurrentMover()
+        gcm.text_read(get_datafile(os.path.join(cur_dir, 'ny_cg.nc')),
+                      get_datafile(os.path.join(cur_dir, 'NYTopology.dat')))
+        assert gcm.walk_from_last_triangle
+        gcm.velocity_blend_mode = velocity_blend.grid
+        chain = CyMoverChain()
+        chain.add_mover(gcm)
+        chain.blocks_in_parallel = in_parallel
+
+        positions = ref.copy()
+        gcm.prepare_for_model_run()
+        steps = []
+        for i in range(4):
+            step_time = start_time + i * time_step
+            if sp_type == spill_type.uncertainty:
+                gcm.prepare_for_model_step(step_time, time_step, 1, sizes)
+            else:
+                gcm.prepare_for_model_step(step_time, time_step)
+
+            next_positions = positions.copy()
+            if chained:
+                chain.get_move(step_time, time_step, positions,
+                               next_positions, None, None, status, sp_type)
+            else:
+                delta = np.zeros((n, ), dtype=world_point)
+                gcm.get_move(step_time, time_step, positions, delta, status,
+                             sp_type)
+                for name in ('long', 'lat', 'z'):
+                    next_positions[name] += delta[name]
+            gcm.model_step_is_done()
+
+            positions = next_positions
+            steps.append(positions.copy())
+        return (steps, gcm.get_blended_tile_counts())
+
+    (expected, _) = run(False)
+    assert np.any(expected[0]['lat'] != ref['lat'])
+
+    for in_parallel in (True, False):
+        (steps, (num_tiles, num_blended)) = run(True, in_parallel)
+        assert 0 < num_blended == num_tiles
+        for (moved, chain_moved) in zip(expected, steps):
+            assert np.all(chain_moved == moved)
+
+
+def test_empty_chain(les):
+    (ref, status, windages, rise_velocities) = les
+    next_positions = ref.copy()
+
+    chain = CyMoverChain()
+    chain.get_move(model_time, time_step, ref, next_positions, None, None,
+                   status, spill_type.forecast)
+
+    assert np.all(next_positions == ref)
+
+
+def test_exceptions(les, movers):
+    (ref, status, windages, rise_velocities) = les
+    chain = CyMoverChain()
+    chain.add_mover(movers[2])
+
+    with pytest.raises(ValueError):
+        chain.get_move(model_time, time_step, ref, ref[:-1].copy(),
+                       windages, rise_velocities, status, spill_type.forecast)
+
+    with pytest.raises(ValueError):
+        chain.get_move(model_time, time_step, ref, ref.copy(),
+                       windages[:-1], rise_velocities, status,
+                       spill_type.forecast)
+
+    chain.clear()
+    assert len(chain) == 0
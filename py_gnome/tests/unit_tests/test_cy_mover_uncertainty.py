@@ -0,0 +1,108 @@
+"""
+unit tests for the per LE uncertainty factors of the current and wind
+movers, through the cython wrappers
+
+designed to be run with py.test
+"""
+
+from datetime import datetime
+
+import numpy as np
+
+from gnome.basic_types import oil_status, status_code_type
+from gnome.utilities import time_utils
+
+from gnome.cy_gnome.cy_cats_mover import CyCatsMover
+from gnome.cy_gnome.cy_wind_mover import CyWindMover
+
+# as kRemoveLEsChunk in UncertaintyArrays.cpp
+remove_chunk = 65536
+
+model_time = time_utils.date_to_sec(datetime(2012, 8, 20, 13))
+time_step = 900
+
+
+def wind_mover():
+    wm = CyWindMover()
+    wm.set_constant_wind(5., 5.)
+    return wm
+
+
+def uncertainty_terms(mover, set_sizes):
+    mover.prepare_for_model_run()
+    mover.prepare_for_model_step(model_time, time_step, len(set_sizes),
+                                 np.array(set_sizes, dtype=np.int32))
+    return mover.uncertainty_terms
+
+
+def test_current_and_wind_draw_apart():
+    """
+    a current and a wind mover, both with the default seed, don't share
+    their draws
+    """
+    (down_stream, cross_stream) = uncertainty_terms(CyCatsMover(), (2000, ))
+    (rand_cos, rand_sin) = uncertainty_terms(wind_mover(), (2000, ))
+
+    assert np.all(np.abs(down_stream) <= .3)
+    assert np.all(np.abs(cross_stream) <= .1)
+    for current_terms in (down_stream, cross_stream):
+        for wind_terms in (rand_cos, rand_sin):
+            assert abs(np.corrcoef(current_terms, wind_terms)[0, 1]) < .1
+
+
+def test_two_current_movers_draw_apart():
+    """
+    two current movers with the same seed draw apart on different streams,
+    and the same on the same one
+    """
+    (down_stream1, _) = uncertainty_terms(CyCatsMover(), (2000, ))
+    (same_stream, _) = uncertainty_terms(CyCatsMover(), (2000, ))
+    cats = CyCatsMover()
+    cats.random_stream = 1
+    (down_stream2, _) = uncertainty_terms(cats, (2000, ))
+
+    assert np.all(same_stream == down_stream1)
+    assert abs(np.corrcoef(down_stream1, down_stream2)[0, 1]) < .1
+
+
+def test_draws_by_set():
+    """
+    an LE's factors depend on its set and index in the set, not on the
+    sizes of the sets before it
+    """
+    for mover in (CyCatsMover(), wind_mover()):
+        (first1, second1) = uncertainty_terms(mover, (300, 500))
+        (first2, second2) = uncertainty_terms(mover, (200, 500))
+
+        assert len(first1) == 800 and len(first2) == 700
+        assert np.all(first1[300:] == first2[200:])
+        assert np.all(second1[300:] == second2[200:])
+        assert np.any(first1[:200] != first1[300:500])
+
+
+def test_remove_les_across_chunks():
+    """
+    removing LEs keeps the others' factors in order, the same as filtering
+    them in one go, with removals at, across and filling whole chunks
+    """
+    np.random.seed(4)
+    num_le = 3 * remove_chunk + 1000
+
+    status = np.empty((num_le, ), dtype=status_code_type)
+    status[:] = oil_status.in_water
+    status[np.random.uniform(size=num_le) < .3] = oil_status.to_be_removed
+    for b in (remove_chunk, 2 * remove_chunk):
+        status[b - 3:b + 2] = oil_status.to_be_removed
+    status[remove_chunk - 1] = oil_status.in_water
+    status[2 * remove_chunk + 10:3 * remove_chunk] = oil_status.to_be_removed
+    status[-1] = oil_status.to_be_removed
+    kept = status != oil_status.to_be_removed
+
+    for mover in (CyCatsMover(), wind_mover()):
+        (first, second) = uncertainty_terms(mover, (num_le, ))
+        mover.model_step_is_done(status)
+        (first_kept, second_kept) = mover.uncertainty_terms
+
+        assert len(first_kept) == np.count_nonzero(kept)
+        assert np.all(first_kept == first[kept])
+        assert np.all(second_kept == second[kept])
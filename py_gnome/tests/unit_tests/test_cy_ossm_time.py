@@ -127,6 +127,25 @@ class TestGetTimeValues:
         np.testing.assert_allclose(vel_rec['u'], actual['u'], tol, tol, msg, 0)
         np.testing.assert_allclose(vel_rec['v'], actual['v'], tol, tol, msg, 0)
 
+    def test_get_time_value_between_times(self):
+        """
+        Values for an array of times, in order or not, match the values
+        asked for one time at a time
+        """
+        t_val = self.ossmT.timeseries
+        time = np.linspace(t_val['time'][0] - 3600, t_val['time'][-1] + 3600,
+                           num=10 * len(t_val)).astype(seconds)
+
+        one_at_a_time = np.hstack([self.ossmT.get_time_value(t)
+                                   for t in time])
+
+        for times, expected in ((time, one_at_a_time),
+                                (time[::-1], one_at_a_time[::-1])):
+            vel_rec = self.ossmT.get_time_value(times)
+
+            assert np.all(vel_rec['u'] == expected['u'])
+            assert np.all(vel_rec['v'] == expected['v'])
+
     def test__set_time_value_handle_none(self):
         """Check TypeError exception for private method"""
         try:
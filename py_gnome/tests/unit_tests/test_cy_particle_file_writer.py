@@ -0,0 +1,144 @@
+"""
+unit tests for the cython wrapper around ParticleFileWriter
+
+designed to be run with py.test
+"""
+
+import os
+from datetime import datetime, timedelta
+
+import numpy as np
+import netCDF4 as nc
+
+from gnome.basic_types import world_point_type, status_code_type, id_type
+from gnome.cy_gnome.cy_particle_file_writer import CyParticleFileWriter
+from gnome.outputters import NetCDFOutput
+
+import pytest
+
+start_time = datetime(2014, 1, 1, 12)
+time_units = 'seconds since {0}'.format(start_time.isoformat())
+
+variables = (('longitude', world_point_type, 1),
+             ('latitude', world_point_type, 1),
+             ('depth', world_point_type, 1),
+             ('status_codes', status_code_type, 1),
+             ('spill_num', id_type, 1),
+             ('id', np.uint32, 1),
+             ('windage_range', np.float64, 2),
+             )
+
+
+def step_arrays(step):
+    'a step with more elements than the last, as they are released'
+    num = 10 * step
+    positions = np.zeros((num, 3), dtype=world_point_type)
+    positions[:, 0] = -72 + .001 * np.arange(num)
+    positions[:, 1] = 41 + .01 * step
+    positions[:, 2] = step
+
+    windage_range = np.zeros((num, 2), dtype=np.float64)
+    windage_range[:, 1] = np.arange(num)
+
+    return {'positions': positions,
+            'status_codes': np.ones((num, ), dtype=status_code_type) * 2,
+            'spill_num': np.zeros((num, ), dtype=id_type),
+            'id': np.arange(num, dtype=np.uint32),
+            'windage_range': windage_range,
+            }
+
+
+def append(writer, step):
+    arrays = step_arrays(step)
+    positions = arrays['positions']
+    writer.append_step(step * 900., [positions[:, 0], positions[:, 1],
+                                     positions[:, 2], arrays['status_codes'],
+                                     arrays['spill_num'], arrays['id'],
+                                     arrays['windage_range']])
+
+
+def check_step(filename, step):
+    arrays = step_arrays(step)
+    data = NetCDFOutput.read_data(filename, index=step,
+                                  which_data='all')
+
+    assert data['current_time_stamp'].item() == (start_time +
+                                                 timedelta(seconds=step * 900))
+    for name in arrays:
+        assert np.all(data[name] == arrays[name])
+
+
+def create(filename):
+    writer = CyParticleFileWriter()
+    writer.create(filename)
+    writer.put_attributes(None, {'comment': 'written by the unit tests'})
+    writer.put_attributes('time', {'units': time_units,
+                                   'calendar': 'gregorian'})
+    for (name, dtype, num_components) in variables:
+        writer.define_variable(name, dtype, num_components)
+    writer.end_definitions()
+
+    return writer
+
+
+def test_append_steps(tmpdir):
+    filename = os.path.join(str(tmpdir), 'particles.nc')
+    writer = create(filename)
+
+    for step in range(4):
+        append(writer, step)
+    assert writer.num_steps == 4
+    assert writer.num_particles == 60
+    writer.close()
+
+    with nc.Dataset(filename) as data:
+        assert data.comment == 'written by the unit tests'
+        assert np.all(data.variables['particle_count'][:] == [0, 10, 20, 30])
+        assert data.variables['windage_range'].shape == (60, 2)
+
+    for step in range(1, 4):
+        check_step(filename, step)
+
+
+def test_open_for_append(tmpdir):
+    filename = os.path.join(str(tmpdir), 'particles.nc')
+    writer = create(filename)
+    append(writer, 1)
+    writer.close()
+
+    writer = CyParticleFileWriter()
+    writer.open_for_append(filename)
+    assert writer.num_steps == 1
+    assert writer.num_particles == 10
+
+    for (name, dtype, num_components) in variables:
+        writer.use_variable(name, dtype, num_components)
+    append(writer, 1)
+    writer.close()
+
+    with nc.Dataset(filename) as data:
+        assert np.all(data.variables['particle_count'][:] == [10, 10])
+        assert np.all(data.variables['id'][:] == np.arange(10).tolist() * 2)
+
+
+def test_exceptions(tmpdir):
+    filename = os.path.join(str(tmpdir), 'particles.nc')
+    writer = create(filename)
+
+    with pytest.raises(ValueError):
+        writer.append_step(0., [np.zeros((3, ))])
+
+    with pytest.raises(IOError):
+        # variables are defined before end_definitions
+        writer.define_variable('mass', np.float64)
+
+    writer.close()
+
+    writer = CyParticleFileWriter()
+    with pytest.raises(IOError):
+        # the file exists
+        writer.create(filename)
+
+    writer.open_for_append(filename)
+    with pytest.raises(IOError):
+        writer.use_variable('id', np.float64)
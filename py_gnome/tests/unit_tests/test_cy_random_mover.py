@@ -10,6 +10,7 @@ from gnome.basic_types import spill_type, world_point, world_point_type
 
 from gnome.cy_gnome.cy_helpers import srand
 from gnome.cy_gnome.cy_random_mover import CyRandomMover
+from gnome.cy_gnome.cy_random_vertical_mover import CyRandomVerticalMover
 import cy_fixtures
 
 import pytest
@@ -132,6 +133,28 @@ class TestRandom:
         assert np.all(delta['lat'] == new_delta['lat'])
         assert np.all(delta['long'] == new_delta['long'])
 
+    def test_seed_property(self):
+        """
+        the draws only depend on the seed, not on the C random state or
+        the number of threads
+        """
+        delta = np.zeros((self.cm.num_le, ), dtype=world_point)
+        self.move(delta)
+
+        srand(5)
+        self.rm.num_threads = 4
+        new_delta = np.zeros((self.cm.num_le, ), dtype=world_point)
+        self.move(new_delta)
+        self.rm.num_threads = 1
+        assert np.all(delta == new_delta)
+
+        self.rm.seed = 2
+        assert self.rm.seed == 2
+        new_delta = np.zeros((self.cm.num_le, ), dtype=world_point)
+        self.move(new_delta)
+        self.rm.seed = 1
+        assert np.all(delta['lat'] != new_delta['lat'])
+
     def _diff(self, delta, new_delta):
         """
         gives the norm of the (delta-new_delta)
@@ -142,6 +165,66 @@ class TestRandom:
         return np.sum(diff ** 2, axis=1) ** .5
 
 
+def random_deltas(mover, num_le=1000):
+    cm = cy_fixtures.CyTestMove()
+    ref = np.zeros((num_le, ), dtype=world_point)
+    ref['z'] = 5.  # mid mixed layer, so the vertical draws aren't reflected
+    status = np.empty((num_le, ), dtype=cm.status.dtype)
+    status[:] = cm.status[0]
+    delta = np.zeros((num_le, ), dtype=world_point)
+
+    mover.prepare_for_model_run()
+    mover.prepare_for_model_step(cm.model_time, 900)
+    mover.get_move(cm.model_time, 900, ref, delta, status, spill_type.forecast)
+    return delta
+
+
+def test_movers_draw_apart():
+    """
+    movers with the same seed don't draw the same numbers, neither two
+    random movers on different streams nor a random and a random vertical
+    mover on the same one
+    """
+    rm1 = CyRandomMover(diffusion_coef=100000)
+    rm2 = CyRandomMover(diffusion_coef=100000)
+    vm = CyRandomVerticalMover(vertical_diffusion_coef_above_ml=5,
+                               vertical_diffusion_coef_below_ml=0)
+    for m in (rm1, rm2, vm):
+        m.seed = 1
+    rm2.random_stream = 2
+
+    delta1 = random_deltas(rm1)
+    delta2 = random_deltas(rm2)
+    v_delta = random_deltas(vm)
+
+    assert np.all(v_delta['z'] != 0)
+    for (a, b) in ((delta1['long'], delta2['long']),
+                   (delta1['lat'], delta2['lat']),
+                   (delta1['long'], v_delta['z']),
+                   (delta2['long'], v_delta['z'])):
+        assert np.any(a != b)
+        assert abs(np.corrcoef(a, b)[0, 1]) < .15
+
+
+def test_stream_is_the_callers():
+    """
+    a mover's draws depend on its seed and stream, not on how many movers
+    were made before it
+    """
+    rm1 = CyRandomMover(diffusion_coef=100000)
+    delta1 = random_deltas(rm1)
+    for i in range(3):
+        CyRandomMover(diffusion_coef=100000)
+    rm2 = CyRandomMover(diffusion_coef=100000)
+
+    assert rm1.random_stream == rm2.random_stream == 0
+    assert np.all(random_deltas(rm2) == delta1)
+
+    rm2.random_stream = 7
+    assert rm2.random_stream == 7
+    assert np.any(random_deltas(rm2)['long'] != delta1['long'])
+
+
 if __name__ == '__main__':
     tr = TestRandom()
 
@@ -0,0 +1,172 @@
+"""
+unit tests for the sums of tidal constituents the Shio height and current
+routines compute all at once, against the routines that sum them one time
+at a time: RStatHeight, RStatCurrent and RStatCurrentRot
+
+designed to be run with py.test
+"""
+
+import os
+
+import numpy as np
+import pytest
+
+import gnome
+from gnome.cy_gnome.cy_shio_time import (CyShioTime, year_data,
+                                         harmonic_sums, rstat_values)
+from gnome.utilities.remote_data import get_datafile
+
+here = os.path.dirname(__file__)
+tides_dir = os.path.join(here, 'sample_data', 'tides')
+yeardata_dir = os.path.join(os.path.dirname(gnome.__file__), 'data',
+                            'yeardata')
+
+# as kStepsBetweenResets in ShioHarmonics.cpp
+steps_between_resets = 32
+
+# the routines' 10 minute step over the 54 hours ShioTimeValue_c computes
+step_hours = 10. / 60.
+window_steps = 54 * 6 + 1
+
+num_steps = (window_steps,
+             steps_between_resets - 1,
+             steps_between_resets * 3 + 1,
+             365 * 24 * 6)      # a year of steps
+start_hours = (0., 100.25, 8000.)
+
+
+def file_station(filename, year=2013):
+    """
+    the amplitudes and epochs of a station's file, corrected for the year
+    """
+    shio = CyShioTime(get_datafile(os.path.join(tides_dir, filename)))
+    (h, k_prime) = shio.constituents
+    (xode, vpu) = year_data(yeardata_dir, year)
+    j = np.arange(len(h)) % len(xode)
+
+    return (h * xode[j], vpu[j] - k_prime)
+
+
+def random_station(num_terms, seed):
+    np.random.seed(seed)
+    amplitudes = np.random.uniform(0., 3., num_terms)
+    amplitudes[np.random.uniform(size=num_terms) < .2] = 0.
+    epochs = np.random.uniform(0., 360., num_terms)
+
+    return (amplitudes, epochs)
+
+
+stations = (('CLISShio.txt', ),
+            ('EbbTidesShio.txt', ),
+            (37, 1),
+            (114, 2))
+
+
+def get_station(station):
+    if isinstance(station[0], str):
+        return file_station(*station)
+    return random_station(*station)
+
+
+def tolerance(amplitudes):
+    'the sums turn phasors a step at a time, they drift by rounding alone'
+    return 1e-9 * np.abs(amplitudes).sum()
+
+
+@pytest.mark.parametrize('station', stations)
+def test_heights(station):
+    (amplitudes, epochs) = get_station(station)
+    ncoeff = min(max(len(amplitudes), 37), 114)
+    datum = 2.5
+
+    for start_hour in start_hours:
+        for n in num_steps:
+            hours = start_hour + np.arange(n) * step_hours
+            sums = harmonic_sums(amplitudes, epochs, 0, ncoeff, start_hour,
+                                 step_hours, n)
+            heights = rstat_values(hours, amplitudes, epochs, ncoeff, 'H',
+                                   {'datum': datum})
+
+            assert np.allclose(sums + datum, heights, rtol=0,
+                               atol=tolerance(amplitudes))
+
+
+@pytest.mark.parametrize('station', stations)
+def test_currents(station):
+    (amplitudes, epochs) = get_station(station)
+    ncoeff = min(len(amplitudes), 114)
+    ref_cur = .3
+
+    for start_hour in start_hours:
+        for n in num_steps:
+            hours = start_hour + np.arange(n) * step_hours
+            sums = harmonic_sums(amplitudes, epochs, 0, ncoeff, start_hour,
+                                 step_hours, n)
+            currents = rstat_values(hours, amplitudes, epochs, ncoeff, 'C',
+                                    {'datum': ref_cur})
+
+            assert np.allclose(sums + ref_cur, currents, rtol=0,
+                               atol=tolerance(amplitudes))
+
+    # a hydraulic station takes the signed square root of the sum
+    hours = 100.25 + np.arange(window_steps) * step_hours
+    sums = harmonic_sums(amplitudes, epochs, 0, ncoeff, 100.25, step_hours,
+                         window_steps)
+    currents = rstat_values(hours, amplitudes, epochs, ncoeff, 'C',
+                            {'datum': ref_cur, 'HFlag': 1})
+    away_from_zero = np.abs(sums) > 1e-3
+
+    assert np.allclose((ref_cur + np.sign(sums) *
+                        np.sqrt(np.abs(sums)))[away_from_zero],
+                       currents[away_from_zero], rtol=0, atol=1e-6)
+
+
+@pytest.mark.parametrize(('num_terms', 'rot_flag', 'seed'), ((74, 1, 3),
+                                                             (74, 2, 4),
+                                                             (228, 1, 5)))
+def test_rotary_currents(num_terms, rot_flag, seed):
+    """
+    the v (north-south or major axis) terms are the first half, the u terms
+    the second, each at the speeds from the first constituent on
+    """
+    (amplitudes, epochs) = random_station(num_terms, seed)
+    num_v = num_terms / 2
+    controls = {'datum': .1, 'FDir': 30, 'EDir': 210, 'RotFlag': rot_flag}
+
+    for start_hour in start_hours:
+        for n in num_steps[:3]:
+            hours = start_hour + np.arange(n) * step_hours
+            v_sums = harmonic_sums(amplitudes, epochs, 0, num_v, start_hour,
+                                   step_hours, n)
+            u_sums = harmonic_sums(amplitudes, epochs, num_v,
+                                   num_terms - num_v, start_hour, step_hours,
+                                   n)
+
+            (values, u, v) = rstat_values(hours, amplitudes, epochs,
+                                          num_terms, 'R', controls)
+            (sum_values, sum_u, sum_v) = rstat_values(hours, amplitudes,
+                                                      epochs, num_terms, 'R',
+                                                      controls,
+                                                      sums=(v_sums, u_sums))
+
+            atol = tolerance(amplitudes)
+            assert np.allclose(sum_u, u, rtol=0, atol=atol)
+            assert np.allclose(sum_v, v, rtol=0, atol=atol)
+            assert np.allclose(sum_values, values, rtol=0, atol=atol)
+
+
+def test_series_across_resets():
+    """
+    the sums at a time are the same whichever run they are part of, the
+    phasors are recomputed from the time every steps_between_resets steps
+    """
+    (amplitudes, epochs) = random_station(114, 6)
+    n = steps_between_resets * 10 + 7
+    whole = harmonic_sums(amplitudes, epochs, 0, 114, 50., step_hours, n)
+
+    for offset in (1, steps_between_resets - 1, steps_between_resets + 5):
+        part = harmonic_sums(amplitudes, epochs, 0, 114,
+                             50. + offset * step_hours, step_hours,
+                             n - offset)
+        assert np.allclose(part, whole[offset:], rtol=0,
+                           atol=tolerance(amplitudes))
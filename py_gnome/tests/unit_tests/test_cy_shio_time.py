@@ -7,12 +7,18 @@ todo: still need to add tests for functions that get the data from C++ code
 """
 
 import os
+import shutil
+import glob
+from datetime import datetime
 
+import numpy as np
 import pytest
 
 import gnome
-from gnome.cy_gnome.cy_shio_time import CyShioTime
+from gnome.cy_gnome.cy_shio_time import (CyShioTime, year_data,
+                                         year_data_info, has_year_data)
 from gnome.utilities.remote_data import get_datafile
+from gnome.utilities.time_utils import date_to_sec
 
 here = os.path.dirname(__file__)
 data_dir = os.path.join(here, 'sample_data')
@@ -20,6 +26,8 @@ tides_dir = os.path.join(data_dir, 'tides')
 lis_dir = os.path.join(data_dir, 'long_island_sound')
 
 shio_file = get_datafile(os.path.join(tides_dir, 'CLISShio.txt'))
+yeardata_dir = os.path.join(os.path.dirname(gnome.__file__), 'data',
+                            'yeardata')
 
 
 def test_exceptions():
@@ -143,3 +151,97 @@ def test_eval_repr():
     shio.scale_factor = 2
     other_shio = eval(repr(shio))
     assert shio == other_shio
+
+
+def copy_year_files(to_dir):
+    'the "#YYYY" text files, with their times'
+    for path in glob.glob(os.path.join(yeardata_dir, '#*')):
+        shutil.copy2(path, to_dir)
+
+
+def read_year_file(path):
+    'the XODE and VPU columns of a year file, as Shio reads them'
+    with open(path, 'rb') as fh:
+        values = np.array(fh.read().split()[:2 * 128], dtype=np.float64)
+    return (values[0::2], values[1::2])
+
+
+def test_year_data_before_1990(tmpdir):
+    year_dir = str(tmpdir)
+    copy_year_files(year_dir)
+
+    (first_year, last_year, _) = year_data_info(year_dir)
+    assert first_year == 1980
+    assert last_year >= 2020
+    assert year_data(year_dir, first_year - 1) is None
+
+    for year in (1980, 1985, 1989):
+        (xode, vpu) = year_data(year_dir, year)
+        (file_xode, file_vpu) = read_year_file(os.path.join(year_dir,
+                                                            '#%d' % year))
+        assert np.all(xode == file_xode)
+        assert np.all(vpu == file_vpu)
+
+    assert has_year_data(year_dir, 1985, 1995)
+    assert not has_year_data(year_dir, 1979, 1981)
+
+
+def test_year_data_text_and_table(tmpdir):
+    """
+    the table yeardata.bin is written from the text files and mapped by the
+    next store, with the same values, unless the text files have changed
+    """
+    text_dir = str(tmpdir.mkdir('text'))
+    copy_year_files(text_dir)
+    (first_year, last_year, mapped) = year_data_info(text_dir)
+    assert not mapped
+    assert os.path.isfile(os.path.join(text_dir, 'yeardata.bin'))
+
+    table_dir = str(tmpdir.mkdir('table'))
+    copy_year_files(table_dir)
+    shutil.copy(os.path.join(text_dir, 'yeardata.bin'), table_dir)
+    assert year_data_info(table_dir) == (first_year, last_year, True)
+
+    for year in range(first_year, last_year + 1):
+        (text_xode, text_vpu) = year_data(text_dir, year)
+        (table_xode, table_vpu) = year_data(table_dir, year)
+        assert np.all(text_xode == table_xode)
+        assert np.all(text_vpu == table_vpu)
+
+    # a year file changed after the table was written
+    stale_dir = str(tmpdir.mkdir('stale'))
+    copy_year_files(stale_dir)
+    shutil.copy(os.path.join(text_dir, 'yeardata.bin'), stale_dir)
+    (xode, vpu) = year_data(text_dir, 1985)
+    with open(os.path.join(stale_dir, '#1985'), 'w') as fh:
+        for (x, v) in zip(xode, vpu + 1.):
+            fh.write('{0} {1}\n'.format(x, v))
+
+    assert not year_data_info(stale_dir)[2]
+    assert np.all(year_data(stale_dir, 1985)[1] == vpu + 1.)
+
+
+def test_span_year_boundary():
+    """
+    values after Jan 1 are computed with that year's corrections, even when
+    the days asked for start the year before
+    """
+    new_year = date_to_sec(datetime(2013, 1, 1))
+    assert has_year_data(yeardata_dir, 2012, 2013)
+
+    # days from Jan 1 on
+    from_new_year = CyShioTime(shio_file, yeardata=yeardata_dir)
+    from_new_year.get_time_value(new_year + 7 * 3600)
+    # days from Dec 31 on
+    across = CyShioTime(shio_file, yeardata=yeardata_dir)
+
+    assert (across.get_time_value(new_year + 2 * 3600)['u'] ==
+            from_new_year.get_time_value(new_year + 2 * 3600)['u'])
+
+    # and before Jan 1, with the corrections of the year before
+    from_dec_30 = CyShioTime(shio_file, yeardata=yeardata_dir)
+    from_dec_30.get_time_value(new_year - 30 * 3600)
+    from_dec_31 = CyShioTime(shio_file, yeardata=yeardata_dir)
+
+    assert np.allclose(from_dec_31.get_time_value(new_year - 4 * 3600)['u'],
+                       from_dec_30.get_time_value(new_year - 4 * 3600)['u'])
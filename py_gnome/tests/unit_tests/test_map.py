@@ -19,7 +19,7 @@ import gnome.map
 from gnome.basic_types import oil_status, status_code_type
 from gnome.utilities.projections import NoProjection
 
-from gnome.map import MapFromBNA, RasterMap
+from gnome.map import MapFromBNA, RasterMap, VectorMap, VectorMapFromBNA
 from gnome.persist import load
 
 from conftest import sample_sc_release
@@ -543,6 +543,70 @@ class Test_MapfromBNA:
         assert not self.bna_map.on_map(point)
 
 
+class Test_VectorMapFromBNA(Test_MapfromBNA):
+    """
+    the same points, checked against the shoreline polygons
+    """
+    bna_map = VectorMapFromBNA(testmap, 6)
+
+
+class Test_VectorMap:
+
+    """
+    beaching on a square island, with a square lake in it
+    """
+
+    island = ((5, 2), (15, 2), (15, 10), (5, 10))
+    lake = ((8, 4), (12, 4), (12, 8), (8, 8))
+
+    def make_map(self):
+        return VectorMap(refloat_halflife=6,
+                         shoreline_polygons=(self.island, self.lake),
+                         map_bounds=((-50, -30), (-50, 30), (50, 30),
+                                     (50, -30)))
+
+    def test_on_land(self):
+        gmap = self.make_map()
+
+        assert gmap.on_land((6, 6, 0.))
+        assert not gmap.on_land((10, 6, 0.))  # in the lake
+        assert not gmap.on_land((3, 6, 0.))
+        assert not gmap.allowable_spill_position((6, 6, 0.))
+        assert gmap.allowable_spill_position((10, 6, 0.))
+
+    def test_land_cross(self):
+        gmap = self.make_map()
+
+        spill = sample_sc_release(3)
+
+        spill['positions'] = np.array(((0.0, 6.0, 0.),
+                                       (10.0, 6.0, 0.),
+                                       (0.0, 0.0, 0.)),
+                                      dtype=np.float64)
+        spill['next_positions'] = np.array(((20.0, 6.0, 0.),
+                                            (10.0, 12.0, 0.),
+                                            (20.0, 1.0, 0.)),
+                                           dtype=np.float64)
+        spill['status_codes'] = np.array((oil_status.in_water, ) * 3,
+                                         dtype=status_code_type)
+
+        gmap.beach_elements(spill)
+
+        # stopped right at the shoreline -- the lake's for the one in it
+        assert np.allclose(spill['next_positions'][:2],
+                           ((5.0, 6.0, 0.), (10.0, 8.0, 0.)), rtol=0,
+                           atol=1e-12)
+        assert np.all(spill['status_codes'][:2] == oil_status.on_land)
+        assert not gmap.on_land(spill['last_water_positions'][0])
+        assert not gmap.on_land(spill['last_water_positions'][1])
+        assert np.allclose(spill['last_water_positions'][:2],
+                           spill['next_positions'][:2], atol=1e-5)
+
+        # passed under the island
+        assert np.array_equal(spill['next_positions'][2], (20.0, 1.0, 0.))
+        assert spill['status_codes'][2] == oil_status.in_water
+
+
 @pytest.mark.parametrize("json_", ('save', 'webapi'))
 def test_serialize_deserialize(json_):
     """
@@ -512,6 +512,63 @@ def test_all_movers(start_time, release_delay, duration):
     assert num_steps_output == calculated_steps
 
 
+def test_chained_moves():
+    '''
+    running the chainable movers in CyMoverChains moves the elements the
+    same as calling each mover's get_move, with a mover that isn't
+    chainable between them; the model keeps its chains from step to step
+    '''
+    start_time = datetime(2012, 1, 1, 0, 0)
+    model = Model(start_time=start_time, time_step=900,
+                  duration=timedelta(hours=3), uncertain=True)
+    model.map = gnome.map.GnomeMap()
+
+    # more elements than the chain moves in one block
+    model.spills += point_line_release_spill(num_elements=10000,
+                                             start_position=(-72.9, 41.1,
+                                                             0.),
+                                             release_time=start_time,
+                                             end_position=(-72.7, 41.15,
+                                                           0.))
+
+    series = np.array((start_time, (10, 45)),
+                      dtype=datetime_value_2d).reshape((1, ))
+    model.movers += RandomMover(diffusion_coef=100000)
+    model.movers += WindMover(Wind(timeseries=series,
+                              units='meter per second'))
+    model.movers += SimpleMover(velocity=(1., -1., 0.))
+    model.movers += CatsMover(get_datafile(os.path.join(lis_dir,
+                                                        'tidesWAC.CUR')))
+
+    def run():
+        model.rewind()
+        tracks = []
+        chain_ids = []
+        for step in model:
+            tracks.append([model.spills.LE('positions', uncertain).copy()
+                           for uncertain in (False, True)])
+            chain_ids.append([id(c) for c in model._mover_chains])
+
+        # the zeroth step doesn't move the elements, the first builds the
+        # chains and the others use them
+        assert all(ids == chain_ids[1] for ids in chain_ids[1:])
+        return (tracks, list(model._mover_chains))
+
+    (chained, chains) = run()
+    assert [len(c) for c in chains] == [2, 1]
+
+    for m in model.movers:
+        m.chainable = False
+    (moved, chains) = run()
+    assert chains == []
+
+    assert np.any(chained[-1][0] != chained[0][0])
+    for (step_chained, step_moved) in zip(chained, moved):
+        for (positions_chained, positions_moved) in zip(step_chained,
+                                                        step_moved):
+            assert np.all(positions_chained == positions_moved)
+
+
 # 0 is infinite persistence
 
 @pytest.mark.parametrize('wind_persist', [-1, 900, 5])
@@ -93,6 +93,19 @@ class TestRandomMover:
         assert True
 
 
+def test_random_stream_save_load(tmpdir):
+    'the random stream is saved with the mover'
+    rand = RandomMover()
+    assert rand.random_stream == 0
+
+    rand.random_stream = 5
+    refs = rand.save(str(tmpdir))
+    rand2 = load(os.path.join(str(tmpdir), refs.reference(rand)))
+
+    assert rand2.random_stream == 5
+    assert rand2 == rand
+
+
 start_locs = [(0., 0., 0.), (30.0, 30.0, 30.0), (-45.0, -60.0, 30.0)]
 
 timesteps = [36, 360, 3600]